@@ -1,19 +1,32 @@
 /**
  * @file b14_https.cc
  * @brief HTTPS 服务器压测程序（纯净版）
- * @details 提供 keep-alive 的 200 OK 文本响应，用于与 Go/Rust HTTPS 服务横向对比
+ * @details 提供 keep-alive 的 200 OK 文本响应，用于与 Go/Rust HTTPS 服务横向对比。
+ * 第 5 个参数为 `handshake` 时改为握手吞吐模式：进程内启动服务器，客户端线程反复新建 TLS 连接
+ * （每个连接一个请求），分别测量不恢复、票据恢复与服务端缓存恢复下的每秒握手数：
+ * `b14_https_server 9444 4 cert/test.crt cert/test.key handshake 8 5`
  */
 
 #include "galay-http/kernel/http/http_server.h"
 #include "galay-http/protoc/http/http_request.h"
+#include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 #ifdef GALAY_HTTP_SSL_ENABLED
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/ssl.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace galay::http;
 using namespace galay::kernel;
@@ -55,6 +68,136 @@ Task<void> handleHttpsRequest(HttpConnImpl<galay::ssl::SslSocket> conn) {
     }
 }
 
+/**
+ * @brief 一次短连接：TCP 连接、TLS 握手（可带上次的会话）、一个请求、close_notify
+ * @return 成功时返回 true，并在 resume 为 true 时把本次会话留给下一次连接
+ */
+bool oneShotRequest(SSL_CTX* ctx, uint16_t port, bool resume, SSL_SESSION*& session, bool& reused) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    SSL* ssl = SSL_new(ctx);
+    SSL_set_fd(ssl, fd);
+    if (resume && session != nullptr) {
+        SSL_set_session(ssl, session);
+    }
+    static constexpr std::string_view kRequest =
+        "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+    char buffer[512];
+    bool ok = SSL_connect(ssl) == 1 &&
+              SSL_write(ssl, kRequest.data(), static_cast<int>(kRequest.size())) > 0 &&
+              SSL_read(ssl, buffer, sizeof(buffer)) > 0;
+    if (ok) {
+        reused = SSL_session_reused(ssl) == 1;
+        if (resume) {
+            if (session != nullptr) {
+                SSL_SESSION_free(session);
+            }
+            session = SSL_get1_session(ssl);
+        }
+        SSL_shutdown(ssl);
+    }
+    SSL_free(ssl);
+    ::close(fd);
+    return ok;
+}
+
+/**
+ * @brief 握手吞吐一轮：按给定会话恢复配置启动服务器，客户端线程压测 seconds 秒
+ */
+void runHandshakeRound(const char* name, HttpTlsSessionConfig session_config, uint16_t port, int io_threads,
+                       const std::string& cert_path, const std::string& key_path, int clients, int seconds) {
+    HttpsServer server(HttpsServerBuilder()
+        .host("127.0.0.1")
+        .port(port)
+        .certPath(cert_path)
+        .keyPath(key_path)
+        .ioSchedulerCount(static_cast<size_t>(io_threads))
+        .tlsSession(std::move(session_config))
+        .build());
+    server.start(handleHttpsRequest);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const bool resume = std::string_view(name) != "none";
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> handshakes{0};
+    std::atomic<uint64_t> reused{0};
+    std::atomic<uint64_t> failures{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; ++i) {
+        threads.emplace_back([&] {
+            SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+            SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+            SSL_SESSION* session = nullptr;
+            while (!stop.load(std::memory_order_relaxed)) {
+                bool was_reused = false;
+                if (!oneShotRequest(ctx, port, resume, session, was_reused)) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                handshakes.fetch_add(1, std::memory_order_relaxed);
+                if (was_reused) {
+                    reused.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (session != nullptr) {
+                SSL_SESSION_free(session);
+            }
+            SSL_CTX_free(ctx);
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto stats = server.tlsSessionStats();
+    server.stop();
+
+    std::cout << name << ": " << handshakes.load() / static_cast<uint64_t>(seconds) << " handshakes/s"
+              << " (client reused=" << reused.load() << " failures=" << failures.load() << ")\n"
+              << "  server resumed=" << stats.resumed << " full=" << stats.full_handshakes
+              << " cache_hits=" << stats.cache_hits << " cache_misses=" << stats.cache_misses
+              << " ticket_unknown_key=" << stats.ticket_unknown_key << "\n";
+}
+
+int runHandshakeBenchmark(uint16_t port, int io_threads, const std::string& cert_path,
+                          const std::string& key_path, int clients, int seconds) {
+    std::cout << "========================================\n";
+    std::cout << "HTTPS Handshake Benchmark\n";
+    std::cout << "========================================\n";
+    std::cout << "Port: " << port << "-" << port + 2 << "\n";
+    std::cout << "IO Threads: " << io_threads << "\n";
+    std::cout << "Clients: " << clients << "\n";
+    std::cout << "Duration: " << seconds << "s per round\n";
+    std::cout << "========================================\n\n";
+
+    HttpTlsSessionConfig none;
+    none.tickets = false;
+    HttpTlsSessionConfig tickets;
+    HttpTlsSessionConfig cache;
+    cache.tickets = false;
+    cache.session_cache = true;
+    // 每轮换一个端口，避开上一轮的 TIME_WAIT
+    runHandshakeRound("none", none, port, io_threads, cert_path, key_path, clients, seconds);
+    runHandshakeRound("tickets", tickets, static_cast<uint16_t>(port + 1), io_threads, cert_path, key_path,
+                      clients, seconds);
+    runHandshakeRound("cache", cache, static_cast<uint16_t>(port + 2), io_threads, cert_path, key_path,
+                      clients, seconds);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
 
     uint16_t port = 9444;
@@ -74,6 +217,16 @@ int main(int argc, char* argv[]) {
     if (argc > 4) {
         key_path = argv[4];
     }
+    if (argc > 5 && std::string_view(argv[5]) == "handshake") {
+        const int clients = argc > 6 ? std::atoi(argv[6]) : 8;
+        const int seconds = argc > 7 ? std::atoi(argv[7]) : 5;
+        try {
+            return runHandshakeBenchmark(port, io_threads, cert_path, key_path, clients, seconds);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
 
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
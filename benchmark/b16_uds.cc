@@ -0,0 +1,232 @@
+/**
+ * @file b16_uds.cc
+ * @brief Unix domain socket 与回环 TCP 的 HTTP 吞吐对比
+ * @details 同一进程内启动两个 HttpServer（127.0.0.1:port 与 unix:path），
+ *          以相同连接数、相同时长的 keep-alive 客户端依次压测，输出两者的 QPS 与平均延迟。
+ *          Unix domain socket 不经过 TCP/IP 协议栈（无校验和、无拥塞控制、无 loopback 软中断），
+ *          同机 sidecar 转发时通常有明显优势。
+ *
+ * 使用方法:
+ *   ./benchmark/b16_uds [port] [unix_path] [connections] [duration] [io_threads]
+ *   默认: 18080 /tmp/galay-b16.sock 64 10 2
+ */
+
+#include "galay-http/kernel/http/http_server.h"
+#include "galay-http/kernel/http/http_client.h"
+#include "galay-http/protoc/http/http_request.h"
+#include "galay-kernel/kernel/runtime.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string_view>
+#include <thread>
+
+using namespace galay::http;
+using namespace galay::kernel;
+
+static constexpr std::string_view kPlainTextOkResponse =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 2\r\n"
+    "\r\n"
+    "OK";
+
+std::atomic<int64_t> g_success{0};
+std::atomic<int64_t> g_fail{0};
+std::atomic<int64_t> g_request_time_us{0};
+std::atomic<int> g_active_connections{0};
+
+struct RunResult {
+    double qps = 0;
+    double avg_latency_us = 0;
+    int64_t success = 0;
+    int64_t fail = 0;
+};
+
+/**
+ * @brief 服务端处理器 - 固定 OK 响应
+ */
+Task<void> handleHttpRequest(HttpConn conn) {
+    auto reader = conn.getReader();
+    auto writer = conn.getWriter();
+
+    while (true) {
+        HttpRequest request;
+        while (true) {
+            auto read_result = co_await reader.getRequest(request);
+            if (!read_result) {
+                co_return;
+            }
+            if (read_result.value()) break;
+        }
+
+        auto result = co_await writer.sendView(kPlainTextOkResponse);
+        if (!result) {
+            co_return;
+        }
+    }
+}
+
+/**
+ * @brief 持续压测工作协程
+ * @param unix_path 非空时经 Unix domain socket 连接，否则连接 127.0.0.1:port
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((noinline))
+#endif
+Task<void> continuousWorker(std::string unix_path, int port,
+                            std::chrono::steady_clock::time_point end_time,
+                            std::atomic<bool>& stop_flag) {
+    g_active_connections++;
+    auto client = HttpClientBuilder().build();
+
+    if (!unix_path.empty()) {
+        auto connect_result = client.connectUnix(unix_path);
+        if (!connect_result) {
+            g_fail++;
+            g_active_connections--;
+            co_return;
+        }
+    } else {
+        auto connect_result = co_await client.connect("http://127.0.0.1:" + std::to_string(port) + "/");
+        if (!connect_result) {
+            g_fail++;
+            g_active_connections--;
+            co_return;
+        }
+    }
+
+    HttpSession session(client.socket());
+    std::map<std::string, std::string> headers{
+        {"Host", "localhost"},
+        {"Connection", "keep-alive"}
+    };
+
+    while (!stop_flag.load(std::memory_order_relaxed) &&
+           std::chrono::steady_clock::now() < end_time) {
+        auto request_start = std::chrono::steady_clock::now();
+        auto result = co_await session.get("/", headers);
+        if (!result) {
+            g_fail++;
+            break;
+        }
+        auto response_opt = result.value();
+        if (!response_opt.has_value()) {
+            continue;
+        }
+        auto request_end = std::chrono::steady_clock::now();
+        g_request_time_us += std::chrono::duration_cast<std::chrono::microseconds>(request_end - request_start).count();
+        if (static_cast<int>(response_opt.value().header().code()) == 200) {
+            g_success++;
+        } else {
+            g_fail++;
+        }
+    }
+
+    // GCC13 协程在复杂析构路径上存在已知 ICE，这里依赖析构关闭 socket。
+    g_active_connections--;
+    co_return;
+}
+
+RunResult runOnce(Runtime& rt, const std::string& unix_path, int port, int connections, int duration_sec) {
+    g_success = 0;
+    g_fail = 0;
+    g_request_time_us = 0;
+    g_active_connections = 0;
+
+    std::atomic<bool> stop_flag{false};
+    auto start = std::chrono::steady_clock::now();
+    auto end_time = start + std::chrono::seconds(duration_sec);
+    for (int i = 0; i < connections; i++) {
+        auto* scheduler = rt.getNextIOScheduler();
+        if (scheduler) {
+            scheduleTask(scheduler, continuousWorker(unix_path, port, end_time, stop_flag));
+        }
+    }
+
+    std::this_thread::sleep_until(end_time);
+    stop_flag.store(true);
+    while (g_active_connections.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    const double duration_s =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    RunResult result;
+    result.success = g_success.load();
+    result.fail = g_fail.load();
+    result.qps = duration_s > 0 ? result.success / duration_s : 0;
+    result.avg_latency_us = result.success > 0 ? g_request_time_us.load() * 1.0 / result.success : 0;
+    return result;
+}
+
+void printResult(const std::string& name, const RunResult& result) {
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0) << result.qps << " req/s"
+              << std::setw(12) << std::setprecision(1) << result.avg_latency_us << " us"
+              << std::setw(10) << result.fail << " fail\n";
+}
+
+int main(int argc, char* argv[]) {
+    uint16_t port = 18080;
+    std::string unix_path = "/tmp/galay-b16.sock";
+    int connections = 64;
+    int duration = 10;
+    int io_threads = 2;
+
+    if (argc > 1) port = static_cast<uint16_t>(std::atoi(argv[1]));
+    if (argc > 2) unix_path = argv[2];
+    if (argc > 3) connections = std::atoi(argv[3]);
+    if (argc > 4) duration = std::atoi(argv[4]);
+    if (argc > 5) io_threads = std::atoi(argv[5]);
+
+    std::cout << "==========================================\n";
+    std::cout << "UDS vs Loopback TCP Benchmark\n";
+    std::cout << "==========================================\n";
+    std::cout << "用法: " << argv[0] << " [port] [unix_path] [connections] [duration] [io_threads]\n";
+    std::cout << "TCP: 127.0.0.1:" << port << "  UDS: " << unix_path << "\n";
+    std::cout << "连接数: " << connections << "  时长: " << duration << " 秒  IO 线程: " << io_threads << "\n";
+    std::cout << "==========================================\n\n";
+
+    try {
+        HttpServer tcp_server(HttpServerBuilder()
+            .host("127.0.0.1")
+            .port(port)
+            .ioSchedulerCount(static_cast<size_t>(io_threads))
+            .computeSchedulerCount(0)
+            .build());
+        HttpServer uds_server(HttpServerBuilder()
+            .host("unix:" + unix_path)
+            .ioSchedulerCount(static_cast<size_t>(io_threads))
+            .computeSchedulerCount(0)
+            .build());
+        tcp_server.start(handleHttpRequest);
+        uds_server.start(handleHttpRequest);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        Runtime rt = RuntimeBuilder().ioSchedulerCount(static_cast<size_t>(io_threads)).computeSchedulerCount(0).build();
+        rt.start();
+
+        const RunResult tcp = runOnce(rt, "", port, connections, duration);
+        const RunResult uds = runOnce(rt, unix_path, port, connections, duration);
+
+        rt.stop();
+        tcp_server.stop();
+        uds_server.stop();
+
+        std::cout << "结果:\n";
+        printResult("loopback TCP", tcp);
+        printResult("unix socket", uds);
+        if (tcp.qps > 0) {
+            std::cout << "\nUDS / TCP QPS 比: " << std::setprecision(2) << (uds.qps / tcp.qps) << "x\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file b17_idle_rss.cc
+ * @brief 空闲 keep-alive 连接的常驻内存（RSS）对比
+ * @details 在进程内以路由模式启动 HttpServer，用阻塞 socket 建立 N 条连接，
+ *          每条连接完成一次请求后保持空闲，读取 /proc/self/status 的 VmRSS，
+ *          输出每条空闲连接的 RSS 增量。分别以 idle_buffer_release 关闭与开启各运行一次进程
+ *          （同一进程内前一轮释放的内存会被分配器复用，结果不可比）。
+ *
+ * 使用方法:
+ *   ./benchmark/b17_idle_rss [release(0|1)] [connections] [port] [io_threads]
+ *   默认: 1 10000 18081 2
+ *   连接数较大时需先调高 ulimit -n
+ */
+
+#include "galay-http/kernel/http/http_server.h"
+#include "galay-http/protoc/http/http_request.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace galay::http;
+using namespace galay::kernel;
+
+static constexpr std::string_view kPlainTextOkResponse =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 2\r\n"
+    "\r\n"
+    "OK";
+
+static constexpr std::string_view kRequest =
+    "GET / HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+Task<void> okHandler(HttpConn& conn, HttpRequest req) {
+    auto writer = conn.getWriter();
+    co_await writer.sendView(kPlainTextOkResponse);
+    co_return;
+}
+
+/**
+ * @brief 读取当前进程的 VmRSS（KB）
+ */
+long readRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::atol(line.c_str() + 6);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 建立连接并完成一次请求，返回保持打开的 fd；失败返回 -1
+ */
+int openIdleConnection(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::send(fd, kRequest.data(), kRequest.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(kRequest.size())) {
+        ::close(fd);
+        return -1;
+    }
+    std::string response;
+    char buf[256];
+    while (response.size() < kPlainTextOkResponse.size()) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            ::close(fd);
+            return -1;
+        }
+        response.append(buf, static_cast<size_t>(n));
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[]) {
+    bool release = true;
+    int connections = 10000;
+    uint16_t port = 18081;
+    int io_threads = 2;
+
+    if (argc > 1) release = std::atoi(argv[1]) != 0;
+    if (argc > 2) connections = std::atoi(argv[2]);
+    if (argc > 3) port = static_cast<uint16_t>(std::atoi(argv[3]));
+    if (argc > 4) io_threads = std::atoi(argv[4]);
+
+    std::cout << "==========================================\n";
+    std::cout << "Idle Keep-Alive RSS Benchmark\n";
+    std::cout << "==========================================\n";
+    std::cout << "用法: " << argv[0] << " [release(0|1)] [connections] [port] [io_threads]\n";
+    std::cout << "idle_buffer_release: " << (release ? "on" : "off")
+              << "  连接数: " << connections << "  端口: " << port << "  IO 线程: " << io_threads << "\n";
+    std::cout << "==========================================\n\n";
+
+    try {
+        HttpServer server(HttpServerBuilder()
+            .host("127.0.0.1")
+            .port(port)
+            .ioSchedulerCount(static_cast<size_t>(io_threads))
+            .computeSchedulerCount(0)
+            .idleBufferRelease(release)
+            .build());
+        HttpRouter router;
+        router.addHandler<HttpMethod::GET>("/", okHandler);
+        server.start(std::move(router));
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        std::vector<int> fds;
+        fds.reserve(static_cast<size_t>(connections));
+        const long baseline_kb = readRssKb();
+        const auto start = std::chrono::steady_clock::now();
+        int failed = 0;
+        for (int i = 0; i < connections; ++i) {
+            const int fd = openIdleConnection(port);
+            if (fd < 0) {
+                ++failed;
+                continue;
+            }
+            fds.push_back(fd);
+        }
+        // 等待服务端协程全部回到空闲等待
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        const long idle_kb = readRssKb();
+        const double elapsed_s =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+
+        const size_t idle = fds.size();
+        std::cout << "结果:\n";
+        std::cout << "  空闲连接:     " << idle << "  (失败 " << failed << ", 建连耗时 "
+                  << std::fixed << std::setprecision(2) << elapsed_s << " s)\n";
+        std::cout << "  基线 RSS:     " << baseline_kb << " KB\n";
+        std::cout << "  空闲后 RSS:   " << idle_kb << " KB\n";
+        if (idle > 0 && baseline_kb >= 0 && idle_kb >= 0) {
+            // 客户端 fd 也计入本进程，但客户端未持有用户态缓冲，增量主要来自服务端
+            std::cout << "  每连接 RSS:   " << std::setprecision(2)
+                      << static_cast<double>(idle_kb - baseline_kb) * 1024.0 / static_cast<double>(idle)
+                      << " B\n";
+        }
+
+        for (int fd : fds) {
+            ::close(fd);
+        }
+        server.stop();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
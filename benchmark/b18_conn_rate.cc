@@ -0,0 +1,166 @@
+/**
+ * @file b18_conn_rate.cc
+ * @brief 短连接建连速率（connections/sec）
+ * @details 在进程内以路由模式启动 HttpServer，多个客户端线程循环执行
+ *          connect → 发送 `Connection: close` 请求 → 读到 EOF → 关闭，
+ *          统计每秒完成的连接数。分别以 accept_batch=1 与更大的值运行，对比批量 accept 的效果；
+ *          acceptStats() 的 batched 计数给出批量取出的连接占比。
+ *          客户端关闭时设置 SO_LINGER=0，避免 TIME_WAIT 耗尽本地端口。
+ *
+ * 使用方法:
+ *   ./benchmark/b18_conn_rate [accept_batch] [client_threads] [duration] [port] [io_threads]
+ *   默认: 32 8 10 18082 2
+ */
+
+#include "galay-http/kernel/http/http_server.h"
+#include "galay-http/protoc/http/http_request.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace galay::http;
+using namespace galay::kernel;
+
+static constexpr std::string_view kPlainTextOkResponse =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n"
+    "Content-Length: 2\r\n"
+    "\r\n"
+    "OK";
+
+static constexpr std::string_view kRequest =
+    "GET / HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+std::atomic<int64_t> g_success{0};
+std::atomic<int64_t> g_fail{0};
+
+Task<void> okHandler(HttpConn& conn, HttpRequest req) {
+    auto writer = conn.getWriter();
+    co_await writer.sendView(kPlainTextOkResponse);
+    co_return;
+}
+
+/**
+ * @brief 完成一次短连接请求
+ */
+bool runShortConnection(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bool ok = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+              ::send(fd, kRequest.data(), kRequest.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(kRequest.size());
+    size_t received = 0;
+    char buf[256];
+    while (ok) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            ok = false;
+        } else if (n == 0) {
+            break;
+        } else {
+            received += static_cast<size_t>(n);
+        }
+    }
+    linger lg{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    ::close(fd);
+    return ok && received >= kPlainTextOkResponse.size();
+}
+
+void clientWorker(uint16_t port, std::chrono::steady_clock::time_point end_time) {
+    while (std::chrono::steady_clock::now() < end_time) {
+        if (runShortConnection(port)) {
+            g_success.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            g_fail.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t accept_batch = 32;
+    int client_threads = 8;
+    int duration = 10;
+    uint16_t port = 18082;
+    int io_threads = 2;
+
+    if (argc > 1) accept_batch = static_cast<size_t>(std::atoi(argv[1]));
+    if (argc > 2) client_threads = std::atoi(argv[2]);
+    if (argc > 3) duration = std::atoi(argv[3]);
+    if (argc > 4) port = static_cast<uint16_t>(std::atoi(argv[4]));
+    if (argc > 5) io_threads = std::atoi(argv[5]);
+
+    std::cout << "==========================================\n";
+    std::cout << "Connection Rate Benchmark\n";
+    std::cout << "==========================================\n";
+    std::cout << "用法: " << argv[0] << " [accept_batch] [client_threads] [duration] [port] [io_threads]\n";
+    std::cout << "accept_batch: " << accept_batch << "  客户端线程: " << client_threads
+              << "  时长: " << duration << " 秒  端口: " << port << "  IO 线程: " << io_threads << "\n";
+    std::cout << "==========================================\n\n";
+
+    try {
+        HttpServer server(HttpServerBuilder()
+            .host("127.0.0.1")
+            .port(port)
+            .backlog(4096)
+            .ioSchedulerCount(static_cast<size_t>(io_threads))
+            .computeSchedulerCount(0)
+            .acceptBatch(accept_batch)
+            .build());
+        HttpRouter router;
+        router.addHandler<HttpMethod::GET>("/", okHandler);
+        server.start(std::move(router));
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto end_time = start + std::chrono::seconds(duration);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < client_threads; ++i) {
+            clients.emplace_back(clientWorker, port, end_time);
+        }
+        for (auto& t : clients) {
+            t.join();
+        }
+        const double elapsed_s =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+
+        const auto stats = server.acceptStats();
+        uint64_t batched = 0;
+        for (const auto& slot : stats.schedulers) {
+            batched += slot.batched;
+        }
+        const uint64_t accepted = stats.totalAccepted();
+        server.stop();
+
+        std::cout << "结果:\n";
+        std::cout << "  完成连接:     " << g_success.load() << "  (失败 " << g_fail.load() << ")\n";
+        std::cout << "  建连速率:     " << std::fixed << std::setprecision(0)
+                  << (elapsed_s > 0 ? g_success.load() / elapsed_s : 0) << " conn/s\n";
+        std::cout << "  批量 accept:  " << batched << " / " << accepted;
+        if (accepted > 0) {
+            std::cout << "  (" << std::setprecision(1) << (100.0 * batched / accepted) << "%)";
+        }
+        std::cout << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file graceful_drain.h
+ * @brief 每调度器一个的排空通知表：服务器排空时通知空闲连接收尾
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 等待下一个请求的 HTTP/1.1 keep-alive 连接与服务端 HTTP/2 连接把侵入式节点挂到
+ * 所在调度器线程的 HttpDrainList；服务器开始排空时在每个 IO 调度器上调用 drain()，依次回调各节点：
+ * - HTTP/1.1 空闲连接 shutdown 后由请求循环按断连关闭
+ * - HTTP/2 连接先后发送两次 GOAWAY，在途流结束（或超时）后关闭
+ * 表进入排空状态后新挂载的节点立即回调。节点析构时自动摘除；表只在所属线程访问，不加锁。
+ * 本文件不依赖运行时。
+ */
+
+#ifndef GALAY_HTTP_GRACEFUL_DRAIN_H
+#define GALAY_HTTP_GRACEFUL_DRAIN_H
+
+#include <cstddef>
+
+namespace galay::http
+{
+
+class HttpDrainList
+{
+public:
+    /**
+     * @brief 侵入式节点
+     * @details 所有者持有节点（通常作为协程帧上的局部对象或连接成员），回调在表所属线程上执行
+     */
+    class Node
+    {
+    public:
+        using Callback = void (*)(Node&);
+
+        explicit Node(Callback callback = nullptr) noexcept : m_callback(callback) {}
+        ~Node() { unlink(); }
+
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        bool linked() const noexcept { return m_list != nullptr; }
+
+        /**
+         * @brief 从表中摘除；未挂载时无操作
+         */
+        void unlink() noexcept
+        {
+            if (m_list != nullptr) {
+                m_list->remove(*this);
+            }
+        }
+
+    private:
+        friend class HttpDrainList;
+
+        Node* m_prev = nullptr;
+        Node* m_next = nullptr;
+        HttpDrainList* m_list = nullptr;
+        Callback m_callback;
+    };
+
+    HttpDrainList() = default;
+    HttpDrainList(const HttpDrainList&) = delete;
+    HttpDrainList& operator=(const HttpDrainList&) = delete;
+
+    ~HttpDrainList()
+    {
+        while (m_head != nullptr) {
+            remove(*m_head);
+        }
+    }
+
+    /**
+     * @brief 当前调度器线程的排空表
+     */
+    static HttpDrainList& local()
+    {
+        thread_local HttpDrainList list;
+        return list;
+    }
+
+    /**
+     * @brief 挂载节点
+     * @return 表已进入排空状态时不挂载、立即回调并返回 false
+     */
+    bool add(Node& node)
+    {
+        if (m_draining) {
+            if (node.m_callback != nullptr) {
+                node.m_callback(node);
+            }
+            return false;
+        }
+        node.unlink();
+        node.m_list = this;
+        node.m_prev = nullptr;
+        node.m_next = m_head;
+        if (m_head != nullptr) {
+            m_head->m_prev = &node;
+        }
+        m_head = &node;
+        ++m_size;
+        return true;
+    }
+
+    void remove(Node& node) noexcept
+    {
+        if (node.m_list != this) {
+            return;
+        }
+        if (node.m_prev != nullptr) {
+            node.m_prev->m_next = node.m_next;
+        } else {
+            m_head = node.m_next;
+        }
+        if (node.m_next != nullptr) {
+            node.m_next->m_prev = node.m_prev;
+        }
+        node.m_prev = nullptr;
+        node.m_next = nullptr;
+        node.m_list = nullptr;
+        --m_size;
+    }
+
+    /**
+     * @brief 进入排空状态并回调当前挂载的全部节点（回调前先摘除）
+     * @return 回调的节点数
+     */
+    size_t drain()
+    {
+        m_draining = true;
+        size_t notified = 0;
+        while (m_head != nullptr) {
+            Node& node = *m_head;
+            remove(node);
+            if (node.m_callback != nullptr) {
+                node.m_callback(node);
+            }
+            ++notified;
+        }
+        return notified;
+    }
+
+    /**
+     * @brief 退出排空状态（服务器在同一线程上重新启动时调用）
+     */
+    void reset() noexcept { m_draining = false; }
+
+    bool draining() const noexcept { return m_draining; }
+    size_t size() const noexcept { return m_size; }
+
+private:
+    Node* m_head = nullptr;
+    size_t m_size = 0;
+    bool m_draining = false;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_GRACEFUL_DRAIN_H
@@ -0,0 +1,345 @@
+/**
+ * @file admission.h
+ * @brief 准入控制与自适应削峰：每调度器连接上限、在途请求上限与 CoDel 式排队时延削峰
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 流量突增时 accept 循环持续接收连接，调度器就绪队列不断变长，所有请求的延迟一起恶化。
+ * 启用后按三道闸门尽早拒绝一部分工作：
+ * - 连接上限：每个 IO 调度器的存活连接数达到 max_connections_per_scheduler 时，新连接直接拒绝
+ * - 在途上限：整个服务器正在执行处理器的请求数达到 max_inflight_requests 时拒绝新请求
+ * - 排队时延：测量处理器从被调度到开始执行的等待时间（HTTP/1.1 为 accept 到连接处理器启动，
+ *   HTTP/2 为流就绪到流处理器启动）。按 CoDel 的思路区分突发与积压：某个 interval 内的最小时延
+ *   仍超过 target，说明就绪队列中存在消不掉的积压，下一个 interval 内时延超过 2 × target 的工作被丢弃
+ * HTTP/1.1 被拒绝时从预先构造好的缓冲直接写出 503 与 Retry-After 后关闭，不解析请求；
+ * HTTP/2 流以 RST_STREAM(REFUSED_STREAM) 拒绝，客户端可以安全重试。
+ * 每个槽位独占缓存行；CoDel 状态只由所属调度器线程读写。本文件不依赖运行时，接入点见 http_server.h。
+ */
+
+#ifndef GALAY_HTTP_ADMISSION_H
+#define GALAY_HTTP_ADMISSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+
+namespace galay::http
+{
+
+/**
+ * @brief 准入控制配置（各上限为 0 表示不限）
+ */
+struct HttpAdmissionConfig
+{
+    bool enabled = false;                                   ///< 是否启用（默认关闭）
+    size_t max_connections_per_scheduler = 0;               ///< 每个 IO 调度器的存活连接上限
+    size_t max_inflight_requests = 0;                       ///< 整个服务器的在途请求上限
+    std::chrono::milliseconds queue_delay_target{0};        ///< 排队时延目标，0 关闭排队削峰
+    std::chrono::milliseconds queue_delay_interval{100};    ///< 判定积压的观察窗口
+    uint32_t retry_after_seconds = 1;                       ///< 503 响应的 Retry-After
+};
+
+/**
+ * @brief 准入判定结果
+ */
+enum class HttpAdmissionVerdict
+{
+    Admit,              ///< 放行
+    ConnectionLimit,    ///< 调度器连接数已满
+    InflightLimit,      ///< 在途请求数已满
+    QueueDelay          ///< 排队时延超标
+};
+
+inline std::string_view toString(HttpAdmissionVerdict verdict)
+{
+    switch (verdict) {
+        case HttpAdmissionVerdict::ConnectionLimit: return "connections";
+        case HttpAdmissionVerdict::InflightLimit: return "inflight";
+        case HttpAdmissionVerdict::QueueDelay: return "queue-delay";
+        default: return "admit";
+    }
+}
+
+/**
+ * @brief 单个调度器的准入统计
+ */
+struct HttpAdmissionSlotStats
+{
+    size_t scheduler = 0;               ///< IO 调度器下标
+    int64_t live = 0;                   ///< 当前存活连接数
+    bool overloaded = false;            ///< 上一个观察窗口是否判定为积压
+    uint64_t rejected_connections = 0;  ///< 因连接上限拒绝的连接数
+    uint64_t shed_queue_delay = 0;      ///< 因排队时延丢弃的连接 / 流数
+};
+
+/**
+ * @brief 准入统计快照
+ */
+struct HttpAdmissionStats
+{
+    bool enabled = false;
+    int64_t inflight = 0;               ///< 当前在途请求数
+    uint64_t shed_inflight = 0;         ///< 因在途上限拒绝的请求数
+    uint64_t refused_streams = 0;       ///< 以 REFUSED_STREAM 拒绝的 HTTP/2 流数
+    std::vector<HttpAdmissionSlotStats> schedulers;
+};
+
+/**
+ * @brief CoDel 式排队时延判定
+ * @details 每个观察窗口记录最小时延；窗口结束时最小时延仍高于 target 即判定为积压。
+ *          积压期间时延超过 2 × target 的样本被丢弃，非积压期间的突发全部放行。
+ *          只由一个线程访问。
+ */
+class HttpCoDel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void configure(std::chrono::milliseconds target, std::chrono::milliseconds interval)
+    {
+        m_target = target;
+        m_interval = interval.count() > 0 ? interval : std::chrono::milliseconds(100);
+        m_window_end = Clock::time_point{};
+        m_window_min = Clock::duration::max();
+        m_overloaded = false;
+    }
+
+    bool enabled() const { return m_target.count() > 0; }
+    bool overloaded() const { return m_overloaded; }
+
+    /**
+     * @brief 记录一个排队时延样本
+     * @return 应丢弃时返回 true
+     */
+    bool shouldShed(Clock::duration sojourn, Clock::time_point now)
+    {
+        if (!enabled()) {
+            return false;
+        }
+        if (now >= m_window_end) {
+            // 窗口内没有样本、或距上个窗口结束已超过一个窗口，说明调度器空闲过，不算积压
+            m_overloaded = m_window_min != Clock::duration::max() && m_window_min > m_target &&
+                           now < m_window_end + m_interval;
+            m_window_min = Clock::duration::max();
+            m_window_end = now + m_interval;
+        }
+        m_window_min = std::min(m_window_min, sojourn);
+        return m_overloaded && sojourn > 2 * m_target;
+    }
+
+private:
+    std::chrono::milliseconds m_target{0};
+    std::chrono::milliseconds m_interval{100};
+    Clock::time_point m_window_end{};
+    Clock::duration m_window_min = Clock::duration::max();
+    bool m_overloaded = false;
+};
+
+/**
+ * @brief 当前线程所属服务器的准入控制（HTTP/2 流管理器在此取用）
+ * @details 服务器 accept 循环启动时写入；未启用准入控制时为 nullptr
+ */
+class HttpAdmissionControl;
+inline HttpAdmissionControl*& currentAdmission()
+{
+    thread_local HttpAdmissionControl* admission = nullptr;
+    return admission;
+}
+
+/**
+ * @brief 各 IO 调度器的准入状态
+ */
+class HttpAdmissionControl
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void reset(size_t scheduler_count, const HttpAdmissionConfig& config)
+    {
+        m_config = config;
+        m_count = scheduler_count;
+        m_slots = scheduler_count == 0 ? nullptr : std::make_unique<Slot[]>(scheduler_count);
+        for (size_t i = 0; i < m_count; ++i) {
+            m_slots[i].codel.configure(config.queue_delay_target, config.queue_delay_interval);
+        }
+        m_inflight.store(0, std::memory_order_relaxed);
+        m_shed_inflight.store(0, std::memory_order_relaxed);
+        m_refused_streams.store(0, std::memory_order_relaxed);
+
+        constexpr std::string_view kBody = "Service Unavailable";
+        m_reject_response = "HTTP/1.1 503 Service Unavailable\r\n"
+                            "Content-Type: text/plain\r\n"
+                            "Content-Length: " + std::to_string(kBody.size()) + "\r\n"
+                            "Retry-After: " + std::to_string(config.retry_after_seconds) + "\r\n"
+                            "Connection: close\r\n\r\n";
+        m_reject_response.append(kBody);
+    }
+
+    bool enabled() const { return m_config.enabled && m_count > 0; }
+    const HttpAdmissionConfig& config() const { return m_config; }
+
+    /**
+     * @brief 预先构造的 503 响应
+     */
+    std::string_view rejectResponse() const { return m_reject_response; }
+
+    /**
+     * @brief 为新连接占用调度器的连接配额
+     * @return 配额已满时返回 false（不计数）
+     */
+    bool tryOpenConnection(size_t index)
+    {
+        if (!enabled() || index >= m_count) {
+            return true;
+        }
+        Slot& slot = m_slots[index];
+        const int64_t live = slot.live.fetch_add(1, std::memory_order_relaxed);
+        const size_t limit = m_config.max_connections_per_scheduler;
+        if (limit > 0 && live >= static_cast<int64_t>(limit)) {
+            slot.live.fetch_sub(1, std::memory_order_relaxed);
+            slot.rejected_connections.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 接收已准入的连接（迁移来的空闲 keep-alive 连接），不检查上限
+     */
+    void adoptConnection(size_t index)
+    {
+        if (enabled() && index < m_count) {
+            m_slots[index].live.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void onConnectionClose(size_t index)
+    {
+        if (enabled() && index < m_count) {
+            m_slots[index].live.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 按排队时延判定（只能由 index 对应的调度器线程调用）
+     * @param queued_at 工作被调度的时间；默认值表示没有可用样本
+     */
+    HttpAdmissionVerdict checkQueueDelay(size_t index, Clock::time_point queued_at, Clock::time_point now = Clock::now())
+    {
+        if (!enabled() || index >= m_count || queued_at == Clock::time_point{}) {
+            return HttpAdmissionVerdict::Admit;
+        }
+        Slot& slot = m_slots[index];
+        if (!slot.codel.shouldShed(now - queued_at, now)) {
+            slot.overloaded.store(slot.codel.overloaded(), std::memory_order_relaxed);
+            return HttpAdmissionVerdict::Admit;
+        }
+        slot.overloaded.store(true, std::memory_order_relaxed);
+        slot.shed_queue_delay.fetch_add(1, std::memory_order_relaxed);
+        return HttpAdmissionVerdict::QueueDelay;
+    }
+
+    /**
+     * @brief 开始一个请求：先按排队时延判定，再占用在途配额
+     * @details 放行时必须与 endRequest() 成对调用；拒绝时不计数
+     */
+    HttpAdmissionVerdict beginRequest(size_t index, Clock::time_point queued_at = Clock::time_point{})
+    {
+        return beginRequest(index, queued_at, queued_at == Clock::time_point{} ? queued_at : Clock::now());
+    }
+
+    HttpAdmissionVerdict beginRequest(size_t index, Clock::time_point queued_at, Clock::time_point now)
+    {
+        if (!enabled()) {
+            return HttpAdmissionVerdict::Admit;
+        }
+        const auto verdict = checkQueueDelay(index, queued_at, now);
+        if (verdict != HttpAdmissionVerdict::Admit) {
+            return verdict;
+        }
+        const int64_t inflight = m_inflight.fetch_add(1, std::memory_order_relaxed);
+        const size_t limit = m_config.max_inflight_requests;
+        if (limit > 0 && inflight >= static_cast<int64_t>(limit)) {
+            m_inflight.fetch_sub(1, std::memory_order_relaxed);
+            m_shed_inflight.fetch_add(1, std::memory_order_relaxed);
+            return HttpAdmissionVerdict::InflightLimit;
+        }
+        return HttpAdmissionVerdict::Admit;
+    }
+
+    void endRequest()
+    {
+        if (enabled()) {
+            m_inflight.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void onRefusedStream()
+    {
+        m_refused_streams.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    HttpAdmissionStats snapshot() const
+    {
+        HttpAdmissionStats stats;
+        stats.enabled = enabled();
+        stats.inflight = m_inflight.load(std::memory_order_relaxed);
+        stats.shed_inflight = m_shed_inflight.load(std::memory_order_relaxed);
+        stats.refused_streams = m_refused_streams.load(std::memory_order_relaxed);
+        stats.schedulers.reserve(m_count);
+        for (size_t i = 0; i < m_count; ++i) {
+            const Slot& slot = m_slots[i];
+            HttpAdmissionSlotStats s;
+            s.scheduler = i;
+            s.live = slot.live.load(std::memory_order_relaxed);
+            s.overloaded = slot.overloaded.load(std::memory_order_relaxed);
+            s.rejected_connections = slot.rejected_connections.load(std::memory_order_relaxed);
+            s.shed_queue_delay = slot.shed_queue_delay.load(std::memory_order_relaxed);
+            stats.schedulers.push_back(s);
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 向被拒绝的明文连接写出 503 并半关闭（不关闭 fd）
+     * @details 发送缓冲为空，一次非阻塞写即可写完；随后丢弃已到达的请求字节，
+     *          避免关闭时接收缓冲非空导致内核发 RST 冲掉尚未被对端读取的响应
+     */
+    static void writeRejection(int fd, std::string_view response)
+    {
+        (void)::send(fd, response.data(), response.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        ::shutdown(fd, SHUT_WR);
+        char discard[4096];
+        for (int i = 0; i < 16 && ::recv(fd, discard, sizeof(discard), MSG_DONTWAIT) > 0; ++i) {
+        }
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<int64_t> live{0};
+        std::atomic<bool> overloaded{false};
+        std::atomic<uint64_t> rejected_connections{0};
+        std::atomic<uint64_t> shed_queue_delay{0};
+        HttpCoDel codel;    ///< 只由所属调度器线程访问
+    };
+
+    HttpAdmissionConfig m_config;
+    size_t m_count = 0;
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<int64_t> m_inflight{0};
+    std::atomic<uint64_t> m_shed_inflight{0};
+    std::atomic<uint64_t> m_refused_streams{0};
+    std::string m_reject_response;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_ADMISSION_H
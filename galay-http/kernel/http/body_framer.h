@@ -0,0 +1,301 @@
+/**
+ * @file body_framer.h
+ * @brief HTTP/1.1 消息体分帧跟踪与流式转发配置
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 反向代理流式转发响应体时不解析、不重组内容，原样把上游字节写给下游，
+ * 只需要知道消息体在哪里结束。HttpBodyFramer 逐段接收原始字节，
+ * 按 Content-Length、chunked 或连接关闭三种分帧方式判定边界：
+ * - Length：计数剩余字节
+ * - Chunked：增量解析块长度行、块数据、CRLF 与 trailer，直到终止空行
+ * - UntilClose：上游关闭连接即结束
+ * 任一时刻只持有一段读缓冲，内存与首字节延迟不随响应体大小增长。
+ */
+
+#ifndef GALAY_HTTP_BODY_FRAMER_H
+#define GALAY_HTTP_BODY_FRAMER_H
+
+#include "galay-http/protoc/http/http_header.h"
+#include "galay-http/protoc/http/parse_utils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+namespace galay::http
+{
+
+/**
+ * @brief Http 模式响应体流式转发配置（按上游组生效）
+ * @details 响应缓存与 single-flight 需要完整响应体，命中这两类请求时仍整体缓冲
+ */
+struct ProxyStreamingConfig
+{
+    bool enabled = true;                ///< 是否边收边转发上游响应体
+    size_t buffer_size = 16 * 1024;     ///< 单次从上游读取并写往下游的最大字节数
+};
+
+/**
+ * @brief 消息体分帧方式
+ */
+enum class HttpBodyFraming
+{
+    None,       ///< 无消息体（HEAD、1xx/204/304）
+    Length,     ///< Content-Length
+    Chunked,    ///< Transfer-Encoding: chunked
+    UntilClose  ///< 以连接关闭结束
+};
+
+/**
+ * @brief 消息体边界跟踪器
+ */
+class HttpBodyFramer
+{
+public:
+    static HttpBodyFramer none() { return HttpBodyFramer(HttpBodyFraming::None, 0); }
+    static HttpBodyFramer length(size_t n) { return HttpBodyFramer(HttpBodyFraming::Length, n); }
+    static HttpBodyFramer chunked() { return HttpBodyFramer(HttpBodyFraming::Chunked, 0); }
+    static HttpBodyFramer untilClose() { return HttpBodyFramer(HttpBodyFraming::UntilClose, 0); }
+
+    /**
+     * @brief 按响应头确定分帧方式（RFC 9112 §6.3）
+     * @param header 上游响应头
+     * @param head_request 对应请求是否为 HEAD
+     */
+    static HttpBodyFramer forResponse(HttpResponseHeader& header, bool head_request)
+    {
+        const int code = static_cast<int>(header.code());
+        if (head_request || (code >= 100 && code < 200) || code == 204 || code == 304) {
+            return none();
+        }
+        const auto& pairs = header.headerPairs();
+        if (const auto* te = detail::getHeaderValuePtrLoose(pairs, "transfer-encoding"); te != nullptr) {
+            return detail::headerValueContainsToken(*te, "chunked") ? chunked() : untilClose();
+        }
+        if (const auto* cl = detail::getHeaderValuePtrLoose(pairs, "content-length"); cl != nullptr) {
+            auto parsed = detail::parseSizeTStrict(*cl);
+            if (parsed.has_value()) {
+                return length(*parsed);
+            }
+            HttpBodyFramer invalid = untilClose();
+            invalid.m_state = State::Failed;
+            return invalid;
+        }
+        return untilClose();
+    }
+
+    HttpBodyFraming framing() const { return m_framing; }
+    bool done() const { return m_state == State::Done; }
+    bool failed() const { return m_state == State::Failed; }
+
+    /**
+     * @brief 下一次读取最多需要的字节数
+     * @details Length 模式不超过剩余字节，避免读入下一条消息
+     */
+    size_t nextReadSize(size_t buffer_size) const
+    {
+        if (m_framing == HttpBodyFraming::Length) {
+            return static_cast<size_t>(std::min<uint64_t>(m_remaining, buffer_size));
+        }
+        return buffer_size;
+    }
+
+    /**
+     * @brief 上游关闭连接
+     * @return UntilClose 模式下视为正常结束；其余未完成的模式视为截断
+     */
+    bool onClose()
+    {
+        if (m_state == State::Done) {
+            return true;
+        }
+        if (m_framing == HttpBodyFraming::UntilClose && m_state != State::Failed) {
+            m_state = State::Done;
+            return true;
+        }
+        m_state = State::Failed;
+        return false;
+    }
+
+    /**
+     * @brief 送入一段上游原始字节
+     * @return 属于当前消息体的前缀长度；小于 data.size() 说明之后的字节不属于本消息
+     */
+    size_t feed(std::string_view data)
+    {
+        if (m_state == State::Done || m_state == State::Failed) {
+            return 0;
+        }
+        switch (m_framing) {
+        case HttpBodyFraming::None:
+            return 0;
+        case HttpBodyFraming::UntilClose:
+            return data.size();
+        case HttpBodyFraming::Length: {
+            const size_t take = static_cast<size_t>(std::min<uint64_t>(m_remaining, data.size()));
+            m_remaining -= take;
+            if (m_remaining == 0) {
+                m_state = State::Done;
+            }
+            return take;
+        }
+        case HttpBodyFraming::Chunked:
+            return feedChunked(data);
+        }
+        return 0;
+    }
+
+private:
+    enum class State
+    {
+        Size,           ///< 块长度（十六进制）
+        Extension,      ///< 块扩展，跳过到 CR
+        SizeLF,         ///< 块长度行的 LF
+        Data,           ///< 块数据
+        DataCR,         ///< 块数据后的 CR
+        DataLF,         ///< 块数据后的 LF
+        TrailerStart,   ///< trailer 行首（CR 表示终止空行）
+        TrailerLine,    ///< trailer 行内容
+        TrailerLF,      ///< trailer 行的 LF
+        FinalLF,        ///< 终止空行的 LF
+        Body,           ///< 非 chunked 模式的消息体
+        Done,
+        Failed
+    };
+
+    HttpBodyFramer(HttpBodyFraming framing, uint64_t length)
+        : m_framing(framing)
+        , m_remaining(length)
+    {
+        if (framing == HttpBodyFraming::Chunked) {
+            m_state = State::Size;
+        } else if (framing == HttpBodyFraming::None ||
+                   (framing == HttpBodyFraming::Length && length == 0)) {
+            m_state = State::Done;
+        } else {
+            m_state = State::Body;
+        }
+    }
+
+    static int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    size_t feedChunked(std::string_view data)
+    {
+        size_t i = 0;
+        while (i < data.size() && m_state != State::Done && m_state != State::Failed) {
+            const char c = data[i];
+            switch (m_state) {
+            case State::Size: {
+                const int v = hexValue(c);
+                if (v >= 0) {
+                    if (m_remaining > (std::numeric_limits<uint64_t>::max() >> 4)) {
+                        m_state = State::Failed;
+                        return i;
+                    }
+                    m_remaining = (m_remaining << 4) | static_cast<uint64_t>(v);
+                    m_size_digits = true;
+                } else if (!m_size_digits) {
+                    m_state = State::Failed;
+                    return i;
+                } else if (c == ';' || c == ' ' || c == '\t') {
+                    m_state = State::Extension;
+                } else if (c == '\r') {
+                    m_state = State::SizeLF;
+                } else {
+                    m_state = State::Failed;
+                    return i;
+                }
+                ++i;
+                break;
+            }
+            case State::Extension:
+                if (c == '\r') {
+                    m_state = State::SizeLF;
+                }
+                ++i;
+                break;
+            case State::SizeLF:
+                if (c != '\n') {
+                    m_state = State::Failed;
+                    return i;
+                }
+                m_size_digits = false;
+                m_state = m_remaining == 0 ? State::TrailerStart : State::Data;
+                ++i;
+                break;
+            case State::Data: {
+                const size_t take = static_cast<size_t>(std::min<uint64_t>(m_remaining, data.size() - i));
+                m_remaining -= take;
+                i += take;
+                if (m_remaining == 0) {
+                    m_state = State::DataCR;
+                }
+                break;
+            }
+            case State::DataCR:
+                if (c != '\r') {
+                    m_state = State::Failed;
+                    return i;
+                }
+                m_state = State::DataLF;
+                ++i;
+                break;
+            case State::DataLF:
+                if (c != '\n') {
+                    m_state = State::Failed;
+                    return i;
+                }
+                m_state = State::Size;
+                ++i;
+                break;
+            case State::TrailerStart:
+                m_state = c == '\r' ? State::FinalLF : State::TrailerLine;
+                ++i;
+                break;
+            case State::TrailerLine:
+                if (c == '\r') {
+                    m_state = State::TrailerLF;
+                }
+                ++i;
+                break;
+            case State::TrailerLF:
+                if (c != '\n') {
+                    m_state = State::Failed;
+                    return i;
+                }
+                m_state = State::TrailerStart;
+                ++i;
+                break;
+            case State::FinalLF:
+                if (c != '\n') {
+                    m_state = State::Failed;
+                    return i;
+                }
+                m_state = State::Done;
+                ++i;
+                break;
+            default:
+                return i;
+            }
+        }
+        return i;
+    }
+
+    HttpBodyFraming m_framing;
+    uint64_t m_remaining = 0;       ///< Length：剩余字节；Chunked：当前块剩余字节
+    State m_state = State::Body;
+    bool m_size_digits = false;     ///< 当前块长度行是否已出现数字
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_BODY_FRAMER_H
@@ -0,0 +1,165 @@
+/**
+ * @file compute_offload.h
+ * @brief 把处理器中的 CPU 密集段投递到计算调度器执行，完成后回到原 IO 调度器继续
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details `compute_scheduler_count` 创建的计算调度器此前只用于内容 ETag 的后台哈希，
+ * 处理器里的压缩、模板渲染、签名校验等工作仍在 IO 调度器上同步执行，期间该调度器上的所有连接停顿。
+ * 用法：
+ * @code
+ * Task<void> handler(HttpConn& conn, HttpRequest req) {
+ *     std::string body = co_await offload([&] { return render(req); });
+ *     ...
+ * }
+ * @endcode
+ * - 服务器在每个 IO 调度器线程上登记所属 Runtime（currentComputeRuntime），offload 据此挑选计算调度器
+ * - 结果、异常与等待器都存放在 awaitable 内（位于调用方协程帧），除计算任务与回切任务的协程帧外不再分配
+ * - 没有计算调度器、不在服务器 IO 线程上或投递失败时，在当前调度器上直接执行
+ * - fn 在计算线程上运行，不得访问 HttpConn / Http2Stream 等连接对象，只应处理拷贝或引用进来的数据
+ */
+
+#ifndef GALAY_HTTP_COMPUTE_OFFLOAD_H
+#define GALAY_HTTP_COMPUTE_OFFLOAD_H
+
+#include "galay-kernel/kernel/runtime.h"
+#include "galay-kernel/kernel/task.h"
+#include "galay-kernel/concurrency/async_waiter.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace galay::http
+{
+
+/**
+ * @brief 当前 IO 调度器线程所属服务器的 Runtime
+ * @details accept 循环启动时写入；非服务器 IO 线程为 nullptr，此时 offload 退化为直接执行
+ */
+inline galay::kernel::Runtime*& currentComputeRuntime()
+{
+    thread_local galay::kernel::Runtime* runtime = nullptr;
+    return runtime;
+}
+
+namespace detail
+{
+
+/**
+ * @brief offload 的结果槽：非 void 结果用 optional 延迟构造
+ */
+template<typename R>
+struct OffloadResult
+{
+    std::optional<R> value;
+
+    template<typename F>
+    void run(F& fn) { value.emplace(fn()); }
+
+    R take() { return std::move(*value); }
+};
+
+template<>
+struct OffloadResult<void>
+{
+    template<typename F>
+    void run(F& fn) { fn(); }
+
+    void take() {}
+};
+
+} // namespace detail
+
+/**
+ * @brief 在计算调度器上执行 fn 并在原 IO 调度器上恢复的 awaitable
+ * @details 内部持有 AsyncWaiter，不可拷贝/移动，须以 `co_await offload(fn)` 的形式直接等待
+ */
+template<typename F>
+class OffloadAwaitable
+{
+public:
+    using Result = std::invoke_result_t<F&>;
+
+    explicit OffloadAwaitable(F fn)
+        : m_fn(std::move(fn))
+        , m_wait_awaitable(&m_waiter)
+    {
+    }
+
+    OffloadAwaitable(const OffloadAwaitable&) = delete;
+    OffloadAwaitable& operator=(const OffloadAwaitable&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        m_io = handle.promise().taskRefView().belongScheduler();
+        galay::kernel::Scheduler* compute = nullptr;
+        if (auto* runtime = currentComputeRuntime();
+            m_io != nullptr && runtime != nullptr && runtime->getComputeSchedulerCount() > 0) {
+            compute = runtime->getNextComputeScheduler();
+        }
+        // 回切任务经由 m_io 的队列唤醒，本函数返回前不会执行，因此先投递再挂起
+        if (compute == nullptr || !scheduleTask(compute, runOnCompute(this))) {
+            run();
+            return false;
+        }
+        return m_wait_awaitable.await_suspend(handle);
+    }
+
+    Result await_resume()
+    {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+        return m_result.take();
+    }
+
+private:
+    void run() noexcept
+    {
+        try {
+            m_result.run(m_fn);
+        } catch (...) {
+            m_error = std::current_exception();
+        }
+    }
+
+    static galay::kernel::Task<void> runOnCompute(OffloadAwaitable* self)
+    {
+        self->run();
+        if (!scheduleTask(self->m_io, notifyOnIo(&self->m_waiter))) {
+            self->m_waiter.notify();
+        }
+        co_return;
+    }
+
+    static galay::kernel::Task<void> notifyOnIo(galay::kernel::AsyncWaiter<void>* waiter)
+    {
+        waiter->notify();
+        co_return;
+    }
+
+    F m_fn;
+    detail::OffloadResult<Result> m_result;
+    std::exception_ptr m_error;
+    galay::kernel::Scheduler* m_io = nullptr;
+    galay::kernel::AsyncWaiter<void> m_waiter;
+    galay::kernel::AsyncWaiterAwaitable<void> m_wait_awaitable;
+};
+
+/**
+ * @brief 在计算调度器上执行 fn，返回其结果（异常在等待处重新抛出）
+ */
+template<typename F>
+OffloadAwaitable<std::decay_t<F>> offload(F&& fn)
+{
+    return OffloadAwaitable<std::decay_t<F>>(std::forward<F>(fn));
+}
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_COMPUTE_OFFLOAD_H
@@ -0,0 +1,347 @@
+/**
+ * @file conn_balancer.h
+ * @brief accept 侧连接均衡：按 IO 调度器的存活连接数与近期忙碌时间挑选目标调度器
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details SO_REUSEPORT 按四元组哈希分配连接，负载均衡器的 keep-alive 连接池只有少量长连接时，
+ * 各调度器的连接数可能相差数倍，且连接在 scheduleTask 之后不再移动。
+ * 启用后每个 accept 循环按下列负载分值挑选目标调度器：
+ *   load = live × (1 + busy)，busy 为调度器线程近一个半衰期内的 CPU 占用（线程 CPU 时间，指数衰减）
+ * 本调度器分值不超过最小分值 × imbalance_ratio + 1 时留在本地，否则交给分值最小的调度器；
+ * 同一规则用于在两次请求之间迁移空闲 keep-alive 连接。
+ * 每个槽位独占缓存行；live 由任意线程原子增减，busy 只由所属调度器写入。
+ * 本文件不依赖运行时，fd 的跨调度器投递见 http_server.h。
+ */
+
+#ifndef GALAY_HTTP_CONN_BALANCER_H
+#define GALAY_HTTP_CONN_BALANCER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <time.h>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+namespace galay::http
+{
+
+/**
+ * @brief 连接均衡配置
+ */
+struct HttpConnBalanceConfig
+{
+    bool enabled = false;                               ///< 是否启用 accept 侧均衡（默认关闭）
+    double imbalance_ratio = 1.25;                      ///< 本地分值超过最小分值的倍数（另加 1 个连接的余量）才转交
+    bool migrate_idle = true;                           ///< 是否在两次请求之间迁移空闲 keep-alive 连接（仅明文路由模式）
+    std::chrono::milliseconds busy_half_life{1000};     ///< 忙碌时间的衰减半衰期
+};
+
+/**
+ * @brief 单个调度器的均衡统计
+ */
+struct HttpConnBalanceSlotStats
+{
+    size_t scheduler = 0;       ///< IO 调度器下标
+    int64_t live = 0;           ///< 当前存活连接数
+    double busy = 0.0;          ///< 近期忙碌时间占比
+    uint64_t handed_in = 0;     ///< 由其他调度器转交进来的新连接数
+    uint64_t migrated_in = 0;   ///< 迁移进来的空闲 keep-alive 连接数
+};
+
+/**
+ * @brief 均衡统计快照
+ */
+struct HttpConnBalanceStats
+{
+    bool enabled = false;
+    std::vector<HttpConnBalanceSlotStats> schedulers;
+};
+
+/**
+ * @brief 跨调度器投递的连接
+ */
+struct HttpConnHandoff
+{
+    int fd = -1;            ///< 已连接的 fd，-1 表示停止投递循环
+    bool migrated = false;  ///< true 为迁移的空闲 keep-alive 连接，false 为新 accept 的连接
+    std::chrono::steady_clock::time_point accepted_at{}; ///< accept 时间（准入控制按此计算排队时延）
+};
+
+namespace detail
+{
+
+/**
+ * @brief 列出本进程的 epoll 实例（/proc/self/fd 中指向 anon_inode:[eventpoll] 的 fd）
+ * @details runtime 启动后调用一次；非 Linux 平台返回空表
+ */
+inline std::vector<int> listEpollFds()
+{
+    std::vector<int> fds;
+#if defined(__linux__)
+    DIR* dir = ::opendir("/proc/self/fd");
+    if (dir == nullptr) {
+        return fds;
+    }
+    const int dir_fd = ::dirfd(dir);
+    while (dirent* entry = ::readdir(dir)) {
+        char* end = nullptr;
+        const long fd = std::strtol(entry->d_name, &end, 10);
+        if (end == entry->d_name || *end != '\0' || fd == dir_fd) {
+            continue;
+        }
+        char target[64];
+        const ssize_t len = ::readlinkat(dir_fd, entry->d_name, target, sizeof(target));
+        if (len > 0 && std::string_view(target, static_cast<size_t>(len)) == "anon_inode:[eventpoll]") {
+            fds.push_back(static_cast<int>(fd));
+        }
+    }
+    ::closedir(dir);
+#endif
+    return fds;
+}
+
+/**
+ * @brief 从各 epoll 实例中删除 fd 的事件注册
+ * @details epoll 的注册以（打开文件描述, fd 号）为键，只要 dup 出的 fd 仍引用同一打开文件描述，
+ *          关闭原 fd 不会移除注册，旧调度器仍会收到已迁走 socket 的事件；迁移前须显式 EPOLL_CTL_DEL。
+ *          不含该 fd 的实例返回 ENOENT，忽略即可。kqueue 在关闭 fd 时移除 kevent，io_uring 没有常驻注册
+ */
+inline void dropEpollRegistrations(int fd, const std::vector<int>& epoll_fds)
+{
+#if defined(__linux__)
+    for (int epoll_fd : epoll_fds) {
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+#else
+    (void)fd;
+    (void)epoll_fds;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief 当前线程所属 IO 调度器在负载表中的下标
+ * @details accept 循环启动时写入；非 IO 调度器线程为 HttpConnBalancer::kStay
+ */
+inline size_t& currentSchedulerSlot()
+{
+    thread_local size_t slot = std::numeric_limits<size_t>::max();
+    return slot;
+}
+
+/**
+ * @brief 各 IO 调度器的负载表
+ */
+class HttpConnBalancer
+{
+public:
+    static constexpr size_t kStay = std::numeric_limits<size_t>::max();   ///< pick 返回值：留在本调度器
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds kBusySampleInterval{1};   ///< 线程 CPU 时间采样间隔
+
+    void reset(size_t scheduler_count, const HttpConnBalanceConfig& config)
+    {
+        m_config = config;
+        m_count = scheduler_count;
+        m_slots = scheduler_count == 0 ? nullptr : std::make_unique<Slot[]>(scheduler_count);
+        m_half_life_ns = std::max<int64_t>(
+            1, std::chrono::duration_cast<std::chrono::nanoseconds>(config.busy_half_life).count());
+    }
+
+    bool enabled() const { return m_config.enabled && m_count > 1; }
+    size_t size() const { return m_count; }
+    const HttpConnBalanceConfig& config() const { return m_config; }
+
+    /**
+     * @brief 为本调度器刚 accept 的连接挑选目标
+     * @return 目标调度器下标；应留在本地时返回 kStay
+     */
+    size_t pick(size_t self, Clock::time_point now = Clock::now()) const
+    {
+        return pickFrom(self, 0, now);
+    }
+
+    /**
+     * @brief 判断本调度器上一个空闲连接是否应迁走
+     * @details 与 pick 相同的规则，但本地分值先扣除该连接自身
+     * @return 目标调度器下标；不迁移时返回 kStay
+     */
+    size_t migrationTarget(size_t self, Clock::time_point now = Clock::now()) const
+    {
+        return pickFrom(self, 1, now);
+    }
+
+    void onOpen(size_t index)
+    {
+        if (index < m_count) {
+            m_slots[index].live.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void onClose(size_t index)
+    {
+        if (index < m_count) {
+            m_slots[index].live.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void onHandedIn(size_t index)
+    {
+        if (index < m_count) {
+            m_slots[index].handed_in.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void onMigratedIn(size_t index)
+    {
+        if (index < m_count) {
+            m_slots[index].migrated_in.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 在调度器线程上采样线程 CPU 时间并计入忙碌值
+     * @details 由 accept 循环与请求循环调用；按 kBusySampleInterval 限频，
+     *          间隔内的调用只读一次单调时钟（vDSO），不产生系统调用
+     */
+    void sampleBusy(size_t index, Clock::time_point now = Clock::now())
+    {
+        struct Sample
+        {
+            Clock::time_point checked_at{};
+            int64_t cpu_ns = -1;
+        };
+        thread_local Sample sample;
+        if (index >= m_count || now - sample.checked_at < kBusySampleInterval) {
+            return;
+        }
+        sample.checked_at = now;
+        timespec ts{};
+        if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+            return;
+        }
+        const int64_t cpu_ns = static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+        if (sample.cpu_ns >= 0 && cpu_ns > sample.cpu_ns) {
+            addBusy(index, std::chrono::nanoseconds(cpu_ns - sample.cpu_ns), now);
+        }
+        sample.cpu_ns = cpu_ns;
+    }
+
+    /**
+     * @brief 累计一段忙碌时间（只能由 index 对应的调度器线程调用）
+     */
+    void addBusy(size_t index, std::chrono::nanoseconds busy, Clock::time_point now = Clock::now())
+    {
+        if (index >= m_count) {
+            return;
+        }
+        Slot& slot = m_slots[index];
+        const int64_t now_ns = now.time_since_epoch().count();
+        const double decayed = decayedBusy(slot, now_ns);
+        slot.busy_ns.store(decayed + static_cast<double>(busy.count()), std::memory_order_relaxed);
+        slot.busy_at_ns.store(now_ns, std::memory_order_relaxed);
+    }
+
+    HttpConnBalanceStats snapshot(Clock::time_point now = Clock::now()) const
+    {
+        HttpConnBalanceStats stats;
+        stats.enabled = enabled();
+        stats.schedulers.reserve(m_count);
+        const int64_t now_ns = now.time_since_epoch().count();
+        for (size_t i = 0; i < m_count; ++i) {
+            const Slot& slot = m_slots[i];
+            HttpConnBalanceSlotStats s;
+            s.scheduler = i;
+            s.live = slot.live.load(std::memory_order_relaxed);
+            s.busy = busyFraction(slot, now_ns);
+            s.handed_in = slot.handed_in.load(std::memory_order_relaxed);
+            s.migrated_in = slot.migrated_in.load(std::memory_order_relaxed);
+            stats.schedulers.push_back(s);
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<int64_t> live{0};
+        std::atomic<double> busy_ns{0.0};       ///< 衰减后的忙碌纳秒数
+        std::atomic<int64_t> busy_at_ns{0};     ///< busy_ns 最近一次更新的时间
+        std::atomic<uint64_t> handed_in{0};
+        std::atomic<uint64_t> migrated_in{0};
+    };
+
+    double decayedBusy(const Slot& slot, int64_t now_ns) const
+    {
+        const double busy = slot.busy_ns.load(std::memory_order_relaxed);
+        const int64_t elapsed = now_ns - slot.busy_at_ns.load(std::memory_order_relaxed);
+        if (busy <= 0.0 || elapsed <= 0) {
+            return busy;
+        }
+        return busy * std::exp2(-static_cast<double>(elapsed) / static_cast<double>(m_half_life_ns));
+    }
+
+    double busyFraction(const Slot& slot, int64_t now_ns) const
+    {
+        // 指数衰减累计值的稳态上限为 half_life / ln2，归一化到 [0, 1]
+        return decayedBusy(slot, now_ns) * 0.6931471805599453 / static_cast<double>(m_half_life_ns);
+    }
+
+    double load(size_t index, int64_t discount, int64_t now_ns) const
+    {
+        const Slot& slot = m_slots[index];
+        const int64_t live = std::max<int64_t>(0, slot.live.load(std::memory_order_relaxed) - discount);
+        return static_cast<double>(live) * (1.0 + busyFraction(slot, now_ns));
+    }
+
+    size_t pickFrom(size_t self, int64_t discount, Clock::time_point now) const
+    {
+        if (!enabled() || self >= m_count) {
+            return kStay;
+        }
+        const int64_t now_ns = now.time_since_epoch().count();
+        size_t best = self;
+        double best_load = load(self, discount, now_ns);
+        const double self_load = best_load;
+        for (size_t i = 0; i < m_count; ++i) {
+            if (i == self) {
+                continue;
+            }
+            const double l = load(i, 0, now_ns);
+            if (l < best_load) {
+                best = i;
+                best_load = l;
+            }
+        }
+        if (best == self || self_load <= best_load * m_config.imbalance_ratio + 1.0) {
+            return kStay;
+        }
+        return best;
+    }
+
+    HttpConnBalanceConfig m_config;
+    size_t m_count = 0;
+    int64_t m_half_life_ns = 1;
+    std::unique_ptr<Slot[]> m_slots;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_CONN_BALANCER_H
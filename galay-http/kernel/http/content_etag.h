@@ -0,0 +1,408 @@
+/**
+ * @file content_etag.h
+ * @brief 基于文件内容的强 ETag（后台计算）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details inode + size + mtime 生成的 ETag 在多副本部署或重新发布后会变化，
+ * 即使内容完全相同也会击穿下游缓存。本文件提供内容哈希 ETag：
+ * - `Xxh64` 为 XXH64 的流式实现，无第三方依赖
+ * - `ContentETagStore` 以「路径 + 文件版本」为键，每个版本只在计算调度器上哈希一次
+ * - 哈希完成前调用方继续使用 inode ETag，请求延迟中不包含哈希耗时
+ */
+
+#ifndef GALAY_HTTP_CONTENT_ETAG_H
+#define GALAY_HTTP_CONTENT_ETAG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace galay::http
+{
+
+/**
+ * @brief XXH64 流式哈希
+ * @details 与 xxHash 官方 XXH64 输出一致；按 32 字节条带处理，适合大文件分块输入
+ */
+class Xxh64
+{
+public:
+    explicit Xxh64(uint64_t seed = 0)
+        : m_v1(seed + kPrime1 + kPrime2)
+        , m_v2(seed + kPrime2)
+        , m_v3(seed)
+        , m_v4(seed - kPrime1)
+        , m_seed(seed)
+    {
+    }
+
+    /**
+     * @brief 追加输入数据
+     */
+    void update(const void* data, size_t len)
+    {
+        const auto* p = static_cast<const uint8_t*>(data);
+        const uint8_t* const end = p + len;
+        m_total_len += len;
+
+        if (m_mem_size + len < 32) {
+            std::memcpy(m_mem + m_mem_size, p, len);
+            m_mem_size += len;
+            return;
+        }
+
+        if (m_mem_size > 0) {
+            const size_t fill = 32 - m_mem_size;
+            std::memcpy(m_mem + m_mem_size, p, fill);
+            consumeStripe(m_mem);
+            p += fill;
+            m_mem_size = 0;
+        }
+
+        while (p + 32 <= end) {
+            consumeStripe(p);
+            p += 32;
+        }
+
+        if (p < end) {
+            m_mem_size = static_cast<size_t>(end - p);
+            std::memcpy(m_mem, p, m_mem_size);
+        }
+    }
+
+    /**
+     * @brief 计算当前哈希值（不改变内部状态）
+     */
+    uint64_t digest() const
+    {
+        uint64_t h;
+        if (m_total_len >= 32) {
+            h = rotl(m_v1, 1) + rotl(m_v2, 7) + rotl(m_v3, 12) + rotl(m_v4, 18);
+            h = mergeRound(h, m_v1);
+            h = mergeRound(h, m_v2);
+            h = mergeRound(h, m_v3);
+            h = mergeRound(h, m_v4);
+        } else {
+            h = m_seed + kPrime5;
+        }
+        h += m_total_len;
+
+        const uint8_t* p = m_mem;
+        const uint8_t* const end = m_mem + m_mem_size;
+        while (p + 8 <= end) {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * kPrime1 + kPrime4;
+            p += 8;
+        }
+        if (p + 4 <= end) {
+            h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+            h = rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        while (p < end) {
+            h ^= static_cast<uint64_t>(*p) * kPrime5;
+            h = rotl(h, 11) * kPrime1;
+            ++p;
+        }
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    /**
+     * @brief 一次性计算哈希
+     */
+    static uint64_t hash(const void* data, size_t len, uint64_t seed = 0)
+    {
+        Xxh64 state(seed);
+        state.update(data, len);
+        return state.digest();
+    }
+
+private:
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t round(uint64_t acc, uint64_t input)
+    {
+        acc += input * kPrime2;
+        acc = rotl(acc, 31);
+        return acc * kPrime1;
+    }
+
+    static uint64_t mergeRound(uint64_t acc, uint64_t val)
+    {
+        acc ^= round(0, val);
+        return acc * kPrime1 + kPrime4;
+    }
+
+    // 按小端读取，与官方实现的规范输出保持一致
+    static uint64_t read64(const uint8_t* p)
+    {
+        uint64_t v = 0;
+        for (int i = 7; i >= 0; --i) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    static uint32_t read32(const uint8_t* p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    void consumeStripe(const uint8_t* p)
+    {
+        m_v1 = round(m_v1, read64(p));
+        m_v2 = round(m_v2, read64(p + 8));
+        m_v3 = round(m_v3, read64(p + 16));
+        m_v4 = round(m_v4, read64(p + 24));
+    }
+
+    uint64_t m_v1;
+    uint64_t m_v2;
+    uint64_t m_v3;
+    uint64_t m_v4;
+    uint64_t m_seed;
+    uint64_t m_total_len = 0;
+    uint8_t m_mem[32] = {};
+    size_t m_mem_size = 0;
+};
+
+/**
+ * @brief 内容哈希 ETag 存储（进程级共享）
+ * @details
+ * - 以「路径 + inode + size + mtime」标识一个文件版本，文件被修改后自然换键
+ * - `request()` 对同一版本去重，只向计算执行器提交一次哈希任务
+ * - 执行器由服务器在启动时安装（投递到计算调度器）；未安装时不做哈希，
+ *   调用方始终使用 inode ETag，保证请求路径上永不同步哈希
+ * - 读写由互斥锁保护；只在元数据缓存未命中的慢路径上访问
+ */
+class ContentETagStore
+{
+public:
+    /**
+     * @brief 计算执行器：接受一个阻塞任务，投递成功返回 true
+     */
+    using Executor = std::function<bool(std::function<void()>)>;
+
+    /**
+     * @brief 查询结果
+     */
+    struct Lookup {
+        std::optional<std::string> etag;  ///< 已就绪的内容 ETag
+        bool pending = false;             ///< 哈希任务正在计算
+    };
+
+    /**
+     * @brief 统计信息
+     */
+    struct Stats {
+        uint64_t submitted = 0;  ///< 已提交的哈希任务数
+        uint64_t completed = 0;  ///< 成功完成的哈希任务数
+        uint64_t failed = 0;     ///< 读文件失败的任务数
+    };
+
+    static ContentETagStore& instance()
+    {
+        static ContentETagStore store;
+        return store;
+    }
+
+    /**
+     * @brief 安装计算执行器
+     * @param owner 执行器所属对象（通常是服务器实例），用于匹配卸载
+     * @param executor 执行器
+     */
+    void setExecutor(const void* owner, Executor executor)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_executor_owner = owner;
+        m_executor = std::move(executor);
+    }
+
+    /**
+     * @brief 卸载计算执行器（仅当 owner 与安装者一致时生效）
+     */
+    void clearExecutor(const void* owner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_executor_owner == owner) {
+            m_executor_owner = nullptr;
+            m_executor = nullptr;
+        }
+    }
+
+    /**
+     * @brief 查询内容 ETag；未就绪时按需提交后台哈希
+     * @param path 文件路径
+     * @param inode inode 号
+     * @param size 文件大小
+     * @param mtime 最后修改时间
+     * @return 已就绪的 ETag，或是否正在计算
+     */
+    Lookup request(const std::string& path, uint64_t inode, size_t size, std::time_t mtime)
+    {
+        std::string key = makeKey(path, inode, size, mtime);
+        Executor executor;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end()) {
+                if (it->second.empty()) {
+                    return Lookup{std::nullopt, true};
+                }
+                return Lookup{it->second, false};
+            }
+            if (!m_executor) {
+                return Lookup{};
+            }
+            if (m_max_entries > 0 && m_entries.size() >= m_max_entries) {
+                evictOneLocked();
+            }
+            m_entries.emplace(key, std::string());
+            ++m_stats.submitted;
+            executor = m_executor;
+        }
+
+        const bool submitted = executor([this, key, path]() {
+            auto digest = hashFile(path);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (!digest) {
+                ++m_stats.failed;
+                if (it != m_entries.end()) {
+                    m_entries.erase(it);
+                }
+                return;
+            }
+            ++m_stats.completed;
+            if (it != m_entries.end()) {
+                it->second = formatETag(*digest);
+            }
+        });
+        if (!submitted) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.erase(key);
+            --m_stats.submitted;
+            return Lookup{};
+        }
+        return Lookup{std::nullopt, true};
+    }
+
+    /**
+     * @brief 设置条目上限（0 表示不限制）
+     */
+    void setMaxEntries(size_t max_entries)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_entries = max_entries;
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+    /**
+     * @brief 以 64KB 分块读取并计算文件的 XXH64
+     * @return 读取失败返回 std::nullopt
+     */
+    static std::optional<uint64_t> hashFile(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        Xxh64 state;
+        char buffer[64 * 1024];
+        while (true) {
+            ssize_t n = ::read(fd, buffer, sizeof(buffer));
+            if (n == 0) {
+                break;
+            }
+            if (n < 0) {
+                ::close(fd);
+                return std::nullopt;
+            }
+            state.update(buffer, static_cast<size_t>(n));
+        }
+        ::close(fd);
+        return state.digest();
+    }
+
+    /**
+     * @brief 将 64 位摘要格式化为强 ETag：`"xxh64-<16 位十六进制>"`
+     */
+    static std::string formatETag(uint64_t digest)
+    {
+        char etag[32];
+        std::snprintf(etag, sizeof(etag), "\"xxh64-%016llx\"", static_cast<unsigned long long>(digest));
+        return std::string(etag);
+    }
+
+private:
+    ContentETagStore() = default;
+
+    static std::string makeKey(const std::string& path, uint64_t inode, size_t size, std::time_t mtime)
+    {
+        std::string key;
+        key.reserve(path.size() + 48);
+        key.append(path);
+        key.push_back('\0');
+        key.append(std::to_string(inode)).push_back('-');
+        key.append(std::to_string(size)).push_back('-');
+        key.append(std::to_string(static_cast<long long>(mtime)));
+        return key;
+    }
+
+    void evictOneLocked()
+    {
+        // 优先淘汰已完成条目，避免丢失计算中的任务记录
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (!it->second.empty()) {
+                m_entries.erase(it);
+                return;
+            }
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::string> m_entries;  ///< 空值表示计算中
+    Executor m_executor;
+    const void* m_executor_owner = nullptr;
+    size_t m_max_entries = 65536;
+    Stats m_stats;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_CONTENT_ETAG_H
@@ -0,0 +1,413 @@
+/**
+ * @file h2c_upstream.h
+ * @brief 反向代理的 h2c 上游多路复用
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 每个 IO 调度器线程为每个上游（host:port）维护少量共享的 h2c 连接，
+ * 下游的 HTTP/1.1 请求各占用其中一条连接上的一个 stream：
+ * - 优先选择在途 stream 最少、且未达到并发上限的已就绪连接
+ * - 并发上限取配置值与对端 SETTINGS_MAX_CONCURRENT_STREAMS 的较小者
+ * - 所有连接都饱和时新建一条连接，直到 max_connections
+ * - 建连期间到达的请求直接占用新连接的 stream 名额，登记唤醒后等待建连完成，
+ *   不会为同一波突发重复建连
+ * - 连接失效或收到 GOAWAY 后不再分配新 stream，最后一个 stream 结束时交给回收回调关闭
+ * 多路复用表只在所属线程访问，无需加锁。
+ */
+
+#ifndef GALAY_HTTP_H2C_UPSTREAM_H
+#define GALAY_HTTP_H2C_UPSTREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace galay::http
+{
+
+/**
+ * @brief h2c 上游配置（按上游生效）
+ */
+struct H2cUpstreamConfig
+{
+    size_t max_connections = 4;             ///< 每线程每上游最多的 h2c 连接数，0 表示不限制
+    uint32_t max_concurrent_streams = 100;  ///< 单连接在途 stream 上限（与对端 SETTINGS 取小）
+};
+
+/**
+ * @brief h2c 上游统计（单线程单上游）
+ */
+struct H2cUpstreamStats
+{
+    uint64_t streams = 0;           ///< 分配的 stream 数
+    uint64_t connects = 0;          ///< 新建连接次数
+    uint64_t connect_failures = 0;  ///< 建连或升级失败次数
+    uint64_t saturated = 0;         ///< 已有连接全部饱和而新建连接的次数
+    uint64_t waits = 0;             ///< 等待建连中的连接的请求数
+    uint64_t exhausted = 0;         ///< 连接数与 stream 名额均已用尽而拒绝的次数
+    uint64_t retired = 0;           ///< 因失效或 GOAWAY 摘除的连接数
+    size_t connections = 0;         ///< 当前可分配 stream 的连接数（含建连中）
+    size_t active = 0;              ///< 当前在途 stream 数
+};
+
+/**
+ * @brief 线程局部的 h2c 上游多路复用表
+ * @tparam Client 客户端类型，默认构造得到未连接的客户端
+ */
+template <typename Client>
+class H2cUpstreamMux
+{
+public:
+    using ClientPtr = std::unique_ptr<Client>;
+    using Wake = std::function<void()>;         ///< 建连完成的唤醒回调
+    using Retire = std::function<void(ClientPtr)>;  ///< 关闭已摘除连接的回调
+
+private:
+    enum class ConnState { Connecting, Ready, Closed };
+
+    struct Connection {
+        ClientPtr client;
+        ConnState state = ConnState::Connecting;
+        size_t active = 0;
+        uint32_t limit = 0;
+        std::vector<Wake> waiters;
+    };
+    using ConnPtr = std::shared_ptr<Connection>;
+
+public:
+    /**
+     * @brief 占用的 stream 名额
+     * @details 析构时归还名额；连接已摘除且这是最后一个 stream 时交给回收回调
+     */
+    class Stream
+    {
+    public:
+        Stream() = default;
+        Stream(Stream&& other) noexcept { *this = std::move(other); }
+        Stream& operator=(Stream&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                m_mux = other.m_mux;
+                m_key = std::move(other.m_key);
+                m_conn = std::move(other.m_conn);
+                m_connector = other.m_connector;
+                m_exhausted = other.m_exhausted;
+                other.m_mux = nullptr;
+            }
+            return *this;
+        }
+        Stream(const Stream&) = delete;
+        Stream& operator=(const Stream&) = delete;
+        ~Stream() { release(); }
+
+        explicit operator bool() const { return m_conn != nullptr; }
+        Client* operator->() const { return m_conn->client.get(); }
+        Client& operator*() const { return *m_conn->client; }
+
+        bool exhausted() const { return m_exhausted; }  ///< 是否因上限被拒绝
+        bool connector() const { return m_connector; }  ///< 是否由本请求负责建连
+        const std::string& key() const { return m_key; }
+
+        /**
+         * @brief 连接是否仍在建立中（非 connector 需要等待）
+         */
+        bool pending() const { return m_conn && m_conn->state == ConnState::Connecting; }
+
+        /**
+         * @brief 连接是否可发起 stream
+         */
+        bool usable() const { return m_conn && m_conn->state == ConnState::Ready; }
+
+        /**
+         * @brief 登记建连完成的唤醒回调
+         * @return 连接已不在建立中时返回 false（不会回调）
+         */
+        bool subscribe(Wake wake)
+        {
+            if (!pending()) {
+                return false;
+            }
+            m_conn->waiters.push_back(std::move(wake));
+            return true;
+        }
+
+        /**
+         * @brief connector 建连成功
+         * @param peer_limit 对端 SETTINGS_MAX_CONCURRENT_STREAMS
+         */
+        void established(uint32_t peer_limit)
+        {
+            if (m_mux != nullptr && pending()) {
+                m_mux->onEstablished(m_key, m_conn, peer_limit);
+            }
+        }
+
+        /**
+         * @brief connector 建连失败，等待者被唤醒后看到 `usable() == false`
+         */
+        void failed()
+        {
+            if (m_mux != nullptr && pending()) {
+                m_mux->onFailed(m_key, m_conn);
+            }
+        }
+
+        /**
+         * @brief 连接在使用中发现失效，摘除后不再分配 stream
+         */
+        void retire()
+        {
+            if (m_mux != nullptr && m_conn && m_conn->state != ConnState::Closed) {
+                m_mux->retireConnection(m_key, m_conn);
+            }
+        }
+
+        /**
+         * @brief 归还 stream 名额
+         * @details connector 未报告建连结果就归还时按建连失败处理，避免等待者永久挂起
+         */
+        void release()
+        {
+            if (m_mux != nullptr && m_conn) {
+                if (m_connector && pending()) {
+                    m_mux->onFailed(m_key, m_conn);
+                }
+                m_mux->onRelease(m_conn);
+            }
+            m_mux = nullptr;
+            m_conn.reset();
+        }
+
+    private:
+        friend class H2cUpstreamMux;
+
+        H2cUpstreamMux* m_mux = nullptr;
+        std::string m_key;
+        ConnPtr m_conn;
+        bool m_connector = false;
+        bool m_exhausted = false;
+    };
+
+    static H2cUpstreamMux& local()
+    {
+        thread_local H2cUpstreamMux mux;
+        return mux;
+    }
+
+    /**
+     * @brief 设置连接回收回调（关闭连接需要异步完成，由调用方投递到调度器）
+     */
+    void setRetireHook(Retire hook) { m_retire = std::move(hook); }
+    bool hasRetireHook() const { return static_cast<bool>(m_retire); }
+
+    /**
+     * @brief 为一次请求分配 stream 名额
+     * @param key 上游标识（host:port）
+     * @param config 该上游的配置（首次使用时生效）
+     * @param probe 就绪连接的探测：返回对端当前允许的并发 stream 数，0 表示连接已不可用
+     * @return 已就绪或建连中连接上的名额；`connector()` 为 true 时调用方负责建连；
+     *         达到上限时返回空名额且 `exhausted()` 为 true
+     */
+    template <typename Probe>
+    Stream acquire(const std::string& key, const H2cUpstreamConfig& config, Probe&& probe)
+    {
+        Bucket& bucket = bucketFor(key, config);
+        ConnPtr best;
+        for (size_t i = 0; i < bucket.conns.size();) {
+            ConnPtr conn = bucket.conns[i];
+            if (conn->state == ConnState::Ready) {
+                const uint32_t peer_limit = probe(*conn->client);
+                if (peer_limit == 0) {
+                    retireConnection(key, conn);
+                    continue;
+                }
+                conn->limit = effectiveLimit(bucket.config, peer_limit);
+            }
+            const size_t cap = conn->state == ConnState::Ready ? conn->limit
+                                                               : effectiveLimit(bucket.config, 0);
+            if (conn->active < cap && (!best || preferOver(*conn, *best))) {
+                best = conn;
+            }
+            ++i;
+        }
+
+        if (best) {
+            ++best->active;
+            ++bucket.stats.streams;
+            if (best->state == ConnState::Connecting) {
+                ++bucket.stats.waits;
+            }
+            return makeStream(key, std::move(best), false);
+        }
+
+        if (bucket.config.max_connections > 0 && bucket.conns.size() >= bucket.config.max_connections) {
+            ++bucket.stats.exhausted;
+            Stream stream;
+            stream.m_exhausted = true;
+            return stream;
+        }
+
+        if (!bucket.conns.empty()) {
+            ++bucket.stats.saturated;
+        }
+        auto conn = std::make_shared<Connection>();
+        conn->client = std::make_unique<Client>();
+        conn->active = 1;
+        bucket.conns.push_back(conn);
+        ++bucket.stats.connects;
+        ++bucket.stats.streams;
+        return makeStream(key, std::move(conn), true);
+    }
+
+    /**
+     * @brief 获取单个上游的统计
+     */
+    H2cUpstreamStats stats(const std::string& key) const
+    {
+        auto it = m_buckets.find(key);
+        if (it == m_buckets.end()) {
+            return H2cUpstreamStats{};
+        }
+        H2cUpstreamStats out = it->second.stats;
+        out.connections = it->second.conns.size();
+        for (const auto& conn : it->second.conns) {
+            out.active += conn->active;
+        }
+        return out;
+    }
+
+    /**
+     * @brief 摘除所有连接（空闲连接立即交给回收回调）
+     */
+    void clear()
+    {
+        for (auto& [key, bucket] : m_buckets) {
+            auto conns = bucket.conns;
+            for (auto& conn : conns) {
+                retireConnection(key, conn);
+            }
+        }
+    }
+
+private:
+    struct Bucket {
+        H2cUpstreamConfig config;
+        std::vector<ConnPtr> conns;     ///< 可分配 stream 的连接（建连中 + 就绪）
+        H2cUpstreamStats stats;
+    };
+
+    static uint32_t effectiveLimit(const H2cUpstreamConfig& config, uint32_t peer_limit)
+    {
+        const uint32_t local = std::max<uint32_t>(config.max_concurrent_streams, 1);
+        return peer_limit == 0 ? local : std::min(local, peer_limit);
+    }
+
+    /**
+     * @brief 就绪连接优先于建连中的连接，其次在途 stream 少者优先
+     */
+    static bool preferOver(const Connection& a, const Connection& b)
+    {
+        const bool a_ready = a.state == ConnState::Ready;
+        const bool b_ready = b.state == ConnState::Ready;
+        if (a_ready != b_ready) {
+            return a_ready;
+        }
+        return a.active < b.active;
+    }
+
+    Bucket& bucketFor(const std::string& key, const H2cUpstreamConfig& config)
+    {
+        auto [it, inserted] = m_buckets.try_emplace(key);
+        if (inserted) {
+            it->second.config = config;
+        }
+        return it->second;
+    }
+
+    Stream makeStream(const std::string& key, ConnPtr conn, bool connector)
+    {
+        Stream stream;
+        stream.m_mux = this;
+        stream.m_key = key;
+        stream.m_conn = std::move(conn);
+        stream.m_connector = connector;
+        return stream;
+    }
+
+    void onEstablished(const std::string& key, const ConnPtr& conn, uint32_t peer_limit)
+    {
+        auto it = m_buckets.find(key);
+        conn->state = ConnState::Ready;
+        conn->limit = it != m_buckets.end() ? effectiveLimit(it->second.config, peer_limit)
+                                            : std::max<uint32_t>(peer_limit, 1);
+        wakeAll(conn);
+    }
+
+    void onFailed(const std::string& key, const ConnPtr& conn)
+    {
+        auto it = m_buckets.find(key);
+        if (it != m_buckets.end()) {
+            ++it->second.stats.connect_failures;
+        }
+        retireConnection(key, conn);
+    }
+
+    void retireConnection(const std::string& key, const ConnPtr& conn)
+    {
+        auto it = m_buckets.find(key);
+        if (it != m_buckets.end()) {
+            auto& conns = it->second.conns;
+            auto pos = std::find(conns.begin(), conns.end(), conn);
+            if (pos != conns.end()) {
+                conns.erase(pos);
+                ++it->second.stats.retired;
+            }
+        }
+        conn->state = ConnState::Closed;
+        wakeAll(conn);
+        if (conn->active == 0) {
+            handOff(*conn);
+        }
+    }
+
+    void onRelease(const ConnPtr& conn)
+    {
+        if (conn->active > 0) {
+            --conn->active;
+        }
+        if (conn->state == ConnState::Closed && conn->active == 0) {
+            handOff(*conn);
+        }
+    }
+
+    void handOff(Connection& conn)
+    {
+        if (conn.client && m_retire) {
+            m_retire(std::move(conn.client));
+        }
+        conn.client.reset();
+    }
+
+    static void wakeAll(const ConnPtr& conn)
+    {
+        std::vector<Wake> waiters;
+        waiters.swap(conn->waiters);
+        for (auto& wake : waiters) {
+            wake();
+        }
+    }
+
+    std::unordered_map<std::string, Bucket> m_buckets;
+    Retire m_retire;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_H2C_UPSTREAM_H
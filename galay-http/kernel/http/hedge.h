@@ -0,0 +1,179 @@
+/**
+ * @file hedge.h
+ * @brief 反向代理的对冲请求与重试预算
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 幂等请求在主请求超过近期延迟分位数（默认 p95）仍未返回时，
+ * 向组内另一个实例发出对冲请求，先返回者胜出，另一个被取消。
+ * 对冲与失败重试都要从令牌桶预算中取令牌：
+ * - 每个请求按 budget_ratio 存入令牌，另有每秒保底令牌，总量有上限
+ * - 上游整体变慢或故障时令牌很快耗尽，额外请求被限制在请求量的固定比例内，
+ *   不会成倍放大负载
+ * 延迟窗口与预算按上游组、按 IO 线程各一份，只在所属线程访问，无需加锁。
+ */
+
+#ifndef GALAY_HTTP_HEDGE_H
+#define GALAY_HTTP_HEDGE_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace galay::http
+{
+
+/**
+ * @brief 对冲与重试配置（按上游组生效）
+ */
+struct HedgeConfig
+{
+    bool enabled = false;                           ///< 是否对幂等请求（GET/HEAD）启用对冲
+    double quantile = 0.95;                         ///< 对冲延迟取近期成功请求延迟的分位数
+    std::chrono::milliseconds min_delay{1};         ///< 对冲延迟下限
+    std::chrono::milliseconds max_delay{1000};      ///< 对冲延迟上限
+    std::chrono::milliseconds default_delay{50};    ///< 样本不足 min_samples 时的对冲延迟
+    size_t min_samples = 32;                        ///< 使用分位数所需的最少样本数
+    bool retry_on_failure = true;                   ///< 主请求失败且未对冲时，立即向其他实例重试一次
+    double budget_ratio = 0.1;                      ///< 每个请求存入的令牌数（额外请求约占请求量的比例）
+    double budget_min_per_second = 5.0;             ///< 低流量时每秒补充的保底令牌
+    double budget_max_tokens = 20.0;                ///< 令牌上限
+};
+
+/**
+ * @brief 近期延迟窗口
+ * @details 环形保存最近 kCapacity 个样本；分位数按需重算，
+ *          每 kRecomputeEvery 个新样本最多重算一次
+ */
+class LatencyWindow
+{
+public:
+    static constexpr size_t kCapacity = 512;
+    static constexpr size_t kRecomputeEvery = 32;
+
+    void observe(std::chrono::nanoseconds latency)
+    {
+        m_samples[m_next] = latency.count() > 0 ? latency.count() : 0;
+        m_next = (m_next + 1) % kCapacity;
+        if (m_size < kCapacity) {
+            ++m_size;
+        }
+        ++m_since_compute;
+    }
+
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief 近期延迟的 q 分位数（无样本时为 0）
+     */
+    std::chrono::nanoseconds quantile(double q)
+    {
+        if (m_size == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        if (q != m_cached_q || m_since_compute >= kRecomputeEvery || m_cached_size != m_size) {
+            std::array<int64_t, kCapacity> sorted;
+            std::copy(m_samples.begin(), m_samples.begin() + m_size, sorted.begin());
+            // nearest-rank：第 ceil(q * n) 小的样本
+            const double exact = std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(m_size));
+            const size_t rank = std::min(m_size, std::max<size_t>(static_cast<size_t>(exact), 1)) - 1;
+            std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + m_size);
+            m_cached = sorted[rank];
+            m_cached_q = q;
+            m_cached_size = m_size;
+            m_since_compute = 0;
+        }
+        return std::chrono::nanoseconds(m_cached);
+    }
+
+private:
+    std::array<int64_t, kCapacity> m_samples{};
+    size_t m_next = 0;
+    size_t m_size = 0;
+    size_t m_since_compute = 0;
+    size_t m_cached_size = 0;
+    double m_cached_q = -1.0;
+    int64_t m_cached = 0;
+};
+
+/**
+ * @brief 重试令牌桶
+ */
+class RetryBudget
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 记录一个请求：存入 budget_ratio 个令牌
+     */
+    void deposit(const HedgeConfig& config, Clock::time_point now = Clock::now())
+    {
+        refill(config, now);
+        m_tokens = std::min(m_tokens + config.budget_ratio, config.budget_max_tokens);
+    }
+
+    /**
+     * @brief 尝试为一次对冲或重试取出一个令牌
+     */
+    bool tryWithdraw(const HedgeConfig& config, Clock::time_point now = Clock::now())
+    {
+        refill(config, now);
+        if (m_tokens < 1.0) {
+            return false;
+        }
+        m_tokens -= 1.0;
+        return true;
+    }
+
+    double tokens() const { return m_tokens; }
+
+private:
+    void refill(const HedgeConfig& config, Clock::time_point now)
+    {
+        if (!m_started) {
+            m_started = true;
+            m_last_refill = now;
+            m_tokens = config.budget_max_tokens;
+            return;
+        }
+        if (now <= m_last_refill) {
+            return;
+        }
+        const double elapsed = std::chrono::duration<double>(now - m_last_refill).count();
+        m_tokens = std::min(m_tokens + elapsed * config.budget_min_per_second, config.budget_max_tokens);
+        m_last_refill = now;
+    }
+
+    double m_tokens = 0.0;
+    Clock::time_point m_last_refill{};
+    bool m_started = false;
+};
+
+/**
+ * @brief 单线程单上游组的对冲状态
+ */
+struct HedgeState
+{
+    LatencyWindow latency;  ///< 成功请求的延迟
+    RetryBudget budget;     ///< 对冲与重试共用的预算
+
+    /**
+     * @brief 主请求发出后多久发出对冲请求
+     */
+    std::chrono::nanoseconds delay(const HedgeConfig& config)
+    {
+        std::chrono::nanoseconds d = config.default_delay;
+        if (latency.size() >= std::max<size_t>(config.min_samples, 1)) {
+            d = latency.quantile(config.quantile);
+        }
+        return std::clamp<std::chrono::nanoseconds>(d, config.min_delay, config.max_delay);
+    }
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_HEDGE_H
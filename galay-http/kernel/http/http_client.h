@@ -5,19 +5,23 @@
  * @version 1.0.0
  *
  * @details 提供 HTTP 与 HTTPS 客户端的模板实现，支持 URL 解析、
- *          TCP/TLS 连接、Session 创建与 Socket 所有权转移（协议升级）。
+ *          TCP/TLS 连接（IPv4 / IPv6）、Unix domain socket 连接、
+ *          Session 创建与 Socket 所有权转移（协议升级）。
  */
 
 #ifndef GALAY_HTTP_CLIENT_H
 #define GALAY_HTTP_CLIENT_H
 
 #include "http_session.h"
+#include "socket_addr.h"
 #include "galay-http/common/http_log.h"
 #include "galay-kernel/async/tcp_socket.h"
 #include "galay-http/protoc/http/http_header.h"
 #include <string>
+#include <expected>
 #include <optional>
 #include <regex>
+#include <sys/socket.h>
 
 namespace galay::websocket {
     template<typename SocketType>
@@ -35,10 +39,11 @@ using namespace galay::kernel;
  */
 struct HttpUrl {
     std::string scheme;    ///< 协议（http/https）
-    std::string host;      ///< 主机名
+    std::string host;      ///< 主机名（IPv6 字面量不含方括号）
     int port;              ///< 端口号
     std::string path;      ///< 路径
     bool is_secure;        ///< 是否为安全连接（HTTPS）
+    bool is_ipv6 = false;  ///< host 是否为 IPv6 字面量（URL 中写作 `[::1]`）
 
     /**
      * @brief 从 URL 字符串解析各组成部分
@@ -46,7 +51,7 @@ struct HttpUrl {
      * @return 解析成功返回 HttpUrl，失败返回 std::nullopt
      */
     static std::optional<HttpUrl> parse(const std::string& url) {
-        std::regex url_regex(R"(^(http|https)://([^:/]+)(?::(\d+))?(/.*)?$)", std::regex::icase);
+        std::regex url_regex(R"(^(http|https)://(\[[0-9A-Fa-f:.%]+\]|[^:/\[\]]+)(?::(\d+))?(/.*)?$)", std::regex::icase);
         std::smatch matches;
 
         if (!std::regex_match(url, matches, url_regex)) {
@@ -56,6 +61,10 @@ struct HttpUrl {
         HttpUrl result;
         result.scheme = matches[1].str();
         result.host = matches[2].str();
+        if (result.host.front() == '[') {
+            result.host = result.host.substr(1, result.host.size() - 2);
+            result.is_ipv6 = true;
+        }
         result.is_secure = (result.scheme == "https" || result.scheme == "HTTPS");
 
         if (matches[3].matched) {
@@ -169,17 +178,45 @@ public:
         }
 
 
-        m_socket = std::make_unique<SocketType>(IPType::IPV4);
+        const IPType ip_type = m_url.is_ipv6 ? IPType::IPV6 : IPType::IPV4;
+        m_socket = std::make_unique<SocketType>(ip_type);
 
         auto nonblock_result = m_socket->option().handleNonBlock();
         if (!nonblock_result) {
             throw std::runtime_error("Failed to set non-blocking: " + nonblock_result.error().message());
         }
 
-        Host server_host(IPType::IPV4, m_url.host, m_url.port);
+        Host server_host(ip_type, m_url.host, m_url.port);
         return m_socket->connect(server_host);
     }
 
+    /**
+     * @brief 经 Unix domain socket 连接
+     * @param path socket 文件路径（`@` 开头为 Linux 抽象命名空间）
+     * @param url 只用于记录 Host 与路径，默认 `http://localhost/`
+     * @return 成功返回空值；失败返回错误，对端监听队列已满时 `retryable` 为 true
+     * @throws std::runtime_error URL 非法
+     * @details 非阻塞连接立即完成或失败，无需 co_await，也不会挂起 IO 线程；
+     *          之后的 `getSession()` 与 TCP 连接完全一致
+     */
+    std::expected<void, HttpUnixConnectError> connectUnix(const std::string& path,
+                                                 const std::string& url = "http://localhost/") {
+        static_assert(std::is_same_v<SocketType, TcpSocket>, "connectUnix requires a plain TcpSocket client");
+        auto parsed_url = HttpUrl::parse(url);
+        if (!parsed_url) {
+            throw std::runtime_error("Invalid HTTP URL: " + url);
+        }
+        m_url = parsed_url.value();
+
+        HttpUnixConnectError error;
+        const int fd = detail::connectUnixStream(path, error.message, &error.retryable);
+        if (fd < 0) {
+            return std::unexpected(std::move(error));
+        }
+        m_socket = std::make_unique<SocketType>(GHandle{fd});
+        return {};
+    }
+
     /**
      * @brief 创建一个借用当前 socket 的 HTTP session
      * @param ring_buffer_size Session 内部 RingBuffer 大小
@@ -319,8 +356,16 @@ public:
         }
 
 
-        // 正确的 SslSocket 构造方式
-        m_socket = std::make_unique<galay::ssl::SslSocket>(&m_ssl_ctx);
+        // 正确的 SslSocket 构造方式；IPv6 地址先创建 AF_INET6 socket 再交给 SslSocket
+        if (m_url.is_ipv6) {
+            const int fd = ::socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to create IPv6 socket");
+            }
+            m_socket = std::make_unique<galay::ssl::SslSocket>(&m_ssl_ctx, GHandle{fd});
+        } else {
+            m_socket = std::make_unique<galay::ssl::SslSocket>(&m_ssl_ctx);
+        }
 
         auto nonblock_result = m_socket->option().handleNonBlock();
         if (!nonblock_result) {
@@ -333,7 +378,7 @@ public:
             HTTP_LOG_WARN("[connect] [sni] [fail]", "host={}", m_url.host);
         }
 
-        Host server_host(IPType::IPV4, m_url.host, m_url.port);
+        Host server_host(m_url.is_ipv6 ? IPType::IPV6 : IPType::IPV4, m_url.host, m_url.port);
         return m_socket->connect(server_host);
     }
 
@@ -6,6 +6,7 @@
  *
  * @details 封装 HTTP/HTTPS 连接的底层 Socket 与 RingBuffer 资源，
  *          提供 Reader/Writer 工厂方法，支持向 WebSocket/HTTP2 协议升级。
+ *          空闲时可把读空的 RingBuffer 归还调度器缓冲池，下次读取前再取回。
  */
 
 #ifndef GALAY_HTTP_CONN_H
@@ -13,6 +14,7 @@
 
 #include "http_reader.h"
 #include "http_writer.h"
+#include "galay-http/kernel/ring_buffer_pool.h"
 #include "galay-kernel/async/tcp_socket.h"
 #include "galay-kernel/common/buffer.h"
 
@@ -47,7 +49,7 @@ public:
      */
     HttpConnImpl(SocketType&& socket)
         : m_socket(std::move(socket))
-        , m_ring_buffer(8192)  // 8KB buffer
+        , m_ring_buffer()  // 8KB buffer，优先复用空闲连接归还的缓冲
     {
     }
 
@@ -89,7 +91,7 @@ public:
      * @return HttpReaderImpl<SocketType> Reader对象
      */
     HttpReaderImpl<SocketType> getReader(const HttpReaderSetting& setting = HttpReaderSetting()) {
-        return HttpReaderImpl<SocketType>(m_ring_buffer, setting, m_socket);
+        return HttpReaderImpl<SocketType>(m_ring_buffer.get(), setting, m_socket);
     }
 
     /**
@@ -98,9 +100,17 @@ public:
      * @return HttpWriterImpl<SocketType> Writer对象
      */
     HttpWriterImpl<SocketType> getWriter(const HttpWriterSetting& setting = HttpWriterSetting()) {
-        return HttpWriterImpl<SocketType>(setting, m_socket);
+        return HttpWriterImpl<SocketType>(setting, m_socket, m_close_requested);
     }
 
+    /**
+     * @brief 本连接在当前请求后关闭：之后 getWriter() 发送的响应头带 `Connection: close`
+     * @details 服务器排空时由请求循环设置；直接以 sendView/send 写出的原始响应不受影响
+     */
+    void requestClose() { m_close_requested = true; }
+
+    bool closeRequested() const { return m_close_requested; }
+
     /**
      * @brief 获取底层 Socket 引用
      * @return SocketType 引用
@@ -108,6 +118,26 @@ public:
      */
     SocketType& getSocket() { return m_socket; }
 
+    /**
+     * @brief 读缓冲中尚未消费的字节数（缓冲已归还时为 0）
+     */
+    size_t bufferedBytes() const { return m_ring_buffer.buffered(); }
+
+    /**
+     * @brief 读缓冲是否已归还缓冲池
+     */
+    bool bufferReleased() const { return m_ring_buffer.released(); }
+
+    /**
+     * @brief 不占读缓冲地等待下一个请求（仅明文 TcpSocket）
+     * @return 收到数据时为 true；对端关闭或读失败时为 false
+     * @details 读缓冲为空时归还当前调度器的缓冲池，数据到达后再取回；
+     *          此前 getReader() 得到的 Reader 在返回 true 后可继续使用
+     */
+    Task<bool> awaitIdleData() requires std::is_same_v<SocketType, TcpSocket> {
+        return awaitReadableWithoutBuffer(m_socket, m_ring_buffer);
+    }
+
     // 允许HttpServerImpl访问私有成员
     template<typename S>
     friend class HttpServerImpl;
@@ -133,11 +163,13 @@ private:
     /**
      * @brief 获取RingBuffer（私有方法，仅供友元类使用）
      * @return RingBuffer引用
+     * @note 缓冲已归还时先从当前调度器的缓冲池取回
      */
-    RingBuffer& ringBuffer() { return m_ring_buffer; }
+    RingBuffer& ringBuffer() { return m_ring_buffer.get(); }
 
     SocketType m_socket;
-    RingBuffer m_ring_buffer;
+    PooledRingBuffer m_ring_buffer;     ///< 读缓冲，空闲时可归还缓冲池
+    bool m_close_requested = false;     ///< 当前请求后关闭（响应头带 Connection: close）
 };
 
 // 类型别名 - HTTP (TcpSocket)
@@ -0,0 +1,299 @@
+/**
+ * @file http_date.h
+ * @brief HTTP 日期（IMF-fixdate）格式化与解析
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 手写实现 RFC 9110 §5.6.7 规定的 HTTP 日期格式，
+ * 不依赖 iostream / locale / strftime，适合放在条件请求等热路径上。
+ * 解析同时兼容两种历史格式（RFC 850 与 asctime）。
+ */
+
+#ifndef GALAY_HTTP_DATE_H
+#define GALAY_HTTP_DATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace galay::http
+{
+
+/**
+ * @brief HTTP 日期工具
+ * @details
+ * - `format()` 输出固定 29 字节的 IMF-fixdate：`Sun, 06 Nov 1994 08:49:37 GMT`
+ * - `parse()` 接受 IMF-fixdate、RFC 850（`Sunday, 06-Nov-94 08:49:37 GMT`）
+ *   与 asctime（`Sun Nov  6 08:49:37 1994`）三种格式
+ * - 全部基于整数运算，与时区、locale 无关
+ */
+class HttpDate
+{
+public:
+    static constexpr size_t kImfFixdateLength = 29; ///< IMF-fixdate 固定长度
+
+    /**
+     * @brief 将 UTC 时间格式化为 IMF-fixdate
+     * @param time Unix 时间戳（秒）
+     * @param out 输出缓冲区，至少 kImfFixdateLength 字节（不写入结尾 '\0'）
+     * @return 写入的字节数（恒为 kImfFixdateLength）
+     */
+    static size_t format(std::time_t time, char* out)
+    {
+        int64_t days = floorDiv(static_cast<int64_t>(time), 86400);
+        int64_t secs = static_cast<int64_t>(time) - days * 86400;
+
+        int64_t year = 0;
+        unsigned month = 0;
+        unsigned day = 0;
+        civilFromDays(days, year, month, day);
+        // 1970-01-01 是星期四
+        const unsigned weekday = static_cast<unsigned>(floorMod(days + 4, 7));
+
+        const unsigned hour = static_cast<unsigned>(secs / 3600);
+        const unsigned minute = static_cast<unsigned>((secs % 3600) / 60);
+        const unsigned second = static_cast<unsigned>(secs % 60);
+
+        const char* wd = kWeekdays[weekday];
+        const char* mn = kMonths[month - 1];
+        const unsigned y = static_cast<unsigned>(year < 0 ? 0 : (year > 9999 ? 9999 : year));
+
+        out[0] = wd[0]; out[1] = wd[1]; out[2] = wd[2];
+        out[3] = ','; out[4] = ' ';
+        put2(out + 5, day);
+        out[7] = ' ';
+        out[8] = mn[0]; out[9] = mn[1]; out[10] = mn[2];
+        out[11] = ' ';
+        put2(out + 12, y / 100);
+        put2(out + 14, y % 100);
+        out[16] = ' ';
+        put2(out + 17, hour);
+        out[19] = ':';
+        put2(out + 20, minute);
+        out[22] = ':';
+        put2(out + 23, second);
+        out[25] = ' '; out[26] = 'G'; out[27] = 'M'; out[28] = 'T';
+        return kImfFixdateLength;
+    }
+
+    /**
+     * @brief 将 UTC 时间格式化为 IMF-fixdate 字符串
+     * @param time Unix 时间戳（秒）
+     * @return IMF-fixdate 字符串
+     */
+    static std::string format(std::time_t time)
+    {
+        std::string out(kImfFixdateLength, '\0');
+        format(time, out.data());
+        return out;
+    }
+
+    /**
+     * @brief 解析 HTTP 日期
+     * @param value 头部值（允许首尾空白）
+     * @param out 输出 Unix 时间戳
+     * @return 解析成功返回 true
+     */
+    static bool parse(std::string_view value, std::time_t& out)
+    {
+        value = trim(value);
+        if (value.size() < 24) {
+            return false;
+        }
+
+        int64_t year = 0;
+        unsigned month = 0;
+        unsigned day = 0;
+        unsigned hour = 0;
+        unsigned minute = 0;
+        unsigned second = 0;
+
+        const size_t comma = value.find(',');
+        if (comma == 3) {
+            // IMF-fixdate: "Sun, 06 Nov 1994 08:49:37 GMT"
+            if (value.size() != kImfFixdateLength || !matchWeekday(value.substr(0, 3)) ||
+                value[4] != ' ' || value[7] != ' ' || value[11] != ' ' || value[16] != ' ' ||
+                value.substr(25) != " GMT") {
+                return false;
+            }
+            unsigned y = 0;
+            if (!read2(value, 5, day) || !readMonth(value.substr(8, 3), month) ||
+                !readN(value, 12, 4, y) || !readTime(value, 17, hour, minute, second)) {
+                return false;
+            }
+            year = y;
+        } else if (comma != std::string_view::npos) {
+            // RFC 850: "Sunday, 06-Nov-94 08:49:37 GMT"
+            if (!matchLongWeekday(value.substr(0, comma))) {
+                return false;
+            }
+            std::string_view rest = value.substr(comma + 1);
+            if (rest.size() != 23 || rest[0] != ' ' || rest[3] != '-' || rest[7] != '-' ||
+                rest[10] != ' ' || rest.substr(19) != " GMT") {
+                return false;
+            }
+            unsigned yy = 0;
+            if (!read2(rest, 1, day) || !readMonth(rest.substr(4, 3), month) ||
+                !read2(rest, 8, yy) || !readTime(rest, 11, hour, minute, second)) {
+                return false;
+            }
+            // 两位年份：与旧实现保持一致，< 70 视为 20xx
+            year = yy < 70 ? 2000 + yy : 1900 + yy;
+        } else {
+            // asctime: "Sun Nov  6 08:49:37 1994"
+            if (value.size() != 24 || !matchWeekday(value.substr(0, 3)) || value[3] != ' ' ||
+                value[7] != ' ' || value[10] != ' ' || value[19] != ' ') {
+                return false;
+            }
+            if (!readMonth(value.substr(4, 3), month)) {
+                return false;
+            }
+            if (value[8] == ' ') {
+                if (!isDigit(value[9])) {
+                    return false;
+                }
+                day = static_cast<unsigned>(value[9] - '0');
+            } else if (!read2(value, 8, day)) {
+                return false;
+            }
+            unsigned y = 0;
+            if (!readTime(value, 11, hour, minute, second) || !readN(value, 20, 4, y)) {
+                return false;
+            }
+            year = y;
+        }
+
+        if (day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59 || second > 60) {
+            return false;
+        }
+
+        const int64_t days = daysFromCivil(year, month, day);
+        out = static_cast<std::time_t>(days * 86400 + hour * 3600 + minute * 60 + second);
+        return true;
+    }
+
+private:
+    static constexpr const char* kWeekdays[7] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    static constexpr const char* kLongWeekdays[7] = {
+        "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+    static constexpr const char* kMonths[12] = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+    static int64_t floorDiv(int64_t a, int64_t b) { return (a - (a < 0 ? b - 1 : 0)) / b; }
+    static int64_t floorMod(int64_t a, int64_t b) { return a - floorDiv(a, b) * b; }
+
+    // Howard Hinnant 的 days_from_civil / civil_from_days 算法（公历，1970-01-01 为第 0 天）
+    static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d)
+    {
+        y -= m <= 2;
+        const int64_t era = floorDiv(y, 400);
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    static void civilFromDays(int64_t z, int64_t& y, unsigned& m, unsigned& d)
+    {
+        z += 719468;
+        const int64_t era = floorDiv(z, 146097);
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+    }
+
+    static unsigned daysInMonth(int64_t y, unsigned m)
+    {
+        static constexpr unsigned kDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        if (m == 2) {
+            const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+            return leap ? 29 : 28;
+        }
+        return kDays[m - 1];
+    }
+
+    static void put2(char* out, unsigned v)
+    {
+        out[0] = static_cast<char>('0' + (v / 10) % 10);
+        out[1] = static_cast<char>('0' + v % 10);
+    }
+
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static bool readN(std::string_view s, size_t pos, size_t n, unsigned& out)
+    {
+        if (pos + n > s.size()) {
+            return false;
+        }
+        unsigned v = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const char c = s[pos + i];
+            if (!isDigit(c)) {
+                return false;
+            }
+            v = v * 10 + static_cast<unsigned>(c - '0');
+        }
+        out = v;
+        return true;
+    }
+
+    static bool read2(std::string_view s, size_t pos, unsigned& out) { return readN(s, pos, 2, out); }
+
+    static bool readTime(std::string_view s, size_t pos, unsigned& h, unsigned& m, unsigned& sec)
+    {
+        return pos + 8 <= s.size() && s[pos + 2] == ':' && s[pos + 5] == ':' &&
+               read2(s, pos, h) && read2(s, pos + 3, m) && read2(s, pos + 6, sec);
+    }
+
+    static bool readMonth(std::string_view s, unsigned& month)
+    {
+        for (unsigned i = 0; i < 12; ++i) {
+            if (s == kMonths[i]) {
+                month = i + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool matchWeekday(std::string_view s)
+    {
+        for (const char* wd : kWeekdays) {
+            if (s == wd) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool matchLongWeekday(std::string_view s)
+    {
+        for (const char* wd : kLongWeekdays) {
+            if (s == wd) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::string_view trim(std::string_view s)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r' || s.front() == '\n')) {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '\n')) {
+            s.remove_suffix(1);
+        }
+        return s;
+    }
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_DATE_H
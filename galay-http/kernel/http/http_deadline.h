@@ -0,0 +1,177 @@
+/**
+ * @file http_deadline.h
+ * @brief HTTP/1.1 读请求阶段的截止时间：keep-alive 空闲、读请求头、读请求体与整个请求
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 此前只有按单次操作配置的接收超时，既不限制读完整个请求头的总时间，
+ * 也不限制两次 keep-alive 请求之间的空闲时间，slowloris 式客户端每隔几秒发一个字节就能长期占住连接。
+ * 每个连接在等待请求期间挂一个时间轮定时器，到期时按观察到的读取进度判定阶段：
+ * - 空闲：读缓冲为空且请求头未开始解析，超过 keepalive_timeout 关闭；首个请求按读请求头计
+ * - 读请求头：请求头须在 header_timeout 内读完，自检查点首次看到数据起算
+ *   （空闲阶段每 header_timeout 检查一次，因此从首字节起最长约 2 × header_timeout）
+ * - 读请求体：两次检查之间没有新数据超过 body_timeout 关闭
+ * - request_timeout 限制从请求开始到请求读完的总时间，0 表示不限
+ * 处理器执行与写响应期间不计时。本文件不依赖运行时，定时器与关闭动作见 http_server.h。
+ */
+
+#ifndef GALAY_HTTP_DEADLINE_H
+#define GALAY_HTTP_DEADLINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+namespace galay::http
+{
+
+/**
+ * @brief 读请求阶段的截止时间配置（各项为 0 表示不限）
+ */
+struct HttpDeadlineConfig
+{
+    bool enabled = true;                                ///< 是否启用
+    std::chrono::milliseconds header_timeout{30000};    ///< 读完请求头的时限
+    std::chrono::milliseconds body_timeout{60000};      ///< 读请求体时无新数据的时限
+    std::chrono::milliseconds keepalive_timeout{75000}; ///< 两次 keep-alive 请求之间的空闲时限
+    std::chrono::milliseconds request_timeout{0};       ///< 读完整个请求的总时限
+};
+
+/**
+ * @brief 截止时间到期的原因
+ */
+enum class HttpDeadlineExpiry
+{
+    None,       ///< 未到期
+    KeepAlive,  ///< keep-alive 空闲超时
+    Header,     ///< 读请求头超时
+    Body,       ///< 读请求体超时
+    Request     ///< 整个请求超时
+};
+
+inline std::string_view toString(HttpDeadlineExpiry expiry)
+{
+    switch (expiry) {
+        case HttpDeadlineExpiry::KeepAlive: return "keepalive";
+        case HttpDeadlineExpiry::Header: return "header";
+        case HttpDeadlineExpiry::Body: return "body";
+        case HttpDeadlineExpiry::Request: return "request";
+        default: return "none";
+    }
+}
+
+/**
+ * @brief 检查点观察到的读取进度
+ */
+struct HttpReadProgress
+{
+    size_t buffered = 0;            ///< 读缓冲中尚未解析的字节数
+    bool header_complete = false;   ///< 请求头是否已解析完成
+    size_t body_received = 0;       ///< 已解析的请求体字节数
+};
+
+/**
+ * @brief 单个连接等待一个请求期间的阶段状态机
+ */
+class HttpRequestDeadline
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 开始等待下一个请求
+     * @param first_request 连接上的首个请求（从 accept 起按读请求头计时）
+     * @param buffered 读缓冲中已有的字节数（流水线请求）
+     */
+    void begin(const HttpDeadlineConfig& config, Clock::time_point now, bool first_request, size_t buffered)
+    {
+        m_config = config;
+        m_total_deadline = Clock::time_point::max();
+        if (first_request || buffered > 0) {
+            enterHeader(now);
+        } else {
+            m_phase = Phase::Idle;
+            m_phase_deadline = after(now, m_config.keepalive_timeout);
+            m_next_check = std::min(m_phase_deadline, after(now, m_config.header_timeout));
+        }
+    }
+
+    /**
+     * @brief 下一次需要检查的时间
+     */
+    Clock::time_point nextCheck() const { return std::min(m_next_check, m_total_deadline); }
+
+    /**
+     * @brief 在检查点按读取进度推进阶段
+     * @return 到期原因；未到期时为 None，下一次检查时间见 nextCheck()
+     */
+    HttpDeadlineExpiry check(const HttpReadProgress& progress, Clock::time_point now)
+    {
+        if (now >= m_total_deadline) {
+            return HttpDeadlineExpiry::Request;
+        }
+        if (progress.header_complete) {
+            if (m_phase != Phase::Body || progress.body_received != m_body_received) {
+                if (m_phase == Phase::Idle) {
+                    enterHeader(now);
+                }
+                m_phase = Phase::Body;
+                m_body_received = progress.body_received;
+                m_phase_deadline = after(now, m_config.body_timeout);
+            } else if (now >= m_phase_deadline) {
+                return HttpDeadlineExpiry::Body;
+            }
+            m_next_check = m_phase_deadline;
+            return HttpDeadlineExpiry::None;
+        }
+        if (m_phase == Phase::Idle) {
+            if (progress.buffered > 0) {
+                enterHeader(now);
+                return HttpDeadlineExpiry::None;
+            }
+            if (now >= m_phase_deadline) {
+                return HttpDeadlineExpiry::KeepAlive;
+            }
+            m_next_check = std::min(m_phase_deadline, after(now, m_config.header_timeout));
+            return HttpDeadlineExpiry::None;
+        }
+        if (now >= m_phase_deadline) {
+            return HttpDeadlineExpiry::Header;
+        }
+        m_next_check = m_phase_deadline;
+        return HttpDeadlineExpiry::None;
+    }
+
+private:
+    enum class Phase
+    {
+        Idle,
+        Header,
+        Body
+    };
+
+    static Clock::time_point after(Clock::time_point now, std::chrono::milliseconds timeout)
+    {
+        return timeout.count() > 0 ? now + timeout : Clock::time_point::max();
+    }
+
+    void enterHeader(Clock::time_point now)
+    {
+        m_phase = Phase::Header;
+        m_phase_deadline = after(now, m_config.header_timeout);
+        m_next_check = m_phase_deadline;
+        m_total_deadline = after(now, m_config.request_timeout);
+    }
+
+    HttpDeadlineConfig m_config;
+    Phase m_phase = Phase::Idle;
+    Clock::time_point m_phase_deadline = Clock::time_point::max();
+    Clock::time_point m_next_check = Clock::time_point::max();
+    Clock::time_point m_total_deadline = Clock::time_point::max();
+    size_t m_body_received = 0;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_DEADLINE_H
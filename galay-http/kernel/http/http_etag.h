@@ -12,14 +12,16 @@
 #ifndef GALAY_HTTP_ETAG_H
 #define GALAY_HTTP_ETAG_H
 
+#include "http_date.h"
 #include <string>
+#include <string_view>
+#include <chrono>
+#include <functional>
 #include <ctime>
 #include <time.h>
 #include <cstdint>
+#include <cstdio>
 #include <vector>
-#include <sstream>
-#include <iomanip>
-#include <locale>
 #include <filesystem>
 #include <sys/stat.h>
 
@@ -55,7 +57,15 @@ public:
      */
     static std::string generateStrong(const fs::path& filePath, size_t fileSize, std::time_t lastModified)
     {
-        uint64_t inode = getFileInode(filePath);
+        return generateStrong(getFileInode(filePath), fileSize, lastModified);
+    }
+
+    /**
+     * @brief 由已知的 inode + size + mtime 生成强 ETag
+     * @details 调用方已持有 stat 结果时使用，避免再次访问文件系统
+     */
+    static std::string generateStrong(uint64_t inode, size_t fileSize, std::time_t lastModified)
+    {
         char etag[128];
         snprintf(etag, sizeof(etag), "\"%lx-%zx-%lx\"",
                  static_cast<unsigned long>(inode),
@@ -81,6 +91,17 @@ public:
      */
     static std::string generate(const fs::path& filePath, Type type = Type::STRONG)
     {
+#ifndef _WIN32
+        // 一次 stat 同时取得 inode / size / mtime
+        struct stat fileStat;
+        if (stat(filePath.c_str(), &fileStat) != 0 || fileStat.st_mtime == 0) {
+            return "\"\"";
+        }
+        std::string strong = generateStrong(static_cast<uint64_t>(fileStat.st_ino),
+                                            static_cast<size_t>(fileStat.st_size),
+                                            fileStat.st_mtime);
+        return type == Type::WEAK ? "W/" + strong : strong;
+#else
         std::error_code ec;
 
         // 获取文件大小
@@ -96,6 +117,7 @@ public:
         } else {
             return generateStrong(filePath, fileSize, lastModifiedTimeT);
         }
+#endif
     }
 
     /**
@@ -141,7 +163,7 @@ public:
         }
 
         std::time_t parsed = 0;
-        if (parseHttpDate(headerTrim, parsed)) {
+        if (HttpDate::parse(headerTrim, parsed)) {
             return lastModified <= parsed;
         }
 
@@ -190,65 +212,23 @@ public:
 
     /**
      * @brief 格式化 HTTP 日期
-     * @details 按照 RFC 7231 格式化为 GMT 时间
+     * @details 按照 RFC 9110 IMF-fixdate 格式化为 GMT 时间
      */
     static std::string formatHttpDate(std::time_t time)
     {
-        char buffer[128];
-        std::tm tm;
-#ifdef _WIN32
-        gmtime_s(&tm, &time);
-#else
-        gmtime_r(&time, &tm);
-#endif
-        strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
-        return std::string(buffer);
+        return HttpDate::format(time);
     }
 
-private:
-    static bool parseWithFormat(const std::string& value, const char* format, std::tm& tm, bool twoDigitYear)
-    {
-        std::istringstream ss(value);
-        ss.imbue(std::locale::classic());
-        ss >> std::get_time(&tm, format);
-        if (ss.fail()) {
-            return false;
-        }
-        ss >> std::ws;
-        if (!ss.eof()) {
-            return false;
-        }
-        if (twoDigitYear && tm.tm_year < 70) {
-            tm.tm_year += 100;
-        }
-        return true;
-    }
-
-    static std::time_t timegmUtc(std::tm* tm)
-    {
-    #ifdef _WIN32
-        return _mkgmtime(tm);
-    #else
-        return timegm(tm);
-    #endif
-    }
-
-    static bool parseHttpDate(const std::string& value, std::time_t& out)
+    /**
+     * @brief 解析 HTTP 日期（IMF-fixdate / RFC 850 / asctime）
+     * @return 解析成功返回 true
+     */
+    static bool parseHttpDate(std::string_view value, std::time_t& out)
     {
-        std::tm tm{};
-        if (parseWithFormat(value, "%a, %d %b %Y %H:%M:%S GMT", tm, false) ||
-            parseWithFormat(value, "%A, %d-%b-%y %H:%M:%S GMT", tm, true) ||
-            parseWithFormat(value, "%a %b %e %H:%M:%S %Y", tm, false)) {
-            const auto t = timegmUtc(&tm);
-            if (t == static_cast<std::time_t>(-1)) {
-                return false;
-            }
-            out = t;
-            return true;
-        }
-        return false;
+        return HttpDate::parse(value, out);
     }
 
+private:
     static bool matchEtagHeader(const std::string& etag, const std::string& headerValue)
     {
         if (headerValue.empty()) {
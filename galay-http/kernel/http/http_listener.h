@@ -0,0 +1,527 @@
+/**
+ * @file http_listener.h
+ * @brief 服务器监听 socket 的创建（IPv4 / IPv6 双栈 / Unix domain socket）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details HttpServer、HttpsServer、H2cServer、H2Server 共用：
+ * - TCP：每个 IO 调度器的 serverLoop 各自创建 listener，借助 SO_REUSEPORT 多线程 accept；
+ *   IPv6 地址按配置设置 IPV6_V6ONLY，默认双栈
+ * - Unix：SO_REUSEPORT 对 AF_UNIX 无效，启动时只 bind/listen 一次，
+ *   各 serverLoop 持有 dup 出的 fd 在同一监听队列上 accept；停止时删除 socket 文件
+ * - CPU 引导：IO 调度器全部绑核时，启动阶段按调度器顺序预先创建整组 TCP listener，
+ *   并挂载按接收 CPU 选择 listener 的 BPF 程序（见 reuseport_steering.h）
+ * - 调优：按 HttpSocketTuning 设置监听 socket 与已 accept 连接的内核选项（见 socket_tuning.h）
+ * - 批量 accept：等待式 accept 返回后以非阻塞 accept4 继续取出监听队列中的连接（HttpAcceptBatch，见 socket_addr.h）
+ * - 交接：配置 `handoff_path` 时预先创建整组 listener，使全部监听 fd 由端点持有，可发送给新进程；
+ *   新进程在继承的 fd 上 accept 而不重新 bind（见 listener_handoff.h）
+ */
+
+#ifndef GALAY_HTTP_LISTENER_H
+#define GALAY_HTTP_LISTENER_H
+
+#include "socket_addr.h"
+#include "socket_tuning.h"
+#include "reuseport_steering.h"
+#include "galay-http/common/http_log.h"
+#include "galay-kernel/async/tcp_socket.h"
+#include <atomic>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace galay::http
+{
+
+using namespace galay::async;
+using namespace galay::kernel;
+
+/**
+ * @brief 按绑核策略推算各 IO 调度器绑定的 CPU
+ * @details Sequential 模式下 IO 调度器依次绑定 CPU 0..n-1；Custom 模式取 custom_io_cpus
+ * @return 所有 IO 调度器都已绑核时返回 CPU 列表，否则返回空
+ */
+inline std::vector<int> pinnedIoSchedulerCpus(const RuntimeAffinityConfig& affinity, size_t io_count)
+{
+    std::vector<int> cpus;
+    if (io_count == 0) {
+        return cpus;
+    }
+    if (affinity.mode == RuntimeAffinityConfig::Mode::Custom && affinity.custom_io_cpus.size() == io_count) {
+        cpus.assign(affinity.custom_io_cpus.begin(), affinity.custom_io_cpus.end());
+    } else if (affinity.mode == RuntimeAffinityConfig::Mode::Sequential && affinity.seq_io_count == io_count) {
+        for (size_t i = 0; i < io_count; ++i) {
+            cpus.push_back(static_cast<int>(i));
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief 服务器监听端点
+ */
+class HttpListenEndpoint
+{
+public:
+    HttpListenEndpoint() = default;
+
+    ~HttpListenEndpoint()
+    {
+        close();
+        closeInherited();
+    }
+
+    HttpListenEndpoint(const HttpListenEndpoint&) = delete;
+    HttpListenEndpoint& operator=(const HttpListenEndpoint&) = delete;
+
+    HttpListenEndpoint(HttpListenEndpoint&& other) noexcept
+        : m_address(std::move(other.m_address))
+        , m_backlog(other.m_backlog)
+        , m_ipv6_only(other.m_ipv6_only)
+        , m_unix_fd(std::exchange(other.m_unix_fd, -1))
+        , m_tcp_fds(std::exchange(other.m_tcp_fds, {}))
+        , m_cpu_steering(std::exchange(other.m_cpu_steering, false))
+        , m_tuning(other.m_tuning)
+        , m_require_group(other.m_require_group)
+        , m_handed_off(other.m_handed_off.load())
+        , m_inherited(std::exchange(other.m_inherited, {}))
+        , m_inherited_authority(std::move(other.m_inherited_authority))
+        , m_accepts(std::move(other.m_accepts))
+    {
+    }
+
+    HttpListenEndpoint& operator=(HttpListenEndpoint&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            closeInherited();
+            m_address = std::move(other.m_address);
+            m_backlog = other.m_backlog;
+            m_ipv6_only = other.m_ipv6_only;
+            m_unix_fd = std::exchange(other.m_unix_fd, -1);
+            m_tcp_fds = std::exchange(other.m_tcp_fds, {});
+            m_cpu_steering = std::exchange(other.m_cpu_steering, false);
+            m_tuning = other.m_tuning;
+            m_require_group = other.m_require_group;
+            m_handed_off.store(other.m_handed_off.load());
+            m_inherited = std::exchange(other.m_inherited, {});
+            m_inherited_authority = std::move(other.m_inherited_authority);
+            m_accepts = std::move(other.m_accepts);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief open() 之前调用：TCP 地址也在启动时按调度器顺序预先创建整组 listener
+     * @details 监听 fd 交接要求全部监听 fd 由端点持有；未挂载 CPU 引导程序时组内仍按哈希分发
+     */
+    void requireListenerGroup(bool enabled) { m_require_group = enabled; }
+
+    /**
+     * @brief open() 之前调用：改用从旧进程继承的监听 fd，不再 bind
+     * @param fds 旧进程的监听 fd（按其调度器下标），所有权转移给端点
+     * @param authority 旧进程的监听地址；与本端配置不一致时 open() 关闭这些 fd 并按配置重新 bind
+     */
+    void adoptInherited(std::vector<int> fds, std::string authority)
+    {
+        closeInherited();
+        m_inherited = std::move(fds);
+        m_inherited_authority = std::move(authority);
+    }
+
+    /**
+     * @brief 启动时调用一次：解析地址，Unix 地址在此完成 bind/listen
+     * @param host 监听地址（IPv4/IPv6 字面量或 `unix:` 路径）
+     * @param ipv6_only IPv6 监听是否关闭双栈
+     * @param loop_count accept 循环（IO 调度器）数量
+     * @param steer_cpus 各 IO 调度器绑定的 CPU；非空且为 TCP 地址时预先创建整组 listener 并挂载 CPU 引导程序
+     * @param tuning 监听 socket 与已 accept 连接的调优选项
+     * @return 失败返回 false（已记录日志）
+     * @details 此前 adoptInherited() 传入的 fd 地址与配置一致时直接接管，不再 bind
+     */
+    bool open(const std::string& host, uint16_t port, int backlog, bool ipv6_only,
+              size_t loop_count, const std::vector<int>& steer_cpus = {},
+              const HttpSocketTuning& tuning = HttpSocketTuning())
+    {
+        close();
+        m_address = HttpSocketAddress::parse(host, port);
+        m_backlog = backlog;
+        m_ipv6_only = ipv6_only;
+        m_tuning = tuning;
+        m_handed_off.store(false);
+        const bool steer = !m_address.isUnix() && !steer_cpus.empty() && steer_cpus.size() == loop_count;
+        if (!m_inherited.empty()) {
+            if (m_inherited_authority == m_address.authority()) {
+                m_accepts.reset(steer ? steer_cpus : std::vector<int>(loop_count, -1));
+                return adoptGroup(loop_count, steer ? steer_cpus : std::vector<int>{});
+            }
+            HTTP_LOG_WARN("[listen] [inherit] [mismatch]", "inherited={} configured={}",
+                          m_inherited_authority, m_address.authority());
+            closeInherited();
+        }
+        if (!m_address.isUnix()) {
+            if (steer) {
+                m_accepts.reset(steer_cpus);
+                return openGroup(loop_count, steer_cpus);
+            }
+            m_accepts.reset(std::vector<int>(loop_count, -1));
+            return m_require_group ? openGroup(loop_count, {}) : true;
+        }
+        m_accepts.reset(std::vector<int>(loop_count, -1));
+        std::string error;
+        m_unix_fd = detail::openUnixListener(m_address.host, backlog, error);
+        if (m_unix_fd < 0) {
+            HTTP_LOG_ERROR("[listen] [unix] [fail]", "path={} error={}", m_address.host, error);
+            return false;
+        }
+        applyTuning(m_unix_fd);
+        return true;
+    }
+
+    /**
+     * @brief 为一个 serverLoop 创建 listener
+     * @param index serverLoop 所在 IO 调度器的下标
+     * @return 已 listen 的非阻塞 socket；失败返回 std::nullopt（已记录日志）
+     */
+    std::optional<TcpSocket> createListener(size_t index) const
+    {
+        if (!m_tcp_fds.empty()) {
+            const int fd = index < m_tcp_fds.size() ? ::dup(m_tcp_fds[index]) : -1;
+            if (fd < 0) {
+                HTTP_LOG_ERROR("[listen] [group] [dup-fail]", "index={}", index);
+                return std::nullopt;
+            }
+            return std::optional<TcpSocket>(std::in_place, GHandle{fd});
+        }
+
+        if (m_address.isUnix()) {
+            const int fd = m_unix_fd >= 0 ? ::dup(m_unix_fd) : -1;
+            if (fd < 0) {
+                HTTP_LOG_ERROR("[listen] [unix] [dup-fail]", "path={}", m_address.host);
+                return std::nullopt;
+            }
+            return std::optional<TcpSocket>(std::in_place, GHandle{fd});
+        }
+
+        const IPType ip_type = m_address.isIPv6() ? IPType::IPV6 : IPType::IPV4;
+        TcpSocket listener(ip_type);
+
+        auto reuse_result = listener.option().handleReuseAddr();
+        if (!reuse_result) {
+            HTTP_LOG_ERROR("[socket] [reuseaddr-fail]", "error={}", reuse_result.error().message());
+            return std::nullopt;
+        }
+
+        // 设置 SO_REUSEPORT 以支持多线程 accept
+        auto reuse_port_result = listener.option().handleReusePort();
+        if (!reuse_port_result) {
+            HTTP_LOG_ERROR("[socket] [reuseport-fail]", "error={}", reuse_port_result.error().message());
+            return std::nullopt;
+        }
+
+        auto nonblock_result = listener.option().handleNonBlock();
+        if (!nonblock_result) {
+            HTTP_LOG_ERROR("[socket] [nonblock-fail]", "error={}", nonblock_result.error().message());
+            return std::nullopt;
+        }
+
+        if (m_address.isIPv6() && !detail::setIpv6Only(listener.handle().fd, m_ipv6_only)) {
+            HTTP_LOG_WARN("[socket] [v6only-fail]", "host={}", m_address.host);
+        }
+        applyTuning(listener.handle().fd);
+
+        Host bind_host(ip_type, m_address.host, m_address.port);
+        auto bind_result = listener.bind(bind_host);
+        if (!bind_result) {
+            HTTP_LOG_ERROR("[bind] [fail]",
+                           "host={} port={} error={}",
+                           m_address.host,
+                           m_address.port,
+                           bind_result.error().message());
+            return std::nullopt;
+        }
+
+        auto listen_result = listener.listen(m_backlog);
+        if (!listen_result) {
+            HTTP_LOG_ERROR("[listen] [fail]", "error={}", listen_result.error().message());
+            return std::nullopt;
+        }
+        return std::optional<TcpSocket>(std::move(listener));
+    }
+
+    /**
+     * @brief accept 循环每接受一个连接调用一次
+     * @param index serverLoop 所在 IO 调度器的下标
+     * @param batched 是否由 HttpAcceptBatch 取出
+     */
+    void recordAccept(size_t index, int fd, bool batched = false)
+    {
+        m_accepts.record(index, fd, m_cpu_steering, batched);
+    }
+
+    /**
+     * @brief 对刚 accept 的 TCP 连接设置逐连接调优选项（未配置时无系统调用）
+     */
+    void tuneAccepted(int fd) const
+    {
+        if (!m_tuning.hasAcceptedOptions() || m_address.isUnix()) {
+            return;
+        }
+        const std::string failed = detail::applyAcceptedTuning(fd, m_tuning);
+        if (!failed.empty()) {
+            HTTP_LOG_DEBUG("[socket] [tuning-fail]", "fd={} options={}", fd, failed);
+        }
+    }
+
+    /**
+     * @brief 各 IO 调度器的 accept 分布
+     */
+    HttpAcceptStats acceptStats() const
+    {
+        return m_accepts.snapshot(m_cpu_steering);
+    }
+
+    /**
+     * @brief CPU 引导程序是否已挂载（连接落在接收 CPU 对应的调度器上）
+     */
+    bool cpuSteering() const { return m_cpu_steering; }
+
+    /**
+     * @brief 端点持有的全部监听 fd（预先创建的 TCP listener 组或 Unix 监听 fd），用于交接给新进程
+     */
+    std::vector<int> listenerFds() const
+    {
+        if (!m_tcp_fds.empty()) {
+            return m_tcp_fds;
+        }
+        return m_unix_fd >= 0 ? std::vector<int>{m_unix_fd} : std::vector<int>{};
+    }
+
+    /**
+     * @brief 监听 fd 已交给新进程：close() 不再删除 Unix socket 文件，也不应再卸载 CPU 引导程序
+     */
+    void markHandedOff() { m_handed_off.store(true); }
+
+    bool handedOff() const { return m_handed_off.load(); }
+
+    /**
+     * @brief 向监听地址发起空连接，唤醒阻塞在 accept 上的循环
+     * @param attempts 连接次数（通常为 accept 循环数）；SO_REUSEPORT 按哈希分发，不保证每个循环都被唤醒
+     */
+    void wakeAcceptLoops(size_t attempts) const
+    {
+        if (attempts == 0) {
+            return;
+        }
+
+        if (m_address.isUnix()) {
+            for (size_t i = 0; i < attempts; ++i) {
+                std::string error;
+                const int fd = detail::connectUnixStream(m_address.host, error);
+                if (fd < 0) {
+                    return;
+                }
+                ::close(fd);
+            }
+            return;
+        }
+
+        if (m_address.port == 0) {
+            return;
+        }
+
+        const bool ipv6 = m_address.isIPv6();
+        const std::string& host = m_address.host;
+        const std::string wake_host = (host.empty() || host == "0.0.0.0" || host == "::")
+            ? (ipv6 ? "::1" : "127.0.0.1")
+            : host;
+        for (size_t i = 0; i < attempts; ++i) {
+            const int fd = ::socket(ipv6 ? AF_INET6 : AF_INET, SOCK_STREAM, 0);
+            if (fd < 0) {
+                return;
+            }
+
+            if (ipv6) {
+                sockaddr_in6 addr{};
+                addr.sin6_family = AF_INET6;
+                addr.sin6_port = htons(m_address.port);
+                if (::inet_pton(AF_INET6, wake_host.c_str(), &addr.sin6_addr) == 1) {
+                    (void)::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+                }
+            } else {
+                sockaddr_in addr{};
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(m_address.port);
+                if (::inet_pton(AF_INET, wake_host.c_str(), &addr.sin_addr) == 1) {
+                    (void)::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+                }
+            }
+            ::close(fd);
+        }
+    }
+
+    /**
+     * @brief 卸载 CPU 引导程序，恢复哈希分发（停止前唤醒 accept 循环时使用）
+     */
+    void detachSteering()
+    {
+        if (m_cpu_steering && !m_tcp_fds.empty() && !m_handed_off) {
+            detail::detachReuseportProgram(m_tcp_fds.front());
+        }
+    }
+
+    /**
+     * @brief 关闭共享的 Unix 监听 fd 并删除 socket 文件，关闭预先创建的 TCP listener 组
+     * @details 监听 fd 已交给新进程时只关闭本进程的引用，socket 文件由新进程继续使用
+     */
+    void close()
+    {
+        if (m_unix_fd >= 0) {
+            ::close(m_unix_fd);
+            m_unix_fd = -1;
+            if (!m_handed_off) {
+                detail::removeUnixSocketFile(m_address.host);
+            }
+        }
+        for (int fd : m_tcp_fds) {
+            ::close(fd);
+        }
+        m_tcp_fds.clear();
+        m_cpu_steering = false;
+    }
+
+    const HttpSocketAddress& address() const { return m_address; }
+
+private:
+    /**
+     * @brief 按调度器顺序创建整组 listener，cpus 非空时挂载 CPU 引导程序
+     */
+    bool openGroup(size_t count, const std::vector<int>& cpus)
+    {
+        return growGroup(count) && attachSteering(cpus);
+    }
+
+    /**
+     * @brief 补足 TCP listener 组到 count 个
+     * @details 新建的 listener 以 SO_REUSEPORT 加入同一地址的组（包括继承来的 listener）
+     */
+    bool growGroup(size_t count)
+    {
+        std::string error;
+        while (m_tcp_fds.size() < count) {
+            const int fd = detail::openTcpListener(m_address, m_backlog, m_ipv6_only, error);
+            if (fd < 0) {
+                HTTP_LOG_ERROR("[listen] [group] [fail]",
+                               "host={} port={} error={}",
+                               m_address.host,
+                               m_address.port,
+                               error);
+                close();
+                return false;
+            }
+            applyTuning(fd);
+            m_tcp_fds.push_back(fd);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 挂载 CPU 引导程序
+     * @details cpus 为空时不挂载；挂载失败（内核不支持等）只记录告警，listener 仍按哈希分发
+     */
+    bool attachSteering(const std::vector<int>& cpus)
+    {
+        if (cpus.empty() || m_tcp_fds.empty()) {
+            return true;
+        }
+        std::string error;
+        if (!detail::attachCpuSteering(m_tcp_fds.front(), cpus, error)) {
+            HTTP_LOG_WARN("[listen] [steer] [attach-fail]", "error={}", error);
+            return true;
+        }
+        m_cpu_steering = true;
+        HTTP_LOG_INFO("[listen] [steer]", "listeners={} port={}", cpus.size(), m_address.port);
+        return true;
+    }
+
+    /**
+     * @brief 接管继承来的监听 fd
+     * @details Unix 地址只取第一个 fd，不删除也不重新创建 socket 文件。
+     *          TCP 组按本进程调度器数补足或截断：多出的 listener 关闭时其队列中已完成握手的连接会被重置，
+     *          新旧进程应保持相同的 IO 调度器数。旧进程挂载的 CPU 引导程序按本进程配置重新挂载或卸载
+     */
+    bool adoptGroup(size_t count, const std::vector<int>& cpus)
+    {
+        std::vector<int> fds = std::exchange(m_inherited, {});
+        if (m_address.isUnix()) {
+            m_unix_fd = fds.front();
+            for (size_t i = 1; i < fds.size(); ++i) {
+                ::close(fds[i]);
+            }
+            applyTuning(m_unix_fd);
+            HTTP_LOG_INFO("[listen] [inherit]", "path={}", m_address.host);
+            return true;
+        }
+        if (fds.size() > count) {
+            HTTP_LOG_WARN("[listen] [inherit] [shrink]", "inherited={} loops={}", fds.size(), count);
+            for (size_t i = count; i < fds.size(); ++i) {
+                ::close(fds[i]);
+            }
+            fds.resize(count);
+        }
+        const size_t inherited = fds.size();
+        m_tcp_fds = std::move(fds);
+        for (int fd : m_tcp_fds) {
+            applyTuning(fd);
+        }
+        if (!growGroup(count)) {
+            return false;
+        }
+        if (cpus.empty()) {
+            detail::detachReuseportProgram(m_tcp_fds.front());
+        }
+        HTTP_LOG_INFO("[listen] [inherit]", "listeners={} port={}", inherited, m_address.port);
+        return attachSteering(cpus);
+    }
+
+    void closeInherited()
+    {
+        for (int fd : m_inherited) {
+            ::close(fd);
+        }
+        m_inherited.clear();
+        m_inherited_authority.clear();
+    }
+
+    /**
+     * @brief 对监听 socket 设置调优选项，失败只记录告警
+     */
+    void applyTuning(int fd) const
+    {
+        const std::string failed = detail::applyListenerTuning(fd, m_tuning, !m_address.isUnix());
+        if (!failed.empty()) {
+            HTTP_LOG_WARN("[listen] [tuning-fail]", "options={}", failed);
+        }
+    }
+
+    HttpSocketAddress m_address;
+    int m_backlog = 128;
+    bool m_ipv6_only = false;
+    int m_unix_fd = -1;     ///< Unix 地址共享的监听 fd
+    std::vector<int> m_tcp_fds;     ///< CPU 引导或交接时预先创建的 listener 组（按调度器下标）
+    bool m_cpu_steering = false;    ///< CPU 引导程序是否已挂载
+    HttpSocketTuning m_tuning;      ///< 监听与已 accept 连接的调优选项
+    bool m_require_group = false;   ///< TCP 地址是否预先创建整组 listener（交接需要）
+    std::atomic<bool> m_handed_off{false};  ///< 监听 fd 是否已交给新进程（由交接协程设置）
+    std::vector<int> m_inherited;   ///< 待接管的继承 fd（open() 前由 adoptInherited 设置）
+    std::string m_inherited_authority;  ///< 继承 fd 的监听地址
+    HttpAcceptCounters m_accepts;   ///< 各调度器 accept 计数
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_LISTENER_H
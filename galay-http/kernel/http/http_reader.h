@@ -22,6 +22,7 @@
 #include "galay-kernel/async/tcp_socket.h"
 #include "galay-kernel/common/buffer.h"
 #include "galay-kernel/kernel/awaitable.h"
+#include <algorithm>
 #include <expected>
 #include <memory>
 #include <optional>
@@ -616,6 +617,246 @@ struct HttpChunkReadState {
     bool m_is_last = false;                             ///< 是否为最后一个 chunk
 };
 
+/**
+ * @brief HTTP 响应头读取状态
+ * @details 只解析响应头，响应体留在 RingBuffer 中由调用方按需读取（流式转发）
+ */
+struct HttpResponseHeaderReadState {
+    using ResultType = std::expected<bool, HttpError>; ///< 结果类型
+
+    /**
+     * @brief 构造函数
+     * @param ring_buffer 环形缓冲区引用
+     * @param setting 读取器配置
+     * @param header 待填充的 HTTP 响应头
+     */
+    HttpResponseHeaderReadState(RingBuffer& ring_buffer,
+                                const HttpReaderSetting& setting,
+                                HttpResponseHeader& header)
+        : m_ring_buffer(&ring_buffer)
+        , m_setting(&setting)
+        , m_header(&header) {}
+
+    /**
+     * @brief 从 RingBuffer 中尝试解析响应头
+     * @return 响应头解析完成或出错返回 true，数据不足返回 false
+     */
+    bool parseFromRingBuffer() {
+        auto read_iovecs = borrowReadIovecs(*m_ring_buffer);
+        if (read_iovecs.empty()) {
+            return false;
+        }
+
+        if (IoVecWindow::buildWindow(read_iovecs, m_parse_iovecs) == 0) {
+            return false;
+        }
+
+        auto [error_code, consumed] = m_header->fromIOVec(m_parse_iovecs);
+        if (consumed > 0) {
+            m_ring_buffer->consume(consumed);
+        }
+
+        if (error_code == kIncomplete || error_code == kHeaderInComplete) {
+            if (m_total_received >= m_setting->getMaxHeaderSize()) {
+                setParseError(HttpError(kHeaderTooLarge));
+                return true;
+            }
+            return false;
+        }
+
+        if (error_code != kNoError) {
+            setParseError(HttpError(error_code));
+            return true;
+        }
+
+        return m_header->isHeaderComplete();
+    }
+
+    /**
+     * @brief 准备接收窗口
+     * @return 成功返回 true
+     */
+    bool prepareRecvWindow() {
+        m_write_iovecs = borrowWriteIovecs(*m_ring_buffer);
+        if (m_write_iovecs.empty()) {
+            setParseError(HttpError(kHeaderTooLarge));
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 准备 SSL 接收窗口
+     * @param[out] buffer 输出缓冲区指针
+     * @param[out] length 输出缓冲区长度
+     * @return 成功返回 true
+     */
+    bool prepareRecvWindow(char*& buffer, size_t& length) {
+        if (!prepareRecvWindow()) {
+            buffer = nullptr;
+            length = 0;
+            return false;
+        }
+        if (!IoVecWindow::bindFirstNonEmpty(m_write_iovecs, buffer, length)) {
+            setParseError(HttpError(kHeaderTooLarge));
+            return false;
+        }
+        return true;
+    }
+
+    const struct iovec* recvIovecsData() const { return m_write_iovecs.data(); } ///< 获取接收 iovec 数据指针
+    size_t recvIovecsCount() const { return m_write_iovecs.size(); } ///< 获取接收 iovec 数量
+
+    void setRecvError(const IOError& io_error) {
+        if (IOError::contains(io_error.code(), kDisconnectError)) {
+            m_http_error = HttpError(kConnectionClose);
+            return;
+        }
+        m_http_error = HttpError(kRecvError, io_error.message());
+    }
+
+#ifdef GALAY_HTTP_SSL_ENABLED
+    void setSslRecvError(const galay::ssl::SslError& error) {
+        if (error.code() == galay::ssl::SslErrorCode::kPeerClosed) {
+            m_http_error = HttpError(kConnectionClose);
+            return;
+        }
+        m_http_error = HttpError(kRecvError, error.message());
+    }
+#endif
+
+    void onPeerClosed() { m_http_error = HttpError(kConnectionClose); } ///< 对端关闭连接
+
+    void onBytesReceived(size_t recv_bytes) {
+        m_ring_buffer->produce(recv_bytes);
+        m_total_received += recv_bytes;
+    }
+
+    void setParseError(HttpError&& error) { m_http_error = std::move(error); } ///< 设置解析错误
+
+    ResultType takeResult() {
+        if (m_http_error.has_value()) {
+            return std::unexpected(std::move(*m_http_error));
+        }
+        return true;
+    }
+
+    RingBuffer* m_ring_buffer;                          ///< 环形缓冲区指针
+    const HttpReaderSetting* m_setting;                 ///< 读取器配置指针
+    HttpResponseHeader* m_header;                       ///< HTTP 响应头指针
+    size_t m_total_received = 0;                        ///< 已接收总字节数
+    std::vector<iovec> m_parse_iovecs;                  ///< 解析用 iovec 缓冲
+    BorrowedIovecs<2> m_write_iovecs;                   ///< 接收窗口 iovec
+    std::optional<HttpError> m_http_error;              ///< HTTP 解析错误
+};
+
+/**
+ * @brief 原始消息体读取状态
+ * @details 不解析内容，取出 RingBuffer 中已有的字节（至多 max_bytes）；
+ *          缓冲区为空时等待一次接收。消息边界由调用方判定。
+ */
+struct HttpBodyBytesReadState {
+    using ResultType = std::expected<bool, HttpError>; ///< 结果类型
+
+    /**
+     * @brief 构造函数
+     * @param ring_buffer 环形缓冲区引用
+     * @param out 读取到的字节追加到此处
+     * @param max_bytes 本次最多取出的字节数
+     */
+    HttpBodyBytesReadState(RingBuffer& ring_buffer, std::string& out, size_t max_bytes)
+        : m_ring_buffer(&ring_buffer)
+        , m_out(&out)
+        , m_max_bytes(max_bytes == 0 ? 1 : max_bytes) {}
+
+    /**
+     * @brief 从 RingBuffer 取出已接收的字节
+     * @return 取到数据返回 true，缓冲区为空返回 false
+     */
+    bool parseFromRingBuffer() {
+        auto read_iovecs = borrowReadIovecs(*m_ring_buffer);
+        size_t copied = 0;
+        for (const auto& iov : read_iovecs) {
+            if (copied >= m_max_bytes) {
+                break;
+            }
+            const size_t take = std::min(iov.iov_len, m_max_bytes - copied);
+            m_out->append(static_cast<const char*>(iov.iov_base), take);
+            copied += take;
+        }
+        if (copied == 0) {
+            return false;
+        }
+        m_ring_buffer->consume(copied);
+        return true;
+    }
+
+    bool prepareRecvWindow() {
+        m_write_iovecs = borrowWriteIovecs(*m_ring_buffer);
+        if (m_write_iovecs.empty()) {
+            setParseError(HttpError(kRecvError, "RingBuffer is full"));
+            return false;
+        }
+        return true;
+    }
+
+    bool prepareRecvWindow(char*& buffer, size_t& length) {
+        if (!prepareRecvWindow()) {
+            buffer = nullptr;
+            length = 0;
+            return false;
+        }
+        if (!IoVecWindow::bindFirstNonEmpty(m_write_iovecs, buffer, length)) {
+            setParseError(HttpError(kRecvError, "RingBuffer is full"));
+            return false;
+        }
+        return true;
+    }
+
+    const struct iovec* recvIovecsData() const { return m_write_iovecs.data(); } ///< 获取接收 iovec 数据指针
+    size_t recvIovecsCount() const { return m_write_iovecs.size(); } ///< 获取接收 iovec 数量
+
+    void setRecvError(const IOError& io_error) {
+        if (IOError::contains(io_error.code(), kDisconnectError)) {
+            m_http_error = HttpError(kConnectionClose);
+            return;
+        }
+        m_http_error = HttpError(kRecvError, io_error.message());
+    }
+
+#ifdef GALAY_HTTP_SSL_ENABLED
+    void setSslRecvError(const galay::ssl::SslError& error) {
+        if (error.code() == galay::ssl::SslErrorCode::kPeerClosed) {
+            m_peer_closed = true;
+            return;
+        }
+        m_http_error = HttpError(kRecvError, error.message());
+    }
+#endif
+
+    void onPeerClosed() { m_peer_closed = true; } ///< 对端关闭连接（以关闭界定消息体时的正常结束）
+    void onBytesReceived(size_t recv_bytes) { m_ring_buffer->produce(recv_bytes); } ///< 处理接收到的字节数
+    void setParseError(HttpError&& error) { m_http_error = std::move(error); } ///< 设置解析错误
+
+    /**
+     * @brief 获取读取结果
+     * @return 取到数据返回 true，对端已关闭且无数据返回 false，失败返回 HttpError
+     */
+    ResultType takeResult() {
+        if (m_http_error.has_value()) {
+            return std::unexpected(std::move(*m_http_error));
+        }
+        return !m_peer_closed;
+    }
+
+    RingBuffer* m_ring_buffer;                          ///< 环形缓冲区指针
+    std::string* m_out;                                 ///< 输出缓冲
+    size_t m_max_bytes;                                 ///< 单次最多取出的字节数
+    BorrowedIovecs<2> m_write_iovecs;                   ///< 接收窗口 iovec
+    std::optional<HttpError> m_http_error;              ///< 接收错误
+    bool m_peer_closed = false;                         ///< 对端是否已关闭
+};
+
 /**
  * @brief 构建异步读取操作
  * @tparam SocketType Socket 类型
@@ -699,6 +940,30 @@ public:
             std::make_shared<detail::HttpChunkReadState>(*m_ring_buffer, chunk_data));
     }
 
+    /**
+     * @brief 异步读取 HTTP 响应头，响应体留在缓冲区中
+     * @param header 待填充的响应头
+     * @return 可 co_await 的异步操作，成功返回 true，失败返回 HttpError
+     * @note 之后应以 getBodyBytes() 按响应头声明的分帧方式读取响应体
+     */
+    auto getResponseHeader(HttpResponseHeader& header) {
+        return detail::buildReadOperation(
+            *m_socket,
+            std::make_shared<detail::HttpResponseHeaderReadState>(*m_ring_buffer, m_setting, header));
+    }
+
+    /**
+     * @brief 异步读取一段原始消息体字节
+     * @param out 读取到的字节追加到此处
+     * @param max_bytes 最多读取的字节数（缓冲区已有数据时不再等待接收）
+     * @return 可 co_await 的异步操作，读到数据返回 true，对端关闭返回 false，失败返回 HttpError
+     */
+    auto getBodyBytes(std::string& out, size_t max_bytes) {
+        return detail::buildReadOperation(
+            *m_socket,
+            std::make_shared<detail::HttpBodyBytesReadState>(*m_ring_buffer, out, max_bytes));
+    }
+
 private:
     /**
      * @brief 获取可复用的请求读取状态（减少内存分配）
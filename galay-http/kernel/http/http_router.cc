@@ -4,9 +4,26 @@
 #include "file_descriptor.h"
 #include "http_etag.h"
 #include "http_range.h"
+#include "static_meta.h"
+#include "content_etag.h"
+#include "splice_pipe.h"
+#include "upstream_pool.h"
+#include "response_cache.h"
+#include "single_flight.h"
+#include "h2c_upstream.h"
+#include "body_framer.h"
+#include "proxy_headers.h"
+#include "socket_addr.h"
+#include "compute_offload.h"
+#include "galay-http/kernel/http2/h2c_client.h"
+#include "galay-kernel/common/sleep.hpp"
+#include "galay-kernel/concurrency/async_waiter.h"
 #include "galay-http/protoc/http/http_response.h"
 #include "galay-http/utils/rsp_bld.h"
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
 #include <array>
 #include <sstream>
 #include <set>
@@ -29,9 +46,36 @@ namespace galay::http
 
 namespace {
 
-constexpr size_t kProxyMaxIdleConnectionsPerUpstream = 32;
 constexpr size_t kProxyRawRelayBufferSize = 16 * 1024;
-thread_local std::unordered_map<std::string, std::vector<std::unique_ptr<HttpClient>>> g_proxyClientPools;
+/// Unix domain socket 上游监听队列已满时的连接次数与首次退避（之后逐次翻倍）
+constexpr int kUnixConnectAttempts = 4;
+constexpr std::chrono::milliseconds kUnixConnectBackoff{1};
+
+using ProxyClientPool = UpstreamConnectionPool<HttpClient>;
+using H2cUpstream = H2cUpstreamMux<galay::http2::H2cClient>;
+
+/**
+ * @brief 由一次 stat 结果构建静态文件元数据
+ * @details 启用内容 ETag 时，已就绪则直接使用；否则提交后台哈希并暂用 inode ETag
+ */
+std::shared_ptr<const StaticFileMeta> buildStaticFileMeta(std::string path,
+                                                          const struct stat& st,
+                                                          std::string mime,
+                                                          const StaticFileConfig& config)
+{
+    if (!config.isEnableContentETag()) {
+        return StaticFileMeta::fromStat(std::move(path), st, std::move(mime), config.isEnableETag());
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    const uint64_t inode = static_cast<uint64_t>(st.st_ino);
+    auto lookup = ContentETagStore::instance().request(path, inode, size, st.st_mtime);
+    const std::time_t mtime = st.st_mtime != 0 ? st.st_mtime : std::time(nullptr);
+    std::string etag = lookup.etag ? std::move(*lookup.etag)
+                                   : ETagGenerator::generateStrong(inode, size, mtime);
+    return StaticFileMeta::create(std::move(path), size, mtime, inode,
+                                  std::move(etag), std::move(mime), lookup.pending);
+}
 
 std::string toLowerAscii(std::string value) {
     std::transform(value.begin(), value.end(), value.begin(),
@@ -81,47 +125,6 @@ void removeHeaderPairLoose(HeaderPair& headers, const std::string& key) {
     }
 }
 
-std::string getHeaderValueLoose(const HeaderPair& headers, const std::string& key) {
-    return headers.getValue(key);
-}
-
-std::vector<std::string> splitConnectionTokens(const std::string& value) {
-    std::vector<std::string> tokens;
-    std::set<std::string> seen;
-    std::string current;
-
-    auto flush_token = [&]() {
-        size_t begin = 0;
-        while (begin < current.size() && std::isspace(static_cast<unsigned char>(current[begin]))) {
-            ++begin;
-        }
-
-        size_t end = current.size();
-        while (end > begin && std::isspace(static_cast<unsigned char>(current[end - 1]))) {
-            --end;
-        }
-
-        if (end > begin) {
-            std::string token = toLowerAscii(current.substr(begin, end - begin));
-            if (seen.insert(token).second) {
-                tokens.push_back(std::move(token));
-            }
-        }
-        current.clear();
-    };
-
-    for (char ch : value) {
-        if (ch == ',') {
-            flush_token();
-        } else {
-            current.push_back(ch);
-        }
-    }
-    flush_token();
-
-    return tokens;
-}
-
 std::string normalizeRoutePrefix(std::string routePrefix) {
     if (routePrefix.empty()) {
         return "/";
@@ -138,8 +141,25 @@ std::string normalizeRoutePrefix(std::string routePrefix) {
     return routePrefix;
 }
 
-std::string buildUpstreamKey(const std::string& host, uint16_t port) {
-    return host + ":" + std::to_string(port);
+/**
+ * @brief 上游实例的地址信息
+ * @details host 可以是 IPv4/IPv6 字面量或 `unix:/path`（此时端口被忽略）
+ */
+struct ProxyUpstreamTarget
+{
+    HttpSocketAddress address;
+    std::string key;            ///< 连接池键（地址规范文本）
+    std::string connect_url;    ///< connectProxyUpstream 的地址：`http://authority/` 或 `unix:/path`
+    std::string host_header;    ///< 发往上游的 Host
+};
+
+ProxyUpstreamTarget resolveUpstreamTarget(const UpstreamEndpoint& upstream) {
+    ProxyUpstreamTarget target;
+    target.address = HttpSocketAddress::parse(upstream.host, upstream.port);
+    target.key = target.address.authority();
+    target.connect_url = target.address.isUnix() ? target.key : "http://" + target.key + "/";
+    target.host_header = target.address.hostHeader();
+    return target;
 }
 
 std::string getClientIpFromConn(HttpConn& conn) {
@@ -166,26 +186,6 @@ std::string getClientIpFromConn(HttpConn& conn) {
     return "";
 }
 
-void applyForwardHeaders(HttpConn& conn, HeaderPair& headers, const std::string& original_host) {
-    const std::string client_ip = getClientIpFromConn(conn);
-    std::string xff = getHeaderValueLoose(headers, "X-Forwarded-For");
-
-    if (!client_ip.empty()) {
-        if (xff.empty()) {
-            xff = client_ip;
-        } else {
-            xff += ", " + client_ip;
-        }
-        headers.addHeaderPair("X-Forwarded-For", xff);
-        headers.addHeaderPair("X-Real-IP", client_ip);
-    }
-
-    headers.addHeaderPair("X-Forwarded-Proto", "http");
-    if (!original_host.empty()) {
-        headers.addHeaderPair("X-Forwarded-Host", original_host);
-    }
-}
-
 std::string rewriteProxyUri(const std::string& routePrefix, const std::string& requestUri) {
     if (requestUri.empty()) {
         return "/";
@@ -216,31 +216,36 @@ std::string rewriteProxyUri(const std::string& routePrefix, const std::string& r
     return requestUri;
 }
 
-bool isLikelyStreamingRequest(const std::string& uri, const HeaderPair& headers)
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle)
 {
-    const std::string accept = toLowerAscii(getHeaderValueLoose(headers, "Accept"));
-    if (accept.find("text/event-stream") != std::string::npos) {
-        return true;
+    if (needle.size() > haystack.size()) {
+        return false;
     }
-
-    const std::string content_type = toLowerAscii(getHeaderValueLoose(headers, "Content-Type"));
-    if (content_type.find("text/event-stream") != std::string::npos) {
-        return true;
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (detail::equalsIgnoreCaseAscii(haystack.substr(i, needle.size()), needle)) {
+            return true;
+        }
     }
+    return false;
+}
 
-    const std::string proxy_stream = toLowerAscii(getHeaderValueLoose(headers, "X-Proxy-Stream"));
-    if (proxy_stream == "1" || proxy_stream == "true" || proxy_stream == "yes") {
+bool isLikelyStreamingRequest(std::string_view uri, const ProxyRequestHeaders& headers)
+{
+    if (containsIgnoreCase(headers.accept(), "text/event-stream") ||
+        containsIgnoreCase(headers.contentType(), "text/event-stream")) {
         return true;
     }
 
-    const std::string lower_uri = toLowerAscii(uri);
-    if (lower_uri.find("/stream") != std::string::npos ||
-        lower_uri.find("stream=true") != std::string::npos ||
-        lower_uri.find("stream=1") != std::string::npos) {
+    const std::string_view proxy_stream = headers.proxyStream();
+    if (detail::equalsIgnoreCaseAscii(proxy_stream, "1") ||
+        detail::equalsIgnoreCaseAscii(proxy_stream, "true") ||
+        detail::equalsIgnoreCaseAscii(proxy_stream, "yes")) {
         return true;
     }
 
-    return false;
+    return containsIgnoreCase(uri, "/stream") ||
+           containsIgnoreCase(uri, "stream=true") ||
+           containsIgnoreCase(uri, "stream=1");
 }
 
 Task<void> sendProxyError(HttpConn& conn, HttpStatusCode code, const std::string& message) {
@@ -250,44 +255,1176 @@ Task<void> sendProxyError(HttpConn& conn, HttpStatusCode code, const std::string
         .text(message)
         .buildMove();
 
-    auto writer = conn.getWriter();
+    auto writer = conn.getWriter();
+    while (true) {
+        auto result = co_await writer.sendResponse(response);
+        if (!result || result.value()) {
+            break;
+        }
+    }
+    co_return;
+}
+
+/**
+ * @brief 连接 Unix domain socket 上游
+ * @details 非阻塞 connect 在对端监听队列满时返回 EAGAIN，此时让出调度器退避后重试，
+ *          不阻塞同一 IO 线程上的其他连接
+ */
+template <typename Client>
+Task<void> connectUnixUpstream(Client& client, const std::string& path, std::string& err_msg)
+{
+    err_msg.clear();
+    for (int attempt = 1;; ++attempt) {
+        auto connect_result = client.connectUnix(path);
+        if (connect_result) {
+            err_msg.clear();
+            co_return;
+        }
+        err_msg = std::move(connect_result.error().message);
+        if (!connect_result.error().retryable || attempt >= kUnixConnectAttempts) {
+            co_return;
+        }
+        co_await galay::kernel::sleep(kUnixConnectBackoff * (1 << (attempt - 1)));
+    }
+}
+
+Task<void> connectProxyUpstream(HttpClient& client,
+                                const std::string& url,
+                                bool& ok,
+                                std::string& err_msg)
+{
+    ok = false;
+    err_msg.clear();
+
+    try {
+        if (url.starts_with(HttpSocketAddress::kUnixPrefix)) {
+            co_await connectUnixUpstream(client, url.substr(HttpSocketAddress::kUnixPrefix.size()), err_msg);
+            ok = err_msg.empty();
+            co_return;
+        }
+        auto connect_result = co_await client.connect(url);
+        if (!connect_result) {
+            err_msg = connect_result.error().message();
+            co_return;
+        }
+        ok = true;
+    } catch (const std::exception& ex) {
+        err_msg = ex.what();
+    } catch (...) {
+        err_msg = "unknown exception";
+    }
+
+    co_return;
+}
+
+/**
+ * @brief 在当前调度器上启动后台协程，不等待其完成
+ * @details 与 HTTP/2 的 startDetachedTask 相同，但调度失败时返回 false 而不抛异常，
+ *          由调用方决定是否降级
+ */
+class SpawnOnCurrentSchedulerAwaitable
+{
+public:
+    explicit SpawnOnCurrentSchedulerAwaitable(Task<void>&& task) noexcept
+        : m_task(std::move(task))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        auto* scheduler = handle.promise().taskRefView().belongScheduler();
+        m_spawned = scheduler != nullptr && scheduleTask(scheduler, std::move(m_task));
+        return false;
+    }
+
+    bool await_resume() const noexcept { return m_spawned; }
+
+private:
+    Task<void> m_task;
+    bool m_spawned = false;
+};
+
+/**
+ * @brief 获取当前协程所属的调度器
+ */
+class CurrentSchedulerAwaitable
+{
+public:
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        m_scheduler = handle.promise().taskRefView().belongScheduler();
+        return false;
+    }
+
+    Scheduler* await_resume() const noexcept { return m_scheduler; }
+
+private:
+    Scheduler* m_scheduler = nullptr;
+};
+
+/**
+ * @brief 关闭连接池丢弃或回收的上游连接
+ * @details 调用方已主动 close 的连接 fd 为 -1，此处跳过；未建连的客户端没有 socket
+ */
+Task<void> closeProxyUpstream(ProxyClientPool::ClientPtr client)
+{
+    auto socket = client->releaseSocket();
+    if (socket && socket->handle().fd >= 0) {
+        co_await socket->close();
+    }
+    co_return;
+}
+
+/**
+ * @brief 在当前调度器上安装连接池回收回调（每线程一次）
+ */
+Task<void> ensureProxyPoolRetireHook()
+{
+    auto& pool = ProxyClientPool::local();
+    if (pool.hasRetireHook()) {
+        co_return;
+    }
+    Scheduler* scheduler = co_await CurrentSchedulerAwaitable();
+    pool.setRetireHook([scheduler](ProxyClientPool::ClientPtr client) {
+        if (scheduler != nullptr) {
+            scheduleTask(scheduler, closeProxyUpstream(std::move(client)));
+        }
+    });
+    co_return;
+}
+
+/**
+ * @brief 周期性回收本线程连接池中的超时空闲连接，池空后退出
+ */
+Task<void> runProxyPoolEvictor()
+{
+    auto& pool = ProxyClientPool::local();
+    while (true) {
+        co_await galay::kernel::sleep(pool.evictionInterval());
+        if (pool.evictExpired() == 0) {
+            break;
+        }
+    }
+    pool.setEvictorRunning(false);
+    co_return;
+}
+
+/**
+ * @brief 后台建立预热连接，成功后放入空闲队列
+ */
+Task<void> warmProxyConnections(std::vector<ProxyClientPool::Handle> handles, std::string url)
+{
+    auto& pool = ProxyClientPool::local();
+    for (auto& handle : handles) {
+        bool ok = false;
+        std::string err;
+        co_await connectProxyUpstream(*handle, url, ok, err);
+        if (!ok) {
+            HTTP_LOG_WARN("[proxy] [warm-fail]", "upstream={} error={}", handle.key(), err);
+            break;
+        }
+        pool.release(std::move(handle));
+    }
+    co_return;
+}
+
+/**
+ * @brief 按需启动预热与空闲回收
+ * @details 预热连接在启动前即已计入连接总数，避免并发请求重复预热
+ */
+Task<void> maintainProxyPool(const std::string& pool_key, const std::string& url)
+{
+    auto& pool = ProxyClientPool::local();
+    if (const size_t deficit = pool.warmDeficit(pool_key); deficit > 0) {
+        std::vector<ProxyClientPool::Handle> handles;
+        handles.reserve(deficit);
+        for (size_t i = 0; i < deficit; ++i) {
+            handles.push_back(pool.reserveWarm(pool_key));
+        }
+        co_await SpawnOnCurrentSchedulerAwaitable(warmProxyConnections(std::move(handles), url));
+    }
+    if (pool.needsEvictor()) {
+        pool.setEvictorRunning(true);
+        if (!co_await SpawnOnCurrentSchedulerAwaitable(runProxyPoolEvictor())) {
+            pool.setEvictorRunning(false);
+        }
+    }
+    co_return;
+}
+
+/// 参与 single-flight 键的内容协商请求头；响应 Vary 超出此范围时不共享
+constexpr std::array<std::string_view, 3> kSingleFlightKeyHeaders = {
+    "accept", "accept-encoding", "accept-language"
+};
+
+/**
+ * @brief 请求是否可参与合并（不携带用户凭据）
+ */
+bool isSingleFlightEligible(const HeaderPair& headers)
+{
+    return SharedResponseHeader::findHeaderValue(headers, "authorization").empty() &&
+           SharedResponseHeader::findHeaderValue(headers, "cookie").empty();
+}
+
+std::string buildSingleFlightKey(const std::string& primary, const HeaderPair& headers)
+{
+    std::string key = primary;
+    for (const auto name : kSingleFlightKeyHeaders) {
+        key.push_back('\x1f');
+        key.append(SharedResponseHeader::findHeaderValue(headers, name));
+    }
+    return key;
+}
+
+/**
+ * @brief 将上游响应转为可共享的预序列化结果，不可共享时返回空
+ */
+SingleFlight::Result buildSingleFlightResult(HttpResponse& response)
+{
+    if (response.header().isChunked()) {
+        return nullptr;
+    }
+    SharedResponseHeader shared(response.header());
+    if (shared.isPrivate()) {
+        return nullptr;
+    }
+    for (const auto& name : SharedResponseHeader::splitHeaderList(shared.vary)) {
+        if (std::find(kSingleFlightKeyHeaders.begin(), kSingleFlightKeyHeaders.end(), name) ==
+            kSingleFlightKeyHeaders.end()) {
+            return nullptr;
+        }
+    }
+    return std::make_shared<const std::string>(shared.serialize(response.bodyStr()));
+}
+
+/**
+ * @brief 在等待者所在调度器上唤醒它
+ */
+Task<void> notifySingleFlightWaiter(std::shared_ptr<galay::kernel::AsyncWaiter<void>> waiter)
+{
+    waiter->notify();
+    co_return;
+}
+
+/**
+ * @brief 计算路由：在计算调度器上生成响应，回到 IO 调度器发送
+ */
+Task<void> runComputeRoute(std::shared_ptr<const HttpComputeHandler> handler, HttpConn& conn, HttpRequest req)
+{
+    std::optional<HttpResponse> response;
+    try {
+        response.emplace(co_await offload([&handler, &req] { return (*handler)(req); }));
+    } catch (const std::exception& ex) {
+        HTTP_LOG_ERROR("[route] [compute]", "uri={} error={}", req.header().uri(), ex.what());
+    } catch (...) {
+        HTTP_LOG_ERROR("[route] [compute]", "uri={} error=unknown exception", req.header().uri());
+    }
+    if (!response) {
+        response.emplace(Http1_1ResponseBuilder()
+            .status(HttpStatusCode::InternalServerError_500)
+            .text("Internal Server Error")
+            .buildMove());
+    }
+
+    auto writer = conn.getWriter();
+    while (true) {
+        auto result = co_await writer.sendResponse(*response);
+        if (!result || result.value()) {
+            break;
+        }
+    }
+    co_return;
+}
+
+/**
+ * @brief 为请求绑定选中的上游实例：Host、Connection 与转发头的取值
+ * @param upstream_host 上游 Host 取值（Unix domain socket 上游为 localhost）
+ */
+ProxyForwarding bindProxyUpstream(std::string_view client_ip, std::string_view upstream_host, ProxyMode mode)
+{
+    ProxyForwarding forwarding;
+    forwarding.client_ip = client_ip;
+    forwarding.upstream_host = upstream_host;
+    forwarding.connection = mode == ProxyMode::Raw ? "close" : "keep-alive";
+    return forwarding;
+}
+
+/**
+ * @brief 序列化发往 HTTP/1.1 上游的请求头，客户端请求头不被修改
+ */
+void buildUpstreamRequestHead(std::string& out,
+                              HttpRequest& req,
+                              const ProxyRequestHeaders& headers,
+                              const ProxyForwarding& forwarding)
+{
+    out.clear();
+    headers.appendUpstreamRequest(out, req.header(), forwarding, req.bodyStr().size());
+}
+
+/**
+ * @brief 在借出的上游连接上完成一次请求/响应交换
+ * @param head 已序列化的上游请求头，body 为请求体，二者需存活到交换结束
+ * @param failure 成功时为 nullptr，失败时为下游错误描述（连接已关闭）
+ * @param cancelled 非空且为 true 时表示已被对冲取消，不再重试
+ * @param body_session 非空时只读取响应头，并交出缓冲区中留有未读响应体的会话供流式转发
+ * @details 复用连接收发失败时视为陈旧连接，换新连接重试一次
+ */
+Task<void> exchangeProxyRequest(ProxyClientPool::Handle& client,
+                                std::string_view head,
+                                std::string_view body,
+                                const std::string& pool_key,
+                                const std::string& url,
+                                HttpResponse& response,
+                                const char*& failure,
+                                const bool* cancelled = nullptr,
+                                std::unique_ptr<HttpSession>* body_session = nullptr)
+{
+    auto& pool = ProxyClientPool::local();
+    bool retried = false;
+    failure = nullptr;
+
+    const bool header_only = body_session != nullptr;
+    while (true) {
+        // 会话持有接收缓冲区，流式转发时响应头之后已收到的字节留在其中，必须交给调用方继续读取
+        auto session = std::make_unique<HttpSession>(client->socket());
+        auto& upstream_writer = session->getWriter();
+        bool send_ok = false;
+        while (true) {
+            auto send_result = co_await upstream_writer.sendRequestView(head, body);
+            if (!send_result) {
+                HTTP_LOG_WARN("[proxy] [send-fail]",
+                              "error={}",
+                              send_result.error().message());
+                break;
+            }
+            if (send_result.value()) {
+                send_ok = true;
+                break;
+            }
+        }
+
+        bool recv_ok = false;
+        if (send_ok) {
+            auto& upstream_reader = session->getReader();
+            response.reset();
+            while (!header_only) {
+                auto recv_result = co_await upstream_reader.getResponse(response);
+                if (!recv_result) {
+                    HTTP_LOG_WARN("[proxy] [recv-fail]",
+                                  "error={}",
+                                  recv_result.error().message());
+                    break;
+                }
+                if (recv_result.value()) {
+                    recv_ok = true;
+                    break;
+                }
+            }
+            if (header_only) {
+                auto recv_result = co_await upstream_reader.getResponseHeader(response.header());
+                if (!recv_result) {
+                    HTTP_LOG_WARN("[proxy] [recv-fail]",
+                                  "error={}",
+                                  recv_result.error().message());
+                } else {
+                    recv_ok = true;
+                }
+            }
+        }
+        if (recv_ok) {
+            if (header_only) {
+                *body_session = std::move(session);
+            }
+            co_return;
+        }
+
+        failure = send_ok ? "Bad Gateway: recv upstream failed"
+                          : "Bad Gateway: send upstream failed";
+        co_await client->close();
+        if (!client.reused() || retried || (cancelled != nullptr && *cancelled)) {
+            co_return;
+        }
+
+        retried = true;
+        pool.noteStaleRetry(pool_key);
+        client.renew();
+        bool reconnect_ok = false;
+        std::string reconnect_err;
+        co_await connectProxyUpstream(*client, url, reconnect_ok, reconnect_err);
+        if (!reconnect_ok) {
+            HTTP_LOG_ERROR("[proxy] [reconnect-fail]", "error={}", reconnect_err);
+            co_return;
+        }
+        failure = nullptr;
+    }
+}
+
+/**
+ * @brief 上游响应是否允许继续复用连接
+ */
+bool isReusableUpstreamResponse(HttpResponse& response)
+{
+    return response.header().isKeepAlive() && !response.header().isConnectionClose();
+}
+
+/**
+ * @brief 流式转发的结果
+ */
+struct ProxyStreamOutcome
+{
+    bool started = false;           ///< 响应头已写往下游（之后出错只能中断下游连接）
+    bool upstream_complete = false; ///< 上游响应体完整结束
+    bool upstream_reusable = false; ///< 上游连接可归还连接池
+    bool downstream_ok = false;     ///< 下游完整收到响应
+    uint64_t body_bytes = 0;        ///< 转发的响应体字节数
+};
+
+/**
+ * @brief 边收边转发上游响应体
+ * @param upstream_session 读取响应头所用的会话，其接收缓冲区中可能已有响应体字节
+ * @param header 已读取的上游响应头；以连接关闭界定的消息体改用 chunked 转发
+ * @details 每轮从上游连接缓冲区取至多 buffer_size 字节，写完下游后才读下一轮：
+ *          下游慢时上游 socket 不再被读取，由 TCP 流控向上游施加背压，
+ *          单个请求的内存占用与响应体大小无关。
+ *          响应头与首段响应体合并为一次发送；chunked 响应体原样透传。
+ */
+Task<void> streamProxyResponse(HttpConn& conn,
+                               HttpSession& upstream_session,
+                               HttpResponseHeader& header,
+                               bool head_request,
+                               const ProxyStreamingConfig& config,
+                               ProxyStreamOutcome& outcome)
+{
+    outcome = ProxyStreamOutcome{};
+    HttpBodyFramer framer = HttpBodyFramer::forResponse(header, head_request);
+    if (framer.failed()) {
+        HTTP_LOG_WARN("[proxy] [stream-invalid]", "code={}", static_cast<int>(header.code()));
+        co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
+                                "Bad Gateway: invalid upstream response");
+        co_return;
+    }
+    const bool rechunk = framer.framing() == HttpBodyFraming::UntilClose;
+    if (rechunk) {
+        removeHeaderPairLoose(header.headerPairs(), "Transfer-Encoding");
+        removeHeaderPairLoose(header.headerPairs(), "Content-Length");
+        header.headerPairs().addHeaderPair("Transfer-Encoding", "chunked");
+    }
+
+    auto& upstream_reader = upstream_session.getReader();
+    auto downstream_writer = conn.getWriter();
+    const size_t buffer_size = std::max<size_t>(config.buffer_size, 1);
+    std::string wire = header.toString();
+    std::string piece;
+    bool trailing_bytes = false;
+
+    while (true) {
+        bool last = framer.done();
+        if (!last) {
+            // 透传时直接读到待发送缓冲尾部，chunked 改写时读到临时缓冲再封装
+            std::string& target = rechunk ? piece : wire;
+            const size_t offset = target.size();
+            auto read_result = co_await upstream_reader.getBodyBytes(target, framer.nextReadSize(buffer_size));
+            if (!read_result) {
+                HTTP_LOG_WARN("[proxy] [stream-recv-fail]", "error={}", read_result.error().message());
+                break;
+            }
+            if (!read_result.value()) {
+                if (!framer.onClose()) {
+                    HTTP_LOG_WARN("[proxy] [stream-truncated]", "bytes={}", outcome.body_bytes);
+                    break;
+                }
+                last = true;
+            } else {
+                const size_t received = target.size() - offset;
+                const size_t accepted = framer.feed(std::string_view(target).substr(offset));
+                if (framer.failed()) {
+                    HTTP_LOG_WARN("[proxy] [stream-bad-chunk]", "bytes={}", outcome.body_bytes);
+                    break;
+                }
+                if (accepted < received) {
+                    // 上游在本条响应之后多发了字节，连接不可再复用
+                    trailing_bytes = true;
+                    target.resize(offset + accepted);
+                }
+                outcome.body_bytes += accepted;
+                last = framer.done();
+            }
+            if (rechunk) {
+                if (!piece.empty()) {
+                    wire += Chunk::toChunk(piece.data(), piece.size(), false);
+                    piece.clear();
+                }
+                if (last) {
+                    wire += Chunk::toChunk(nullptr, 0, true);
+                }
+            }
+        }
+
+        if (!wire.empty()) {
+            bool sent = false;
+            while (true) {
+                auto send_result = co_await downstream_writer.sendView(wire);
+                if (!send_result) {
+                    HTTP_LOG_ERROR("[proxy] [forward-fail]",
+                                   "error={}",
+                                   send_result.error().message());
+                    break;
+                }
+                if (send_result.value()) {
+                    sent = true;
+                    break;
+                }
+            }
+            if (!sent) {
+                co_return;
+            }
+            outcome.started = true;
+            wire.clear();
+        }
+        if (last) {
+            outcome.upstream_complete = true;
+            outcome.downstream_ok = true;
+            outcome.upstream_reusable = !trailing_bytes && !rechunk &&
+                                        header.isKeepAlive() && !header.isConnectionClose();
+            co_return;
+        }
+    }
+
+    // 上游中途失败：响应头已发出时只能中断下游连接，让客户端感知截断
+    if (outcome.started) {
+        const int fd = conn.getSocket().handle().fd;
+        if (fd >= 0) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    } else {
+        co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
+                                "Bad Gateway: recv upstream failed");
+    }
+    co_return;
+}
+
+/**
+ * @brief 探测共享的 h2c 连接
+ * @return 对端允许的并发 stream 数；连接已停止或收到 GOAWAY 时返回 0
+ */
+uint32_t probeH2cUpstream(galay::http2::H2cClient& client)
+{
+    auto* h2_conn = client.getConn();
+    if (!client.isUpgraded() || h2_conn == nullptr || h2_conn->streamManager() == nullptr ||
+        !h2_conn->streamManager()->isRunning() || h2_conn->isGoawayReceived()) {
+        return 0;
+    }
+    return std::max<uint32_t>(h2_conn->peerSettings().max_concurrent_streams, 1);
+}
+
+/**
+ * @brief 关闭已从多路复用表摘除的 h2c 连接
+ */
+Task<void> shutdownH2cUpstream(H2cUpstream::ClientPtr client)
+{
+    auto result = co_await client->shutdown();
+    if (!result) {
+        HTTP_LOG_DEBUG("[proxy] [h2c-shutdown-fail]", "error={}", result.error().toString());
+    }
+    co_return;
+}
+
+/**
+ * @brief 在当前调度器上安装 h2c 连接回收回调（每线程一次）
+ */
+Task<void> ensureH2cRetireHook()
+{
+    auto& mux = H2cUpstream::local();
+    if (mux.hasRetireHook()) {
+        co_return;
+    }
+    Scheduler* scheduler = co_await CurrentSchedulerAwaitable();
+    mux.setRetireHook([scheduler](H2cUpstream::ClientPtr client) {
+        if (scheduler != nullptr) {
+            scheduleTask(scheduler, shutdownH2cUpstream(std::move(client)));
+        }
+    });
+    co_return;
+}
+
+/**
+ * @brief 由 HTTP/1.1 请求构建 h2 请求头
+ * @details 路径取自 HTTP/1.1 请求行，保证与 Http1 上游收到的编码一致；
+ *          上游 Host 作为 :authority，连接级头部在 HTTP/2 中非法，已在分类时丢弃
+ */
+std::vector<galay::http2::Http2HeaderField> buildH2cRequestHeaders(HttpRequest& req,
+                                                                   const ProxyRequestHeaders& headers,
+                                                                   const ProxyForwarding& forwarding)
+{
+    std::string request_line;
+    req.header().appendRequestLine(request_line);
+    const size_t path_begin = request_line.find(' ') + 1;
+    const size_t path_end = request_line.find(' ', path_begin);
+
+    std::vector<galay::http2::Http2HeaderField> fields;
+    fields.emplace_back(":method", httpMethodToString(req.header().method()));
+    fields.emplace_back(":scheme", "http");
+    fields.emplace_back(":authority", std::string(forwarding.upstream_host));
+    fields.emplace_back(":path", request_line.substr(path_begin, path_end - path_begin));
+    headers.forEachUpstreamHeader(forwarding, [&fields](std::string_view key, std::string_view value) {
+        fields.emplace_back(toLowerAscii(std::string(key)), std::string(value));
+    });
+    return fields;
+}
+
+/**
+ * @brief 将 h2 响应转为 HTTP/1.1 响应，交给缓存、合并与下游转发复用
+ */
+void fillResponseFromH2c(galay::http2::Http2Response& h2_response, HttpResponse& response)
+{
+    response.reset();
+    response.header().version() = HttpVersion::HttpVersion_1_1;
+    response.header().code() = static_cast<HttpStatusCode>(h2_response.status);
+    for (auto& field : h2_response.headers) {
+        if (field.name.empty() || field.name[0] == ':' || field.name == "content-length" ||
+            SharedResponseHeader::isHopByHopHeader(field.name)) {
+            continue;
+        }
+        response.header().headerPairs().addHeaderPair(field.name, field.value);
+    }
+    response.setBodyStr(std::move(h2_response.body));
+}
+
+/**
+ * @brief 在共享的 h2c 连接上完成一次请求/响应交换
+ * @param upstream_lease 本请求的上游记账；本地连接数达到上限时放弃记账，不计为上游失败
+ * @param failure 成功时为 nullptr，失败时为下游错误描述，failure_code 为对应状态码
+ * @param started 非空时写入已发出的 stream，供对冲取消使用
+ * @details 名额由线程局部的多路复用表分配：本请求负责建连时完成 connect + upgrade，
+ *          连接仍在建立中时挂起等待，不做重试（请求可能已在上游执行）
+ */
+Task<void> exchangeH2cRequest(const UpstreamEndpoint& upstream,
+                              const std::string& upstream_key,
+                              const H2cUpstreamConfig& config,
+                              HttpRequest& req,
+                              const ProxyRequestHeaders& headers,
+                              const ProxyForwarding& forwarding,
+                              UpstreamGroup::Lease& upstream_lease,
+                              HttpResponse& response,
+                              HttpStatusCode& failure_code,
+                              const char*& failure,
+                              galay::http2::Http2Stream::ptr* started = nullptr)
+{
+    failure_code = HttpStatusCode::BadGateway_502;
+    failure = nullptr;
+    co_await ensureH2cRetireHook();
+
+    auto lease = H2cUpstream::local().acquire(upstream_key, config, probeH2cUpstream);
+    if (!lease) {
+        HTTP_LOG_WARN("[proxy] [h2c-exhausted]", "upstream={}", upstream_key);
+        upstream_lease.abandon();
+        failure_code = HttpStatusCode::ServiceUnavailable_503;
+        failure = "Service Unavailable: upstream connection limit reached";
+        co_return;
+    }
+
+    if (lease.connector()) {
+        const auto address = HttpSocketAddress::parse(upstream.host, upstream.port);
+        std::string connect_error;
+        if (address.isUnix()) {
+            co_await connectUnixUpstream(*lease, address.host, connect_error);
+        } else {
+            auto connect_result = co_await lease->connect(upstream.host, upstream.port);
+            if (!connect_result) {
+                connect_error = connect_result.error().message();
+            }
+        }
+        if (!connect_error.empty()) {
+            HTTP_LOG_ERROR("[proxy] [h2c-connect-fail]", "upstream={} error={}",
+                           upstream_key, connect_error);
+            lease.failed();
+        } else {
+            auto upgrade_result = co_await lease->upgrade("/");
+            if (!upgrade_result) {
+                HTTP_LOG_ERROR("[proxy] [h2c-upgrade-fail]", "upstream={} error={}",
+                               upstream_key, upgrade_result.error().toString());
+                lease.failed();
+            } else {
+                lease.established(probeH2cUpstream(*lease));
+            }
+        }
+    } else if (lease.pending()) {
+        auto waiter = std::make_shared<galay::kernel::AsyncWaiter<void>>();
+        if (lease.subscribe([waiter]() { waiter->notify(); })) {
+            co_await waiter->wait();
+        }
+    }
+    if (!lease.usable()) {
+        failure = "Bad Gateway: connect upstream failed";
+        co_return;
+    }
+
+    auto* manager = lease->getConn()->streamManager();
+    auto stream = manager->allocateStream();
+    if (!stream) {
+        lease.retire();
+        failure = "Bad Gateway: send upstream failed";
+        co_return;
+    }
+    if (started != nullptr) {
+        *started = stream;
+    }
+    std::string body = req.getBodyStr();
+    stream->sendHeaders(buildH2cRequestHeaders(req, headers, forwarding), body.empty(), true);
+    if (!body.empty()) {
+        stream->sendData(std::move(body), true);
+    }
+
+    bool finished = false;
+    bool broken = false;
+    while (!finished && !broken) {
+        auto frames = co_await stream->getFrames(16);
+        if (!frames) {
+            broken = true;
+            break;
+        }
+        for (auto& frame : frames.value()) {
+            if (!frame) {
+                broken = true;
+                break;
+            }
+            if ((frame->isHeaders() || frame->isData()) && frame->isEndStream()) {
+                finished = true;
+                break;
+            }
+        }
+    }
+    if (!finished) {
+        HTTP_LOG_WARN("[proxy] [h2c-recv-fail]", "upstream={}", upstream_key);
+        if (!manager->isRunning()) {
+            lease.retire();
+        }
+        failure = "Bad Gateway: recv upstream failed";
+        co_return;
+    }
+
+    fillResponseFromH2c(stream->response(), response);
+    co_return;
+}
+
+/**
+ * @brief stale-while-revalidate 后台刷新：重新回源并更新缓存
+ * @param req 已改写为上游 URI 的客户端请求副本（头部保持原样）
+ * @param client_ip 客户端地址，用于生成转发头
+ */
+Task<void> refreshProxyCache(UpstreamGroup::ptr upstreams,
+                             HttpRequest req,
+                             std::string client_ip,
+                             std::string cache_key,
+                             ResponseCache::EntryPtr stale)
+{
+    const UpstreamGroup::Pick upstream_pick = upstreams->select();
+    const UpstreamEndpoint& upstream = upstreams->endpoint(upstream_pick.index);
+    UpstreamGroup::Lease upstream_lease(*upstreams, upstream_pick);
+    const ProxyUpstreamTarget target = resolveUpstreamTarget(upstream);
+    const std::string& pool_key = target.key;
+    const std::string& url = target.connect_url;
+    ProxyRequestHeaders proxy_headers;
+    proxy_headers.scan(req.header().headerPairs());
+    const ProxyForwarding forwarding = bindProxyUpstream(client_ip, target.host_header, ProxyMode::Http);
+
+    if (upstreams->config().protocol == UpstreamProtocol::H2c) {
+        HttpResponse response;
+        HttpStatusCode failure_code = HttpStatusCode::BadGateway_502;
+        const char* failure = nullptr;
+        co_await exchangeH2cRequest(upstream, pool_key, upstreams->config().h2c, req,
+                                    proxy_headers, forwarding, upstream_lease, response, failure_code, failure);
+        if (failure != nullptr) {
+            HTTP_LOG_WARN("[proxy] [cache-refresh-fail]", "upstream={} error={}", pool_key, failure);
+        } else {
+            upstream_lease.finish(static_cast<int>(response.header().code()) < 500);
+            ResponseCache::local().store(cache_key, req.header().headerPairs(), response.header(),
+                                         response.bodyStr(), upstreams->config().cache);
+        }
+        ResponseCache::finishRefresh(stale);
+        co_return;
+    }
+
+    co_await ensureProxyPoolRetireHook();
+    auto& pool = ProxyClientPool::local();
+    auto client = pool.acquire(pool_key, upstreams->config().pool);
+    if (!client) {
+        upstream_lease.abandon();
+        ResponseCache::finishRefresh(stale);
+        co_return;
+    }
+    if (!client.reused()) {
+        bool connect_ok = false;
+        std::string connect_err;
+        co_await connectProxyUpstream(*client, url, connect_ok, connect_err);
+        if (!connect_ok) {
+            HTTP_LOG_WARN("[proxy] [cache-refresh-fail]", "upstream={} error={}", pool_key, connect_err);
+            ResponseCache::finishRefresh(stale);
+            co_return;
+        }
+    }
+
+    ProxyHeadBuffer head;
+    buildUpstreamRequestHead(head.get(), req, proxy_headers, forwarding);
+    HttpResponse response;
+    const char* failure = nullptr;
+    co_await exchangeProxyRequest(client, head.get(), req.bodyStr(), pool_key, url, response, failure);
+    if (failure != nullptr) {
+        HTTP_LOG_WARN("[proxy] [cache-refresh-fail]", "upstream={} error={}", pool_key, failure);
+        ResponseCache::finishRefresh(stale);
+        co_return;
+    }
+    upstream_lease.finish(static_cast<int>(response.header().code()) < 500);
+
+    ResponseCache::local().store(cache_key, req.header().headerPairs(), response.header(),
+                                 response.bodyStr(), upstreams->config().cache);
+    ResponseCache::finishRefresh(stale);
+
+    if (isReusableUpstreamResponse(response)) {
+        pool.release(std::move(client));
+    } else {
+        co_await client->close();
+    }
+    co_return;
+}
+
+/**
+ * @brief 一次对冲竞速的共享状态
+ * @details 主请求、对冲请求与计时器都在发起请求的调度器上运行，无需加锁；
+ *          后完成的一方在处理器返回后仍持有该状态，自行清理连接
+ */
+struct HedgeRace
+{
+    static constexpr int kAttempts = 2;
+
+    int launched = 0;                                   ///< 已发出的尝试数
+    int finished = 0;                                   ///< 已结束的尝试数
+    int winner = -1;                                    ///< 胜出的尝试下标
+    bool timer_fired = false;                           ///< 对冲延迟已到
+    bool cancelled[kAttempts] = {false, false};         ///< 被取消的尝试
+    bool done[kAttempts] = {false, false};              ///< 已结束的尝试
+    ProxyClientPool::Handle* clients[kAttempts] = {nullptr, nullptr};   ///< 进行中的 HTTP/1.1 连接
+    galay::http2::Http2Stream::ptr streams[kAttempts];  ///< 进行中的 h2c stream
+    HttpResponse response;                              ///< 胜出的响应
+    HttpStatusCode failure_code = HttpStatusCode::BadGateway_502;
+    const char* failure = "Bad Gateway: upstream request failed";
+    std::shared_ptr<galay::kernel::AsyncWaiter<void>> waiter;
+
+    /**
+     * @brief 唤醒等待中的处理器（每次等待只唤醒一次）
+     */
+    void wake()
+    {
+        if (waiter) {
+            auto w = std::move(waiter);
+            waiter.reset();
+            w->notify();
+        }
+    }
+
+    /**
+     * @brief 取消仍在进行的尝试
+     * @details HTTP/1.1 关闭套接字读写，使挂起的收发立即失败；h2c 发送 RST_STREAM 并结束帧队列
+     */
+    void cancel(int slot)
+    {
+        if (done[slot] || cancelled[slot]) {
+            return;
+        }
+        cancelled[slot] = true;
+        if (clients[slot] != nullptr && *clients[slot]) {
+            const int fd = (*clients[slot])->socket().handle().fd;
+            if (fd >= 0) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+        if (streams[slot]) {
+            streams[slot]->sendRstStream(galay::http2::Http2ErrorCode::Cancel);
+            streams[slot]->closeFrameQueue();
+        }
+    }
+};
+
+/**
+ * @brief 竞速中的一次上游尝试
+ * @param req 已改写为上游 URI 的客户端请求副本（头部保持原样）
+ * @param client_ip 客户端地址，用于生成转发头
+ */
+Task<void> runProxyAttempt(std::shared_ptr<HedgeRace> race,
+                           int slot,
+                           UpstreamGroup::ptr upstreams,
+                           UpstreamGroup::Pick upstream_pick,
+                           HttpRequest req,
+                           std::string client_ip)
+{
+    const UpstreamGroupConfig& config = upstreams->config();
+    const UpstreamEndpoint& upstream = upstreams->endpoint(upstream_pick.index);
+    UpstreamGroup::Lease upstream_lease(*upstreams, upstream_pick);
+    const ProxyUpstreamTarget target = resolveUpstreamTarget(upstream);
+    const std::string& pool_key = target.key;
+    const std::string& url = target.connect_url;
+    ProxyRequestHeaders proxy_headers;
+    proxy_headers.scan(req.header().headerPairs());
+    const ProxyForwarding forwarding = bindProxyUpstream(client_ip, target.host_header, ProxyMode::Http);
+    const auto start = std::chrono::steady_clock::now();
+
+    HttpResponse response;
+    HttpStatusCode failure_code = HttpStatusCode::BadGateway_502;
+    const char* failure = nullptr;
+    auto& pool = ProxyClientPool::local();
+    ProxyClientPool::Handle client;
+    if (config.protocol == UpstreamProtocol::H2c) {
+        co_await exchangeH2cRequest(upstream, pool_key, config.h2c, req, proxy_headers, forwarding,
+                                    upstream_lease, response, failure_code, failure, &race->streams[slot]);
+    } else {
+        co_await ensureProxyPoolRetireHook();
+        client = pool.acquire(pool_key, config.pool);
+        if (!client) {
+            // 本地连接数上限不是上游故障，不参与异常检测
+            upstream_lease.abandon();
+            failure_code = HttpStatusCode::ServiceUnavailable_503;
+            failure = "Service Unavailable: upstream connection limit reached";
+        } else {
+            race->clients[slot] = &client;
+            if (!client.reused()) {
+                bool connect_ok = false;
+                std::string connect_err;
+                co_await connectProxyUpstream(*client, url, connect_ok, connect_err);
+                if (!connect_ok) {
+                    HTTP_LOG_WARN("[proxy] [connect-fail]", "upstream={} error={}", pool_key, connect_err);
+                    failure = "Bad Gateway: connect upstream failed";
+                }
+            }
+            if (failure == nullptr && !race->cancelled[slot]) {
+                ProxyHeadBuffer head;
+                buildUpstreamRequestHead(head.get(), req, proxy_headers, forwarding);
+                co_await exchangeProxyRequest(client, head.get(), req.bodyStr(), pool_key, url,
+                                              response, failure, &race->cancelled[slot]);
+            }
+            race->clients[slot] = nullptr;
+        }
+    }
+    race->streams[slot].reset();
+    race->done[slot] = true;
+    ++race->finished;
+
+    const bool ok = failure == nullptr && !race->cancelled[slot];
+    const bool reusable = ok && isReusableUpstreamResponse(response);
+    if (race->cancelled[slot]) {
+        upstream_lease.abandon();
+    } else if (ok) {
+        upstream_lease.finish(static_cast<int>(response.header().code()) < 500);
+        upstreams->hedgeState().latency.observe(std::chrono::steady_clock::now() - start);
+    }
+
+    if (ok && race->winner < 0) {
+        race->winner = slot;
+        race->response = std::move(response);
+        if (race->launched == HedgeRace::kAttempts) {
+            if (slot == 0) {
+                ProxyStats::instance().addHedgeLoss();
+            } else {
+                ProxyStats::instance().addHedgeWin();
+            }
+        }
+        for (int other = 0; other < HedgeRace::kAttempts; ++other) {
+            if (other != slot) {
+                race->cancel(other);
+            }
+        }
+    } else if (!ok && !race->cancelled[slot]) {
+        race->failure_code = failure_code;
+        race->failure = failure != nullptr ? failure : race->failure;
+    }
+    race->wake();
+
+    if (client) {
+        if (reusable) {
+            pool.release(std::move(client));
+        } else {
+            co_await client->close();
+        }
+    }
+    co_return;
+}
+
+/**
+ * @brief 对冲计时器：到期后唤醒处理器决定是否发出对冲请求
+ */
+Task<void> runHedgeTimer(std::shared_ptr<HedgeRace> race, std::chrono::nanoseconds delay)
+{
+    co_await galay::kernel::sleep(std::chrono::duration_cast<std::chrono::milliseconds>(delay));
+    if (race->winner < 0) {
+        race->timer_fired = true;
+        race->wake();
+    }
+    co_return;
+}
+
+/**
+ * @brief 对冲交换：主请求超过延迟分位数未返回时向另一实例发出对冲请求，取先返回者
+ * @param req 已改写为上游 URI 的客户端请求（头部保持原样）
+ * @param client_ip 客户端地址，用于生成转发头
+ * @details 主请求失败且尚未对冲时立即改为重试；对冲与重试都消耗预算令牌
+ */
+Task<void> hedgedProxyExchange(UpstreamGroup::ptr upstreams,
+                               HttpRequest& req,
+                               const std::string& client_ip,
+                               HttpResponse& response,
+                               HttpStatusCode& failure_code,
+                               const char*& failure)
+{
+    const HedgeConfig& config = upstreams->config().hedge;
+    HedgeState& hedge = upstreams->hedgeState();
+    hedge.budget.deposit(config);
+
+    auto race = std::make_shared<HedgeRace>();
+    auto copyRequest = [&req]() {
+        HttpRequest copy;
+        copy.header().copyFrom(req.header());
+        return copy;
+    };
+
+    // 选择结果（含探测名额）随参数交给尝试协程，由其 Lease 领取
+    const UpstreamGroup::Pick primary = upstreams->select();
+    race->launched = 1;
+    if (!co_await SpawnOnCurrentSchedulerAwaitable(runProxyAttempt(race, 0, upstreams, primary, copyRequest(), client_ip))) {
+        // 无法调度后台协程：退化为单次请求
+        co_await runProxyAttempt(race, 0, upstreams, primary, copyRequest(), client_ip);
+    } else {
+        // 计时器调度失败时只是不发对冲，主请求照常完成
+        co_await SpawnOnCurrentSchedulerAwaitable(runHedgeTimer(race, hedge.delay(config)));
+    }
+
+    bool may_launch = true;
+    while (race->winner < 0) {
+        const bool primary_failed = race->finished == race->launched;
+        if (may_launch && race->launched < HedgeRace::kAttempts &&
+            (race->timer_fired || (primary_failed && config.retry_on_failure))) {
+            may_launch = false;
+            if (hedge.budget.tryWithdraw(config)) {
+                const UpstreamGroup::Pick other = upstreams->selectOther(primary.index);
+                race->launched = HedgeRace::kAttempts;
+                if (primary_failed) {
+                    ProxyStats::instance().addBudgetRetry();
+                } else {
+                    ProxyStats::instance().addHedge();
+                }
+                if (!co_await SpawnOnCurrentSchedulerAwaitable(runProxyAttempt(race, 1, upstreams, other, copyRequest(), client_ip))) {
+                    co_await runProxyAttempt(race, 1, upstreams, other, copyRequest(), client_ip);
+                }
+                continue;
+            }
+            ProxyStats::instance().addBudgetDenied();
+        }
+        if (race->finished == race->launched) {
+            break;
+        }
+        auto waiter = std::make_shared<galay::kernel::AsyncWaiter<void>>();
+        race->waiter = waiter;
+        co_await waiter->wait();
+    }
+
+    if (race->winner < 0) {
+        failure_code = race->failure_code;
+        failure = race->failure;
+        co_return;
+    }
+    failure = nullptr;
+    response = std::move(race->response);
+    co_return;
+}
+
+/**
+ * @brief 写入缓存、应答合并的请求，并把上游响应转发给下游
+ * @details 发送会移走响应体，缓存与合并结果必须在发送前生成
+ */
+Task<void> deliverProxyResponse(HttpConn& conn,
+                                HttpResponse& response,
+                                const std::string& cache_key,
+                                HeaderPair& request_headers,
+                                const ResponseCacheConfig& cache_config,
+                                SingleFlight::LeaderGuard* flight_leader,
+                                bool& downstream_ok)
+{
+    if (!cache_key.empty()) {
+        ResponseCache::local().store(cache_key, request_headers, response.header(),
+                                     response.bodyStr(), cache_config);
+    }
+    if (flight_leader != nullptr) {
+        flight_leader->complete(buildSingleFlightResult(response));
+    }
+
+    // sendResponse 会移走响应体，计数用的长度须在发送前取出
+    const size_t body_bytes = response.bodyStr().size();
+    auto downstream_writer = conn.getWriter();
+    downstream_ok = false;
     while (true) {
-        auto result = co_await writer.sendResponse(response);
-        if (!result || result.value()) {
+        auto forward_result = co_await downstream_writer.sendResponse(response);
+        if (!forward_result) {
+            HTTP_LOG_ERROR("[proxy] [forward-fail]",
+                           "error={}",
+                           forward_result.error().message());
+            break;
+        }
+        if (forward_result.value()) {
+            downstream_ok = true;
             break;
         }
     }
+    if (downstream_ok) {
+        ProxyStats::instance().addHttp(body_bytes);
+    }
     co_return;
 }
 
-Task<void> connectProxyUpstream(HttpClient& client,
-                                const std::string& url,
-                                bool& ok,
-                                std::string& err_msg)
+bool isValidUpstreamGroup(const UpstreamGroup::ptr& upstreams)
 {
-    ok = false;
-    err_msg.clear();
-
-    try {
-        auto connect_result = co_await client.connect(url);
-        if (!connect_result) {
-            err_msg = connect_result.error().message();
-            co_return;
+    if (!upstreams || upstreams->size() == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < upstreams->size(); ++i) {
+        const auto& endpoint = upstreams->endpoint(i);
+        if (endpoint.host.empty() ||
+            (endpoint.port == 0 && !HttpSocketAddress::parse(endpoint.host, 0).isUnix())) {
+            return false;
         }
-        ok = true;
-    } catch (const std::exception& ex) {
-        err_msg = ex.what();
-    } catch (...) {
-        err_msg = "unknown exception";
     }
+    return true;
+}
 
-    co_return;
+std::string describeUpstreams(const UpstreamGroup::ptr& upstreams)
+{
+    if (!upstreams) {
+        return "<null>";
+    }
+    std::string out;
+    for (size_t i = 0; i < upstreams->size(); ++i) {
+        const auto& endpoint = upstreams->endpoint(i);
+        if (i > 0) {
+            out += ',';
+        }
+        out += HttpSocketAddress::parse(endpoint.host, endpoint.port).authority();
+    }
+    return out;
 }
 
-Task<void> relayRawUpstreamToDownstream(TcpSocket& upstream,
-                                        TcpSocket& downstream,
-                                        bool& ok,
-                                        std::string& err_msg)
+/**
+ * @brief 缓冲转发：recv 到用户态缓冲后 send 给下游
+ * @details splice 不可用（非 Linux、TLS 等非裸 fd 场景）时的通用路径
+ */
+template <typename UpstreamSocket, typename DownstreamSocket>
+Task<void> relayRawBuffered(UpstreamSocket& upstream,
+                            DownstreamSocket& downstream,
+                            uint64_t& relayed_bytes,
+                            bool& ok,
+                            std::string& err_msg)
 {
     ok = false;
     err_msg.clear();
@@ -322,8 +1459,172 @@ Task<void> relayRawUpstreamToDownstream(TcpSocket& upstream,
             }
 
             offset += sent;
+            relayed_bytes += sent;
+        }
+    }
+}
+
+/**
+ * @brief 等待下游可写：从管道取出 1 字节经协程化 send 发出
+ * @details 与上游侧的 1 字节 recv 探测对称：send 在发送缓冲区腾出空间前挂起，
+ *          返回后管道中其余数据继续由 splice 搬运，慢客户端下也只有这 1 字节经过用户态
+ */
+Task<void> awaitDownstreamWritable(SplicePipe& pipe,
+                                   TcpSocket& downstream,
+                                   uint64_t& relayed_bytes,
+                                   bool& ok,
+                                   std::string& err_msg)
+{
+    ok = false;
+    char head = 0;
+    if (::read(pipe.read_fd, &head, 1) != 1) {
+        err_msg = "splice pipe read failed";
+        co_return;
+    }
+    pipe.pending -= 1;
+    auto send_result = co_await downstream.send(&head, 1);
+    if (!send_result) {
+        err_msg = send_result.error().message();
+        co_return;
+    }
+    if (send_result.value() == 0) {
+        err_msg = "downstream send returned 0";
+        co_return;
+    }
+    relayed_bytes += 1;
+    ok = true;
+    co_return;
+}
+
+/**
+ * @brief 把 splice 管道中的残留数据读出，经协程化 send 发给下游
+ * @details 仅用于 socket 不支持 splice（EINVAL/ENOSYS）时回退前清空管道
+ */
+Task<void> drainSplicePipe(SplicePipe& pipe,
+                           TcpSocket& downstream,
+                           std::vector<char>& spill,
+                           uint64_t& relayed_bytes,
+                           bool& ok,
+                           std::string& err_msg)
+{
+    ok = false;
+    while (pipe.pending > 0) {
+        spill.resize(pipe.capacity);
+        const ssize_t n = ::read(pipe.read_fd, spill.data(), pipe.pending);
+        if (n <= 0) {
+            err_msg = "splice pipe read failed";
+            co_return;
+        }
+        pipe.pending -= static_cast<size_t>(n);
+
+        size_t offset = 0;
+        while (offset < static_cast<size_t>(n)) {
+            auto send_result = co_await downstream.send(spill.data() + offset, static_cast<size_t>(n) - offset);
+            if (!send_result) {
+                err_msg = send_result.error().message();
+                co_return;
+            }
+            if (send_result.value() == 0) {
+                err_msg = "downstream send returned 0";
+                co_return;
+            }
+            offset += send_result.value();
+            relayed_bytes += send_result.value();
+        }
+    }
+    ok = true;
+    co_return;
+}
+
+/**
+ * @brief Raw 模式回包转发：TCP → TCP 优先走 splice 零拷贝
+ * @details
+ * - 以 1 字节 recv 等待上游可读，探测字节写入管道作为本轮数据前缀，
+ *   随后非阻塞 splice 把上游已就绪的数据经管道搬到下游
+ * - 下游发送缓冲区已满时，以 1 字节协程化 send 等待可写，随后继续从管道 splice
+ * - 管道不可用或 socket 不支持 splice 时回退到缓冲转发
+ */
+Task<void> relayRawUpstreamToDownstream(TcpSocket& upstream,
+                                        TcpSocket& downstream,
+                                        uint64_t& splice_bytes,
+                                        uint64_t& buffered_bytes,
+                                        bool& ok,
+                                        std::string& err_msg)
+{
+    ok = false;
+    err_msg.clear();
+
+    auto& pipe_pool = SplicePipePool::local();
+    std::optional<SplicePipe> pipe;
+    if constexpr (SplicePipePool::isSupported()) {
+        pipe = pipe_pool.acquire();
+    }
+    if (!pipe) {
+        ProxyStats::instance().addRawSpliceFallback();
+        co_await relayRawBuffered(upstream, downstream, buffered_bytes, ok, err_msg);
+        co_return;
+    }
+
+    const int upstream_fd = upstream.handle().fd;
+    const int downstream_fd = downstream.handle().fd;
+    std::vector<char> spill;
+    bool fallback = false;
+
+    while (!ok && err_msg.empty() && !fallback) {
+        char probe = 0;
+        auto recv_result = co_await upstream.recv(&probe, 1);
+        if (!recv_result) {
+            err_msg = recv_result.error().message();
+            break;
+        }
+        if (recv_result.value() == 0) {
+            ok = true;
+            break;
+        }
+        if (::write(pipe->write_fd, &probe, 1) != 1) {
+            err_msg = "splice pipe write failed";
+            break;
+        }
+        pipe->pending += 1;
+
+        while (true) {
+            auto pumped = SplicePipePool::pump(upstream_fd, downstream_fd, *pipe);
+            splice_bytes += pumped.bytes_out;
+            if (pumped.error == EINVAL || pumped.error == ENOSYS) {
+                fallback = true;
+                break;
+            }
+            if (pumped.error != 0) {
+                err_msg = std::string("splice failed: ") + strerror(pumped.error);
+                break;
+            }
+            if (pumped.output_blocked) {
+                bool writable = false;
+                co_await awaitDownstreamWritable(*pipe, downstream, buffered_bytes, writable, err_msg);
+                if (!writable) {
+                    break;
+                }
+                continue;
+            }
+            if (pumped.input_eof) {
+                ok = true;
+            }
+            break;
+        }
+    }
+
+    if (fallback) {
+        // socket 不支持 splice：先发出管道中的残留，再改走缓冲转发
+        ProxyStats::instance().addRawSpliceFallback();
+        bool drain_ok = false;
+        co_await drainSplicePipe(*pipe, downstream, spill, buffered_bytes, drain_ok, err_msg);
+        if (drain_ok) {
+            co_await relayRawBuffered(upstream, downstream, buffered_bytes, ok, err_msg);
         }
     }
+
+    pipe_pool.release(*pipe);
+    co_return;
 }
 
 } // namespace
@@ -736,6 +2037,24 @@ void HttpRouter::tryFiles(const std::string& routePrefix,
                           uint16_t upstreamPort,
                           const StaticFileConfig& config,
                           ProxyMode mode)
+{
+    if (upstreamHost.empty() ||
+        (upstreamPort == 0 && !HttpSocketAddress::parse(upstreamHost, 0).isUnix())) {
+        HTTP_LOG_ERROR("[try-files] [invalid-upstream]",
+                       "host={} port={}",
+                       upstreamHost,
+                       upstreamPort);
+        return;
+    }
+
+    tryFiles(routePrefix, dirPath, UpstreamGroup::single(upstreamHost, upstreamPort), config, mode);
+}
+
+void HttpRouter::tryFiles(const std::string& routePrefix,
+                          const std::string& dirPath,
+                          UpstreamGroup::ptr upstreams,
+                          const StaticFileConfig& config,
+                          ProxyMode mode)
 {
     namespace fs = std::filesystem;
 
@@ -744,16 +2063,13 @@ void HttpRouter::tryFiles(const std::string& routePrefix,
         return;
     }
 
-    if (upstreamHost.empty() || upstreamPort == 0) {
-        HTTP_LOG_ERROR("[try-files] [invalid-upstream]",
-                       "host={} port={}",
-                       upstreamHost,
-                       upstreamPort);
+    if (!isValidUpstreamGroup(upstreams)) {
+        HTTP_LOG_ERROR("[try-files] [invalid-upstream]", "upstreams={}", describeUpstreams(upstreams));
         return;
     }
 
     std::string normalizedPrefix = normalizeRoutePrefix(routePrefix);
-    auto fallbackProxy = createProxyHandler("/", upstreamHost, upstreamPort, mode);
+    auto fallbackProxy = createProxyHandler("/", upstreams, mode);
     auto handler = createStaticFileHandler(normalizedPrefix, dirPath, config, std::move(fallbackProxy));
 
     std::string wildcardPath = normalizedPrefix;
@@ -768,11 +2084,10 @@ void HttpRouter::tryFiles(const std::string& routePrefix,
     }
 
     HTTP_LOG_INFO("[try-files]",
-                  "dir={} route={} upstream={}:{}",
+                  "dir={} route={} upstream={}",
                   dirPath,
                   normalizedPrefix,
-                  upstreamHost,
-                  upstreamPort);
+                  describeUpstreams(upstreams));
 }
 
 void HttpRouter::proxy(const std::string& routePrefix,
@@ -780,7 +2095,8 @@ void HttpRouter::proxy(const std::string& routePrefix,
                        uint16_t upstreamPort,
                        ProxyMode mode)
 {
-    if (upstreamHost.empty() || upstreamPort == 0) {
+    if (upstreamHost.empty() ||
+        (upstreamPort == 0 && !HttpSocketAddress::parse(upstreamHost, 0).isUnix())) {
         HTTP_LOG_ERROR("[proxy] [invalid-upstream]",
                        "host={} port={}",
                        upstreamHost,
@@ -788,8 +2104,20 @@ void HttpRouter::proxy(const std::string& routePrefix,
         return;
     }
 
+    proxy(routePrefix, UpstreamGroup::single(upstreamHost, upstreamPort), mode);
+}
+
+void HttpRouter::proxy(const std::string& routePrefix,
+                       UpstreamGroup::ptr upstreams,
+                       ProxyMode mode)
+{
+    if (!isValidUpstreamGroup(upstreams)) {
+        HTTP_LOG_ERROR("[proxy] [invalid-upstream]", "upstreams={}", describeUpstreams(upstreams));
+        return;
+    }
+
     std::string normalizedPrefix = normalizeRoutePrefix(routePrefix);
-    auto handler = createProxyHandler(normalizedPrefix, upstreamHost, upstreamPort, mode);
+    auto handler = createProxyHandler(normalizedPrefix, upstreams, mode);
 
     std::string wildcardPath = normalizedPrefix == "/" ? "/**" : normalizedPrefix + "/**";
     addHandler<HttpMethod::GET, HttpMethod::POST, HttpMethod::PUT,
@@ -806,18 +2134,16 @@ void HttpRouter::proxy(const std::string& routePrefix,
         if (!m_fallbackProxyHandlerState) {
             m_fallbackProxyHandlerState = std::make_shared<std::optional<HttpRouteHandler>>();
         }
-        *m_fallbackProxyHandlerState = createProxyHandler("/", upstreamHost, upstreamPort, mode);
+        *m_fallbackProxyHandlerState = createProxyHandler("/", upstreams, mode);
         HTTP_LOG_INFO("[proxy-fallback] [enable]",
-                      "upstream={}:{} mode={}",
-                      upstreamHost,
-                      upstreamPort,
+                      "upstream={} mode={}",
+                      describeUpstreams(upstreams),
                       mode == ProxyMode::Raw ? "raw" : "http");
     }
 
     HTTP_LOG_INFO("[proxy] [mount]",
-                  "upstream={}:{} route={}",
-                  upstreamHost,
-                  upstreamPort,
+                  "upstream={} route={}",
+                  describeUpstreams(upstreams),
                   normalizedPrefix);
 }
 
@@ -848,8 +2174,11 @@ HttpRouteHandler HttpRouter::createStaticFileHandler(const std::string& routePre
         canonicalDir = fs::path(dirPath);
     }
 
+    // 每个挂载点独占一段元数据缓存命名空间
+    const uint64_t mountId = StaticFileMetaCache::nextMountId();
+
     // 捕获 routePrefix、dirPath 和 config，返回一个协程处理器
-    return [routePrefix, dirPath, canonicalDir, config, fallbackHandler](HttpConn& conn, HttpRequest req) -> Task<void> {
+    return [routePrefix, dirPath, canonicalDir, config, fallbackHandler, mountId](HttpConn& conn, HttpRequest req) -> Task<void> {
         namespace fs = std::filesystem;
 
         // 获取请求的路径参数（通配符匹配的部分）
@@ -867,6 +2196,33 @@ HttpRouteHandler HttpRouter::createStaticFileHandler(const std::string& routePre
             relativePath = requestPath.substr(start);
         }
 
+        // 元数据缓存快路径：条件 GET/HEAD 命中后直接发送预构造的 304，不访问文件系统
+        if (config.isEnableMetaCache()) {
+            const auto method = req.header().method();
+            const auto& headers = req.header().headerPairs();
+            std::string_view ifNoneMatch = headers.getCommonHeader(CommonHeaderIndex::IfNoneMatch);
+            std::string_view ifModifiedSince = headers.getCommonHeader(CommonHeaderIndex::IfModifiedSince);
+            if ((method == HttpMethod::GET || method == HttpMethod::HEAD) &&
+                (!ifNoneMatch.empty() || !ifModifiedSince.empty()) &&
+                !headers.hasCommonHeader(CommonHeaderIndex::Range) &&
+                !headers.hasKey("If-Match")) {
+                auto meta = StaticFileMetaCache::local().lookup(mountId,
+                                                               relativePath,
+                                                               config.getMetaCacheTtl(),
+                                                               std::chrono::steady_clock::now());
+                // 内容 ETag 计算中的条目走慢路径，以便结果就绪后及时切换
+                if (meta && !meta->etag_pending && meta->notModified(ifNoneMatch, ifModifiedSince)) {
+                    auto writer = conn.getWriter();
+                    // meta 持有 304 字节，需存活到发送完成
+                    auto result = co_await writer.sendView(meta->not_modified_response);
+                    if (!result) {
+                        HTTP_LOG_DEBUG("[static] [304-fail]", "error={}", result.error().message());
+                    }
+                    co_return;
+                }
+            }
+        }
+
         // 构建完整文件路径
         fs::path fullPath = fs::path(dirPath) / relativePath;
 
@@ -915,8 +2271,9 @@ HttpRouteHandler HttpRouter::createStaticFileHandler(const std::string& routePre
             co_return;
         }
 
-        // 检查文件是否存在且是普通文件
-        if (!fs::exists(canonicalFile) || !fs::is_regular_file(canonicalFile)) {
+        // 检查文件是否存在且是普通文件（一次 stat 同时取得 size / mtime / inode）
+        struct stat fileStat;
+        if (::stat(canonicalFile.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
             if (fallbackHandler) {
                 co_await fallbackHandler(conn, std::move(req));
                 co_return;
@@ -934,20 +2291,23 @@ HttpRouteHandler HttpRouter::createStaticFileHandler(const std::string& routePre
             co_return;
         }
 
-        // 获取文件大小
-        size_t fileSize = fs::file_size(canonicalFile);
-
         // 设置 Content-Type
         std::string extension = canonicalFile.extension().string();
         std::string ext = extension.empty() ? "" : extension.substr(1);
-        std::string mimeType = MimeType::convertToMimeType(ext);
+        auto meta = buildStaticFileMeta(canonicalFile.string(),
+                                        fileStat,
+                                        MimeType::convertToMimeType(ext),
+                                        config);
+        if (config.isEnableMetaCache()) {
+            StaticFileMetaCache::local().store(mountId, relativePath, meta, config.getMetaCacheMaxEntries());
+        }
         HTTP_LOG_DEBUG("[static]",
                        "request={} file={} size={} mime={}",
                        requestPath,
-                       canonicalFile.string(),
-                       fileSize,
-                       mimeType);
-        co_await sendFileContent(conn, req, canonicalFile.string(), fileSize, mimeType, config);
+                       meta->file_path,
+                       meta->file_size,
+                       meta->mime_type);
+        co_await sendFileContent(conn, req, std::move(meta), config);
         co_return;
     };
 }
@@ -1029,239 +2389,286 @@ HttpRouteHandler HttpRouter::createSingleFileHandler(const std::string& filePath
     };
 }
 
+HttpRouteHandler HttpRouter::createComputeHandler(HttpComputeHandler handler)
+{
+    auto shared = std::make_shared<const HttpComputeHandler>(std::move(handler));
+    return [shared](HttpConn& conn, HttpRequest req) -> Task<void> {
+        return runComputeRoute(shared, conn, std::move(req));
+    };
+}
+
 HttpRouteHandler HttpRouter::createProxyHandler(const std::string& routePrefix,
-                                                const std::string& upstreamHost,
-                                                uint16_t upstreamPort,
+                                                UpstreamGroup::ptr upstreams,
                                                 ProxyMode mode)
 {
-    return [routePrefix, upstreamHost, upstreamPort, mode](HttpConn& conn, HttpRequest req) -> Task<void> {
+    return [routePrefix, upstreams, mode](HttpConn& conn, HttpRequest req) -> Task<void> {
         const std::string request_uri = req.header().uri();
         const std::string upstream_uri = rewriteProxyUri(routePrefix, request_uri);
-        const std::string pool_key = buildUpstreamKey(upstreamHost, upstreamPort);
-        const std::string upstream_connect_url = "http://" + upstreamHost + ":" +
-                                                 std::to_string(upstreamPort) + "/";
 
+        // 一次遍历完成请求头分类；客户端 HeaderPair 保持不变，转发时直接序列化改写结果
         auto& headers = req.header().headerPairs();
-        const std::string original_host = getHeaderValueLoose(headers, "Host");
-        const std::string connection = getHeaderValueLoose(headers, "Connection");
-        std::vector<std::string> hop_by_hop_tokens = splitConnectionTokens(connection);
+        ProxyRequestHeaders proxy_headers;
+        proxy_headers.scan(headers);
+        const std::string_view original_host = proxy_headers.host();
+        const std::string client_ip = getClientIpFromConn(conn);
 
         ProxyMode effective_mode = mode;
-        if (mode == ProxyMode::Http && isLikelyStreamingRequest(upstream_uri, headers)) {
+        if (mode == ProxyMode::Http && isLikelyStreamingRequest(upstream_uri, proxy_headers)) {
             effective_mode = ProxyMode::Raw;
             HTTP_LOG_INFO("[proxy] [stream-upgrade]",
-                          "uri={} upstream={}:{}",
+                          "uri={} route={}",
                           upstream_uri,
-                          upstreamHost,
-                          upstreamPort);
+                          routePrefix);
         }
 
-        removeHeaderPairLoose(headers, "Connection");
-        removeHeaderPairLoose(headers, "Proxy-Connection");
-        removeHeaderPairLoose(headers, "Keep-Alive");
-        removeHeaderPairLoose(headers, "TE");
-        removeHeaderPairLoose(headers, "Trailer");
-        removeHeaderPairLoose(headers, "Transfer-Encoding");
-        removeHeaderPairLoose(headers, "Upgrade");
-        for (const auto& token : hop_by_hop_tokens) {
-            removeHeaderPairLoose(headers, token);
-        }
-
-        applyForwardHeaders(conn, headers, original_host);
-        removeHeaderPairLoose(headers, "Host");
-        headers.addHeaderPair("Host", upstreamHost + ":" + std::to_string(upstreamPort));
-        headers.addHeaderPair("Connection", effective_mode == ProxyMode::Raw ? "close" : "keep-alive");
-
         req.header().uri() = upstream_uri;
 
-        if (effective_mode == ProxyMode::Raw) {
-            auto client = std::make_unique<HttpClient>();
-            bool connect_ok = false;
-            std::string connect_err;
-            co_await connectProxyUpstream(*client, upstream_connect_url, connect_ok, connect_err);
-            if (!connect_ok) {
-                HTTP_LOG_ERROR("[proxy-raw] [connect-fail]", "error={}", connect_err);
-                co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
-                                        "Bad Gateway: connect upstream failed");
-                co_return;
+        // 响应缓存：按客户端视角的 authority + URI 建键，命中时不选择上游
+        const ResponseCacheConfig& cache_config = upstreams->config().cache;
+        std::string cache_key;
+        if (cache_config.enabled && effective_mode == ProxyMode::Http &&
+            req.header().method() == HttpMethod::GET) {
+            cache_key = ResponseCache::primaryKey("GET", original_host, request_uri);
+            if (ResponseCache::canServeFromCache(headers)) {
+                auto cached = ResponseCache::local().lookup(cache_key, headers);
+                if (cached.entry) {
+                    if (cached.refresh) {
+                        HttpRequest refresh_req;
+                        refresh_req.header().copyFrom(req.header());
+                        if (!co_await SpawnOnCurrentSchedulerAwaitable(
+                                refreshProxyCache(upstreams, std::move(refresh_req), client_ip, cache_key, cached.entry))) {
+                            ResponseCache::finishRefresh(cached.entry);
+                        }
+                    }
+                    auto writer = conn.getWriter();
+                    // cached.entry 持有响应字节，需存活到发送完成
+                    auto result = co_await writer.sendView(cached.entry->wire);
+                    if (!result) {
+                        HTTP_LOG_DEBUG("[proxy] [cache-hit-fail]", "error={}", result.error().message());
+                    }
+                    co_return;
+                }
             }
+        }
 
-            auto session = client->getSession();
-            auto& upstream_writer = session.getWriter();
-            bool send_ok = false;
-            while (true) {
-                auto send_result = co_await upstream_writer.sendRequest(req);
-                if (!send_result) {
-                    HTTP_LOG_WARN("[proxy-raw] [send-fail]",
-                                  "error={}",
-                                  send_result.error().message());
-                    break;
+        // single-flight：相同 GET 回源期间到达的请求挂起等待 leader 的响应
+        std::optional<SingleFlight::LeaderGuard> flight_leader;
+        if (upstreams->config().single_flight && effective_mode == ProxyMode::Http &&
+            req.header().method() == HttpMethod::GET && isSingleFlightEligible(headers)) {
+            const std::string flight_key = buildSingleFlightKey(
+                ResponseCache::primaryKey("GET", original_host, request_uri), headers);
+            auto joined = SingleFlight::instance().join(flight_key);
+            if (joined.leader) {
+                flight_leader.emplace(SingleFlight::instance(), flight_key, joined.flight);
+            } else {
+                Scheduler* scheduler = co_await CurrentSchedulerAwaitable();
+                auto waiter = std::make_shared<galay::kernel::AsyncWaiter<void>>();
+                const bool parked = joined.flight->subscribe([scheduler, waiter]() {
+                    if (scheduler == nullptr || !scheduleTask(scheduler, notifySingleFlightWaiter(waiter))) {
+                        waiter->notify();
+                    }
+                });
+                if (parked) {
+                    co_await waiter->wait();
                 }
-                if (send_result.value()) {
-                    send_ok = true;
-                    break;
+                if (auto shared = joined.flight->result()) {
+                    auto writer = conn.getWriter();
+                    // shared 持有响应字节，需存活到发送完成
+                    auto result = co_await writer.sendView(*shared);
+                    if (!result) {
+                        HTTP_LOG_DEBUG("[proxy] [coalesced-fail]", "error={}", result.error().message());
+                    }
+                    co_return;
                 }
+                // leader 失败或响应不可共享：自行回源
             }
+        }
 
-            if (!send_ok) {
-                co_await client->close();
-                co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
-                                        "Bad Gateway: send upstream failed");
+        // 对冲：幂等请求交给竞速的多次尝试，连接与记账在各尝试内完成
+        if (upstreams->config().hedge.enabled && effective_mode == ProxyMode::Http &&
+            (req.header().method() == HttpMethod::GET || req.header().method() == HttpMethod::HEAD) &&
+            req.bodyStr().empty()) {
+            HttpResponse hedged_response;
+            HttpStatusCode failure_code = HttpStatusCode::BadGateway_502;
+            const char* hedge_failure = nullptr;
+            co_await hedgedProxyExchange(upstreams, req, client_ip, hedged_response, failure_code, hedge_failure);
+            if (hedge_failure != nullptr) {
+                co_await sendProxyError(conn, failure_code, hedge_failure);
                 co_return;
             }
-
-            bool relay_ok = false;
-            std::string relay_err;
-            co_await relayRawUpstreamToDownstream(client->socket(),
-                                                  conn.getSocket(),
-                                                  relay_ok,
-                                                  relay_err);
-            if (!relay_ok && !relay_err.empty()) {
-                HTTP_LOG_WARN("[proxy-raw] [relay-fail]", "error={}", relay_err);
-            }
-
-            co_await client->close();
+            bool downstream_ok = false;
+            co_await deliverProxyResponse(conn, hedged_response, cache_key, headers, cache_config,
+                                          flight_leader ? &*flight_leader : nullptr, downstream_ok);
             co_return;
         }
-        
-        auto& pool = g_proxyClientPools[pool_key];
-        std::unique_ptr<HttpClient> client;
-        bool borrowed_from_pool = false;
-        if (!pool.empty()) {
-            client = std::move(pool.back());
-            pool.pop_back();
-            borrowed_from_pool = true;
-        }
 
-        if (!client) {
-            client = std::make_unique<HttpClient>();
-            bool connect_ok = false;
-            std::string connect_err;
-            co_await connectProxyUpstream(*client, upstream_connect_url, connect_ok, connect_err);
-            if (!connect_ok) {
-                HTTP_LOG_ERROR("[proxy] [connect-fail]", "error={}", connect_err);
-                co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
-                                        "Bad Gateway: connect upstream failed");
-                co_return;
-            }
-        }
+        // 按负载均衡策略选择上游实例；lease 负责在途数与延迟记账
+        const UpstreamGroup::Pick upstream_pick = upstreams->select();
+        const UpstreamEndpoint& upstream = upstreams->endpoint(upstream_pick.index);
+        UpstreamGroup::Lease upstream_lease(*upstreams, upstream_pick);
+        const ProxyUpstreamTarget target = resolveUpstreamTarget(upstream);
+        const std::string& pool_key = target.key;
+        const std::string& upstream_connect_url = target.connect_url;
+        const ProxyForwarding forwarding = bindProxyUpstream(client_ip, target.host_header, effective_mode);
 
+        // h2c 上游：请求作为共享连接上的一个 stream 转发，不占用连接池
+        const bool use_h2c = upstreams->config().protocol == UpstreamProtocol::H2c &&
+                             effective_mode == ProxyMode::Http;
+        auto& pool = ProxyClientPool::local();
         HttpResponse upstream_response;
-        bool request_ok = false;
-        bool retried = false;
-
-        while (!request_ok) {
-            auto session = client->getSession();
-            auto& upstream_writer = session.getWriter();
-            bool send_ok = false;
-            while (true) {
-                auto send_result = co_await upstream_writer.sendRequest(req);
-                if (!send_result) {
-                    HTTP_LOG_WARN("[proxy] [send-fail]",
-                                  "error={}",
-                                  send_result.error().message());
-                    break;
-                }
-                if (send_result.value()) {
-                    send_ok = true;
-                    break;
+        ProxyClientPool::Handle client;
+        if (use_h2c) {
+            HttpStatusCode failure_code = HttpStatusCode::BadGateway_502;
+            const char* h2c_failure = nullptr;
+            co_await exchangeH2cRequest(upstream, pool_key, upstreams->config().h2c, req,
+                                        proxy_headers, forwarding, upstream_lease,
+                                        upstream_response, failure_code, h2c_failure);
+            if (h2c_failure != nullptr) {
+                co_await sendProxyError(conn, failure_code, h2c_failure);
+                co_return;
+            }
+        } else {
+            co_await ensureProxyPoolRetireHook();
+            client = pool.acquire(pool_key, upstreams->config().pool);
+            if (!client) {
+                HTTP_LOG_WARN("[proxy] [pool-exhausted]", "upstream={}", pool_key);
+                upstream_lease.abandon();
+                co_await sendProxyError(conn, HttpStatusCode::ServiceUnavailable_503,
+                                        "Service Unavailable: upstream connection limit reached");
+                co_return;
+            }
+            co_await maintainProxyPool(pool_key, upstream_connect_url);
+
+            if (!client.reused()) {
+                bool connect_ok = false;
+                std::string connect_err;
+                co_await connectProxyUpstream(*client, upstream_connect_url, connect_ok, connect_err);
+                if (!connect_ok) {
+                    HTTP_LOG_ERROR("[proxy] [connect-fail]", "upstream={} error={}", pool_key, connect_err);
+                    co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
+                                            "Bad Gateway: connect upstream failed");
+                    co_return;
                 }
             }
 
-            if (!send_ok) {
-                co_await client->close();
-                if (borrowed_from_pool && !retried) {
-                    retried = true;
-                    borrowed_from_pool = false;
-                    client = std::make_unique<HttpClient>();
+            ProxyHeadBuffer head;
+            buildUpstreamRequestHead(head.get(), req, proxy_headers, forwarding);
+
+            if (effective_mode == ProxyMode::Raw) {
+                bool send_ok = false;
+                while (!send_ok) {
+                    auto session = client->getSession();
+                    auto& upstream_writer = session.getWriter();
+                    while (true) {
+                        auto send_result = co_await upstream_writer.sendRequestView(head.get(), req.bodyStr());
+                        if (!send_result) {
+                            HTTP_LOG_WARN("[proxy-raw] [send-fail]",
+                                          "error={}",
+                                          send_result.error().message());
+                            break;
+                        }
+                        if (send_result.value()) {
+                            send_ok = true;
+                            break;
+                        }
+                    }
+                    if (send_ok) {
+                        break;
+                    }
+
+                    co_await client->close();
+                    if (!client.reused()) {
+                        co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
+                                                "Bad Gateway: send upstream failed");
+                        co_return;
+                    }
+                    // 预热/复用的连接在探测后仍可能被上游关闭，换新连接重试一次
+                    pool.noteStaleRetry(pool_key);
+                    client.renew();
                     bool reconnect_ok = false;
                     std::string reconnect_err;
                     co_await connectProxyUpstream(*client, upstream_connect_url, reconnect_ok, reconnect_err);
                     if (!reconnect_ok) {
-                        HTTP_LOG_ERROR("[proxy] [reconnect-fail]", "error={}", reconnect_err);
+                        HTTP_LOG_ERROR("[proxy-raw] [reconnect-fail]", "error={}", reconnect_err);
                         co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
                                                 "Bad Gateway: send upstream failed");
                         co_return;
                     }
-                    continue;
+                }
+                // 流式响应时长与上游负载无关，延迟只统计到请求发出
+                upstream_lease.stopClock();
+
+                bool relay_ok = false;
+                std::string relay_err;
+                uint64_t splice_bytes = 0;
+                uint64_t buffered_bytes = 0;
+                co_await relayRawUpstreamToDownstream(client->socket(),
+                                                      conn.getSocket(),
+                                                      splice_bytes,
+                                                      buffered_bytes,
+                                                      relay_ok,
+                                                      relay_err);
+                ProxyStats::instance().addRaw(splice_bytes, buffered_bytes);
+                upstream_lease.finish(relay_ok || splice_bytes + buffered_bytes > 0);
+                if (!relay_ok && !relay_err.empty()) {
+                    HTTP_LOG_WARN("[proxy-raw] [relay-fail]", "error={}", relay_err);
                 }
 
-                co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
-                                        "Bad Gateway: send upstream failed");
+                co_await client->close();
                 co_return;
             }
 
-            auto& upstream_reader = session.getReader();
-            upstream_response.reset();
-            bool recv_ok = false;
-            while (true) {
-                auto recv_result = co_await upstream_reader.getResponse(upstream_response);
-                if (!recv_result) {
-                    HTTP_LOG_WARN("[proxy] [recv-fail]",
-                                  "error={}",
-                                  recv_result.error().message());
-                    break;
-                }
-                if (recv_result.value()) {
-                    recv_ok = true;
-                    break;
-                }
+            // 流式转发：缓存与 single-flight 需要完整响应体，其余请求只读响应头后边收边转发
+            const bool stream_body = upstreams->config().streaming.enabled && cache_key.empty() &&
+                                     !flight_leader &&
+                                     req.header().version() == HttpVersion::HttpVersion_1_1;
+            const bool head_request = req.header().method() == HttpMethod::HEAD;
+            const char* exchange_failure = nullptr;
+            std::unique_ptr<HttpSession> body_session;
+            co_await exchangeProxyRequest(client, head.get(), req.bodyStr(), pool_key, upstream_connect_url,
+                                          upstream_response, exchange_failure, nullptr,
+                                          stream_body ? &body_session : nullptr);
+            if (exchange_failure != nullptr) {
+                co_await sendProxyError(conn, HttpStatusCode::BadGateway_502, exchange_failure);
+                co_return;
             }
-
-            if (!recv_ok) {
-                co_await client->close();
-                if (borrowed_from_pool && !retried) {
-                    retried = true;
-                    borrowed_from_pool = false;
-                    client = std::make_unique<HttpClient>();
-                    bool reconnect_ok = false;
-                    std::string reconnect_err;
-                    co_await connectProxyUpstream(*client, upstream_connect_url, reconnect_ok, reconnect_err);
-                    if (!reconnect_ok) {
-                        HTTP_LOG_ERROR("[proxy] [reconnect-fail]", "error={}", reconnect_err);
-                        co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
-                                                "Bad Gateway: recv upstream failed");
-                        co_return;
-                    }
-                    continue;
+            if (stream_body) {
+                // 延迟统计到响应头到达，响应体时长取决于大小与下游速度
+                upstream_lease.stopClock();
+                ProxyStreamOutcome outcome;
+                co_await streamProxyResponse(conn, *body_session, upstream_response.header(), head_request,
+                                             upstreams->config().streaming, outcome);
+                body_session.reset();
+                upstream_lease.finish(outcome.upstream_complete &&
+                                      static_cast<int>(upstream_response.header().code()) < 500);
+                if (outcome.downstream_ok) {
+                    ProxyStats::instance().addHttpStreamed(outcome.body_bytes);
+                }
+                if (outcome.downstream_ok && outcome.upstream_reusable) {
+                    pool.release(std::move(client));
+                    co_await maintainProxyPool(pool_key, upstream_connect_url);
+                } else {
+                    co_await client->close();
                 }
-
-                co_await sendProxyError(conn, HttpStatusCode::BadGateway_502,
-                                        "Bad Gateway: recv upstream failed");
                 co_return;
             }
-
-            request_ok = true;
         }
-
-        auto downstream_writer = conn.getWriter();
+        upstream_lease.finish(static_cast<int>(upstream_response.header().code()) < 500);
         bool downstream_ok = false;
-        while (true) {
-            auto forward_result = co_await downstream_writer.sendResponse(upstream_response);
-            if (!forward_result) {
-                HTTP_LOG_ERROR("[proxy] [forward-fail]",
-                               "error={}",
-                               forward_result.error().message());
-                break;
-            }
-            if (forward_result.value()) {
-                downstream_ok = true;
-                break;
-            }
+        co_await deliverProxyResponse(conn, upstream_response, cache_key, headers, cache_config,
+                                      flight_leader ? &*flight_leader : nullptr, downstream_ok);
+
+        // h2c stream 随响应结束，共享连接由多路复用表管理
+        if (use_h2c) {
+            co_return;
         }
 
-        bool keep_upstream = downstream_ok &&
-                             upstream_response.header().isKeepAlive() &&
-                             !upstream_response.header().isConnectionClose();
+        bool keep_upstream = downstream_ok && isReusableUpstreamResponse(upstream_response);
 
         if (keep_upstream) {
-            auto& idle = g_proxyClientPools[pool_key];
-            if (idle.size() < kProxyMaxIdleConnectionsPerUpstream) {
-                idle.push_back(std::move(client));
-            } else if (client) {
-                co_await client->close();
-            }
-        } else if (client) {
+            pool.release(std::move(client));
+            co_await maintainProxyPool(pool_key, upstream_connect_url);
+        } else {
             co_await client->close();
         }
 
@@ -1281,6 +2688,7 @@ Task<void> HttpRouter::sendFileContent(HttpConn& conn,
     // 生成稳定 ETag（mtime + size + inode/路径哈希）
     namespace fs = std::filesystem;
     std::time_t lastModified = 0;
+    uint64_t inode = 0;
 #ifdef _WIN32
     {
         std::error_code ec;
@@ -1296,6 +2704,7 @@ Task<void> HttpRouter::sendFileContent(HttpConn& conn,
     struct stat st;
     if (stat(filePath.c_str(), &st) == 0) {
         lastModified = st.st_mtime;
+        inode = static_cast<uint64_t>(st.st_ino);
     } else {
         std::error_code ec;
         auto ftime = fs::last_write_time(filePath, ec);
@@ -1312,12 +2721,31 @@ Task<void> HttpRouter::sendFileContent(HttpConn& conn,
         lastModified = std::time(nullptr);
     }
 
-    const bool enableEtag = config.isEnableETag();
     std::string etag;
-    if (enableEtag) {
+    if (config.isEnableETag()) {
         etag = ETagGenerator::generateStrong(filePath, fileSize, lastModified);
     }
-    std::string lastModifiedStr = ETagGenerator::formatHttpDate(lastModified);
+    auto meta = StaticFileMeta::create(filePath,
+                                       fileSize,
+                                       lastModified,
+                                       inode,
+                                       std::move(etag),
+                                       mimeType);
+    co_await sendFileContent(conn, req, std::move(meta), config);
+}
+
+Task<void> HttpRouter::sendFileContent(HttpConn& conn,
+                                       HttpRequest& req,
+                                       std::shared_ptr<const StaticFileMeta> meta,
+                                       const StaticFileConfig& config)
+{
+    const std::string& filePath = meta->file_path;
+    const size_t fileSize = meta->file_size;
+    const std::string& mimeType = meta->mime_type;
+    const std::time_t lastModified = meta->last_modified;
+    const std::string& etag = meta->etag;
+    const std::string& lastModifiedStr = meta->last_modified_str;
+    const bool enableEtag = config.isEnableETag() && !etag.empty();
 
     auto writer = conn.getWriter();
 
@@ -1336,18 +2764,20 @@ Task<void> HttpRouter::sendFileContent(HttpConn& conn,
         co_return;
     }
 
-    // 2. 处理 If-None-Match (ETag 条件请求)
-    std::string ifNoneMatch = req.header().headerPairs().getValue("If-None-Match");
-    if (enableEtag && ETagGenerator::matchIfNoneMatch(etag, ifNoneMatch)) {
-        // ETag 匹配，返回 304 Not Modified
-        auto response = Http1_1ResponseBuilder()
-            .status(HttpStatusCode::NotModified_304)
-            .header("ETag", etag)
-            .header("Last-Modified", lastModifiedStr)
-            .buildMove();
-        while (true) {
-            auto send_result = co_await writer.sendResponse(response);
-            if (!send_result || send_result.value()) break;
+    // 2. 处理 If-None-Match / If-Modified-Since（条件 GET，存在 If-None-Match 时忽略后者）
+    const auto method = req.header().method();
+    const auto& conditionalHeaders = req.header().headerPairs();
+    std::string_view ifNoneMatch = enableEtag
+        ? conditionalHeaders.getCommonHeader(CommonHeaderIndex::IfNoneMatch)
+        : std::string_view();
+    std::string_view ifModifiedSince = (method == HttpMethod::GET || method == HttpMethod::HEAD)
+        ? conditionalHeaders.getCommonHeader(CommonHeaderIndex::IfModifiedSince)
+        : std::string_view();
+    if (meta->notModified(ifNoneMatch, ifModifiedSince)) {
+        // 304 Not Modified：直接发送预构造字节
+        auto result = co_await writer.sendView(meta->not_modified_response);
+        if (!result) {
+            HTTP_LOG_DEBUG("[static] [304-fail]", "error={}", result.error().message());
         }
         co_return;
     }
@@ -15,7 +15,10 @@
 #include "http_conn.h"
 #include "static_cfg.h"
 #include "http_range.h"
+#include "proxy_stats.h"
+#include "upstream.h"
 #include "galay-http/protoc/http/http_request.h"
+#include "galay-http/protoc/http/http_response.h"
 #include "galay-http/protoc/http/http_base.h"
 #include "galay-kernel/kernel/task.h"
 #include <functional>
@@ -32,6 +35,8 @@ namespace galay::http
 
 using namespace galay::kernel;
 
+struct StaticFileMeta;
+
 template<typename SocketType>
 class HttpServerImpl;
 
@@ -41,6 +46,12 @@ class HttpServerImpl;
  */
 using HttpRouteHandler = std::function<Task<void>(HttpConn&, HttpRequest)>;
 
+/**
+ * @brief 计算路由处理器类型
+ * @details 在计算调度器上由请求同步生成完整响应，不接触连接对象
+ */
+using HttpComputeHandler = std::function<HttpResponse(HttpRequest&)>;
+
 /**
  * @brief 代理转发模式
  * @details
@@ -126,6 +137,21 @@ public:
         (addHandlerInternal(Methods, path, handler), ...);
     }
 
+    /**
+     * @brief 添加在计算调度器上执行的路由
+     * @tparam Methods HTTP方法类型（可变参数模板）
+     * @param path 路由路径（同 addHandler）
+     * @param handler 由请求生成响应的同步函数
+     * @details 请求读完后 handler 投递到计算调度器执行，响应回到原 IO 调度器发送，
+     *          适合压缩、渲染等 CPU 密集且无需流式读写的路由；没有计算调度器时在 IO 调度器上直接执行。
+     *          handler 抛出异常时返回 500。
+     */
+    template<HttpMethod... Methods>
+    void addComputeHandler(const std::string& path, HttpComputeHandler handler) {
+        auto route = createComputeHandler(std::move(handler));
+        (addHandlerInternal(Methods, path, route), ...);
+    }
+
     /**
      * @brief 查找路由处理器
      * @param method HTTP方法
@@ -202,13 +228,27 @@ public:
                   const StaticFileConfig& config = StaticFileConfig(),
                   ProxyMode mode = ProxyMode::Http);
 
+    /**
+     * @brief try_files，未命中时回源到上游组
+     * @param routePrefix 路由前缀
+     * @param dirPath 本地文件系统目录路径
+     * @param upstreams 上游组（按组内策略负载均衡）
+     * @param config 静态文件传输配置（可选）
+     * @param mode 代理模式
+     */
+    void tryFiles(const std::string& routePrefix,
+                  const std::string& dirPath,
+                  UpstreamGroup::ptr upstreams,
+                  const StaticFileConfig& config = StaticFileConfig(),
+                  ProxyMode mode = ProxyMode::Http);
+
     /**
      * @brief 挂载反向代理路由（运行时转发到上游）
      * @param routePrefix 路由前缀，例如 "/api" 或 "/"（全量代理）
-     * @param upstreamHost 上游主机
-     * @param upstreamPort 上游端口
+     * @param upstreamHost 上游主机（IPv4/IPv6 字面量，或 `unix:/path` 表示 Unix domain socket）
+     * @param upstreamPort 上游端口（Unix domain socket 传 0）
      * @details 注册一个通配符路由，将请求转发到上游 HTTP 服务
-     *          例如：proxy("/api", "127.0.0.1", 8080)
+     *          例如：proxy("/api", "127.0.0.1", 8080) 或 proxy("/api", "unix:/run/app.sock", 0)
      *          访问 /api/users 会转发为 http://127.0.0.1:8080/users
      *          当 routePrefix 为 "/" 时，也会作为本地路由未命中时的 fallback proxy
      */
@@ -217,6 +257,26 @@ public:
                uint16_t upstreamPort,
                ProxyMode mode = ProxyMode::Http);
 
+    /**
+     * @brief 挂载反向代理路由，转发到上游组
+     * @param routePrefix 路由前缀
+     * @param upstreams 上游组，例如
+     *        UpstreamGroup::create({{"10.0.0.1", 8080}, {"10.0.0.2", 8080}},
+     *                              {.policy = LoadBalancePolicy::PeakEwma})
+     * @param mode 代理模式（Http / Raw 均支持）
+     */
+    void proxy(const std::string& routePrefix,
+               UpstreamGroup::ptr upstreams,
+               ProxyMode mode = ProxyMode::Http);
+
+    /**
+     * @brief 获取反向代理统计（进程级，所有 IO 调度器汇总）
+     * @return 统计快照，包括各转发模式的请求数与字节数
+     */
+    static ProxyStatsSnapshot proxyStats() {
+        return ProxyStats::instance().snapshot();
+    }
+
 private:
     bool hasFallbackProxy() const;
     HttpRouteHandler* fallbackProxyHandler();
@@ -303,16 +363,22 @@ private:
     HttpRouteHandler createSingleFileHandler(const std::string& filePath,
                                              const StaticFileConfig& config);
 
+    /**
+     * @brief 创建计算路由处理器
+     * @param handler 在计算调度器上生成响应的函数
+     * @return 处理函数
+     */
+    static HttpRouteHandler createComputeHandler(HttpComputeHandler handler);
+
     /**
      * @brief 创建反向代理处理器
      * @param routePrefix 路由前缀
-     * @param upstreamHost 上游主机
-     * @param upstreamPort 上游端口
+     * @param upstreams 上游组
+     * @param mode 代理模式
      * @return 处理函数
      */
     HttpRouteHandler createProxyHandler(const std::string& routePrefix,
-                                        const std::string& upstreamHost,
-                                        uint16_t upstreamPort,
+                                        UpstreamGroup::ptr upstreams,
                                         ProxyMode mode);
 
     /**
@@ -332,6 +398,19 @@ private:
                                       const std::string& mimeType,
                                       const StaticFileConfig& config);
 
+    /**
+     * @brief 基于已取得的文件元数据发送文件内容
+     * @param conn HTTP连接
+     * @param req HTTP请求（用于处理 Range 和条件请求）
+     * @param meta 文件元数据快照（持有 ETag / Last-Modified / 预构造 304）
+     * @param config 静态文件传输配置
+     * @return 协程
+     */
+    static Task<void> sendFileContent(HttpConn& conn,
+                                      HttpRequest& req,
+                                      std::shared_ptr<const StaticFileMeta> meta,
+                                      const StaticFileConfig& config);
+
     /**
      * @brief 发送单个 Range 响应（206 Partial Content）
      * @param conn HTTP连接
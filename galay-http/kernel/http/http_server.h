@@ -15,15 +15,33 @@
 
 #include "http_conn.h"
 #include "http_router.h"
+#include "content_etag.h"
+#include "http_listener.h"
+#include "conn_balancer.h"
+#include "compute_offload.h"
+#include "http_deadline.h"
+#include "admission.h"
+#include "server_drain.h"
+#include "worker_pool.h"
+#include "galay-http/kernel/wheel_driver.h"
 #include "galay-http/common/http_log.h"
 #include "galay-http/utils/rsp_bld.h"
 #include "galay-kernel/async/tcp_socket.h"
 #include "galay-kernel/kernel/runtime.h"
+#include "galay-kernel/concurrency/mpsc_channel.h"
+#include <algorithm>
 #include <memory>
 #include <atomic>
 #include <functional>
 #include <cstdint>
 #include <optional>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
 
 #if defined(__linux__)
 #include <pthread.h>
@@ -33,6 +51,7 @@
 #ifdef GALAY_HTTP_SSL_ENABLED
 #include "galay-ssl/async/ssl_socket.h"
 #include "galay-ssl/ssl/ssl_context.h"
+#include "tls_session.h"
 #endif
 
 namespace galay::http
@@ -54,18 +73,46 @@ using HttpConnHandlerImpl = std::function<Task<void>(HttpConnImpl<SocketType>)>;
 /**
  * @brief HTTP服务器配置
  * @details
- * - `host` / `port` / `backlog` 控制监听 socket
+ * - `host` / `port` / `backlog` 控制监听 socket；`host` 为 `::` 等 IPv6 地址时默认双栈，
+ *   为 `unix:/path` 时监听 Unix domain socket
  * - `io_scheduler_count` 与 `compute_scheduler_count` 交由 `RuntimeBuilder` 创建调度器
- * - `affinity` 只描述调度器绑核策略，不会改变业务 handler 的语义
+ * - `affinity` 只描述调度器绑核策略，不会改变业务 handler 的语义；
+ *   IO 调度器全部绑核且 `reuseport_cpu_steering` 开启时，连接按接收 CPU 交给绑定在该 CPU 上的调度器
+ * - `conn_balance` 开启后 accept 循环按各调度器存活连接数与 CPU 占用把新连接转交给最空闲的调度器，
+ *   明文路由模式下还会在两次请求之间迁移空闲 keep-alive 连接
+ * - `deadlines` 在 `start(HttpRouter&&)` 模式下限制 keep-alive 空闲、读请求头、读请求体与整个请求的时间，
+ *   由每个 IO 调度器一个的时间轮统一计时，到期后关闭连接
+ * - `admission` 开启后按每调度器连接上限、在途请求上限与排队时延拒绝超出处理能力的工作，
+ *   明文连接收到预先构造的 503 + Retry-After
+ * - `idle_buffer_release` 开启后明文路由模式在两次请求之间把读空的 8KB 读缓冲归还调度器缓冲池，
+ *   以 1 字节探测读等待下一个请求，数据到达后再取回缓冲
+ * - `accept_batch` 大于 1 时每次 accept 唤醒后以非阻塞 accept4 继续取出排队连接，直到队列为空或取满
+ * - `tuning` 设置 TCP_DEFER_ACCEPT、TCP_FASTOPEN、忙轮询、收发缓冲等监听选项与 TCP_NOTSENT_LOWAT、
+ *   TCP_QUICKACK 等逐连接选项，设置失败只记录告警
+ * - `handoff_path` 非空时启动先从该 Unix socket 路径上的旧进程继承监听 fd，开始 accept 后通知旧进程排空，
+ *   再在同一路径上等待下一代进程（不支持 Linux 抽象命名空间路径）
+ * - `worker_processes` 大于 0 时为预 fork 多进程模式：主进程 bind 监听 socket 后经单线程的监管进程 fork 出工作进程，
+ *   每个工作进程运行 `io_scheduler_count` 个 IO 调度器，崩溃的工作进程自动重启（见 worker_pool.h）
  */
 struct HttpServerConfig
 {
-    std::string host = "0.0.0.0";              ///< 监听地址
-    uint16_t port = 8080;                       ///< 监听端口
+    std::string host = "0.0.0.0";              ///< 监听地址：IPv4/IPv6 字面量或 `unix:/path`
+    uint16_t port = 8080;                       ///< 监听端口（Unix 地址忽略）
     int backlog = 128;                          ///< listen backlog 队列长度
+    bool ipv6_only = false;                     ///< IPv6 监听时是否设置 IPV6_V6ONLY（默认双栈）
     size_t io_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO; ///< IO 调度器数量
     size_t compute_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO; ///< 计算调度器数量
     RuntimeAffinityConfig affinity;             ///< 调度器绑核策略
+    bool reuseport_cpu_steering = true;         ///< IO 调度器绑核时按接收 CPU 选择 listener
+    HttpConnBalanceConfig conn_balance;         ///< accept 侧连接均衡（默认关闭）
+    HttpDeadlineConfig deadlines;               ///< 读请求阶段的截止时间（路由模式）
+    HttpAdmissionConfig admission;              ///< 准入控制与排队削峰（默认关闭）
+    bool idle_buffer_release = false;           ///< 空闲 keep-alive 连接归还读缓冲（明文路由模式）
+    size_t accept_batch = 1;                    ///< 每次 accept 唤醒最多取出的连接数（1 为不批量）
+    HttpSocketTuning tuning;                    ///< 监听 socket 与已 accept 连接的内核选项（默认不设置）
+    std::string handoff_path;                   ///< 监听 fd 交接用的 Unix socket 路径（为空不交接）
+    size_t worker_processes = 0;                ///< 预 fork 工作进程数（0 为单进程）
+    std::chrono::milliseconds worker_stop_timeout{5000}; ///< 工作进程收到 SIGTERM 后排空的上限
 };
 
 /**
@@ -77,6 +124,17 @@ public:
     HttpServerBuilder& host(std::string v)              { m_config.host = std::move(v); return *this; } ///< 设置监听地址
     HttpServerBuilder& port(uint16_t v)                 { m_config.port = v; return *this; } ///< 设置监听端口
     HttpServerBuilder& backlog(int v)                   { m_config.backlog = v; return *this; } ///< 设置 listen backlog
+    HttpServerBuilder& ipv6Only(bool v)                 { m_config.ipv6_only = v; return *this; } ///< 设置 IPv6 是否仅单栈
+    HttpServerBuilder& reuseportCpuSteering(bool v)     { m_config.reuseport_cpu_steering = v; return *this; } ///< 设置绑核时是否按接收 CPU 分发连接
+    HttpServerBuilder& connBalance(HttpConnBalanceConfig v) { m_config.conn_balance = v; return *this; } ///< 设置 accept 侧连接均衡
+    HttpServerBuilder& deadlines(HttpDeadlineConfig v)  { m_config.deadlines = v; return *this; } ///< 设置读请求阶段的截止时间
+    HttpServerBuilder& admission(HttpAdmissionConfig v) { m_config.admission = v; return *this; } ///< 设置准入控制
+    HttpServerBuilder& idleBufferRelease(bool v)        { m_config.idle_buffer_release = v; return *this; } ///< 设置空闲连接是否归还读缓冲
+    HttpServerBuilder& acceptBatch(size_t v)            { m_config.accept_batch = v; return *this; } ///< 设置每次 accept 唤醒最多取出的连接数
+    HttpServerBuilder& socketTuning(HttpSocketTuning v) { m_config.tuning = v; return *this; } ///< 设置 socket 调优选项
+    HttpServerBuilder& handoffPath(std::string v)       { m_config.handoff_path = std::move(v); return *this; } ///< 设置监听 fd 交接路径
+    HttpServerBuilder& workerProcesses(size_t v)        { m_config.worker_processes = v; return *this; } ///< 设置预 fork 工作进程数
+    HttpServerBuilder& workerStopTimeout(std::chrono::milliseconds v) { m_config.worker_stop_timeout = v; return *this; } ///< 设置工作进程排空上限
     HttpServerBuilder& ioSchedulerCount(size_t v)       { m_config.io_scheduler_count = v; return *this; } ///< 设置 IO 调度器数量
     HttpServerBuilder& computeSchedulerCount(size_t v)  { m_config.compute_scheduler_count = v; return *this; } ///< 设置计算调度器数量
     /**
@@ -124,6 +182,9 @@ private:
  * - 服务器独占持有内部 `Runtime`
  * - `start()` 成功后会启动 runtime，并在每个 IO 调度器上创建监听/accept 循环
  * - `stop()` 可重复调用；第一次调用会关闭 listener 并停止 runtime
+ * - `beginDrain()` 停止 accept 并通知空闲连接关闭；`gracefulStop(timeout)` 排空后再停止
+ * - 预 fork 模式下 `start()` 在主进程中返回，工作进程不会返回到调用方；主进程的 `stop()` / `gracefulStop()`
+ *   向工作进程发送 SIGTERM，工作进程排空（至多 `worker_stop_timeout`）后退出
  *
  * 处理器约束：
  * - 传入的 `ConnHandler` / 路由 handler 必须在协程结束前完成连接相关资源的合法使用
@@ -180,11 +241,32 @@ public:
 
         m_handler = [this](HttpConnImpl<SocketType> conn) -> Task<void> {
             bool keep_alive = true;
+            bool first_request = true;
+            RequestDeadlineTimer deadline_timer;
+            IdleDrainNode idle_node;
 
             while (keep_alive) {
-                auto reader = conn.getReader();
                 HttpRequest request;
+                // 等待下一个请求期间挂在排空表上；服务器已在排空时直接关闭
+                if (!first_request && !idle_node.watch(conn, request)) {
+                    break;
+                }
+                if (m_config.deadlines.enabled) {
+                    deadline_timer.begin(m_config.deadlines, conn, request, first_request);
+                    co_await ensureWheelDriver();
+                }
+                if constexpr (std::is_same_v<SocketType, TcpSocket>) {
+                    if (m_config.idle_buffer_release && !first_request && !co_await conn.awaitIdleData()) {
+                        deadline_timer.cancel();
+                        idle_node.unlink();
+                        break;
+                    }
+                }
+                first_request = false;
+                auto reader = conn.getReader();
                 auto read_result = co_await reader.getRequest(request);
+                deadline_timer.cancel();
+                idle_node.unlink();
 
                 if (!read_result) {
                     const auto& error = read_result.error();
@@ -205,8 +287,15 @@ public:
                     }
                     break;
                 }
+                if (auto* counters = currentWorkerCounters()) {
+                    counters->onRequest();
+                }
 
                 keep_alive = request.header().isKeepAlive() && !request.header().isConnectionClose();
+                if (keep_alive && m_drain.draining()) {
+                    keep_alive = false;
+                    conn.requestClose();
+                }
 
                 auto match = m_router->findHandler(request.header().method(), request.header().uri());
 
@@ -235,7 +324,14 @@ public:
                 }
 
                 if constexpr (std::is_same_v<SocketType, TcpSocket>) {
+                    const HttpAdmissionVerdict verdict = m_admission.beginRequest(currentSchedulerSlot());
+                    if (verdict != HttpAdmissionVerdict::Admit) {
+                        HTTP_LOG_DEBUG("[admission] [shed]", "reason={}", toString(verdict));
+                        HttpAdmissionControl::writeRejection(conn.getSocket().handle().fd, m_admission.rejectResponse());
+                        break;
+                    }
                     co_await (*match.handler)(conn, std::move(request));
+                    m_admission.endRequest();
                 } else {
                     break;
                 }
@@ -243,6 +339,12 @@ public:
                 if (!keep_alive) {
                     break;
                 }
+
+                if constexpr (std::is_same_v<SocketType, TcpSocket>) {
+                    if (m_balancer.enabled() && co_await migrateIdleConnection(conn)) {
+                        co_return;
+                    }
+                }
             }
 
             co_await conn.close();
@@ -263,12 +365,115 @@ public:
 
         m_running.store(false);
 
+        if (m_workers.master()) {
+            m_workers.stop(m_config.worker_stop_timeout + kWorkerKillGrace);
+            m_listen.close();
+            HTTP_LOG_INFO("[server] [prefork] [stopped]", "workers={}", m_config.worker_processes);
+            return;
+        }
+
         if (m_listener) {
             m_listener.reset();
         }
 
+        for (auto& channel : m_handoff) {
+            channel->send(HttpConnHandoff{});
+        }
+
+        ContentETagStore::instance().clearExecutor(this);
         m_runtime.stop();
+        m_listen.close();
+        m_drain.onStopped();
+
+        // 运行时停止后仍在队列中的连接直接关闭
+        for (auto& channel : m_handoff) {
+            while (auto handoff = channel->tryRecv()) {
+                if (handoff->fd >= 0) {
+                    ::close(handoff->fd);
+                }
+            }
+        }
+        m_handoff.clear();
+
+    }
+
+    /**
+     * @brief 开始排空：停止 accept，通知空闲 keep-alive 连接关闭
+     * @details 非阻塞，可重复调用。正在处理的请求继续完成，响应头带 `Connection: close` 后关闭连接。
+     *          监听 fd 已交给新进程时监听 socket 由新进程继续使用，不唤醒 accept 循环也不卸载 CPU 引导程序；
+     *          此时仍阻塞在 accept 上的循环至多再取到一个连接，照常处理后退出
+     */
+    void beginDrain() {
+        if (m_workers.master()) {
+            if (m_running.load() && !m_workers.stopping()) {
+                HTTP_LOG_INFO("[server] [prefork] [drain]", "workers={}", m_config.worker_processes);
+                m_workers.drain();
+            }
+            return;
+        }
+        if (!m_running.load() || !m_drain.begin(m_runtime)) {
+            return;
+        }
+        HTTP_LOG_INFO("[server] [drain]", "active={} handed_off={}",
+                      m_drain.activeConnections(), m_drain.handedOff());
+        // 工作进程之间共享监听 socket，唤醒连接可能落到其他工作进程，只等 runtime 停止时收回 accept 循环
+        if (!m_drain.handedOff() && !m_workers.isWorker()) {
+            m_listen.detachSteering();
+            m_listen.wakeAcceptLoops(m_runtime.getIOSchedulerCount());
+        }
+    }
+
+    /**
+     * @brief 排空后停止服务器
+     * @param timeout 等待存活连接结束的上限；超时后仍在处理的连接随 runtime 停止而中断
+     * @return 超时前全部连接已结束返回 true
+     */
+    bool gracefulStop(std::chrono::milliseconds timeout) {
+        if (!m_running.load()) {
+            return true;
+        }
+        if (m_workers.master()) {
+            const bool drained = m_workers.stop(timeout);
+            stop();
+            return drained;
+        }
+        beginDrain();
+        const bool drained = m_drain.waitIdle(timeout);
+        stop();
+        return drained;
+    }
+
+    /**
+     * @brief 是否已开始排空
+     */
+    bool draining() const {
+        return m_drain.draining() || m_workers.stopping();
+    }
+
+    /**
+     * @brief 监听 fd 是否已交给新进程（此后服务器自动进入排空）
+     */
+    bool handedOff() const {
+        return m_drain.handedOff();
+    }
 
+    /**
+     * @brief 已开始处理、尚未结束的连接数
+     */
+    size_t activeConnections() const {
+        if (m_workers.master()) {
+            return static_cast<size_t>(std::max<int64_t>(m_workers.snapshot().active, 0));
+        }
+        return m_drain.activeConnections();
+    }
+
+    /**
+     * @brief 预 fork 模式下全部工作进程的计数器汇总
+     * @details 直接读取共享内存，主进程与工作进程中均可调用（可在路由中挂一个统计端点返回 `toText()`）；
+     *          单进程模式返回空快照
+     */
+    HttpWorkerStats workerStats() const {
+        return m_workers.snapshot();
     }
 
     /**
@@ -287,7 +492,31 @@ public:
         return m_runtime;
     }
 
+    /**
+     * @brief 各 IO 调度器的 accept 分布
+     * @details `cpu_steering` 表示是否已按接收 CPU 分发；`cpu_local` 为连接接收 CPU 与调度器绑定 CPU 一致的数量
+     */
+    HttpAcceptStats acceptStats() const {
+        return m_listen.acceptStats();
+    }
+
+    /**
+     * @brief 连接均衡统计：各 IO 调度器的存活连接数、CPU 占用与转交/迁移进来的连接数
+     */
+    HttpConnBalanceStats connBalanceStats() const {
+        return m_balancer.snapshot();
+    }
+
+    /**
+     * @brief 准入控制统计：在途请求数、各调度器存活连接数与各原因的拒绝数
+     */
+    HttpAdmissionStats admissionStats() const {
+        return m_admission.snapshot();
+    }
+
 protected:
+    static constexpr std::chrono::milliseconds kWorkerKillGrace{1000};  ///< 主进程 stop() 在工作进程排空上限之外多等的时间
+
     /**
      * @brief 内部启动实现
      * @return 成功返回 true
@@ -302,97 +531,500 @@ protected:
             return false;
         }
 
+        const size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
+        const bool prefork = m_config.worker_processes > 0;
+        std::vector<int> steer_cpus;
+        // 多个工作进程共享同一组 listener，按 CPU 引导无法对应到某个进程的调度器
+        if (m_config.reuseport_cpu_steering && !prefork) {
+            steer_cpus = pinnedIoSchedulerCpus(m_config.affinity, io_scheduler_count);
+        }
+        if (prefork && !m_config.handoff_path.empty()) {
+            HTTP_LOG_WARN("[server] [prefork]", "handoff_path ignored in prefork mode");
+        }
+        m_drain.reset(prefork ? std::string() : m_config.handoff_path);
+        m_drain.prepareListen(m_listen);
+        // 预 fork 模式下主进程预先创建整组 listener，工作进程继承后各自 dup
+        m_listen.requireListenerGroup(prefork || !m_config.handoff_path.empty());
+        if (!m_listen.open(m_config.host, m_config.port, m_config.backlog, m_config.ipv6_only,
+                           io_scheduler_count, steer_cpus, m_config.tuning)) {
+            return false;
+        }
+
+        m_balancer.reset(io_scheduler_count, m_config.conn_balance);
+        m_admission.reset(io_scheduler_count, m_config.admission);
+        m_handoff.clear();
+        if (m_balancer.enabled()) {
+            for (size_t i = 0; i < io_scheduler_count; ++i) {
+                m_handoff.push_back(std::make_unique<MpscChannel<HttpConnHandoff>>());
+            }
+        }
+
+        if (prefork) {
+            return startWorkers();
+        }
+        startLoops();
+        return true;
+    }
 
+    /**
+     * @brief 启动 runtime 并在每个 IO 调度器上启动 serverLoop（单进程模式或工作进程中调用）
+     */
+    void startLoops() {
+        const size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
         m_runtime.start();
+        // 调度器的 epoll 实例在 start() 中创建；迁移空闲连接前要从中注销原 fd
+        m_epoll_fds.clear();
+        if (m_balancer.enabled() && m_balancer.config().migrate_idle) {
+            m_epoll_fds = detail::listEpollFds();
+        }
 
+        // 有计算调度器时，内容 ETag 等后台任务投递到计算调度器执行
+        if (m_runtime.getComputeSchedulerCount() > 0) {
+            ContentETagStore::instance().setExecutor(this, [this](std::function<void()> job) {
+                auto* scheduler = m_runtime.getNextComputeScheduler();
+                return scheduler != nullptr && scheduleTask(scheduler, runComputeJob(std::move(job)));
+            });
+        }
 
         m_running.store(true);
 
         // 在每个 IO 调度器上启动一个 serverLoop，每个 serverLoop 创建自己的 listener
         // 利用 SO_REUSEPORT 实现多线程 accept
-        size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
         for (size_t i = 0; i < io_scheduler_count; i++) {
             auto* scheduler = m_runtime.getIOScheduler(i);
             if (scheduler) {
-                scheduleTask(scheduler, serverLoop(scheduler));
+                scheduleTask(scheduler, serverLoop(scheduler, i));
+                if (m_balancer.enabled()) {
+                    scheduleTask(scheduler, handoffLoop(scheduler, i));
+                }
             }
         }
+        m_drain.onStarted(m_runtime, m_listen, [this] { beginDrain(); });
+    }
 
+    /**
+     * @brief 预 fork 模式：fork 出工作进程，主进程只负责监管
+     */
+    bool startWorkers() {
+        std::string error;
+        m_running.store(true);
+        const bool started = m_workers.start(
+            m_config.worker_processes, m_runtime.getIOSchedulerCount(),
+            [this](size_t worker) { runWorker(worker); },
+            [](size_t worker, int pid, int status, bool respawn) {
+                HTTP_LOG_WARN("[server] [prefork] [exit]", "worker={} pid={} status={} respawn={}",
+                              worker, pid, status, respawn);
+            },
+            error);
+        if (!started) {
+            m_running.store(false);
+            m_listen.close();
+            HTTP_LOG_ERROR("[server] [prefork] [fail]", "error={}", error);
+            return false;
+        }
+        HTTP_LOG_INFO("[server] [prefork]", "workers={} io_schedulers={}",
+                      m_config.worker_processes, m_runtime.getIOSchedulerCount());
         return true;
     }
 
     /**
-     * @brief 服务器 accept 循环
-     * @param scheduler 当前 IO 调度器
-     * @details 每个 IO 调度器上运行一个独立的 serverLoop，
-     *          创建独立的 listener socket，利用 SO_REUSEPORT 实现多线程 accept。
+     * @brief 工作进程入口：运行服务循环直到收到 SIGTERM / SIGINT，排空后停止 runtime
+     * @details 信号在启动 runtime 之前屏蔽，调度器线程继承屏蔽字，信号只由本线程 sigwait 接收
      */
-    virtual Task<void> serverLoop(IOScheduler* scheduler) {
-        // 每个 serverLoop 创建自己的 listener socket
-        TcpSocket listener(IPType::IPV4);
+    void runWorker(size_t worker) {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGINT);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        startLoops();
+        HTTP_LOG_INFO("[server] [worker] [start]", "worker={} pid={}", worker, ::getpid());
+
+        int signo = 0;
+        sigwait(&signals, &signo);
+        beginDrain();
+        const bool drained = m_drain.waitIdle(m_config.worker_stop_timeout);
+        HTTP_LOG_INFO("[server] [worker] [stop]", "worker={} signal={} drained={}", worker, signo, drained);
+        m_runtime.stop();
+    }
 
+    /**
+     * @brief 当前工作进程中 index 号调度器的共享计数器槽位（单进程模式为 nullptr）
+     */
+    HttpWorkerCounters* workerCounters(size_t index) const {
+        const auto worker = m_workers.workerIndex();
+        return worker ? m_workers.counters(*worker, index) : nullptr;
+    }
 
-        auto reuse_result = listener.option().handleReuseAddr();
-        if (!reuse_result) {
-            co_return;
+    /**
+     * @brief 等待请求期间挂在时间轮上的截止时间检查
+     * @details 到期时按读缓冲与请求解析进度推进阶段；判定超时后 shutdown 连接，
+     *          阻塞中的读操作随之返回，由请求循环按断连处理并关闭
+     */
+    struct RequestDeadlineTimer : TimingWheel::Timer
+    {
+        RequestDeadlineTimer()
+            : TimingWheel::Timer(&RequestDeadlineTimer::onCheck)
+        {
         }
 
-        // 设置 SO_REUSEPORT 以支持多线程 accept
-        auto reuse_port_result = listener.option().handleReusePort();
-        if (!reuse_port_result) {
-            co_return;
+        void begin(const HttpDeadlineConfig& config, HttpConnImpl<SocketType>& conn,
+                   HttpRequest& request, bool first_request)
+        {
+            m_conn = &conn;
+            m_request = &request;
+            m_fd = conn.getSocket().handle().fd;
+            m_deadline.begin(config, TimingWheel::Clock::now(), first_request, conn.bufferedBytes());
+            rearm();
         }
 
-        auto nonblock_result = listener.option().handleNonBlock();
-        if (!nonblock_result) {
-            co_return;
+    private:
+        void rearm()
+        {
+            const auto next = m_deadline.nextCheck();
+            if (next == TimingWheel::Clock::time_point::max()) {
+                cancel();
+                return;
+            }
+            TimingWheel::local().arm(*this, next);
         }
 
-        Host bind_host(IPType::IPV4, m_config.host, m_config.port);
-        auto bind_result = listener.bind(bind_host);
-        if (!bind_result) {
-            co_return;
+        static void onCheck(TimingWheel::Timer& timer)
+        {
+            auto& self = static_cast<RequestDeadlineTimer&>(timer);
+            HttpReadProgress progress;
+            progress.buffered = self.m_conn->bufferedBytes();
+            progress.header_complete = self.m_request->isHeaderComplete();
+            progress.body_received = self.m_request->bodyParsedSize();
+            const auto expiry = self.m_deadline.check(progress, TimingWheel::Clock::now());
+            if (expiry == HttpDeadlineExpiry::None) {
+                self.rearm();
+                return;
+            }
+            HTTP_LOG_DEBUG("[deadline] [expire]", "phase={} fd={}", toString(expiry), self.m_fd);
+            ::shutdown(self.m_fd, SHUT_RDWR);
         }
 
-        auto listen_result = listener.listen(m_config.backlog);
-        if (!listen_result) {
-            co_return;
+        HttpRequestDeadline m_deadline;
+        HttpConnImpl<SocketType>* m_conn = nullptr;
+        HttpRequest* m_request = nullptr;
+        int m_fd = -1;
+    };
+
+    /**
+     * @brief 等待下一个请求期间挂在排空表上的节点
+     * @details 排空时读缓冲为空、请求头尚未开始且 socket 中没有未读数据的连接被 shutdown，
+     *          阻塞中的读操作随之返回，由请求循环按断连处理并关闭；已收到部分请求的连接继续处理，响应后关闭
+     */
+    struct IdleDrainNode : HttpDrainList::Node
+    {
+        IdleDrainNode()
+            : HttpDrainList::Node(&IdleDrainNode::onDrain)
+        {
         }
 
+        /**
+         * @return 服务器已在排空时返回 false，调用方应关闭连接
+         */
+        bool watch(HttpConnImpl<SocketType>& conn, HttpRequest& request)
+        {
+            m_conn = &conn;
+            m_request = &request;
+            return HttpDrainList::local().add(*this);
+        }
 
-        while (m_running.load()) {
-            Host client_host;
-            auto accept_result = co_await listener.accept(&client_host);
+    private:
+        static void onDrain(HttpDrainList::Node& node)
+        {
+            auto& self = static_cast<IdleDrainNode&>(node);
+            const int fd = self.m_conn->getSocket().handle().fd;
+            int pending = 0;
+            if (self.m_conn->bufferedBytes() != 0 || self.m_request->isHeaderComplete() ||
+                (::ioctl(fd, FIONREAD, &pending) == 0 && pending > 0)) {
+                return;
+            }
+            HTTP_LOG_DEBUG("[drain] [idle-close]", "fd={}", fd);
+            ::shutdown(fd, SHUT_RDWR);
+        }
+
+        HttpConnImpl<SocketType>* m_conn = nullptr;
+        HttpRequest* m_request = nullptr;
+    };
+
+    /**
+     * @brief 在计算调度器上执行一个阻塞任务
+     */
+    static Task<void> runComputeJob(std::function<void()> job) {
+        job();
+        co_return;
+    }
 
-            if (!accept_result) {
-                if (m_running.load()) {
-                    HTTP_LOG_WARN("[accept] [fail]", "error={}", accept_result.error().message());
+    /**
+     * @brief 服务器 accept 循环
+     * @param scheduler 当前 IO 调度器
+     * @param index 当前 IO 调度器的下标
+     * @details 每个 IO 调度器上运行一个独立的 serverLoop，
+     *          创建独立的 listener socket，利用 SO_REUSEPORT 实现多线程 accept。
+     */
+    virtual Task<void> serverLoop(IOScheduler* scheduler, size_t index) {
+        currentSchedulerSlot() = index;
+        currentComputeRuntime() = &m_runtime;
+        HttpDrainList::local().reset();
+        currentWorkerCounters() = workerCounters(index);
+        // 每个 serverLoop 创建自己的 listener socket（Unix 地址共享同一监听队列）
+        auto listener_opt = m_listen.createListener(index);
+        if (!listener_opt) {
+            co_return;
+        }
+        TcpSocket& listener = *listener_opt;
+        HttpAcceptBatch batch(listener.handle().fd, m_config.accept_batch);
+
+        // 排空开始后不再 accept；阻塞中的 accept 返回的连接照常处理
+        while (m_running.load() && !m_drain.draining()) {
+            GHandle handle{};
+            const int batched_fd = batch.next();
+            const bool batched = batched_fd >= 0;
+            if (batched) {
+                handle = GHandle{batched_fd};
+            } else {
+                Host client_host;
+                auto accept_result = co_await listener.accept(&client_host);
+
+                if (!accept_result) {
+                    if (m_running.load()) {
+                        HTTP_LOG_WARN("[accept] [fail]", "error={}", accept_result.error().message());
+                    }
+                    continue;
                 }
+                handle = accept_result.value();
+                batch.arm();
+            }
+            m_listen.recordAccept(index, handle.fd, batched);
+            m_listen.tuneAccepted(handle.fd);
+            if (auto* counters = currentWorkerCounters()) {
+                counters->onAccept();
+            }
+            const auto accepted_at = acceptedAt();
+            if (m_balancer.enabled() && balanceAccepted(index, handle.fd, accepted_at)) {
                 continue;
             }
 
-
-            auto client_socket_opt = createClientSocket(accept_result.value());
+            auto client_socket_opt = createClientSocket(handle);
             if (!client_socket_opt) {
                 continue;
             }
 
 
+            SocketType client_socket = std::move(*client_socket_opt);
+            // 批量取出的 fd 已由 accept4 设为非阻塞
+            if (!batched && !client_socket.option().handleNonBlock()) {
+                continue;
+            }
+            if (!admitConnection(index, client_socket)) {
+                co_await client_socket.close();
+                continue;
+            }
+
+            // 在当前调度器上处理连接
+            if (m_balancer.enabled() || m_admission.enabled()) {
+                onTrackedOpen(index);
+                scheduleTask(scheduler, serveTracked(index, accepted_at, std::move(client_socket)));
+            } else {
+                HttpConnImpl<SocketType> conn(std::move(client_socket));
+                scheduleTask(scheduler, serveConn(std::move(conn)));
+            }
+        }
+
+        co_await listener.close();
+        co_return;
+    }
+
+    /**
+     * @brief 为刚 accept 的连接挑选调度器
+     * @return 已转交给其他调度器（或转交失败已关闭）时返回 true；留在本地返回 false
+     * @details 目标调度器的存活计数在此立即增加，使同一批 accept 不会全部涌向同一个调度器；
+     *          留在本地的连接在交给 serveTracked 前计数
+     */
+    bool balanceAccepted(size_t index, int fd, std::chrono::steady_clock::time_point accepted_at) {
+        m_balancer.sampleBusy(index);
+        const size_t target = m_balancer.pick(index);
+        if (target == HttpConnBalancer::kStay) {
+            return false;
+        }
+        m_balancer.onOpen(target);
+        if (!m_running.load() || target >= m_handoff.size()) {
+            ::close(fd);
+            m_balancer.onClose(target);
+            return true;
+        }
+        m_handoff[target]->send(HttpConnHandoff{fd, false, accepted_at});
+        return true;
+    }
+
+    /**
+     * @brief 接收其他调度器转交来的连接
+     * @param index 当前 IO 调度器的下标
+     * @details 每个 IO 调度器一个 MPSC 队列，任意 accept 循环可写入，只由本协程消费
+     */
+    Task<void> handoffLoop(IOScheduler* scheduler, size_t index) {
+        auto& channel = *m_handoff[index];
+        while (m_running.load()) {
+            auto handoff_result = co_await channel.recv();
+            if (!handoff_result || handoff_result.value().fd < 0) {
+                break;
+            }
+            const HttpConnHandoff handoff = handoff_result.value();
+            if (handoff.migrated) {
+                m_balancer.onMigratedIn(index);
+            } else {
+                m_balancer.onHandedIn(index);
+            }
+
+            auto client_socket_opt = createClientSocket(GHandle{handoff.fd});
+            if (!client_socket_opt) {
+                ::close(handoff.fd);
+                m_balancer.onClose(index);
+                continue;
+            }
             SocketType client_socket = std::move(*client_socket_opt);
             auto nonblock_result = client_socket.option().handleNonBlock();
             if (!nonblock_result) {
+                co_await client_socket.close();
+                m_balancer.onClose(index);
                 continue;
             }
+            // 迁移来的空闲连接已准入过，只计数
+            if (handoff.migrated) {
+                m_admission.adoptConnection(index);
+            } else if (!admitConnection(index, client_socket)) {
+                co_await client_socket.close();
+                m_balancer.onClose(index);
+                continue;
+            }
+            if (!scheduleTask(scheduler, serveTracked(index, handoff.accepted_at, std::move(client_socket)))) {
+                onTrackedClose(index);
+            }
+        }
+        co_return;
+    }
 
-            HttpConnImpl<SocketType> conn(std::move(client_socket));
-
-            // 在当前调度器上处理连接
-            scheduleTask(scheduler, m_handler(std::move(conn)));
+    /**
+     * @brief 在均衡或准入控制模式下处理一个连接，结束时从负载表与连接配额中扣除
+     * @param index 连接所在 IO 调度器的下标（HttpsServer 在此完成 TLS 握手）
+     * @param accepted_at accept 时间，用于排队时延判定；默认值表示不判定
+     */
+    virtual Task<void> serveTracked(size_t index, std::chrono::steady_clock::time_point accepted_at, SocketType socket) {
+        if (shedQueued(index, accepted_at, socket)) {
+            co_await socket.close();
+        } else {
+            HttpConnImpl<SocketType> conn(std::move(socket));
+            co_await serveConn(std::move(conn));
         }
+        onTrackedClose(index);
+        co_return;
+    }
 
+    /**
+     * @brief 执行连接处理器，计入存活连接数（排空时等待其归零）
+     */
+    Task<void> serveConn(HttpConnImpl<SocketType> conn) {
+        // 连接可能迁移到其他调度器，开、关计在同一槽位上
+        auto* counters = currentWorkerCounters();
+        m_drain.onConnOpen();
+        if (counters != nullptr) {
+            counters->onConnOpen();
+        }
+        co_await m_handler(std::move(conn));
+        if (counters != nullptr) {
+            counters->onConnClose();
+        }
+        m_drain.onConnClose();
         co_return;
     }
 
+    /**
+     * @brief 准入控制开启时记录 accept 时间
+     */
+    std::chrono::steady_clock::time_point acceptedAt() const {
+        return m_admission.enabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    }
+
+    /**
+     * @brief 为新连接占用本调度器的连接配额
+     * @return 配额已满时返回 false；明文连接已写出 503，调用方负责关闭
+     */
+    bool admitConnection(size_t index, SocketType& socket) {
+        if (m_admission.tryOpenConnection(index)) {
+            return true;
+        }
+        HTTP_LOG_DEBUG("[admission] [reject]", "reason={} scheduler={}",
+                       toString(HttpAdmissionVerdict::ConnectionLimit), index);
+        if constexpr (std::is_same_v<SocketType, TcpSocket>) {
+            HttpAdmissionControl::writeRejection(socket.handle().fd, m_admission.rejectResponse());
+        }
+        return false;
+    }
+
+    /**
+     * @brief 连接处理器启动时按 accept 以来的排队时延判定是否丢弃
+     * @return 应丢弃时返回 true；明文连接已写出 503，TLS 连接在握手前直接关闭
+     */
+    bool shedQueued(size_t index, std::chrono::steady_clock::time_point accepted_at, SocketType& socket) {
+        if (m_admission.checkQueueDelay(index, accepted_at) == HttpAdmissionVerdict::Admit) {
+            return false;
+        }
+        HTTP_LOG_DEBUG("[admission] [shed]", "reason={} scheduler={}",
+                       toString(HttpAdmissionVerdict::QueueDelay), index);
+        if constexpr (std::is_same_v<SocketType, TcpSocket>) {
+            HttpAdmissionControl::writeRejection(socket.handle().fd, m_admission.rejectResponse());
+        }
+        return true;
+    }
+
+    void onTrackedOpen(size_t index) {
+        if (m_balancer.enabled()) {
+            m_balancer.onOpen(index);
+        }
+    }
+
+    void onTrackedClose(size_t index) {
+        if (m_balancer.enabled()) {
+            m_balancer.onClose(index);
+        }
+        m_admission.onConnectionClose(index);
+    }
+
+    /**
+     * @brief 两次请求之间把空闲 keep-alive 连接迁移到更空闲的调度器
+     * @return 已迁移（当前协程应直接返回）时为 true
+     * @details 仅在读缓冲为空时迁移，避免丢失已读入的流水线请求。
+     *          dup 出的 fd 仍引用同一 socket，关闭原 fd 时对端不会收到 FIN；但 epoll 注册要等引用该 socket 的
+     *          所有 fd 都关闭才会消失，因此关闭前先从本进程的 epoll 实例中显式删除原 fd 的注册，
+     *          避免旧调度器继续收到已迁走 socket 的事件。目标调度器从 MPSC 队列取出 dup 的 fd 后重新建立连接对象。
+     */
+    Task<bool> migrateIdleConnection(HttpConnImpl<SocketType>& conn) {
+        const size_t self = currentSchedulerSlot();
+        m_balancer.sampleBusy(self);
+        if (!m_balancer.config().migrate_idle || conn.bufferedBytes() != 0) {
+            co_return false;
+        }
+        const size_t target = m_balancer.migrationTarget(self);
+        if (target == HttpConnBalancer::kStay || target >= m_handoff.size() || !m_running.load()) {
+            co_return false;
+        }
+        const int fd = ::dup(conn.getSocket().handle().fd);
+        if (fd < 0) {
+            co_return false;
+        }
+        m_balancer.onOpen(target);
+        detail::dropEpollRegistrations(conn.getSocket().handle().fd, m_epoll_fds);
+        co_await conn.close();
+        m_handoff[target]->send(HttpConnHandoff{fd, true});
+        HTTP_LOG_DEBUG("[balance] [migrate]", "from={} to={}", self, target);
+        co_return true;
+    }
+
     /**
      * @brief 根据文件描述符创建客户端 Socket
      * @param fd accept 获得的文件描述符
@@ -413,6 +1045,13 @@ protected:
     ConnHandler m_handler;                  ///< 连接处理器
     std::optional<HttpRouter> m_router;     ///< 路由表（路由模式下使用）
     std::unique_ptr<TcpSocket> m_listener;  ///< 监听 Socket（已弃用，每个 loop 独立创建）
+    HttpListenEndpoint m_listen;            ///< 监听地址与 Unix 共享监听 fd
+    HttpConnBalancer m_balancer;            ///< 各 IO 调度器负载表（conn_balance 启用时使用）
+    HttpAdmissionControl m_admission;       ///< 准入控制状态（admission 启用时使用）
+    HttpServerDrain m_drain;                ///< 排空状态、存活连接数与监听 fd 交接
+    HttpWorkerPool m_workers;               ///< 预 fork 模式的工作进程池与共享计数器
+    std::vector<std::unique_ptr<MpscChannel<HttpConnHandoff>>> m_handoff; ///< 各 IO 调度器的连接转交队列
+    std::vector<int> m_epoll_fds;           ///< 本进程的 epoll 实例（迁移空闲连接前注销原 fd 用）
     std::atomic<bool> m_running;            ///< 运行状态标志
 };
 
@@ -427,16 +1066,27 @@ inline HttpServer HttpServerBuilder::build() const { return HttpServer(m_config)
  * @details
  * - `cert_path` / `key_path` 是 TLS 服务端证书与私钥
  * - `ca_path`、`verify_peer`、`verify_depth` 用于双向 TLS 或客户端证书校验
+ * - `tls_session` 配置会话恢复：默认开启轮换密钥的会话票据，服务端会话缓存按 IO 调度器数分片（默认关闭）
  * - `reader_setting` / `writer_setting` 仅在 TLS 连接路径上生效
  */
 struct HttpsServerConfig
 {
-    std::string host = "0.0.0.0";              ///< 监听地址
-    uint16_t port = 443;                        ///< 监听端口
+    std::string host = "0.0.0.0";              ///< 监听地址：IPv4/IPv6 字面量或 `unix:/path`
+    uint16_t port = 443;                        ///< 监听端口（Unix 地址忽略）
     int backlog = 128;                          ///< listen backlog 队列长度
+    bool ipv6_only = false;                     ///< IPv6 监听时是否设置 IPV6_V6ONLY（默认双栈）
     size_t io_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO; ///< IO 调度器数量
     size_t compute_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO; ///< 计算调度器数量
     RuntimeAffinityConfig affinity;             ///< 调度器绑核策略
+    bool reuseport_cpu_steering = true;         ///< IO 调度器绑核时按接收 CPU 选择 listener
+    HttpConnBalanceConfig conn_balance;         ///< accept 侧连接均衡（默认关闭）
+    HttpDeadlineConfig deadlines;               ///< 读请求阶段的截止时间（路由模式）
+    HttpAdmissionConfig admission;              ///< 准入控制与排队削峰（默认关闭）
+    size_t accept_batch = 1;                    ///< 每次 accept 唤醒最多取出的连接数（1 为不批量）
+    HttpSocketTuning tuning;                    ///< 监听 socket 与已 accept 连接的内核选项（默认不设置）
+    std::string handoff_path;                   ///< 监听 fd 交接用的 Unix socket 路径（为空不交接）
+    size_t worker_processes = 0;                ///< 预 fork 工作进程数（0 为单进程）
+    std::chrono::milliseconds worker_stop_timeout{5000}; ///< 工作进程收到 SIGTERM 后排空的上限
     HttpReaderSetting reader_setting;           ///< TLS 连接的读取器配置
     HttpWriterSetting writer_setting;           ///< TLS 连接的写入器配置
     std::string cert_path;                      ///< TLS 服务端证书路径
@@ -444,6 +1094,7 @@ struct HttpsServerConfig
     std::string ca_path;                        ///< CA 证书路径（用于客户端证书校验）
     bool verify_peer = false;                   ///< 是否校验客户端证书
     int verify_depth = 4;                       ///< 证书链校验深度
+    HttpTlsSessionConfig tls_session;           ///< TLS 会话恢复（票据与服务端会话缓存）
 };
 
 class HttpsServer;
@@ -457,6 +1108,16 @@ public:
     HttpsServerBuilder& host(std::string v)              { m_config.host = std::move(v); return *this; } ///< 设置监听地址
     HttpsServerBuilder& port(uint16_t v)                 { m_config.port = v; return *this; } ///< 设置监听端口
     HttpsServerBuilder& backlog(int v)                   { m_config.backlog = v; return *this; } ///< 设置 listen backlog
+    HttpsServerBuilder& ipv6Only(bool v)                 { m_config.ipv6_only = v; return *this; } ///< 设置 IPv6 是否仅单栈
+    HttpsServerBuilder& reuseportCpuSteering(bool v)     { m_config.reuseport_cpu_steering = v; return *this; } ///< 设置绑核时是否按接收 CPU 分发连接
+    HttpsServerBuilder& connBalance(HttpConnBalanceConfig v) { m_config.conn_balance = v; return *this; } ///< 设置 accept 侧连接均衡
+    HttpsServerBuilder& deadlines(HttpDeadlineConfig v)  { m_config.deadlines = v; return *this; } ///< 设置读请求阶段的截止时间
+    HttpsServerBuilder& admission(HttpAdmissionConfig v) { m_config.admission = v; return *this; } ///< 设置准入控制
+    HttpsServerBuilder& acceptBatch(size_t v)            { m_config.accept_batch = v; return *this; } ///< 设置每次 accept 唤醒最多取出的连接数
+    HttpsServerBuilder& socketTuning(HttpSocketTuning v) { m_config.tuning = v; return *this; } ///< 设置 socket 调优选项
+    HttpsServerBuilder& handoffPath(std::string v)       { m_config.handoff_path = std::move(v); return *this; } ///< 设置监听 fd 交接路径
+    HttpsServerBuilder& workerProcesses(size_t v)        { m_config.worker_processes = v; return *this; } ///< 设置预 fork 工作进程数
+    HttpsServerBuilder& workerStopTimeout(std::chrono::milliseconds v) { m_config.worker_stop_timeout = v; return *this; } ///< 设置工作进程排空上限
     HttpsServerBuilder& ioSchedulerCount(size_t v)       { m_config.io_scheduler_count = v; return *this; } ///< 设置 IO 调度器数量
     HttpsServerBuilder& computeSchedulerCount(size_t v)  { m_config.compute_scheduler_count = v; return *this; } ///< 设置计算调度器数量
     HttpsServerBuilder& sequentialAffinity(size_t io_count, size_t compute_count) {
@@ -480,6 +1141,7 @@ public:
     HttpsServerBuilder& caPath(std::string v)            { m_config.ca_path = std::move(v); return *this; } ///< 设置 CA 证书路径
     HttpsServerBuilder& verifyPeer(bool v)               { m_config.verify_peer = v; return *this; } ///< 设置是否校验客户端证书
     HttpsServerBuilder& verifyDepth(int v)               { m_config.verify_depth = v; return *this; } ///< 设置证书链校验深度
+    HttpsServerBuilder& tlsSession(HttpTlsSessionConfig v) { m_config.tls_session = std::move(v); return *this; } ///< 设置 TLS 会话恢复
     HttpsServer build() const; ///< 构建 HTTPS 服务器实例
     HttpsServerConfig buildConfig() const                { return m_config; } ///< 导出配置
 private:
@@ -506,6 +1168,13 @@ public:
 
     ~HttpsServer() override = default;
 
+    /**
+     * @brief TLS 会话恢复统计（预 fork 模式下只含本进程的握手）
+     */
+    HttpTlsSessionStats tlsSessionStats() const {
+        return m_tls_sessions.snapshot();
+    }
+
 protected:
     bool startInternal() override {
         // 初始化 SSL 上下文
@@ -524,65 +1193,76 @@ protected:
         return galay::ssl::SslSocket(&m_ssl_ctx, fd);
     }
 
-    Task<void> serverLoop(IOScheduler* scheduler) override {
-        // 每个 serverLoop 创建自己的 listener socket
-        TcpSocket listener(IPType::IPV4);
-
-        auto reuse_result = listener.option().handleReuseAddr();
-        if (!reuse_result) {
-            co_return;
-        }
-
-        // 设置 SO_REUSEPORT 以支持多线程 accept
-        auto reuse_port_result = listener.option().handleReusePort();
-        if (!reuse_port_result) {
+    Task<void> serverLoop(IOScheduler* scheduler, size_t index) override {
+        currentSchedulerSlot() = index;
+        currentComputeRuntime() = &m_runtime;
+        HttpDrainList::local().reset();
+        currentWorkerCounters() = workerCounters(index);
+        // 每个 serverLoop 创建自己的 listener socket（Unix 地址共享同一监听队列）
+        auto listener_opt = m_listen.createListener(index);
+        if (!listener_opt) {
             co_return;
         }
-
-        auto nonblock_result = listener.option().handleNonBlock();
-        if (!nonblock_result) {
-            co_return;
-        }
-
-        Host bind_host(IPType::IPV4, m_config.host, m_config.port);
-        auto bind_result = listener.bind(bind_host);
-        if (!bind_result) {
-            co_return;
-        }
-
-        auto listen_result = listener.listen(m_config.backlog);
-        if (!listen_result) {
-            co_return;
-        }
-
-        while (m_running.load()) {
-            Host client_host;
-            auto accept_result = co_await listener.accept(&client_host);
-
-            if (!accept_result) {
-                if (m_running.load()) {
-                    HTTP_LOG_WARN("[accept] [fail]", "error={}", accept_result.error().message());
+        TcpSocket& listener = *listener_opt;
+        HttpAcceptBatch batch(listener.handle().fd, m_config.accept_batch);
+
+        // 排空开始后不再 accept；阻塞中的 accept 返回的连接照常处理
+        while (m_running.load() && !m_drain.draining()) {
+            GHandle handle{};
+            const int batched_fd = batch.next();
+            const bool batched = batched_fd >= 0;
+            if (batched) {
+                handle = GHandle{batched_fd};
+            } else {
+                Host client_host;
+                auto accept_result = co_await listener.accept(&client_host);
+
+                if (!accept_result) {
+                    if (m_running.load()) {
+                        HTTP_LOG_WARN("[accept] [fail]", "error={}", accept_result.error().message());
+                    }
+                    continue;
                 }
+                handle = accept_result.value();
+                batch.arm();
+            }
+            m_listen.recordAccept(index, handle.fd, batched);
+            m_listen.tuneAccepted(handle.fd);
+            if (auto* counters = currentWorkerCounters()) {
+                counters->onAccept();
+            }
+            const auto accepted_at = acceptedAt();
+            if (m_balancer.enabled() && balanceAccepted(index, handle.fd, accepted_at)) {
                 continue;
             }
 
-
-            auto client_socket_opt = createClientSocket(accept_result.value());
+            auto client_socket_opt = createClientSocket(handle);
             if (!client_socket_opt) {
                 continue;
             }
 
             galay::ssl::SslSocket client_socket = std::move(*client_socket_opt);
-            auto nonblock_result = client_socket.option().handleNonBlock();
-            if (!nonblock_result) {
+            if (!batched && !client_socket.option().handleNonBlock()) {
                 continue;
             }
             auto nodelay_result = client_socket.option().handleTcpNoDelay();
             if (!nodelay_result) {
                 HTTP_LOG_DEBUG("[socket] [nodelay]", "failed to set TCP_NODELAY");
             }
+            if (!admitConnection(index, client_socket)) {
+                co_await client_socket.close();
+                continue;
+            }
+
+            // 均衡或准入控制开启时连接留在本调度器，计数与排队时延按调度器统计
+            if (m_balancer.enabled() || m_admission.enabled()) {
+                onTrackedOpen(index);
+                scheduleTask(scheduler, serveTracked(index, accepted_at, std::move(client_socket)));
+                continue;
+            }
 
-            auto* target_scheduler = m_runtime.getNextIOScheduler();
+            // 按接收 CPU 分发时连接已落在本核调度器上，不再轮转
+            auto* target_scheduler = m_listen.cpuSteering() ? nullptr : m_runtime.getNextIOScheduler();
             if (target_scheduler == nullptr) {
                 target_scheduler = scheduler;
             }
@@ -592,6 +1272,19 @@ protected:
             }
         }
 
+        co_await listener.close();
+        co_return;
+    }
+
+    Task<void> serveTracked(size_t index, std::chrono::steady_clock::time_point accepted_at,
+                            galay::ssl::SslSocket socket) override {
+        // 丢弃发生在握手之前，省下的正是过载时最贵的 TLS 握手
+        if (shedQueued(index, accepted_at, socket)) {
+            co_await socket.close();
+        } else {
+            co_await handleSslConnection(std::move(socket));
+        }
+        onTrackedClose(index);
         co_return;
     }
 
@@ -607,7 +1300,7 @@ private:
 
         // 创建连接并调用处理器
         HttpConnImpl<galay::ssl::SslSocket> conn(std::move(socket));
-        co_await m_handler(std::move(conn));
+        co_await serveConn(std::move(conn));
         co_return;
     }
 
@@ -616,6 +1309,16 @@ private:
         base_config.host = config.host;
         base_config.port = config.port;
         base_config.backlog = config.backlog;
+        base_config.ipv6_only = config.ipv6_only;
+        base_config.reuseport_cpu_steering = config.reuseport_cpu_steering;
+        base_config.conn_balance = config.conn_balance;
+        base_config.deadlines = config.deadlines;
+        base_config.admission = config.admission;
+        base_config.accept_batch = config.accept_batch;
+        base_config.tuning = config.tuning;
+        base_config.handoff_path = config.handoff_path;
+        base_config.worker_processes = config.worker_processes;
+        base_config.worker_stop_timeout = config.worker_stop_timeout;
         base_config.io_scheduler_count = config.io_scheduler_count;
         base_config.compute_scheduler_count = config.compute_scheduler_count;
         base_config.affinity = config.affinity;
@@ -662,10 +1365,21 @@ private:
             m_ssl_ctx.setVerifyMode(galay::ssl::SslVerifyMode::None);
         }
 
+        // 会话恢复：在 fork 工作进程之前安装，随机生成的票据主密钥由各工作进程共享
+        const size_t io_count = m_https_config.io_scheduler_count == GALAY_RUNTIME_SCHEDULER_COUNT_AUTO
+            ? std::max<size_t>(std::thread::hardware_concurrency(), 1)
+            : m_https_config.io_scheduler_count;
+        std::string error;
+        if (!m_tls_sessions.install(m_ssl_ctx.native(), m_https_config.tls_session, io_count, error)) {
+            HTTP_LOG_ERROR("[ssl] [session] [fail]", "error={}", error);
+            return false;
+        }
+
         return true;
     }
 
     HttpsServerConfig m_https_config;
+    HttpTlsSessionManager m_tls_sessions;       ///< 先于 m_ssl_ctx 构造、后于其析构
     galay::ssl::SslContext m_ssl_ctx;
 };
 
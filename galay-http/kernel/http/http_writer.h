@@ -263,11 +263,13 @@ public:
      * @brief 构造函数
      * @param setting 写入器配置
      * @param socket Socket 引用
+     * @param force_close 发送的响应头是否强制带 `Connection: close`（服务器排空时由连接设置）
      */
-    HttpWriterImpl(const HttpWriterSetting& setting, SocketType& socket)
+    HttpWriterImpl(const HttpWriterSetting& setting, SocketType& socket, bool force_close = false)
         : m_setting(setting)
         , m_socket(&socket)
         , m_remaining_bytes(0)
+        , m_force_close(force_close)
     {
     }
 
@@ -279,6 +281,9 @@ public:
     auto sendResponse(HttpResponse& response) {
         if (m_remaining_bytes == 0) {
             logResponseStatus(response.header().code());
+            if (m_force_close) {
+                response.header().headerPairs().addHeaderPair("Connection", "close");
+            }
 
             if constexpr (is_tcp_socket_v<SocketType>) {
                 m_body_buffer = response.getBodyStr();
@@ -343,6 +348,40 @@ public:
         }
     }
 
+    /**
+     * @brief 发送已序列化的请求头与请求体（均为外部持有的视图）
+     * @param head 请求行与头部（含结尾空行）
+     * @param body 请求体，可为空
+     * @return 可 co_await 的异步操作
+     * @note 调用方必须保证 head 与 body 的底层存储在 await 完成前保持有效；
+     *       明文 TCP 以 writev 直接发送两段视图，不复制到 writer 内部缓冲区
+     */
+    auto sendRequestView(std::string_view head, std::string_view body) {
+        if (m_remaining_bytes == 0) {
+            if constexpr (is_tcp_socket_v<SocketType>) {
+                clearExternalBuffer();
+                m_buffer.clear();
+                m_body_buffer.clear();
+                std::vector<iovec> iovecs;
+                iovecs.reserve(2);
+                iovecs.push_back({const_cast<char*>(head.data()), head.size()});
+                if (!body.empty()) {
+                    iovecs.push_back({const_cast<char*>(body.data()), body.size()});
+                }
+                m_writev_cursor.reset(std::move(iovecs));
+                m_remaining_bytes = m_writev_cursor.remainingBytes();
+            } else {
+                prepareSslSendLayout(std::string(head), body);
+            }
+        }
+
+        if constexpr (is_tcp_socket_v<SocketType>) {
+            return makeWritevAwaitable();
+        } else {
+            return makeSendAwaitable();
+        }
+    }
+
     /**
      * @brief 异步发送 HTTP 响应头
      * @param header HTTP 响应头
@@ -351,6 +390,9 @@ public:
     auto sendHeader(HttpResponseHeader&& header) {
         if (m_remaining_bytes == 0) {
             logResponseStatus(header.code());
+            if (m_force_close) {
+                header.headerPairs().addHeaderPair("Connection", "close");
+            }
             m_buffer = header.toString();
             m_remaining_bytes = m_buffer.size();
         }
@@ -571,6 +613,7 @@ private:
     size_t m_external_buffer_size = 0;
     IoVecCursor m_writev_cursor;
     FastPathCounters m_fast_path_counters;
+    bool m_force_close = false;
 };
 
 using HttpWriter = HttpWriterImpl<TcpSocket>;
@@ -0,0 +1,281 @@
+/**
+ * @file listener_handoff.h
+ * @brief 新旧进程之间经 Unix domain socket（SCM_RIGHTS）交接监听 fd
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 服务器配置 `handoff_path` 后，升级流程为：
+ * 1. 新进程启动时连接 `handoff_path`，旧进程在一条消息里发送监听地址文本与全部监听 fd（SCM_RIGHTS）
+ * 2. 新进程直接在继承的 fd 上 accept，不重新 bind，监听队列与排队中的连接都不丢失
+ * 3. 新进程开始 accept 后回送一个就绪字节，旧进程随即停止 accept 并排空在途请求
+ * 4. 新进程在同一路径上重新监听，等待下一代进程
+ * 新进程在回送就绪字节之前退出时，旧进程继续服务。
+ * 交接 socket 会交出全部监听 fd，且对端一个就绪字节即令旧进程排空，因此：
+ * 文件权限为 0600（kHandoffSocketMode），旧进程发送前以对端凭据确认其 uid 与本进程有效 uid 相同或为 root。
+ * 本文件只包含系统调用封装，不依赖运行时；旧进程侧的交接协程见 server_drain.h。
+ */
+
+#ifndef GALAY_HTTP_LISTENER_HANDOFF_H
+#define GALAY_HTTP_LISTENER_HANDOFF_H
+
+#include "socket_addr.h"
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace galay::http
+{
+
+namespace detail
+{
+
+inline constexpr size_t kMaxHandoffFds = 250;       ///< 单条消息携带的 fd 上限（内核 SCM_MAX_FD 为 253）
+inline constexpr size_t kMaxHandoffTag = 512;       ///< 地址文本上限
+inline constexpr char kHandoffReady = 'R';          ///< 新进程开始 accept 后回送的就绪字节
+inline constexpr mode_t kHandoffSocketMode = 0600;  ///< 交接 socket 文件权限：只允许属主连接
+
+/**
+ * @brief 确认交接连接的对端可信：有效 uid 与本进程相同，或为 root
+ * @details 抽象命名空间路径没有文件权限，只能依靠这里的检查
+ */
+inline bool handoffPeerTrusted(int sock, std::string& error)
+{
+    uid_t uid = 0;
+#if defined(__linux__)
+    ucred cred{};
+    socklen_t len = sizeof(cred);
+    if (::getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    uid = cred.uid;
+#else
+    gid_t gid = 0;
+    if (::getpeereid(sock, &uid, &gid) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+#endif
+    if (uid != 0 && uid != ::geteuid()) {
+        error = "untrusted peer uid=" + std::to_string(uid);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 以一条消息发送地址文本与监听 fd
+ * @param tag 地址文本，不能为空（流式 socket 上不带数据的 sendmsg 不会投递控制消息）
+ */
+inline bool sendListenerFds(int sock, const std::vector<int>& fds, std::string_view tag, std::string& error)
+{
+    if (fds.empty() || fds.size() > kMaxHandoffFds || tag.empty() || tag.size() > kMaxHandoffTag) {
+        error = "invalid handoff payload";
+        return false;
+    }
+    iovec iov{const_cast<char*>(tag.data()), tag.size()};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()), 0);
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+    ssize_t sent = 0;
+    do {
+        sent = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != static_cast<ssize_t>(tag.size())) {
+        error = sent < 0 ? std::strerror(errno) : "short write";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 接收 sendListenerFds 发送的消息
+ * @details 收到的 fd 带 FD_CLOEXEC；控制消息被截断时关闭已收到的 fd 并返回 false
+ */
+inline bool recvListenerFds(int sock, std::vector<int>& fds, std::string& tag, std::string& error)
+{
+    char buffer[kMaxHandoffTag];
+    iovec iov{buffer, sizeof(buffer)};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * kMaxHandoffFds), 0);
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t received = 0;
+    do {
+        received = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received <= 0) {
+        error = received < 0 ? std::strerror(errno) : "peer closed";
+        return false;
+    }
+
+    fds.clear();
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        const size_t offset = fds.size();
+        fds.resize(offset + count);
+        std::memcpy(fds.data() + offset, CMSG_DATA(cmsg), sizeof(int) * count);
+    }
+    if ((msg.msg_flags & MSG_CTRUNC) != 0 || fds.empty()) {
+        for (int fd : fds) {
+            ::close(fd);
+        }
+        fds.clear();
+        error = "no listener fds received";
+        return false;
+    }
+    tag.assign(buffer, static_cast<size_t>(received));
+    return true;
+}
+
+/**
+ * @brief fd 是否为处于 listen 状态的流式 socket
+ */
+inline bool isListeningSocket(int fd)
+{
+    int accepting = 0;
+    socklen_t len = sizeof(accepting);
+    return ::getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &accepting, &len) == 0 && accepting != 0;
+}
+
+} // namespace detail
+
+/**
+ * @brief 新进程侧：从旧进程继承监听 fd
+ * @details fetch() 连接旧进程的交接 socket 并取回监听 fd；服务器开始 accept 后调用 confirm() 通知旧进程排空。
+ *          析构时关闭未被 take() 取走的 fd 与控制连接；未 confirm 即断开时旧进程继续服务
+ */
+class HttpListenerInheritance
+{
+public:
+    static constexpr int kReceiveTimeoutMs = 2000;     ///< 等待旧进程发送 fd 的超时
+
+    HttpListenerInheritance() = default;
+    ~HttpListenerInheritance() { reset(); }
+
+    HttpListenerInheritance(const HttpListenerInheritance&) = delete;
+    HttpListenerInheritance& operator=(const HttpListenerInheritance&) = delete;
+
+    /**
+     * @brief 连接交接路径并接收监听 fd
+     * @return 成功返回 true；路径上没有旧进程（不存在或拒绝连接）时返回 false 且 error 为空
+     */
+    bool fetch(const std::string& path, std::string& error)
+    {
+        reset();
+        error.clear();
+        sockaddr_un addr{};
+        socklen_t len = 0;
+        if (!detail::fillUnixSockAddr(path, addr, len)) {
+            error = "invalid handoff path";
+            return false;
+        }
+        m_control = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_control < 0) {
+            error = std::strerror(errno);
+            return false;
+        }
+        int rc = 0;
+        do {
+            rc = ::connect(m_control, reinterpret_cast<const sockaddr*>(&addr), len);
+        } while (rc != 0 && errno == EINTR);
+        if (rc != 0) {
+            if (errno != ENOENT && errno != ECONNREFUSED) {
+                error = std::strerror(errno);
+            }
+            reset();
+            return false;
+        }
+        timeval timeout{kReceiveTimeoutMs / 1000, (kReceiveTimeoutMs % 1000) * 1000};
+        ::setsockopt(m_control, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (!detail::recvListenerFds(m_control, m_fds, m_authority, error)) {
+            reset();
+            return false;
+        }
+        for (int fd : m_fds) {
+            if (!detail::isListeningSocket(fd)) {
+                error = "received fd is not a listening socket";
+                reset();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool valid() const { return !m_fds.empty(); }
+
+    /**
+     * @brief 旧进程的监听地址（HttpSocketAddress::authority() 格式）
+     */
+    const std::string& authority() const { return m_authority; }
+
+    /**
+     * @brief 取走监听 fd 的所有权
+     */
+    std::vector<int> take() { return std::exchange(m_fds, {}); }
+
+    /**
+     * @brief 通知旧进程停止 accept 并开始排空，随后关闭控制连接
+     * @return 未 fetch 成功或发送失败时返回 false
+     */
+    bool confirm()
+    {
+        if (m_control < 0) {
+            return false;
+        }
+        const char ready = detail::kHandoffReady;
+        ssize_t sent = 0;
+        do {
+            sent = ::send(m_control, &ready, 1, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        reset();
+        return sent == 1;
+    }
+
+    /**
+     * @brief 关闭未取走的 fd 与控制连接
+     */
+    void reset()
+    {
+        for (int fd : m_fds) {
+            ::close(fd);
+        }
+        m_fds.clear();
+        m_authority.clear();
+        if (m_control >= 0) {
+            ::close(m_control);
+            m_control = -1;
+        }
+    }
+
+private:
+    int m_control = -1;             ///< 与旧进程之间的控制连接
+    std::vector<int> m_fds;         ///< 收到的监听 fd（按旧进程的调度器下标）
+    std::string m_authority;        ///< 旧进程的监听地址
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_LISTENER_HANDOFF_H
@@ -0,0 +1,382 @@
+/**
+ * @file proxy_headers.h
+ * @brief 反向代理请求头的单遍改写
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 转发请求时不再逐个删除、添加 HeaderPair 中的字段：
+ * - scan() 一次遍历客户端请求头，按字段名分类：逐跳头部（含 Connection 列出的字段）丢弃，
+ *   Host / X-Forwarded-* 记录原值供重新生成，其余字段以视图形式记录待转发
+ * - appendUpstreamRequest() 把请求行、转发字段与 Host、X-Forwarded-*、Connection、
+ *   Content-Length 直接追加到复用的输出缓冲，客户端请求的 HeaderPair 保持不变
+ * 记录的视图指向原请求头的存储，扫描后直到序列化完成前不得修改原请求头。
+ */
+
+#ifndef GALAY_HTTP_PROXY_HEADERS_H
+#define GALAY_HTTP_PROXY_HEADERS_H
+
+#include "galay-http/protoc/http/http_header.h"
+#include "galay-http/protoc/http/parse_utils.h"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace galay::http
+{
+
+/**
+ * @brief 转发给上游时生成的头部取值
+ */
+struct ProxyForwarding
+{
+    std::string_view client_ip;         ///< 客户端地址，为空时不追加 X-Forwarded-For / X-Real-IP
+    std::string_view proto = "http";    ///< X-Forwarded-Proto
+    std::string_view upstream_host;     ///< 上游 Host（host:port）
+    std::string_view connection;        ///< 上游 Connection，为空时不写
+};
+
+/**
+ * @brief 客户端请求头的单遍分类结果
+ */
+class ProxyRequestHeaders
+{
+public:
+    static constexpr size_t kInlineFields = 32;         ///< 内联记录的转发字段数，超出部分进入溢出数组
+    static constexpr size_t kInlineConnectionTokens = 8;    ///< 内联记录的 Connection 字段名个数，超出部分进入溢出数组
+
+    /**
+     * @brief 遍历客户端请求头并分类
+     */
+    void scan(const HeaderPair& headers)
+    {
+        m_count = 0;
+        m_overflow.clear();
+        m_token_count = 0;
+        m_token_overflow.clear();
+        m_host = {};
+        m_forwarded_for = {};
+        m_real_ip = {};
+        m_forwarded_host = {};
+        m_accept = {};
+        m_content_type = {};
+        m_proxy_stream = {};
+
+        std::string_view connection;
+        headers.forEachHeader([this, &connection](std::string_view key, std::string_view value) {
+            switch (classify(key)) {
+            case Kind::Forward:
+                break;
+            case Kind::Drop:
+                return;
+            case Kind::Host:
+                m_host = value;
+                return;
+            case Kind::Connection:
+                connection = value;
+                return;
+            case Kind::ForwardedFor:
+                m_forwarded_for = value;
+                return;
+            case Kind::RealIp:
+                m_real_ip = value;
+                return;
+            case Kind::ForwardedHost:
+                m_forwarded_host = value;
+                return;
+            case Kind::Accept:
+                m_accept = value;
+                break;
+            case Kind::ContentType:
+                m_content_type = value;
+                break;
+            case Kind::ProxyStream:
+                m_proxy_stream = value;
+                break;
+            }
+            push(key, value);
+        });
+        splitConnectionTokens(connection);
+    }
+
+    std::string_view host() const { return m_host; }                 ///< 客户端 Host
+    std::string_view accept() const { return m_accept; }             ///< Accept
+    std::string_view contentType() const { return m_content_type; }  ///< Content-Type
+    std::string_view proxyStream() const { return m_proxy_stream; }  ///< X-Proxy-Stream
+
+    /**
+     * @brief 遍历转发给上游的字段（不含 Host、Connection、Content-Length）
+     * @details 依次为客户端字段（已去除逐跳字段）与 X-Forwarded-* / X-Real-IP
+     */
+    template <typename Fn>
+    void forEachUpstreamHeader(const ProxyForwarding& forwarding, Fn&& fn) const
+    {
+        auto visit = [this, &fn](const Field& field) {
+            if (!isConnectionToken(field.first)) {
+                fn(field.first, field.second);
+            }
+        };
+        for (size_t i = 0; i < m_count; ++i) {
+            visit(m_inline[i]);
+        }
+        for (const auto& field : m_overflow) {
+            visit(field);
+        }
+
+        if (!forwarding.client_ip.empty()) {
+            if (m_forwarded_for.empty()) {
+                fn(std::string_view("X-Forwarded-For"), forwarding.client_ip);
+            } else {
+                m_forwarded_for_buffer.clear();
+                m_forwarded_for_buffer.append(m_forwarded_for).append(", ").append(forwarding.client_ip);
+                fn(std::string_view("X-Forwarded-For"), std::string_view(m_forwarded_for_buffer));
+            }
+            fn(std::string_view("X-Real-IP"), forwarding.client_ip);
+        } else {
+            if (!m_forwarded_for.empty()) {
+                fn(std::string_view("X-Forwarded-For"), m_forwarded_for);
+            }
+            if (!m_real_ip.empty()) {
+                fn(std::string_view("X-Real-IP"), m_real_ip);
+            }
+        }
+        fn(std::string_view("X-Forwarded-Proto"), forwarding.proto);
+        if (!m_host.empty()) {
+            fn(std::string_view("X-Forwarded-Host"), m_host);
+        } else if (!m_forwarded_host.empty()) {
+            fn(std::string_view("X-Forwarded-Host"), m_forwarded_host);
+        }
+    }
+
+    /**
+     * @brief 追加转发给上游的 HTTP/1.1 请求头（请求行之后的部分，含结尾空行）
+     * @param body_size 请求体字节数，写入 Content-Length
+     */
+    void appendUpstreamHeaders(std::string& out, const ProxyForwarding& forwarding, size_t body_size) const
+    {
+        out.reserve(out.size() + estimatedSize(forwarding));
+        appendField(out, "Host", forwarding.upstream_host);
+        forEachUpstreamHeader(forwarding, [&out](std::string_view key, std::string_view value) {
+            appendField(out, key, value);
+        });
+        if (!forwarding.connection.empty()) {
+            appendField(out, "Connection", forwarding.connection);
+        }
+        char digits[24];
+        const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), body_size);
+        (void)ec;
+        appendField(out, "Content-Length", std::string_view(digits, static_cast<size_t>(end - digits)));
+        out += "\r\n";
+    }
+
+    /**
+     * @brief 追加完整的上游请求头（请求行 + 头部）
+     */
+    void appendUpstreamRequest(std::string& out,
+                               const HttpRequestHeader& header,
+                               const ProxyForwarding& forwarding,
+                               size_t body_size) const
+    {
+        header.appendRequestLine(out);
+        appendUpstreamHeaders(out, forwarding, body_size);
+    }
+
+private:
+    using Field = std::pair<std::string_view, std::string_view>;
+
+    enum class Kind
+    {
+        Forward,
+        Drop,
+        Host,
+        Connection,
+        ForwardedFor,
+        RealIp,
+        ForwardedHost,
+        Accept,
+        ContentType,
+        ProxyStream
+    };
+
+    static bool is(std::string_view key, std::string_view name)
+    {
+        return detail::equalsIgnoreCaseAscii(key, name);
+    }
+
+    /**
+     * @brief 按长度分派后再做一次忽略大小写比较，普通字段通常只需比较长度
+     */
+    static Kind classify(std::string_view key)
+    {
+        switch (key.size()) {
+        case 2:
+            return is(key, "te") ? Kind::Drop : Kind::Forward;
+        case 4:
+            return is(key, "host") ? Kind::Host : Kind::Forward;
+        case 6:
+            return is(key, "accept") ? Kind::Accept : Kind::Forward;
+        case 7:
+            return (is(key, "trailer") || is(key, "upgrade")) ? Kind::Drop : Kind::Forward;
+        case 9:
+            return is(key, "x-real-ip") ? Kind::RealIp : Kind::Forward;
+        case 10:
+            if (is(key, "connection")) return Kind::Connection;
+            return is(key, "keep-alive") ? Kind::Drop : Kind::Forward;
+        case 12:
+            return is(key, "content-type") ? Kind::ContentType : Kind::Forward;
+        case 14:
+            if (is(key, "content-length")) return Kind::Drop;
+            return is(key, "x-proxy-stream") ? Kind::ProxyStream : Kind::Forward;
+        case 15:
+            return is(key, "x-forwarded-for") ? Kind::ForwardedFor : Kind::Forward;
+        case 16:
+            if (is(key, "proxy-connection")) return Kind::Drop;
+            if (is(key, "x-forwarded-host")) return Kind::ForwardedHost;
+            return Kind::Forward;
+        case 17:
+            if (is(key, "transfer-encoding") || is(key, "x-forwarded-proto")) return Kind::Drop;
+            return Kind::Forward;
+        default:
+            return Kind::Forward;
+        }
+    }
+
+    static void appendField(std::string& out, std::string_view key, std::string_view value)
+    {
+        out.append(key).append(": ").append(value).append("\r\n");
+    }
+
+    void push(std::string_view key, std::string_view value)
+    {
+        if (m_count < kInlineFields) {
+            m_inline[m_count++] = Field(key, value);
+        } else {
+            m_overflow.emplace_back(key, value);
+        }
+    }
+
+    void splitConnectionTokens(std::string_view value)
+    {
+        size_t start = 0;
+        while (start < value.size()) {
+            size_t end = value.find(',', start);
+            if (end == std::string_view::npos) {
+                end = value.size();
+            }
+            size_t left = start;
+            size_t right = end;
+            while (left < right && (value[left] == ' ' || value[left] == '\t')) ++left;
+            while (right > left && (value[right - 1] == ' ' || value[right - 1] == '\t')) --right;
+            const std::string_view token = value.substr(left, right - left);
+            // keep-alive / close 是连接选项而非字段名，字段本身已按逐跳头部丢弃
+            if (!token.empty() && !is(token, "close") && !is(token, "keep-alive")) {
+                pushToken(token);
+            }
+            start = end + 1;
+        }
+    }
+
+    void pushToken(std::string_view token)
+    {
+        if (m_token_count < kInlineConnectionTokens) {
+            m_tokens[m_token_count++] = token;
+        } else {
+            m_token_overflow.push_back(token);
+        }
+    }
+
+    bool isConnectionToken(std::string_view key) const
+    {
+        for (size_t i = 0; i < m_token_count; ++i) {
+            if (is(key, m_tokens[i])) {
+                return true;
+            }
+        }
+        for (const auto token : m_token_overflow) {
+            if (is(key, token)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t estimatedSize(const ProxyForwarding& forwarding) const
+    {
+        size_t size = 160 + forwarding.upstream_host.size() + 2 * forwarding.client_ip.size() +
+                      m_forwarded_for.size() + m_host.size();
+        for (size_t i = 0; i < m_count; ++i) {
+            size += m_inline[i].first.size() + m_inline[i].second.size() + 4;
+        }
+        for (const auto& field : m_overflow) {
+            size += field.first.size() + field.second.size() + 4;
+        }
+        return size;
+    }
+
+    std::array<Field, kInlineFields> m_inline{};
+    size_t m_count = 0;
+    std::vector<Field> m_overflow;
+    std::array<std::string_view, kInlineConnectionTokens> m_tokens{};
+    size_t m_token_count = 0;
+    std::vector<std::string_view> m_token_overflow;
+    std::string_view m_host;
+    std::string_view m_forwarded_for;
+    std::string_view m_real_ip;
+    std::string_view m_forwarded_host;
+    std::string_view m_accept;
+    std::string_view m_content_type;
+    std::string_view m_proxy_stream;
+    mutable std::string m_forwarded_for_buffer;     ///< 合并后的 X-Forwarded-For（仅客户端已带该字段时使用）
+};
+
+/**
+ * @brief 线程内复用的请求头序列化缓冲
+ * @details 构造时从线程局部空闲表取出一块已分配的缓冲，析构时清空后放回；
+ *          在协程中跨 co_await 持有也安全（每个请求独占一块）
+ */
+class ProxyHeadBuffer
+{
+public:
+    static constexpr size_t kMaxRetainedCapacity = 16 * 1024;   ///< 超过该容量的缓冲不回收
+    static constexpr size_t kMaxPooled = 64;                    ///< 每线程最多保留的空闲缓冲数
+
+    ProxyHeadBuffer()
+    {
+        auto& pool = freeList();
+        if (!pool.empty()) {
+            m_buffer = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
+
+    ~ProxyHeadBuffer()
+    {
+        auto& pool = freeList();
+        if (m_buffer.capacity() <= kMaxRetainedCapacity && pool.size() < kMaxPooled) {
+            m_buffer.clear();
+            pool.push_back(std::move(m_buffer));
+        }
+    }
+
+    ProxyHeadBuffer(const ProxyHeadBuffer&) = delete;
+    ProxyHeadBuffer& operator=(const ProxyHeadBuffer&) = delete;
+
+    std::string& get() { return m_buffer; }
+
+private:
+    static std::vector<std::string>& freeList()
+    {
+        thread_local std::vector<std::string> pool;
+        return pool;
+    }
+
+    std::string m_buffer;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_PROXY_HEADERS_H
@@ -0,0 +1,234 @@
+/**
+ * @file proxy_stats.h
+ * @brief 反向代理运行统计
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 进程级计数器，按线程分槽：各 IO 调度器只以 relaxed 原子操作累加本线程的槽，
+ * 读取时汇总，热路径上没有跨核共享的缓存行；
+ * 转发过程中先在本地累计，结束时一次性提交，避免逐包的原子操作。
+ */
+
+#ifndef GALAY_HTTP_PROXY_STATS_H
+#define GALAY_HTTP_PROXY_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace galay::http
+{
+
+/**
+ * @brief 代理统计快照
+ */
+struct ProxyStatsSnapshot
+{
+    uint64_t http_requests = 0;         ///< Http 模式转发的请求数
+    uint64_t http_bytes = 0;            ///< Http 模式转发的响应体字节数
+    uint64_t http_streamed = 0;         ///< Http 模式中边收边转发响应体的请求数
+    uint64_t raw_requests = 0;          ///< Raw 模式转发的请求数
+    uint64_t raw_splice_bytes = 0;      ///< Raw 模式经 splice 零拷贝转发的字节数
+    uint64_t raw_buffered_bytes = 0;    ///< Raw 模式经用户态缓冲转发的字节数
+    uint64_t raw_splice_fallbacks = 0;  ///< splice 不可用而回退到缓冲转发的次数
+    uint64_t pool_hits = 0;             ///< 上游连接池复用次数
+    uint64_t pool_misses = 0;           ///< 上游连接池未命中（新建连接）次数
+    uint64_t pool_evictions = 0;        ///< 上游连接池回收的空闲连接数
+    uint64_t pool_stale_retries = 0;    ///< 复用连接失效后重连重试的次数
+    uint64_t pool_exhausted = 0;        ///< 达到上游连接总数上限而拒绝的次数
+    uint64_t cache_hits = 0;            ///< 响应缓存新鲜命中次数
+    uint64_t cache_stale_hits = 0;      ///< 响应缓存 stale-while-revalidate 命中次数
+    uint64_t cache_misses = 0;          ///< 响应缓存未命中次数
+    uint64_t cache_stores = 0;          ///< 响应缓存写入次数
+    uint64_t hedges = 0;                ///< 发出的对冲请求数
+    uint64_t hedge_wins = 0;            ///< 对冲请求先于主请求返回的次数
+    uint64_t hedge_losses = 0;          ///< 主请求先返回、对冲请求被取消的次数
+    uint64_t budget_retries = 0;        ///< 主请求失败后向其他实例重试的次数
+    uint64_t budget_denied = 0;         ///< 重试预算耗尽而放弃对冲或重试的次数
+};
+
+/**
+ * @brief 代理统计计数器
+ * @details 每个线程（IO 调度器）独占一个按缓存行对齐的计数槽，热路径只写本线程的槽；
+ *          `snapshot()` 汇总所有槽。线程退出后槽保留计数并交给之后的新线程复用
+ */
+class ProxyStats
+{
+public:
+    static ProxyStats& instance()
+    {
+        static ProxyStats stats;
+        return stats;
+    }
+
+    void addHttp(uint64_t bytes)
+    {
+        Slot& slot = local();
+        slot.add(kHttpRequests, 1);
+        slot.add(kHttpBytes, bytes);
+    }
+
+    void addHttpStreamed(uint64_t bytes)
+    {
+        addHttp(bytes);
+        local().add(kHttpStreamed, 1);
+    }
+
+    void addRaw(uint64_t splice_bytes, uint64_t buffered_bytes)
+    {
+        Slot& slot = local();
+        slot.add(kRawRequests, 1);
+        slot.add(kRawSpliceBytes, splice_bytes);
+        slot.add(kRawBufferedBytes, buffered_bytes);
+    }
+
+    void addRawSpliceFallback() { local().add(kRawSpliceFallbacks, 1); }
+    void addPoolHit() { local().add(kPoolHits, 1); }
+    void addPoolMiss() { local().add(kPoolMisses, 1); }
+    void addPoolEvictions(uint64_t n) { local().add(kPoolEvictions, n); }
+    void addPoolStaleRetry() { local().add(kPoolStaleRetries, 1); }
+    void addPoolExhausted() { local().add(kPoolExhausted, 1); }
+    void addCacheHit() { local().add(kCacheHits, 1); }
+    void addCacheStaleHit() { local().add(kCacheStaleHits, 1); }
+    void addCacheMiss() { local().add(kCacheMisses, 1); }
+    void addCacheStore() { local().add(kCacheStores, 1); }
+    void addHedge() { local().add(kHedges, 1); }
+    void addHedgeWin() { local().add(kHedgeWins, 1); }
+    void addHedgeLoss() { local().add(kHedgeLosses, 1); }
+    void addBudgetRetry() { local().add(kBudgetRetries, 1); }
+    void addBudgetDenied() { local().add(kBudgetDenied, 1); }
+
+    /**
+     * @brief 汇总各线程的计数（各字段独立读取，不保证彼此一致）
+     */
+    ProxyStatsSnapshot snapshot() const
+    {
+        ProxyStatsSnapshot s;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Slot& slot : m_slots) {
+            s.http_requests += slot.load(kHttpRequests);
+            s.http_bytes += slot.load(kHttpBytes);
+            s.http_streamed += slot.load(kHttpStreamed);
+            s.raw_requests += slot.load(kRawRequests);
+            s.raw_splice_bytes += slot.load(kRawSpliceBytes);
+            s.raw_buffered_bytes += slot.load(kRawBufferedBytes);
+            s.raw_splice_fallbacks += slot.load(kRawSpliceFallbacks);
+            s.pool_hits += slot.load(kPoolHits);
+            s.pool_misses += slot.load(kPoolMisses);
+            s.pool_evictions += slot.load(kPoolEvictions);
+            s.pool_stale_retries += slot.load(kPoolStaleRetries);
+            s.pool_exhausted += slot.load(kPoolExhausted);
+            s.cache_hits += slot.load(kCacheHits);
+            s.cache_stale_hits += slot.load(kCacheStaleHits);
+            s.cache_misses += slot.load(kCacheMisses);
+            s.cache_stores += slot.load(kCacheStores);
+            s.hedges += slot.load(kHedges);
+            s.hedge_wins += slot.load(kHedgeWins);
+            s.hedge_losses += slot.load(kHedgeLosses);
+            s.budget_retries += slot.load(kBudgetRetries);
+            s.budget_denied += slot.load(kBudgetDenied);
+        }
+        return s;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Slot& slot : m_slots) {
+            for (auto& counter : slot.counters) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    enum Counter : size_t
+    {
+        kHttpRequests,
+        kHttpBytes,
+        kHttpStreamed,
+        kRawRequests,
+        kRawSpliceBytes,
+        kRawBufferedBytes,
+        kRawSpliceFallbacks,
+        kPoolHits,
+        kPoolMisses,
+        kPoolEvictions,
+        kPoolStaleRetries,
+        kPoolExhausted,
+        kCacheHits,
+        kCacheStaleHits,
+        kCacheMisses,
+        kCacheStores,
+        kHedges,
+        kHedgeWins,
+        kHedgeLosses,
+        kBudgetRetries,
+        kBudgetDenied,
+        kCounterCount
+    };
+
+    struct alignas(64) Slot
+    {
+        std::array<std::atomic<uint64_t>, kCounterCount> counters{};
+        bool in_use = false;    ///< 是否已被存活线程占用（受 m_mutex 保护）
+
+        void add(Counter counter, uint64_t n) { counters[counter].fetch_add(n, std::memory_order_relaxed); }
+        uint64_t load(Counter counter) const { return counters[counter].load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief 线程退出时归还计数槽
+     */
+    struct SlotLease
+    {
+        Slot* slot = nullptr;
+        ~SlotLease()
+        {
+            if (slot != nullptr) {
+                ProxyStats::instance().releaseSlot(*slot);
+            }
+        }
+    };
+
+    ProxyStats() = default;
+
+    Slot& local()
+    {
+        thread_local SlotLease lease;
+        if (lease.slot == nullptr) {
+            lease.slot = &acquireSlot();
+        }
+        return *lease.slot;
+    }
+
+    Slot& acquireSlot()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Slot& slot : m_slots) {
+            if (!slot.in_use) {
+                slot.in_use = true;
+                return slot;
+            }
+        }
+        Slot& slot = m_slots.emplace_back();
+        slot.in_use = true;
+        return slot;
+    }
+
+    void releaseSlot(Slot& slot)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        slot.in_use = false;
+    }
+
+    mutable std::mutex m_mutex;
+    std::deque<Slot> m_slots;   ///< deque 追加时不移动已有元素，槽地址稳定
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_PROXY_STATS_H
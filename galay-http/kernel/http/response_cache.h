@@ -0,0 +1,665 @@
+/**
+ * @file response_cache.h
+ * @brief 反向代理响应缓存（RFC 9111 子集）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 共享缓存语义，按线程（即 IO 调度器）分片，热路径无锁：
+ * - 键：方法 + authority + URI，再加上响应 Vary 指定的请求头取值
+ * - 仅缓存带显式新鲜度（s-maxage / max-age / Expires）的 GET 响应，
+ *   遵守 no-store / private / no-cache / must-revalidate，不做启发式新鲜度
+ * - 条目保存预序列化的完整响应，命中时一次发送；Age 字段为定宽数字，
+ *   命中时原地改写，无需重新序列化
+ * - 支持 stale-while-revalidate：过期后窗口内先返回旧响应，由调用方后台刷新
+ */
+
+#ifndef GALAY_HTTP_RESPONSE_CACHE_H
+#define GALAY_HTTP_RESPONSE_CACHE_H
+
+#include "http_date.h"
+#include "proxy_stats.h"
+#include "galay-http/protoc/http/http_header.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace galay::http
+{
+
+/**
+ * @brief 响应缓存配置（每线程分片独立生效）
+ */
+struct ResponseCacheConfig
+{
+    bool enabled = false;                       ///< 是否启用
+    size_t max_entries = 1024;                  ///< 每线程最大条目数
+    size_t max_bytes = 64 * 1024 * 1024;        ///< 每线程最大字节数（按序列化响应计）
+    size_t max_object_size = 1024 * 1024;       ///< 单个响应上限，超过不缓存
+};
+
+/**
+ * @brief Cache-Control 指令解析结果
+ */
+struct CacheControl
+{
+    bool no_store = false;
+    bool no_cache = false;
+    bool is_private = false;
+    bool is_public = false;
+    bool must_revalidate = false;               ///< must-revalidate 或 proxy-revalidate
+    std::optional<int64_t> max_age;
+    std::optional<int64_t> s_maxage;
+    std::optional<int64_t> stale_while_revalidate;
+
+    /**
+     * @brief 解析 Cache-Control 头部值
+     * @details 指令名大小写不敏感；带参数的 no-cache / private（限定字段）按整体处理
+     */
+    static CacheControl parse(std::string_view value)
+    {
+        CacheControl cc;
+        size_t pos = 0;
+        while (pos < value.size()) {
+            size_t end = value.find(',', pos);
+            if (end == std::string_view::npos) {
+                end = value.size();
+            }
+            std::string_view item = trim(value.substr(pos, end - pos));
+            pos = end + 1;
+            if (item.empty()) {
+                continue;
+            }
+
+            std::string_view name = item;
+            std::string_view arg;
+            const size_t eq = item.find('=');
+            if (eq != std::string_view::npos) {
+                name = trim(item.substr(0, eq));
+                arg = trim(item.substr(eq + 1));
+                if (arg.size() >= 2 && arg.front() == '"' && arg.back() == '"') {
+                    arg = arg.substr(1, arg.size() - 2);
+                }
+            }
+
+            if (iequals(name, "no-store")) {
+                cc.no_store = true;
+            } else if (iequals(name, "no-cache")) {
+                cc.no_cache = true;
+            } else if (iequals(name, "private")) {
+                cc.is_private = true;
+            } else if (iequals(name, "public")) {
+                cc.is_public = true;
+            } else if (iequals(name, "must-revalidate") || iequals(name, "proxy-revalidate")) {
+                cc.must_revalidate = true;
+            } else if (iequals(name, "max-age")) {
+                cc.max_age = parseSeconds(arg);
+            } else if (iequals(name, "s-maxage")) {
+                cc.s_maxage = parseSeconds(arg);
+            } else if (iequals(name, "stale-while-revalidate")) {
+                cc.stale_while_revalidate = parseSeconds(arg);
+            }
+        }
+        return cc;
+    }
+
+    static bool iequals(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) !=
+                std::tolower(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static std::string_view trim(std::string_view s)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+            s.remove_suffix(1);
+        }
+        return s;
+    }
+
+    /**
+     * @brief 解析 delta-seconds；非法值视为 0（RFC 9111 §1.2.2），溢出时饱和
+     */
+    static int64_t parseSeconds(std::string_view s)
+    {
+        int64_t out = 0;
+        if (s.empty()) {
+            return 0;
+        }
+        for (char c : s) {
+            if (c < '0' || c > '9') {
+                return 0;
+            }
+            out = out * 10 + (c - '0');
+            if (out > kMaxDeltaSeconds) {
+                return kMaxDeltaSeconds;
+            }
+        }
+        return out;
+    }
+
+    static constexpr int64_t kMaxDeltaSeconds = 2147483648LL; ///< RFC 9111 建议的上限 2^31
+};
+
+/**
+ * @brief 可在多个下游之间共享的上游响应头
+ * @details 一次遍历取出缓存判定所需字段，并去掉逐跳字段、Connection 列出的字段、
+ *          Content-Length 与 Age；响应缓存与请求合并（single-flight）共用
+ */
+struct SharedResponseHeader
+{
+    HttpResponseHeader header;          ///< 过滤后的响应头
+    std::string cache_control;          ///< Cache-Control
+    std::string expires;                ///< Expires
+    std::string date;                   ///< Date
+    std::string age;                    ///< 上游 Age
+    std::string vary;                   ///< Vary
+    bool has_set_cookie = false;        ///< 是否携带 Set-Cookie
+
+    explicit SharedResponseHeader(HttpResponseHeader& upstream)
+    {
+        const std::vector<std::string> connection_tokens =
+            splitHeaderList(findHeaderValue(upstream.headerPairs(), "connection"));
+        header.copyFrom(upstream);
+        header.headerPairs().clear();
+        upstream.headerPairs().forEachHeader([&](std::string_view k, std::string_view v) {
+            if (CacheControl::iequals(k, "cache-control")) {
+                cache_control.assign(v);
+            } else if (CacheControl::iequals(k, "expires")) {
+                expires.assign(v);
+            } else if (CacheControl::iequals(k, "date")) {
+                date.assign(v);
+            } else if (CacheControl::iequals(k, "age")) {
+                age.assign(v);
+                return;
+            } else if (CacheControl::iequals(k, "vary")) {
+                vary.assign(v);
+            } else if (CacheControl::iequals(k, "set-cookie")) {
+                has_set_cookie = true;
+            }
+            if (isHopByHopHeader(k) || CacheControl::iequals(k, "content-length")) {
+                return;
+            }
+            for (const auto& token : connection_tokens) {
+                if (CacheControl::iequals(k, token)) {
+                    return;
+                }
+            }
+            header.headerPairs().addHeaderPair(std::string(k), std::string(v));
+        });
+    }
+
+    /**
+     * @brief 响应是否只属于单个用户（private 或 Set-Cookie）
+     */
+    bool isPrivate() const
+    {
+        return has_set_cookie || CacheControl::parse(cache_control).is_private;
+    }
+
+    /**
+     * @brief 序列化为完整响应
+     * @param body 响应体
+     * @param age_offset 非空时追加定宽 Age 字段，并输出其数字偏移
+     */
+    std::string serialize(std::string_view body, size_t* age_offset = nullptr)
+    {
+        header.headerPairs().addHeaderPair("Content-Length", std::to_string(body.size()));
+        if (age_offset != nullptr) {
+            header.headerPairs().addHeaderPair("Age", std::string(kAgeDigits, '0'));
+        }
+        std::string wire = header.toString();
+        if (age_offset != nullptr) {
+            const std::string placeholder = "ge: " + std::string(kAgeDigits, '0') + "\r\n";
+            const size_t pos = wire.find(placeholder);
+            *age_offset = pos == std::string::npos ? std::string::npos : pos + 4;
+            header.headerPairs().removeHeaderPair("Age");
+            header.headerPairs().removeHeaderPair("age");
+        }
+        wire.append(body);
+        return wire;
+    }
+
+    static constexpr size_t kAgeDigits = 10;    ///< Age 字段定宽位数
+
+    /**
+     * @brief 大小写不敏感地查找头部值
+     */
+    static std::string findHeaderValue(const HeaderPair& headers, std::string_view name)
+    {
+        std::string out;
+        headers.forEachHeader([&](std::string_view k, std::string_view v) {
+            if (out.empty() && CacheControl::iequals(k, name)) {
+                out.assign(v);
+            }
+        });
+        return out;
+    }
+
+    /**
+     * @brief 拆分逗号分隔的字段名列表，结果为小写且去重
+     */
+    static std::vector<std::string> splitHeaderList(std::string_view value)
+    {
+        std::vector<std::string> out;
+        size_t pos = 0;
+        while (pos < value.size()) {
+            size_t end = value.find(',', pos);
+            if (end == std::string_view::npos) {
+                end = value.size();
+            }
+            std::string_view item = CacheControl::trim(value.substr(pos, end - pos));
+            pos = end + 1;
+            if (item.empty()) {
+                continue;
+            }
+            std::string name;
+            for (char c : item) {
+                name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+            }
+            if (std::find(out.begin(), out.end(), name) == out.end()) {
+                out.push_back(std::move(name));
+            }
+        }
+        return out;
+    }
+
+    static bool isHopByHopHeader(std::string_view key)
+    {
+        return CacheControl::iequals(key, "connection") ||
+               CacheControl::iequals(key, "keep-alive") ||
+               CacheControl::iequals(key, "proxy-connection") ||
+               CacheControl::iequals(key, "transfer-encoding") ||
+               CacheControl::iequals(key, "te") ||
+               CacheControl::iequals(key, "trailer") ||
+               CacheControl::iequals(key, "upgrade");
+    }
+};
+
+/**
+ * @brief 缓存中的一条响应
+ * @details 以 shared_ptr 在缓存与正在发送的协程之间共享；wire 中的 Age 数字
+ *          定宽原地改写，并发发送同一条目时只会看到不同的合法数字
+ */
+struct CachedResponse
+{
+    static constexpr size_t kAgeDigits = SharedResponseHeader::kAgeDigits; ///< Age 字段定宽位数
+
+    std::string wire;                           ///< 预序列化的完整响应
+    size_t age_offset = std::string::npos;      ///< Age 数字在 wire 中的偏移
+    std::chrono::steady_clock::time_point origin_time; ///< 折算到源站生成时刻（已扣除上游 Age）
+    std::chrono::seconds fresh_for{0};          ///< 新鲜度寿命
+    std::chrono::seconds stale_while_revalidate{0}; ///< 过期后可先返回旧响应的窗口
+    std::vector<std::string> vary;              ///< Vary 指定的请求头（小写）
+    bool refreshing = false;                    ///< 后台刷新是否进行中
+
+    /**
+     * @brief 当前年龄
+     */
+    std::chrono::seconds age(std::chrono::steady_clock::time_point now) const
+    {
+        if (now <= origin_time) {
+            return std::chrono::seconds(0);
+        }
+        return std::chrono::duration_cast<std::chrono::seconds>(now - origin_time);
+    }
+
+    /**
+     * @brief 将当前年龄写入 wire 中的 Age 字段
+     */
+    void stampAge(std::chrono::steady_clock::time_point now)
+    {
+        if (age_offset == std::string::npos) {
+            return;
+        }
+        uint64_t value = static_cast<uint64_t>(age(now).count());
+        for (size_t i = kAgeDigits; i > 0; --i) {
+            wire[age_offset + i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+};
+
+/**
+ * @brief 线程局部的响应缓存分片
+ */
+class ResponseCache
+{
+public:
+    using EntryPtr = std::shared_ptr<CachedResponse>;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 查找结果
+     */
+    enum class State {
+        Miss,       ///< 未命中，或已过期且超出 stale-while-revalidate 窗口
+        Fresh,      ///< 新鲜命中
+        Stale,      ///< 过期但在 stale-while-revalidate 窗口内
+    };
+
+    struct Lookup {
+        State state = State::Miss;
+        EntryPtr entry;
+        bool refresh = false;   ///< Stale 命中且本次负责发起后台刷新
+    };
+
+    /**
+     * @brief 缓存统计
+     */
+    struct Stats {
+        uint64_t hits = 0;          ///< 新鲜命中
+        uint64_t stale_hits = 0;    ///< stale-while-revalidate 命中
+        uint64_t misses = 0;        ///< 未命中
+        uint64_t stores = 0;        ///< 写入次数
+        uint64_t evictions = 0;     ///< 因容量上限淘汰的条目数
+    };
+
+    static ResponseCache& local()
+    {
+        thread_local ResponseCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 构造主键（方法 + authority + URI）
+     */
+    static std::string primaryKey(std::string_view method, std::string_view authority, std::string_view uri)
+    {
+        std::string key;
+        key.reserve(method.size() + authority.size() + uri.size() + 2);
+        key.append(method).push_back(' ');
+        for (char c : authority) {
+            key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+        key.push_back(' ');
+        key.append(uri);
+        return key;
+    }
+
+    /**
+     * @brief 请求是否允许从缓存读取
+     * @details 请求携带 no-cache / no-store 或 Pragma: no-cache 时直接回源
+     */
+    static bool canServeFromCache(const HeaderPair& request_headers)
+    {
+        const std::string cc = SharedResponseHeader::findHeaderValue(request_headers, "cache-control");
+        if (!cc.empty()) {
+            const CacheControl parsed = CacheControl::parse(cc);
+            if (parsed.no_cache || parsed.no_store) {
+                return false;
+            }
+        }
+        const std::string pragma = SharedResponseHeader::findHeaderValue(request_headers, "pragma");
+        return !CacheControl::iequals(CacheControl::trim(pragma), "no-cache");
+    }
+
+    /**
+     * @brief 查找缓存
+     * @param primary 主键
+     * @param request_headers 请求头（用于匹配 Vary）
+     */
+    Lookup lookup(const std::string& primary, const HeaderPair& request_headers, Clock::time_point now = Clock::now())
+    {
+        Lookup result;
+        auto vary_it = m_vary.find(primary);
+        const std::string key = vary_it == m_vary.end()
+                                    ? primary
+                                    : variantKey(primary, vary_it->second, request_headers);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            ++m_stats.misses;
+            ProxyStats::instance().addCacheMiss();
+            return result;
+        }
+
+        const EntryPtr& entry = it->second.entry;
+        const auto age = entry->age(now);
+        if (age < entry->fresh_for) {
+            result.state = State::Fresh;
+            ++m_stats.hits;
+            ProxyStats::instance().addCacheHit();
+        } else if (age < entry->fresh_for + entry->stale_while_revalidate) {
+            result.state = State::Stale;
+            result.refresh = !entry->refreshing;
+            entry->refreshing = true;
+            ++m_stats.stale_hits;
+            ProxyStats::instance().addCacheStaleHit();
+        } else {
+            ++m_stats.misses;
+            ProxyStats::instance().addCacheMiss();
+            return result;
+        }
+
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+        entry->stampAge(now);
+        result.entry = entry;
+        return result;
+    }
+
+    /**
+     * @brief 尝试缓存上游响应
+     * @param primary 主键
+     * @param request_headers 原始请求头
+     * @param response_header 上游响应头
+     * @param body 响应体
+     * @param config 缓存配置
+     * @return 响应可缓存并已写入时返回 true
+     */
+    bool store(const std::string& primary,
+               const HeaderPair& request_headers,
+               HttpResponseHeader& response_header,
+               std::string_view body,
+               const ResponseCacheConfig& config,
+               Clock::time_point now = Clock::now(),
+               std::time_t wall_now = std::time(nullptr))
+    {
+        if (!config.enabled || config.max_entries == 0 || response_header.isChunked() ||
+            !isCacheableStatus(static_cast<int>(response_header.code()))) {
+            return false;
+        }
+
+        const std::string request_cc = SharedResponseHeader::findHeaderValue(request_headers, "cache-control");
+        if (!request_cc.empty() && CacheControl::parse(request_cc).no_store) {
+            return false;
+        }
+
+        SharedResponseHeader shared(response_header);
+        const CacheControl cc = CacheControl::parse(shared.cache_control);
+        if (cc.no_store || cc.is_private || cc.no_cache || shared.has_set_cookie) {
+            return false;
+        }
+        // 带 Authorization 的请求仅在响应显式允许共享时缓存（RFC 9111 §3.5）
+        if (!SharedResponseHeader::findHeaderValue(request_headers, "authorization").empty() &&
+            !cc.is_public && !cc.s_maxage && !cc.must_revalidate) {
+            return false;
+        }
+
+        std::vector<std::string> vary_names;
+        if (!parseVary(shared.vary, vary_names)) {
+            return false;
+        }
+
+        int64_t lifetime = 0;
+        if (cc.s_maxage) {
+            lifetime = *cc.s_maxage;
+        } else if (cc.max_age) {
+            lifetime = *cc.max_age;
+        } else if (!shared.expires.empty()) {
+            std::time_t expires_at = 0;
+            std::time_t date_at = wall_now;
+            if (!HttpDate::parse(shared.expires, expires_at)) {
+                return false;
+            }
+            if (!shared.date.empty()) {
+                HttpDate::parse(shared.date, date_at);
+            }
+            lifetime = std::max<int64_t>(0, static_cast<int64_t>(expires_at - date_at));
+        } else {
+            return false;
+        }
+        if (lifetime <= 0) {
+            return false;
+        }
+
+        auto entry = std::make_shared<CachedResponse>();
+        entry->fresh_for = std::chrono::seconds(lifetime);
+        if (cc.stale_while_revalidate && !cc.must_revalidate) {
+            entry->stale_while_revalidate = std::chrono::seconds(*cc.stale_while_revalidate);
+        }
+        entry->origin_time = now - std::chrono::seconds(CacheControl::parseSeconds(CacheControl::trim(shared.age)));
+        entry->vary = vary_names;
+        entry->wire = shared.serialize(body, &entry->age_offset);
+        if (entry->wire.size() > config.max_object_size || entry->wire.size() > config.max_bytes) {
+            return false;
+        }
+
+        if (vary_names.empty()) {
+            m_vary.erase(primary);
+        } else {
+            if (m_vary.size() >= config.max_entries * 2) {
+                m_vary.clear();
+            }
+            m_vary[primary] = vary_names;
+        }
+        const std::string key = vary_names.empty()
+                                    ? primary
+                                    : variantKey(primary, vary_names, request_headers);
+        insert(key, std::move(entry), config);
+        ++m_stats.stores;
+        ProxyStats::instance().addCacheStore();
+        return true;
+    }
+
+    /**
+     * @brief 后台刷新结束（无论成功与否），允许下一次 Stale 命中重新发起
+     */
+    static void finishRefresh(const EntryPtr& entry)
+    {
+        if (entry) {
+            entry->refreshing = false;
+        }
+    }
+
+    void erase(const std::string& primary)
+    {
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->first == primary || it->first.starts_with(primary + kVarySeparator)) {
+                m_bytes -= it->second.entry->wire.size();
+                m_lru.erase(it->second.lru);
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_vary.erase(primary);
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_lru.clear();
+        m_vary.clear();
+        m_bytes = 0;
+    }
+
+    size_t size() const { return m_entries.size(); }     ///< 条目数
+    size_t bytes() const { return m_bytes; }             ///< 占用字节数
+    const Stats& stats() const { return m_stats; }       ///< 统计
+
+private:
+    static constexpr char kVarySeparator = '\x1f';
+
+    struct Slot {
+        EntryPtr entry;
+        std::list<std::string>::iterator lru;
+    };
+
+    static bool isCacheableStatus(int code)
+    {
+        switch (code) {
+        case 200: case 203: case 204: case 300: case 301: case 308:
+        case 404: case 405: case 410: case 414: case 501:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief 解析 Vary，返回排序后的小写字段名；Vary: * 返回 false（不可缓存）
+     */
+    static bool parseVary(std::string_view value, std::vector<std::string>& out)
+    {
+        out = SharedResponseHeader::splitHeaderList(value);
+        if (std::find(out.begin(), out.end(), "*") != out.end()) {
+            return false;
+        }
+        std::sort(out.begin(), out.end());
+        return true;
+    }
+
+    static std::string variantKey(const std::string& primary,
+                                  const std::vector<std::string>& vary,
+                                  const HeaderPair& request_headers)
+    {
+        std::string key = primary;
+        for (const auto& name : vary) {
+            key.push_back(kVarySeparator);
+            key.append(name).push_back('=');
+            key.append(SharedResponseHeader::findHeaderValue(request_headers, name));
+        }
+        return key;
+    }
+
+    void insert(const std::string& key, EntryPtr entry, const ResponseCacheConfig& config)
+    {
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            m_bytes -= it->second.entry->wire.size();
+            m_lru.erase(it->second.lru);
+            m_entries.erase(it);
+        }
+        while (!m_lru.empty() &&
+               (m_entries.size() >= config.max_entries || m_bytes + entry->wire.size() > config.max_bytes)) {
+            auto victim = m_entries.find(m_lru.back());
+            m_bytes -= victim->second.entry->wire.size();
+            m_entries.erase(victim);
+            m_lru.pop_back();
+            ++m_stats.evictions;
+        }
+        m_lru.push_front(key);
+        m_bytes += entry->wire.size();
+        m_entries.emplace(key, Slot{std::move(entry), m_lru.begin()});
+    }
+
+    std::unordered_map<std::string, Slot> m_entries;
+    std::list<std::string> m_lru;                                        ///< 头部最近使用
+    std::unordered_map<std::string, std::vector<std::string>> m_vary;    ///< 主键 → Vary 字段
+    size_t m_bytes = 0;
+    Stats m_stats;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_RESPONSE_CACHE_H
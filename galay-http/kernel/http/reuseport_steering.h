@@ -0,0 +1,223 @@
+/**
+ * @file reuseport_steering.h
+ * @brief SO_REUSEPORT 组按接收 CPU 选择 listener，以及各调度器的 accept 统计
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 默认情况下内核按四元组哈希在 reuseport 组内挑选 listener，
+ * 处理该连接 RX 软中断的 CPU 与负责该连接的 IO 调度器往往不是同一个核，
+ * 每个包都要跨核唤醒、迁移 socket 缓存行。
+ * 当 IO 调度器绑核时，向组内挂载一段经典 BPF 程序（SO_ATTACH_REUSEPORT_CBPF）：
+ * 读取当前 CPU（即 SO_INCOMING_CPU），返回绑定在该 CPU 上的调度器所持 listener 的组内下标；
+ * 未匹配任何调度器的 CPU 返回越界下标，内核随之退回哈希选择。
+ * 组内下标即 listen 的先后顺序，因此启用时由 HttpListenEndpoint 在启动阶段按调度器顺序预先创建整组 listener。
+ */
+
+#ifndef GALAY_HTTP_REUSEPORT_STEERING_H
+#define GALAY_HTTP_REUSEPORT_STEERING_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+namespace galay::http
+{
+
+/**
+ * @brief 单个 IO 调度器的 accept 统计
+ */
+struct HttpAcceptSlotStats
+{
+    size_t scheduler = 0;       ///< IO 调度器下标
+    int cpu = -1;               ///< 绑定的 CPU（未绑核为 -1）
+    uint64_t accepted = 0;      ///< accept 成功的连接数
+    uint64_t cpu_local = 0;     ///< 其中 SO_INCOMING_CPU 与绑定 CPU 一致的连接数（仅 CPU 引导启用时统计）
+    uint64_t batched = 0;       ///< 其中由批量非阻塞 accept 取出的连接数
+};
+
+/**
+ * @brief 服务器 accept 分布快照
+ */
+struct HttpAcceptStats
+{
+    bool cpu_steering = false;                  ///< 是否已挂载按 CPU 选择 listener 的 BPF 程序
+    std::vector<HttpAcceptSlotStats> schedulers; ///< 按 IO 调度器下标排列
+
+    uint64_t totalAccepted() const
+    {
+        uint64_t total = 0;
+        for (const auto& slot : schedulers) {
+            total += slot.accepted;
+        }
+        return total;
+    }
+};
+
+namespace detail
+{
+
+/**
+ * @brief 读取已 accept 连接的 SO_INCOMING_CPU
+ * @return 处理该连接接收路径的 CPU，不支持时返回 -1
+ */
+inline int incomingCpu(int fd)
+{
+#if defined(__linux__) && defined(SO_INCOMING_CPU)
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (::getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) == 0) {
+        return cpu;
+    }
+#else
+    (void)fd;
+#endif
+    return -1;
+}
+
+#if defined(__linux__)
+/**
+ * @brief 生成按 CPU 选择 listener 的经典 BPF 程序
+ * @param cpus 第 i 个元素为组内第 i 个 listener 所属调度器绑定的 CPU
+ * @return 指令序列；cpus 为空或超出 BPF_MAXINSNS 时返回空
+ * @details `ld cpu; jeq cpu0 → ret 0; jeq cpu1 → ret 1; ...; ret n`，
+ *          最后的越界返回值让内核对未绑定调度器的 CPU 退回哈希选择
+ */
+inline std::vector<sock_filter> buildCpuSteeringProgram(const std::vector<int>& cpus)
+{
+    std::vector<sock_filter> program;
+    if (cpus.empty() || cpus.size() * 2 + 2 > BPF_MAXINSNS) {
+        return program;
+    }
+    program.reserve(cpus.size() * 2 + 2);
+    program.push_back(sock_filter BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        program.push_back(sock_filter BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast<uint32_t>(cpus[i]), 0, 1));
+        program.push_back(sock_filter BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(i)));
+    }
+    program.push_back(sock_filter BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(cpus.size())));
+    return program;
+}
+#endif
+
+/**
+ * @brief 向 fd 所在的 reuseport 组挂载按 CPU 选择的程序（作用于整组）
+ * @return 失败返回 false 并写入 error
+ */
+inline bool attachCpuSteering(int fd, const std::vector<int>& cpus, std::string& error)
+{
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    auto program = buildCpuSteeringProgram(cpus);
+    if (program.empty()) {
+        error = "invalid cpu list";
+        return false;
+    }
+    sock_fprog prog{};
+    prog.len = static_cast<unsigned short>(program.size());
+    prog.filter = program.data();
+    if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)cpus;
+    error = "SO_ATTACH_REUSEPORT_CBPF not supported";
+    return false;
+#endif
+}
+
+/**
+ * @brief 卸载 reuseport 组的选择程序，恢复哈希分发
+ * @details 停止时唤醒 accept 循环前调用，使唤醒连接不再集中落到发起线程所在 CPU 的 listener
+ */
+inline bool detachReuseportProgram(int fd)
+{
+#if defined(__linux__) && defined(SO_DETACH_REUSEPORT_BPF)
+    const int zero = 0;
+    return ::setsockopt(fd, SOL_SOCKET, SO_DETACH_REUSEPORT_BPF, &zero, sizeof(zero)) == 0;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief 各 IO 调度器的 accept 计数
+ * @details 每个槽位独占缓存行，只由对应调度器的 accept 循环写入
+ */
+class HttpAcceptCounters
+{
+public:
+    /**
+     * @param cpus 各调度器绑定的 CPU（未绑核为 -1）
+     */
+    void reset(std::vector<int> cpus)
+    {
+        m_cpus = std::move(cpus);
+        m_slots = m_cpus.empty() ? nullptr : std::make_unique<Slot[]>(m_cpus.size());
+    }
+
+    /**
+     * @brief 记录一次 accept
+     * @param check_cpu 为 true 时读取连接的 SO_INCOMING_CPU 并与绑定 CPU 比较
+     * @param batched 是否由批量非阻塞 accept 取出
+     */
+    void record(size_t index, int fd, bool check_cpu, bool batched = false)
+    {
+        if (index >= m_cpus.size()) {
+            return;
+        }
+        Slot& slot = m_slots[index];
+        slot.accepted.fetch_add(1, std::memory_order_relaxed);
+        if (batched) {
+            slot.batched.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (check_cpu && m_cpus[index] >= 0 && detail::incomingCpu(fd) == m_cpus[index]) {
+            slot.cpu_local.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    HttpAcceptStats snapshot(bool cpu_steering) const
+    {
+        HttpAcceptStats stats;
+        stats.cpu_steering = cpu_steering;
+        stats.schedulers.reserve(m_cpus.size());
+        for (size_t i = 0; i < m_cpus.size(); ++i) {
+            HttpAcceptSlotStats slot;
+            slot.scheduler = i;
+            slot.cpu = m_cpus[i];
+            slot.accepted = m_slots[i].accepted.load(std::memory_order_relaxed);
+            slot.cpu_local = m_slots[i].cpu_local.load(std::memory_order_relaxed);
+            slot.batched = m_slots[i].batched.load(std::memory_order_relaxed);
+            stats.schedulers.push_back(slot);
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> cpu_local{0};
+        std::atomic<uint64_t> batched{0};
+    };
+
+    std::vector<int> m_cpus;
+    std::unique_ptr<Slot[]> m_slots;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_REUSEPORT_STEERING_H
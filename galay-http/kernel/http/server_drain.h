@@ -0,0 +1,222 @@
+/**
+ * @file server_drain.h
+ * @brief 服务器优雅排空与监听 fd 交接（HttpServer、HttpsServer、H2cServer、H2Server 共用）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 排空：停止 accept，已在处理的请求继续完成；
+ * - HTTP/1.1 路由模式：等待下一个请求的空闲 keep-alive 连接立即关闭，正在处理的请求响应带 `Connection: close`
+ * - HTTP/2：连接发送 GOAWAY，不再接受新流，在途流结束（或 graceful_shutdown_timeout）后关闭
+ * 调用方以 gracefulStop(timeout) 等待存活连接归零或超时后停止 runtime。
+ *
+ * 交接：配置 `handoff_path` 后，启动时先尝试从该路径上的旧进程继承监听 fd（见 listener_handoff.h），
+ * 开始 accept 后通知旧进程，再在同一路径上等待下一代进程；旧进程收到就绪字节后自动开始排空，
+ * 监听 socket 始终处于打开状态，升级期间不丢 SYN 队列与已完成握手的排队连接。
+ */
+
+#ifndef GALAY_HTTP_SERVER_DRAIN_H
+#define GALAY_HTTP_SERVER_DRAIN_H
+
+#include "http_listener.h"
+#include "listener_handoff.h"
+#include "galay-http/kernel/graceful_drain.h"
+#include "galay-http/common/http_log.h"
+#include "galay-kernel/async/tcp_socket.h"
+#include "galay-kernel/kernel/runtime.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace galay::http
+{
+
+using namespace galay::async;
+using namespace galay::kernel;
+
+/**
+ * @brief 服务器的排空状态、存活连接计数与交接协程
+ */
+class HttpServerDrain
+{
+public:
+    static constexpr auto kIdlePollInterval = std::chrono::milliseconds(5);
+
+    /**
+     * @brief 每次启动前调用：清除上一轮的排空与交接状态
+     */
+    void reset(const std::string& handoff_path)
+    {
+        m_handoff_path = handoff_path;
+        m_draining.store(false);
+        m_handed_off.store(false);
+        m_inheritance.reset();
+    }
+
+    bool draining() const { return m_draining.load(std::memory_order_acquire); }
+    bool handedOff() const { return m_handed_off.load(std::memory_order_acquire); }
+    size_t activeConnections() const { return m_active.load(std::memory_order_acquire); }
+
+    void onConnOpen() { m_active.fetch_add(1, std::memory_order_acq_rel); }
+    void onConnClose() { m_active.fetch_sub(1, std::memory_order_acq_rel); }
+
+    /**
+     * @brief open() 之前调用：配置了交接路径时预先创建整组 listener，并尝试继承旧进程的监听 fd
+     * @details 路径上没有旧进程时按配置正常 bind
+     */
+    void prepareListen(HttpListenEndpoint& listen)
+    {
+        if (m_handoff_path.empty()) {
+            return;
+        }
+        listen.requireListenerGroup(true);
+        std::string error;
+        if (m_inheritance.fetch(m_handoff_path, error)) {
+            listen.adoptInherited(m_inheritance.take(), m_inheritance.authority());
+        } else if (!error.empty()) {
+            HTTP_LOG_WARN("[handoff] [inherit] [fail]", "path={} error={}", m_handoff_path, error);
+        }
+    }
+
+    /**
+     * @brief accept 循环启动后调用：通知旧进程开始排空，并在交接路径上等待下一代进程
+     * @param on_handoff 监听 fd 交给下一代进程后在 IO 调度器 0 上调用（通常为服务器的 beginDrain）
+     */
+    void onStarted(Runtime& runtime, HttpListenEndpoint& listen, std::function<void()> on_handoff)
+    {
+        if (m_handoff_path.empty()) {
+            return;
+        }
+        if (m_inheritance.confirm()) {
+            HTTP_LOG_INFO("[handoff] [inherit]", "path={}", m_handoff_path);
+        }
+        auto* scheduler = runtime.getIOScheduler(0);
+        if (scheduler != nullptr) {
+            scheduleTask(scheduler, serveHandoff(listen, std::move(on_handoff)));
+        }
+    }
+
+    /**
+     * @brief runtime 停止后调用：未交接时删除交接 socket 文件
+     */
+    void onStopped()
+    {
+        m_inheritance.reset();
+        if (!m_handoff_path.empty() && !handedOff()) {
+            detail::removeUnixSocketFile(m_handoff_path);
+        }
+    }
+
+    /**
+     * @brief 进入排空状态，并在每个 IO 调度器上通知排空表中的连接
+     * @return 此前已在排空时返回 false
+     */
+    bool begin(Runtime& runtime)
+    {
+        bool expected = false;
+        if (!m_draining.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        const size_t io_count = runtime.getIOSchedulerCount();
+        for (size_t i = 0; i < io_count; ++i) {
+            auto* scheduler = runtime.getIOScheduler(i);
+            if (scheduler != nullptr) {
+                scheduleTask(scheduler, drainLocal());
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 等待存活连接归零
+     * @return 超时前归零返回 true
+     */
+    bool waitIdle(std::chrono::milliseconds timeout) const
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (activeConnections() > 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(kIdlePollInterval);
+        }
+        return true;
+    }
+
+private:
+    static Task<void> drainLocal()
+    {
+        const size_t notified = HttpDrainList::local().drain();
+        HTTP_LOG_DEBUG("[drain] [notify]", "conns={}", notified);
+        co_return;
+    }
+
+    /**
+     * @brief 在交接路径上等待下一代进程，发送全部监听 fd 并等待其就绪字节
+     * @details 新进程未回送就绪字节即断开时继续等待下一次连接；交接完成后不再监听该路径。
+     *          socket 文件权限为 0600，且只向 uid 与本进程相同（或为 root）的对端发送监听 fd
+     */
+    Task<void> serveHandoff(HttpListenEndpoint& listen, std::function<void()> on_handoff)
+    {
+        std::string error;
+        const int fd = detail::openUnixListener(m_handoff_path, 4, error, detail::kHandoffSocketMode);
+        if (fd < 0) {
+            HTTP_LOG_ERROR("[handoff] [listen] [fail]", "path={} error={}", m_handoff_path, error);
+            co_return;
+        }
+        TcpSocket listener(GHandle{fd});
+
+        while (!draining()) {
+            Host peer_host;
+            auto accept_result = co_await listener.accept(&peer_host);
+            if (!accept_result) {
+                continue;
+            }
+            TcpSocket peer(accept_result.value());
+            if (!detail::handoffPeerTrusted(peer.handle().fd, error)) {
+                HTTP_LOG_WARN("[handoff] [reject]", "path={} error={}", m_handoff_path, error);
+                co_await peer.close();
+                continue;
+            }
+            const std::vector<int> fds = listen.listenerFds();
+            if (!detail::sendListenerFds(peer.handle().fd, fds, listen.address().authority(), error)) {
+                HTTP_LOG_WARN("[handoff] [send] [fail]", "error={}", error);
+                co_await peer.close();
+                continue;
+            }
+            if (!peer.option().handleNonBlock()) {
+                co_await peer.close();
+                continue;
+            }
+            char ready = 0;
+            auto ready_result = co_await peer.recv(&ready, 1);
+            co_await peer.close();
+            if (!ready_result || ready_result.value() != 1 || ready != detail::kHandoffReady) {
+                HTTP_LOG_WARN("[handoff] [abort]", "path={}", m_handoff_path);
+                continue;
+            }
+            m_handed_off.store(true, std::memory_order_release);
+            listen.markHandedOff();
+            HTTP_LOG_INFO("[handoff] [done]", "path={} listeners={}", m_handoff_path, fds.size());
+            if (on_handoff) {
+                on_handoff();
+            }
+            break;
+        }
+        co_await listener.close();
+        co_return;
+    }
+
+    std::string m_handoff_path;                 ///< 交接 socket 路径（为空表示不交接）
+    HttpListenerInheritance m_inheritance;      ///< 启动时从旧进程继承的监听 fd
+    std::atomic<bool> m_draining{false};
+    std::atomic<bool> m_handed_off{false};
+    std::atomic<size_t> m_active{0};            ///< 已开始处理、尚未结束的连接数
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_SERVER_DRAIN_H
@@ -0,0 +1,241 @@
+/**
+ * @file single_flight.h
+ * @brief 相同上游请求合并（single-flight）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 进程级注册表，按键分条带加锁：
+ * - 第一个到达的请求成为 leader，负责回源
+ * - 回源期间到达的相同请求登记唤醒回调后挂起，leader 完成时统一唤醒，
+ *   并共享同一份预序列化响应
+ * - 唤醒回调由调用方提供，负责把唤醒投递回等待者所在的调度器，
+ *   因此跨调度器的等待者不会在 leader 线程上被恢复
+ * - 响应不可共享（private / Set-Cookie / Vary 超出键范围）或回源失败时，
+ *   结果为空，等待者各自回源
+ */
+
+#ifndef GALAY_HTTP_SINGLE_FLIGHT_H
+#define GALAY_HTTP_SINGLE_FLIGHT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace galay::http
+{
+
+/**
+ * @brief single-flight 统计
+ */
+struct SingleFlightStats
+{
+    uint64_t leaders = 0;       ///< 回源的 leader 数
+    uint64_t followers = 0;     ///< 挂起等待的请求数
+    uint64_t shared = 0;        ///< 由 leader 响应直接应答的等待者数
+    uint64_t fallbacks = 0;     ///< 结果不可共享而自行回源的等待者数
+};
+
+/**
+ * @brief 请求合并注册表
+ */
+class SingleFlight
+{
+public:
+    using Result = std::shared_ptr<const std::string>;   ///< 预序列化的完整响应，空表示不可共享
+    using Wake = std::function<void()>;                  ///< 唤醒回调
+
+    /**
+     * @brief 一次进行中的回源
+     */
+    class Flight
+    {
+    public:
+        /**
+         * @brief 登记唤醒回调
+         * @return 已完成时返回 false（不会回调，调用方直接读取结果）
+         */
+        bool subscribe(Wake wake)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_done) {
+                return false;
+            }
+            m_waiters.push_back(std::move(wake));
+            return true;
+        }
+
+        /**
+         * @brief 读取结果（仅在完成后有意义）
+         */
+        Result result() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_result;
+        }
+
+        bool done() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_done;
+        }
+
+    private:
+        friend class SingleFlight;
+
+        mutable std::mutex m_mutex;
+        bool m_done = false;
+        Result m_result;
+        std::vector<Wake> m_waiters;
+    };
+
+    using FlightPtr = std::shared_ptr<Flight>;
+
+    /**
+     * @brief 加入结果
+     */
+    struct Join {
+        FlightPtr flight;
+        bool leader = false;
+    };
+
+    /**
+     * @brief leader 守卫：析构时若尚未完成，以空结果完成，避免等待者永久挂起
+     */
+    class LeaderGuard
+    {
+    public:
+        LeaderGuard(SingleFlight& registry, std::string key, FlightPtr flight)
+            : m_registry(&registry)
+            , m_key(std::move(key))
+            , m_flight(std::move(flight))
+        {
+        }
+        LeaderGuard(const LeaderGuard&) = delete;
+        LeaderGuard& operator=(const LeaderGuard&) = delete;
+        ~LeaderGuard() { complete(nullptr); }
+
+        void complete(Result result)
+        {
+            if (m_flight) {
+                m_registry->complete(m_key, m_flight, std::move(result));
+                m_flight.reset();
+            }
+        }
+
+    private:
+        SingleFlight* m_registry;
+        std::string m_key;
+        FlightPtr m_flight;
+    };
+
+    static SingleFlight& instance()
+    {
+        static SingleFlight registry;
+        return registry;
+    }
+
+    /**
+     * @brief 加入或发起一次回源
+     */
+    Join join(const std::string& key)
+    {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto [it, inserted] = shard.flights.try_emplace(key);
+        if (inserted) {
+            it->second = std::make_shared<Flight>();
+            m_leaders.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_followers.fetch_add(1, std::memory_order_relaxed);
+        }
+        return Join{it->second, inserted};
+    }
+
+    /**
+     * @brief 完成回源并唤醒所有等待者
+     * @details 先从注册表摘除，之后到达的相同请求会发起新的回源
+     */
+    void complete(const std::string& key, const FlightPtr& flight, Result result)
+    {
+        {
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.flights.find(key);
+            if (it != shard.flights.end() && it->second == flight) {
+                shard.flights.erase(it);
+            }
+        }
+
+        std::vector<Wake> waiters;
+        {
+            std::lock_guard<std::mutex> lock(flight->m_mutex);
+            if (flight->m_done) {
+                return;
+            }
+            flight->m_done = true;
+            flight->m_result = result;
+            waiters.swap(flight->m_waiters);
+        }
+        if (result) {
+            m_shared.fetch_add(waiters.size(), std::memory_order_relaxed);
+        } else {
+            m_fallbacks.fetch_add(waiters.size(), std::memory_order_relaxed);
+        }
+        for (auto& wake : waiters) {
+            wake();
+        }
+    }
+
+    /**
+     * @brief 进行中的回源数
+     */
+    size_t inflight() const
+    {
+        size_t total = 0;
+        for (const auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.flights.size();
+        }
+        return total;
+    }
+
+    SingleFlightStats stats() const
+    {
+        SingleFlightStats s;
+        s.leaders = m_leaders.load(std::memory_order_relaxed);
+        s.followers = m_followers.load(std::memory_order_relaxed);
+        s.shared = m_shared.load(std::memory_order_relaxed);
+        s.fallbacks = m_fallbacks.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static constexpr size_t kShardCount = 16;
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, FlightPtr> flights;
+    };
+
+    Shard& shardFor(const std::string& key)
+    {
+        return m_shards[std::hash<std::string>{}(key) % kShardCount];
+    }
+
+    std::array<Shard, kShardCount> m_shards;
+    std::atomic<uint64_t> m_leaders{0};
+    std::atomic<uint64_t> m_followers{0};
+    std::atomic<uint64_t> m_shared{0};
+    std::atomic<uint64_t> m_fallbacks{0};
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_SINGLE_FLIGHT_H
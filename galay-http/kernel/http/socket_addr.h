@@ -0,0 +1,354 @@
+/**
+ * @file socket_addr.h
+ * @brief 监听/连接地址解析：IPv4、IPv6（双栈）与 Unix domain socket
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 服务器与客户端配置沿用 `host` 字符串表达地址族：
+ * - `0.0.0.0`、`127.0.0.1`：IPv4
+ * - `::`、`::1`、`[::1]`：IPv6；监听 `::` 时默认关闭 IPV6_V6ONLY，同时接受 IPv4 连接
+ * - `unix:/run/app.sock`：Unix domain socket，端口被忽略；`unix:@name` 为 Linux 抽象命名空间
+ * Unix domain socket 不经过回环 TCP 协议栈，适合同机 sidecar 与应用之间的转发。
+ * 本文件只包含系统调用封装，不依赖运行时，监听/连接 socket 的创建见 http_listener.h；
+ * accept 循环的批量非阻塞 accept（HttpAcceptBatch）也在此实现。
+ */
+
+#ifndef GALAY_HTTP_SOCKET_ADDR_H
+#define GALAY_HTTP_SOCKET_ADDR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace galay::http
+{
+
+/**
+ * @brief 地址族
+ */
+enum class HttpAddressFamily
+{
+    IPv4,   ///< AF_INET
+    IPv6,   ///< AF_INET6
+    Unix    ///< AF_UNIX（SOCK_STREAM）
+};
+
+/**
+ * @brief 解析后的监听/连接地址
+ */
+struct HttpSocketAddress
+{
+    static constexpr std::string_view kUnixPrefix = "unix:";   ///< Unix domain socket 地址前缀
+
+    HttpAddressFamily family = HttpAddressFamily::IPv4;   ///< 地址族
+    std::string host;                                     ///< IP 字面量（不含方括号）或 socket 路径
+    uint16_t port = 0;                                    ///< 端口（Unix 时为 0）
+
+    /**
+     * @brief 从配置中的 host 与 port 解析地址
+     * @param host IPv4/IPv6 字面量（IPv6 可带方括号）或 `unix:` 前缀的路径
+     */
+    static HttpSocketAddress parse(std::string_view host, uint16_t port)
+    {
+        HttpSocketAddress address;
+        if (host.substr(0, kUnixPrefix.size()) == kUnixPrefix) {
+            address.family = HttpAddressFamily::Unix;
+            address.host = host.substr(kUnixPrefix.size());
+            return address;
+        }
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+            host = host.substr(1, host.size() - 2);
+            address.family = HttpAddressFamily::IPv6;
+        } else if (host.find(':') != std::string_view::npos) {
+            address.family = HttpAddressFamily::IPv6;
+        }
+        address.host = host;
+        address.port = port;
+        return address;
+    }
+
+    bool isUnix() const { return family == HttpAddressFamily::Unix; }
+    bool isIPv6() const { return family == HttpAddressFamily::IPv6; }
+
+    /**
+     * @brief 地址的规范文本：`1.2.3.4:80`、`[::1]:80` 或 `unix:/path`
+     * @details 用作连接池键与日志
+     */
+    std::string authority() const
+    {
+        if (isUnix()) {
+            return std::string(kUnixPrefix) + host;
+        }
+        std::string out;
+        out.reserve(host.size() + 8);
+        if (isIPv6()) {
+            out += '[';
+            out += host;
+            out += ']';
+        } else {
+            out += host;
+        }
+        out += ':';
+        out += std::to_string(port);
+        return out;
+    }
+
+    /**
+     * @brief 发往该地址的请求使用的 Host 头
+     * @details Unix domain socket 没有主机名，使用 `localhost`
+     */
+    std::string hostHeader() const
+    {
+        return isUnix() ? std::string("localhost") : authority();
+    }
+};
+
+/**
+ * @brief Unix domain socket 连接失败的原因
+ */
+struct HttpUnixConnectError
+{
+    std::string message;        ///< 错误描述
+    bool retryable = false;     ///< 对端监听队列已满（EAGAIN），稍后重试可能成功
+};
+
+namespace detail
+{
+
+/**
+ * @brief 填充 sockaddr_un
+ * @param path 文件路径；`@` 开头表示抽象命名空间（sun_path[0] 为 0）
+ * @return 路径为空或超过 sun_path 容量时返回 false
+ */
+inline bool fillUnixSockAddr(std::string_view path, sockaddr_un& addr, socklen_t& len)
+{
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    if (path.front() == '@') {
+        addr.sun_path[0] = '\0';
+        len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+    } else {
+        len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief 删除遗留的 socket 文件（只删除 socket 类型的文件，抽象命名空间无需删除）
+ */
+inline void removeUnixSocketFile(const std::string& path)
+{
+    if (path.empty() || path.front() == '@') {
+        return;
+    }
+    struct stat st{};
+    if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        ::unlink(path.c_str());
+    }
+}
+
+/**
+ * @brief 创建非阻塞的 Unix domain socket 监听 fd
+ * @details 绑定前删除上次进程遗留的 socket 文件，否则 bind 返回 EADDRINUSE
+ * @param mode 非 0 时在 listen 之前把 socket 文件权限改为该值（bind 按 umask 创建文件，
+ *             listen 之前的连接会被拒绝，因此不存在按宽松权限接受连接的窗口）；抽象命名空间没有文件权限，忽略
+ * @return 成功返回 fd，失败返回 -1 并写入 error
+ */
+inline int openUnixListener(const std::string& path, int backlog, std::string& error, mode_t mode = 0)
+{
+    sockaddr_un addr{};
+    socklen_t len = 0;
+    if (!fillUnixSockAddr(path, addr, len)) {
+        error = "invalid unix socket path";
+        return -1;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return -1;
+    }
+    removeUnixSocketFile(path);
+    const bool restrict_mode = mode != 0 && path.front() != '@';
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), len) != 0 ||
+        (restrict_mode && ::chmod(path.c_str(), mode) != 0) || ::listen(fd, backlog) != 0) {
+        error = std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief 设置 IPV6_V6ONLY
+ * @param enabled false 时同一 socket 同时接受 IPv4（映射为 ::ffff:a.b.c.d）与 IPv6 连接
+ */
+inline bool setIpv6Only(int fd, bool enabled)
+{
+    const int value = enabled ? 1 : 0;
+    return ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &value, sizeof(value)) == 0;
+}
+
+/**
+ * @brief 创建非阻塞、SO_REUSEPORT 的 TCP 监听 fd
+ * @details 需要在启动时按固定顺序预先创建整组 listener 时使用（reuseport 组内下标即创建顺序）；
+ *          地址必须是 IP 字面量
+ * @return 成功返回 fd，失败返回 -1 并写入 error
+ */
+inline int openTcpListener(const HttpSocketAddress& address, int backlog, bool ipv6_only, std::string& error)
+{
+    sockaddr_storage storage{};
+    socklen_t len = 0;
+    const int family = address.isIPv6() ? AF_INET6 : AF_INET;
+    if (address.isIPv6()) {
+        auto* addr = reinterpret_cast<sockaddr_in6*>(&storage);
+        addr->sin6_family = AF_INET6;
+        addr->sin6_port = htons(address.port);
+        if (::inet_pton(AF_INET6, address.host.c_str(), &addr->sin6_addr) != 1) {
+            error = "invalid ipv6 address";
+            return -1;
+        }
+        len = sizeof(sockaddr_in6);
+    } else if (!address.isUnix()) {
+        auto* addr = reinterpret_cast<sockaddr_in*>(&storage);
+        addr->sin_family = AF_INET;
+        addr->sin_port = htons(address.port);
+        if (::inet_pton(AF_INET, address.host.c_str(), &addr->sin_addr) != 1) {
+            error = "invalid ipv4 address";
+            return -1;
+        }
+        len = sizeof(sockaddr_in);
+    } else {
+        error = "not a tcp address";
+        return -1;
+    }
+
+    const int fd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return -1;
+    }
+    const int one = 1;
+    const bool ok = ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) == 0 &&
+                    ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == 0 &&
+                    (!address.isIPv6() || setIpv6Only(fd, ipv6_only)) &&
+                    ::bind(fd, reinterpret_cast<const sockaddr*>(&storage), len) == 0 &&
+                    ::listen(fd, backlog) == 0;
+    if (!ok) {
+        error = std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief 连接 Unix domain socket，返回已连接的非阻塞 fd
+ * @details 以非阻塞 socket 发起 connect：本地连接由内核立即完成或失败，不会挂起调用线程。
+ *          对端监听队列已满时返回 EAGAIN（不同于 TCP 的 EINPROGRESS，没有待完成的连接可等待），
+ *          此时 retryable 置为 true，由调用方退避后重新连接
+ * @param retryable 非空时写入失败是否为暂时性的
+ * @return 成功返回 fd，失败返回 -1 并写入 error
+ */
+inline int connectUnixStream(const std::string& path, std::string& error, bool* retryable = nullptr)
+{
+    if (retryable != nullptr) {
+        *retryable = false;
+    }
+    sockaddr_un addr{};
+    socklen_t len = 0;
+    if (!fillUnixSockAddr(path, addr, len)) {
+        error = "invalid unix socket path";
+        return -1;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return -1;
+    }
+    int rc = 0;
+    do {
+        rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), len);
+    } while (rc != 0 && errno == EINTR);
+    if (rc != 0) {
+        const int err = errno;
+        error = std::strerror(err);
+        if (retryable != nullptr) {
+            *retryable = err == EAGAIN || err == EWOULDBLOCK;
+        }
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace detail
+
+/**
+ * @brief 一次 accept 唤醒后的批量非阻塞 accept
+ * @details 等待式 accept 返回后调用 arm()，之后 next() 以 accept4(SOCK_NONBLOCK | SOCK_CLOEXEC)
+ *          直接取出监听队列中已完成握手的连接，直到 EAGAIN 或本轮取满 limit - 1 个，
+ *          连接风暴时一次唤醒处理一批连接；取出的 fd 已是非阻塞，无需再单独 fcntl。
+ *          limit 为 0 或 1 时不批量。只在所属 accept 循环内使用
+ */
+class HttpAcceptBatch
+{
+public:
+    HttpAcceptBatch(int listen_fd, size_t limit)
+        : m_listen_fd(listen_fd)
+        , m_limit(limit == 0 ? 1 : limit)
+    {
+    }
+
+    /**
+     * @brief 等待式 accept 成功后开启新一轮批量
+     */
+    void arm() { m_remaining = m_limit - 1; }
+
+    /**
+     * @brief 取出下一个排队连接
+     * @return 非阻塞 fd；队列已空、本轮已取满或出错时返回 -1，调用方回到等待式 accept
+     */
+    int next()
+    {
+        while (m_remaining > 0) {
+            const int fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0) {
+                --m_remaining;
+                return fd;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ECONNABORTED) {
+                --m_remaining;
+                continue;
+            }
+            // EAGAIN 表示队列已空；EMFILE 等错误交给等待式 accept 报告
+            m_remaining = 0;
+        }
+        return -1;
+    }
+
+private:
+    int m_listen_fd;
+    size_t m_limit;
+    size_t m_remaining = 0;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_SOCKET_ADDR_H
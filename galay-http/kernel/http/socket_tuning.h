@@ -0,0 +1,122 @@
+/**
+ * @file socket_tuning.h
+ * @brief 监听 socket 与已 accept 连接的内核参数调优
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details HttpServer、HttpsServer、H2cServer、H2Server 共用同一组选项：
+ * - 监听 socket：TCP_DEFER_ACCEPT、TCP_FASTOPEN、SO_RCVBUF / SO_SNDBUF、SO_BUSY_POLL / SO_PREFER_BUSY_POLL，
+ *   创建 listener 时设置一次，缓冲大小与忙轮询由 accept 出的连接继承
+ * - 已 accept 的连接：TCP_NOTSENT_LOWAT、TCP_QUICKACK，每个连接 accept 后设置
+ * 所有选项默认不设置（沿用内核默认值）；设置失败只返回失败的选项名，由调用方记录告警，不影响启动。
+ * Unix domain socket 只应用缓冲大小。本文件只包含系统调用封装，不依赖运行时。
+ */
+
+#ifndef GALAY_HTTP_SOCKET_TUNING_H
+#define GALAY_HTTP_SOCKET_TUNING_H
+
+#include <string>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef TCP_NOTSENT_LOWAT
+#define TCP_NOTSENT_LOWAT 25
+#endif
+
+namespace galay::http
+{
+
+/**
+ * @brief socket 调优选项，0 / false 表示不设置
+ */
+struct HttpSocketTuning
+{
+    int defer_accept_seconds = 0;   ///< TCP_DEFER_ACCEPT：连接上有数据（或超时）后才唤醒 accept
+    int fastopen_queue = 0;         ///< TCP_FASTOPEN：待完成 TFO 请求的队列长度
+    int busy_poll_usecs = 0;        ///< SO_BUSY_POLL：阻塞读时忙轮询网卡队列的微秒数
+    bool prefer_busy_poll = false;  ///< SO_PREFER_BUSY_POLL：忙轮询期间抑制软中断处理
+    int recv_buffer = 0;            ///< SO_RCVBUF（字节，内核按两倍记账）
+    int send_buffer = 0;            ///< SO_SNDBUF（字节，内核按两倍记账）
+    int notsent_lowat = 0;          ///< TCP_NOTSENT_LOWAT：发送队列未发送数据超过该值时不报告可写
+    bool quickack = false;          ///< TCP_QUICKACK：accept 后立即确认，不等待延迟 ACK
+
+    /**
+     * @brief 是否有需要在每个已 accept 连接上设置的选项
+     */
+    bool hasAcceptedOptions() const { return notsent_lowat > 0 || quickack; }
+};
+
+namespace detail
+{
+
+inline void setIntOption(int fd, int level, int name, int value, const char* label, std::string& failed)
+{
+    if (::setsockopt(fd, level, name, &value, sizeof(value)) != 0) {
+        if (!failed.empty()) {
+            failed += ',';
+        }
+        failed += label;
+    }
+}
+
+/**
+ * @brief 设置监听 socket 的调优选项
+ * @param is_tcp 为 false（Unix domain socket）时只设置缓冲大小
+ * @return 设置失败的选项名（逗号分隔），全部成功为空
+ * @note 缓冲大小须在 listener 收到连接之前设置，accept 出的连接按此时的大小继承并协商窗口扩大因子
+ */
+inline std::string applyListenerTuning(int fd, const HttpSocketTuning& tuning, bool is_tcp)
+{
+    std::string failed;
+    if (tuning.recv_buffer > 0) {
+        setIntOption(fd, SOL_SOCKET, SO_RCVBUF, tuning.recv_buffer, "SO_RCVBUF", failed);
+    }
+    if (tuning.send_buffer > 0) {
+        setIntOption(fd, SOL_SOCKET, SO_SNDBUF, tuning.send_buffer, "SO_SNDBUF", failed);
+    }
+    if (!is_tcp) {
+        return failed;
+    }
+    if (tuning.defer_accept_seconds > 0) {
+        setIntOption(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, tuning.defer_accept_seconds, "TCP_DEFER_ACCEPT", failed);
+    }
+    if (tuning.fastopen_queue > 0) {
+        setIntOption(fd, IPPROTO_TCP, TCP_FASTOPEN, tuning.fastopen_queue, "TCP_FASTOPEN", failed);
+    }
+    if (tuning.busy_poll_usecs > 0) {
+        setIntOption(fd, SOL_SOCKET, SO_BUSY_POLL, tuning.busy_poll_usecs, "SO_BUSY_POLL", failed);
+    }
+    if (tuning.prefer_busy_poll) {
+        setIntOption(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, 1, "SO_PREFER_BUSY_POLL", failed);
+    }
+    return failed;
+}
+
+/**
+ * @brief 设置已 accept 连接的调优选项（仅 TCP）
+ * @return 设置失败的选项名（逗号分隔），全部成功为空
+ */
+inline std::string applyAcceptedTuning(int fd, const HttpSocketTuning& tuning)
+{
+    std::string failed;
+    if (tuning.notsent_lowat > 0) {
+        setIntOption(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, tuning.notsent_lowat, "TCP_NOTSENT_LOWAT", failed);
+    }
+    if (tuning.quickack) {
+        setIntOption(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK", failed);
+    }
+    return failed;
+}
+
+} // namespace detail
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_SOCKET_TUNING_H
@@ -0,0 +1,219 @@
+/**
+ * @file splice_pipe.h
+ * @brief splice(2) 零拷贝转发所需的管道池与非阻塞搬运
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details Linux 下 socket → pipe → socket 的 splice 搬运只在内核中移动页引用，
+ * 避免用户态缓冲区的两次拷贝。管道按线程（即 IO 调度器）池化复用，
+ * 热路径上无需反复 pipe2/close。非 Linux 平台 `isSupported()` 返回 false，
+ * 调用方应回退到缓冲转发。
+ */
+
+#ifndef GALAY_HTTP_SPLICE_PIPE_H
+#define GALAY_HTTP_SPLICE_PIPE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+namespace galay::http
+{
+
+/**
+ * @brief 一对 splice 用管道
+ */
+struct SplicePipe
+{
+    int read_fd = -1;       ///< 管道读端
+    int write_fd = -1;      ///< 管道写端
+    size_t capacity = 0;    ///< 管道容量（字节）
+    size_t pending = 0;     ///< 管道中尚未转出的字节数
+
+    bool valid() const { return read_fd >= 0 && write_fd >= 0; }
+};
+
+/**
+ * @brief 一次非阻塞搬运的结果
+ */
+struct SplicePumpResult
+{
+    size_t bytes_in = 0;        ///< 从输入 fd 搬入管道的字节数
+    size_t bytes_out = 0;       ///< 从管道搬到输出 fd 的字节数
+    bool input_eof = false;     ///< 输入端已到 EOF
+    bool input_drained = false; ///< 输入端暂无数据（EAGAIN）
+    bool output_blocked = false;///< 输出端发送缓冲区已满（EAGAIN），管道中仍有数据
+    int error = 0;              ///< 非 EAGAIN 错误的 errno，0 表示无错误
+};
+
+/**
+ * @brief 线程局部的 splice 管道池
+ * @details
+ * - `acquire()` 优先复用空闲管道，否则新建并尝试将容量调整为 kPipeSize
+ * - `release()` 只回收已排空的管道；仍有残留数据的管道直接关闭
+ * - 空闲管道数超过 kMaxIdle 时直接关闭，避免 fd 堆积
+ */
+class SplicePipePool
+{
+public:
+    static constexpr size_t kPipeSize = 256 * 1024; ///< 期望的管道容量
+    static constexpr size_t kMaxIdle = 16;          ///< 每线程最多缓存的空闲管道数
+
+    /**
+     * @brief 当前平台是否支持 splice
+     */
+    static constexpr bool isSupported()
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 获取当前线程的管道池
+     */
+    static SplicePipePool& local()
+    {
+        thread_local SplicePipePool pool;
+        return pool;
+    }
+
+    ~SplicePipePool()
+    {
+        for (auto& pipe : m_idle) {
+            closePipe(pipe);
+        }
+    }
+
+    /**
+     * @brief 获取一个空管道
+     * @return 平台不支持或创建失败时返回 std::nullopt
+     */
+    std::optional<SplicePipe> acquire()
+    {
+        if (!m_idle.empty()) {
+            SplicePipe pipe = m_idle.back();
+            m_idle.pop_back();
+            return pipe;
+        }
+#ifdef __linux__
+        int fds[2];
+        if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+            return std::nullopt;
+        }
+        SplicePipe pipe;
+        pipe.read_fd = fds[0];
+        pipe.write_fd = fds[1];
+        // 调整容量失败不致命，按内核实际容量使用
+        ::fcntl(pipe.write_fd, F_SETPIPE_SZ, static_cast<int>(kPipeSize));
+        const int size = ::fcntl(pipe.write_fd, F_GETPIPE_SZ);
+        pipe.capacity = size > 0 ? static_cast<size_t>(size) : 64 * 1024;
+        ++m_created;
+        return pipe;
+#else
+        return std::nullopt;
+#endif
+    }
+
+    /**
+     * @brief 归还管道
+     */
+    void release(SplicePipe pipe)
+    {
+        if (!pipe.valid()) {
+            return;
+        }
+        if (pipe.pending != 0 || m_idle.size() >= kMaxIdle) {
+            closePipe(pipe);
+            return;
+        }
+        m_idle.push_back(pipe);
+    }
+
+    size_t idleCount() const { return m_idle.size(); }  ///< 空闲管道数
+    size_t createdCount() const { return m_created; }   ///< 累计新建管道数
+
+    /**
+     * @brief 尽可能把 in_fd 上已就绪的数据经管道搬到 out_fd，不阻塞
+     * @param in_fd 输入 socket（非阻塞）
+     * @param out_fd 输出 socket（非阻塞）
+     * @param pipe 中转管道，pending 会随搬运更新
+     * @return 本轮搬运结果；返回时要么输入暂无数据且管道已排空，要么输出阻塞、EOF 或出错
+     */
+    static SplicePumpResult pump(int in_fd, int out_fd, SplicePipe& pipe)
+    {
+        SplicePumpResult result;
+#ifdef __linux__
+        constexpr unsigned kFlags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+        while (true) {
+            if (!result.input_eof && !result.input_drained && pipe.pending < pipe.capacity) {
+                const ssize_t n = ::splice(in_fd, nullptr, pipe.write_fd, nullptr,
+                                           pipe.capacity - pipe.pending, kFlags);
+                if (n > 0) {
+                    pipe.pending += static_cast<size_t>(n);
+                    result.bytes_in += static_cast<size_t>(n);
+                } else if (n == 0) {
+                    result.input_eof = true;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    result.input_drained = true;
+                } else if (errno != EINTR) {
+                    result.error = errno;
+                    return result;
+                }
+            }
+
+            if (pipe.pending > 0) {
+                const ssize_t m = ::splice(pipe.read_fd, nullptr, out_fd, nullptr, pipe.pending, kFlags);
+                if (m > 0) {
+                    pipe.pending -= static_cast<size_t>(m);
+                    result.bytes_out += static_cast<size_t>(m);
+                } else if (m == 0 || errno == EAGAIN || errno == EWOULDBLOCK) {
+                    result.output_blocked = true;
+                    return result;
+                } else if (errno != EINTR) {
+                    result.error = errno;
+                    return result;
+                }
+            }
+
+            if ((result.input_eof || result.input_drained) && pipe.pending == 0) {
+                return result;
+            }
+        }
+#else
+        (void)in_fd;
+        (void)out_fd;
+        (void)pipe;
+        result.error = ENOSYS;
+        return result;
+#endif
+    }
+
+private:
+    static void closePipe(SplicePipe& pipe)
+    {
+        if (pipe.read_fd >= 0) {
+            ::close(pipe.read_fd);
+        }
+        if (pipe.write_fd >= 0) {
+            ::close(pipe.write_fd);
+        }
+        pipe.read_fd = -1;
+        pipe.write_fd = -1;
+    }
+
+    std::vector<SplicePipe> m_idle;
+    size_t m_created = 0;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_SPLICE_PIPE_H
@@ -1,6 +1,7 @@
 #ifndef GALAY_STATIC_FILE_CONFIG_H
 #define GALAY_STATIC_FILE_CONFIG_H
 
+#include <chrono>
 #include <cstddef>
 
 namespace galay::http
@@ -60,7 +61,10 @@ public:
         , m_sendfile_chunk_size(10 * 1024 * 1024) // 10MB
         , m_enable_cache(false)
         , m_enable_etag(true)
+        , m_enable_content_etag(false)
         , m_max_cache_size(100 * 1024 * 1024)     // 100MB
+        , m_meta_cache_ttl(0)                      // 关闭
+        , m_meta_cache_max_entries(4096)
     {
     }
 
@@ -178,6 +182,26 @@ public:
         return m_enable_etag;
     }
 
+    /**
+     * @brief 设置是否使用内容哈希 ETag
+     * @param enable 是否启用
+     * @details 启用后 ETag 由文件内容的 XXH64 摘要生成，多副本、重新部署后保持不变。
+     *          每个文件版本只在计算调度器上哈希一次；结果就绪前沿用 inode ETag，
+     *          服务器未配置计算调度器时不生效
+     * @note 需同时启用 ETag
+     */
+    void setEnableContentETag(bool enable) {
+        m_enable_content_etag = enable;
+    }
+
+    /**
+     * @brief 获取是否使用内容哈希 ETag
+     * @return 是否启用
+     */
+    bool isEnableContentETag() const {
+        return m_enable_etag && m_enable_content_etag;
+    }
+
     /**
      * @brief 设置最大缓存大小
      * @param size 最大缓存大小（字节）
@@ -194,6 +218,49 @@ public:
         return m_max_cache_size;
     }
 
+    /**
+     * @brief 设置元数据缓存有效期
+     * @param ttl 有效期，0 表示关闭元数据缓存
+     * @details 启用后，条件请求（If-None-Match / If-Modified-Since）在有效期内
+     *          直接命中线程局部缓存并发送预构造的 304，不再 stat 文件；
+     *          文件在有效期内被修改时，最多延迟 ttl 才能被感知
+     * @note 仅对 mount() 有效
+     */
+    void setMetaCacheTtl(std::chrono::milliseconds ttl) {
+        m_meta_cache_ttl = ttl;
+    }
+
+    /**
+     * @brief 获取元数据缓存有效期
+     * @return 有效期，0 表示关闭
+     */
+    std::chrono::milliseconds getMetaCacheTtl() const {
+        return m_meta_cache_ttl;
+    }
+
+    /**
+     * @brief 是否启用元数据缓存
+     */
+    bool isEnableMetaCache() const {
+        return m_meta_cache_ttl.count() > 0;
+    }
+
+    /**
+     * @brief 设置每个挂载点、每个 IO 线程的元数据缓存条目上限
+     * @param max_entries 条目上限，0 表示不限制
+     */
+    void setMetaCacheMaxEntries(size_t max_entries) {
+        m_meta_cache_max_entries = max_entries;
+    }
+
+    /**
+     * @brief 获取元数据缓存条目上限
+     * @return 条目上限
+     */
+    size_t getMetaCacheMaxEntries() const {
+        return m_meta_cache_max_entries;
+    }
+
     /**
      * @brief 根据文件大小决定传输模式（用于 AUTO 模式）
      * @param file_size 文件大小（字节）
@@ -222,7 +289,10 @@ private:
     size_t m_sendfile_chunk_size;        ///< SendFile 块大小（字节）
     bool m_enable_cache;                 ///< 是否启用缓存
     bool m_enable_etag;                  ///< 是否启用 ETag 条件请求
+    bool m_enable_content_etag;          ///< 是否使用内容哈希 ETag
     size_t m_max_cache_size;             ///< 最大缓存大小（字节）
+    std::chrono::milliseconds m_meta_cache_ttl;  ///< 元数据缓存有效期（0 表示关闭）
+    size_t m_meta_cache_max_entries;     ///< 元数据缓存条目上限
 };
 
 } // namespace galay::http
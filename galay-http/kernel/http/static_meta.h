@@ -0,0 +1,283 @@
+/**
+ * @file static_meta.h
+ * @brief 静态文件元数据缓存（条件请求 304 快路径）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 缓存静态文件的 size / mtime / inode / ETag / Last-Modified，
+ * 并预先序列化好 304 Not Modified 响应。命中且未过期时，条件请求
+ * 只需一次哈希查找和一次发送，不触发任何文件系统系统调用。
+ * 缓存按线程（即 IO 调度器）独立持有，热路径上无锁、无跨核竞争。
+ */
+
+#ifndef GALAY_HTTP_STATIC_META_H
+#define GALAY_HTTP_STATIC_META_H
+
+#include "http_date.h"
+#include "http_etag.h"
+#include "galay-http/protoc/http/http_header.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <sys/stat.h>
+
+namespace galay::http
+{
+
+/**
+ * @brief 单个静态文件的元数据快照
+ * @details 创建后只读；以 shared_ptr<const> 形式在缓存与正在发送的协程之间共享，
+ *          因此即使缓存在发送期间被淘汰，预构造的 304 字节也保持有效。
+ */
+struct StaticFileMeta
+{
+    std::string file_path;              ///< 规范化后的文件路径
+    size_t file_size = 0;               ///< 文件大小（字节）
+    std::time_t last_modified = 0;      ///< 最后修改时间
+    uint64_t inode = 0;                 ///< inode 号
+    std::string etag;                   ///< ETag（未启用 ETag 时为空）
+    bool etag_pending = false;          ///< 内容 ETag 仍在后台计算，etag 暂为 inode ETag
+    std::string last_modified_str;      ///< IMF-fixdate 格式的 Last-Modified
+    std::string mime_type;              ///< MIME 类型
+    std::string not_modified_response;  ///< 预序列化的 304 响应
+    std::chrono::steady_clock::time_point validated_at; ///< 最近一次 stat 校验时间
+
+    /**
+     * @brief 由已知属性构建元数据
+     * @param path 规范化后的文件路径
+     * @param size 文件大小
+     * @param mtime 最后修改时间（0 时回退为当前时间）
+     * @param inode inode 号
+     * @param etag ETag（为空表示不启用 ETag）
+     * @param mime MIME 类型
+     * @param etag_pending 内容 ETag 是否仍在计算
+     * @return 只读元数据快照
+     */
+    static std::shared_ptr<const StaticFileMeta> create(std::string path,
+                                                        size_t size,
+                                                        std::time_t mtime,
+                                                        uint64_t inode,
+                                                        std::string etag,
+                                                        std::string mime,
+                                                        bool etag_pending = false)
+    {
+        auto meta = std::make_shared<StaticFileMeta>();
+        meta->file_path = std::move(path);
+        meta->file_size = size;
+        meta->last_modified = mtime != 0 ? mtime : std::time(nullptr);
+        meta->inode = inode;
+        meta->etag = std::move(etag);
+        meta->etag_pending = etag_pending;
+        meta->last_modified_str = HttpDate::format(meta->last_modified);
+        meta->mime_type = std::move(mime);
+        meta->not_modified_response = buildNotModified(meta->etag, meta->last_modified_str);
+        meta->validated_at = std::chrono::steady_clock::now();
+        return meta;
+    }
+
+    /**
+     * @brief 由一次 stat 结果构建元数据
+     * @param enable_etag 是否生成 ETag
+     */
+    static std::shared_ptr<const StaticFileMeta> fromStat(std::string path,
+                                                          const struct stat& st,
+                                                          std::string mime,
+                                                          bool enable_etag)
+    {
+        const size_t size = static_cast<size_t>(st.st_size);
+        const std::time_t mtime = st.st_mtime != 0 ? st.st_mtime : std::time(nullptr);
+        const uint64_t inode = static_cast<uint64_t>(st.st_ino);
+        std::string etag = enable_etag ? ETagGenerator::generateStrong(inode, size, mtime) : std::string();
+        return create(std::move(path), size, mtime, inode, std::move(etag), std::move(mime));
+    }
+
+    /**
+     * @brief 判断条件请求是否可以直接回 304
+     * @param if_none_match If-None-Match 头（可为空）
+     * @param if_modified_since If-Modified-Since 头（可为空）
+     * @return 满足 304 条件返回 true
+     * @details 遵循 RFC 9110 §13.2.2：存在 If-None-Match 时忽略 If-Modified-Since
+     */
+    bool notModified(std::string_view if_none_match, std::string_view if_modified_since) const
+    {
+        if (!etag.empty() && !if_none_match.empty()) {
+            if (if_none_match == etag) {
+                return true;
+            }
+            return ETagGenerator::matchIfNoneMatch(etag, std::string(if_none_match));
+        }
+        if (!if_modified_since.empty()) {
+            std::time_t since = 0;
+            return HttpDate::parse(if_modified_since, since) && last_modified <= since;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 序列化 304 Not Modified 响应
+     */
+    static std::string buildNotModified(const std::string& etag, const std::string& last_modified_str)
+    {
+        HttpResponseHeader header;
+        header.version() = HttpVersion::HttpVersion_1_1;
+        header.code() = HttpStatusCode::NotModified_304;
+        if (!etag.empty()) {
+            header.headerPairs().addHeaderPair("ETag", etag);
+        }
+        header.headerPairs().addHeaderPair("Last-Modified", last_modified_str);
+        header.headerPairs().addHeaderPair("Content-Length", "0");
+        return header.toString();
+    }
+};
+
+/**
+ * @brief 线程局部的静态文件元数据缓存
+ * @details
+ * - 每个 IO 调度器线程通过 `local()` 拿到自己的实例，无需加锁
+ * - 以 (挂载点 ID, 相对路径) 为键；相对路径查找支持 string_view，不产生临时分配
+ * - TTL 过期后条目仍保留，由调用方重新 stat 校验后覆盖
+ */
+class StaticFileMetaCache
+{
+public:
+    using MetaPtr = std::shared_ptr<const StaticFileMeta>;
+
+    /**
+     * @brief 缓存统计
+     */
+    struct Stats {
+        uint64_t hits = 0;        ///< 命中且未过期
+        uint64_t misses = 0;      ///< 未命中或已过期
+        uint64_t evictions = 0;   ///< 因容量上限淘汰的条目数
+    };
+
+    /**
+     * @brief 获取当前线程的缓存实例
+     */
+    static StaticFileMetaCache& local()
+    {
+        thread_local StaticFileMetaCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 为一个挂载点分配全局唯一 ID
+     */
+    static uint64_t nextMountId()
+    {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 查找未过期的元数据
+     * @param mount_id 挂载点 ID
+     * @param relative_path 相对挂载目录的路径
+     * @param ttl 有效期
+     * @param now 当前时间
+     * @return 命中返回元数据，否则返回 nullptr
+     */
+    MetaPtr lookup(uint64_t mount_id,
+                   std::string_view relative_path,
+                   std::chrono::milliseconds ttl,
+                   std::chrono::steady_clock::time_point now)
+    {
+        auto mount_it = m_mounts.find(mount_id);
+        if (mount_it == m_mounts.end()) {
+            ++m_stats.misses;
+            return nullptr;
+        }
+        auto it = mount_it->second.find(relative_path);
+        if (it == mount_it->second.end() || now - it->second->validated_at > ttl) {
+            ++m_stats.misses;
+            return nullptr;
+        }
+        ++m_stats.hits;
+        return it->second;
+    }
+
+    /**
+     * @brief 查找元数据（忽略 TTL）
+     */
+    MetaPtr peek(uint64_t mount_id, std::string_view relative_path) const
+    {
+        auto mount_it = m_mounts.find(mount_id);
+        if (mount_it == m_mounts.end()) {
+            return nullptr;
+        }
+        auto it = mount_it->second.find(relative_path);
+        return it == mount_it->second.end() ? nullptr : it->second;
+    }
+
+    /**
+     * @brief 写入或覆盖元数据
+     * @param max_entries 单个挂载点的条目上限，达到上限时淘汰任意一条
+     */
+    void store(uint64_t mount_id, std::string_view relative_path, MetaPtr meta, size_t max_entries)
+    {
+        auto& entries = m_mounts[mount_id];
+        auto it = entries.find(relative_path);
+        if (it != entries.end()) {
+            it->second = std::move(meta);
+            return;
+        }
+        if (max_entries > 0 && entries.size() >= max_entries) {
+            entries.erase(entries.begin());
+            ++m_stats.evictions;
+        }
+        entries.emplace(std::string(relative_path), std::move(meta));
+    }
+
+    /**
+     * @brief 删除指定条目
+     */
+    void erase(uint64_t mount_id, std::string_view relative_path)
+    {
+        auto mount_it = m_mounts.find(mount_id);
+        if (mount_it == m_mounts.end()) {
+            return;
+        }
+        auto it = mount_it->second.find(relative_path);
+        if (it != mount_it->second.end()) {
+            mount_it->second.erase(it);
+        }
+    }
+
+    void clear() { m_mounts.clear(); } ///< 清空所有条目
+
+    /**
+     * @brief 当前缓存的条目总数
+     */
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto& [id, entries] : m_mounts) {
+            total += entries.size();
+        }
+        return total;
+    }
+
+    const Stats& stats() const { return m_stats; } ///< 获取统计信息
+
+private:
+    struct TransparentHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    using EntryMap = std::unordered_map<std::string, MetaPtr, TransparentHash, std::equal_to<>>;
+
+    std::unordered_map<uint64_t, EntryMap> m_mounts;
+    Stats m_stats;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_STATIC_META_H
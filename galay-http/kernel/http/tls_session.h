@@ -0,0 +1,536 @@
+/**
+ * @file tls_session.h
+ * @brief TLS 会话恢复：轮换密钥的会话票据与按分片加锁的服务端会话缓存（HttpsServer、H2Server 共用）
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details
+ * - 会话票据（无状态恢复）：票据密钥按 `ticket_key_rotation` 划分纪元，由主密钥对纪元号做 HMAC-SHA256 派生，
+ *   当前纪元的密钥加密新票据，覆盖 `session_lifetime` 的历史纪元密钥仍可解密（解密后要求续发新票据）。
+ *   派生只依赖主密钥与时钟，预 fork 的工作进程（主密钥在 fork 前生成）或配置了相同 `ticket_secret` 的多台机器
+ *   无需同步即可互相恢复会话
+ * - 服务端会话缓存（有状态恢复，TLS 1.2 会话 ID 与关闭票据时的 TLS 1.3 有状态票据）：
+ *   替换 OpenSSL 单锁的内部缓存，按调度器数分片、各分片独立加锁与 LRU 淘汰；按会话 ID 哈希选分片，
+ *   客户端重连落到其他调度器也能命中
+ *   （OpenSSL 会把未发送 close_notify 就释放的连接的会话从缓存中移除；票据恢复不受影响）
+ * - 统计：握手完成时按 SSL_session_reused 计入恢复 / 完整握手
+ * 本文件只依赖 OpenSSL，不依赖运行时。
+ */
+
+#ifndef GALAY_HTTP_TLS_SESSION_H
+#define GALAY_HTTP_TLS_SESSION_H
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace galay::http
+{
+
+/**
+ * @brief TLS 会话恢复配置
+ */
+struct HttpTlsSessionConfig
+{
+    bool tickets = true;                                ///< 会话票据（无状态恢复）
+    std::chrono::seconds ticket_key_rotation{3600};     ///< 票据密钥轮换周期
+    std::chrono::seconds session_lifetime{7200};        ///< 票据与缓存会话的有效期
+    std::string ticket_secret;                          ///< 派生票据密钥的主密钥（至少 16 字节；为空时启动时随机生成）
+    bool session_cache = false;                         ///< 服务端会话缓存（有状态恢复）
+    size_t session_cache_size = 20480;                  ///< 缓存会话总数上限，按分片均分
+};
+
+/**
+ * @brief TLS 会话恢复统计
+ */
+struct HttpTlsSessionStats
+{
+    uint64_t resumed = 0;               ///< 恢复会话的握手数
+    uint64_t full_handshakes = 0;       ///< 完整握手数
+    uint64_t ticket_unknown_key = 0;    ///< 票据密钥已过期或不属于本服务的票据数
+    uint64_t ticket_renewed = 0;        ///< 以历史纪元密钥解密、续发了新票据的次数
+    uint64_t key_rotations = 0;         ///< 票据密钥轮换次数
+    uint64_t cache_hits = 0;            ///< 服务端缓存命中数
+    uint64_t cache_misses = 0;          ///< 服务端缓存未命中数
+    uint64_t cache_evictions = 0;       ///< 因容量淘汰的缓存会话数
+    uint64_t cache_entries = 0;         ///< 当前缓存的会话数
+};
+
+/**
+ * @brief 挂在 SSL_CTX 上的会话恢复管理器
+ * @details 须比 SSL_CTX 上的握手活得久（通常作为服务器成员，声明在 SSL 上下文之前）；
+ *          回调在各调度器线程上并发执行
+ */
+class HttpTlsSessionManager
+{
+public:
+    static constexpr size_t kTicketKeyNameLength = 16;
+    static constexpr size_t kMinSecretLength = 16;
+
+    HttpTlsSessionManager() = default;
+    ~HttpTlsSessionManager() { clearCache(); }
+
+    HttpTlsSessionManager(const HttpTlsSessionManager&) = delete;
+    HttpTlsSessionManager& operator=(const HttpTlsSessionManager&) = delete;
+
+    /**
+     * @brief 在 SSL_CTX 上安装票据、缓存与统计回调
+     * @param shards 缓存分片数（通常为 IO 调度器数）
+     * @return 主密钥过短或 OpenSSL 调用失败时返回 false 并写入 error
+     */
+    bool install(SSL_CTX* ctx, const HttpTlsSessionConfig& config, size_t shards, std::string& error)
+    {
+        if (ctx == nullptr) {
+            error = "invalid SSL_CTX";
+            return false;
+        }
+        m_config = config;
+        m_rotation_seconds = std::max<int64_t>(config.ticket_key_rotation.count(), 1);
+        m_history_epochs = (std::max<int64_t>(config.session_lifetime.count(), 1) + m_rotation_seconds - 1) /
+                           m_rotation_seconds;
+        clearCache();
+        {
+            std::lock_guard<std::mutex> lock(m_key_mutex);
+            m_keys.clear();
+        }
+
+        if (SSL_CTX_set_ex_data(ctx, ctxIndex(), this) != 1) {
+            error = "SSL_CTX_set_ex_data failed";
+            return false;
+        }
+        static constexpr std::string_view kSessionIdContext = "galay-http";
+        SSL_CTX_set_session_id_context(ctx, reinterpret_cast<const unsigned char*>(kSessionIdContext.data()),
+                                       static_cast<unsigned int>(kSessionIdContext.size()));
+        SSL_CTX_set_timeout(ctx, static_cast<long>(std::max<int64_t>(config.session_lifetime.count(), 1)));
+        SSL_CTX_set_info_callback(ctx, &HttpTlsSessionManager::onInfo);
+
+        if (config.tickets) {
+            if (!initSecret(config.ticket_secret, error)) {
+                return false;
+            }
+            SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+            SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, &HttpTlsSessionManager::onTicketKey);
+#else
+            SSL_CTX_set_tlsext_ticket_key_cb(ctx, &HttpTlsSessionManager::onTicketKey);
+#endif
+        } else {
+            SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        }
+
+        if (config.session_cache) {
+            const size_t count = std::max<size_t>(shards, 1);
+            m_shards.clear();
+            for (size_t i = 0; i < count; ++i) {
+                m_shards.push_back(std::make_unique<Shard>());
+            }
+            m_shard_capacity = std::max<size_t>(config.session_cache_size / count, 1);
+            SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+            SSL_CTX_sess_set_new_cb(ctx, &HttpTlsSessionManager::onNewSession);
+            SSL_CTX_sess_set_get_cb(ctx, &HttpTlsSessionManager::onGetSession);
+            SSL_CTX_sess_set_remove_cb(ctx, &HttpTlsSessionManager::onRemoveSession);
+        } else {
+            SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+        }
+        return true;
+    }
+
+    HttpTlsSessionStats snapshot() const
+    {
+        HttpTlsSessionStats stats;
+        stats.resumed = m_resumed.load(std::memory_order_relaxed);
+        stats.full_handshakes = m_full.load(std::memory_order_relaxed);
+        stats.ticket_unknown_key = m_ticket_unknown.load(std::memory_order_relaxed);
+        stats.ticket_renewed = m_ticket_renewed.load(std::memory_order_relaxed);
+        stats.key_rotations = m_rotations.load(std::memory_order_relaxed);
+        stats.cache_hits = m_cache_hits.load(std::memory_order_relaxed);
+        stats.cache_misses = m_cache_misses.load(std::memory_order_relaxed);
+        stats.cache_evictions = m_cache_evictions.load(std::memory_order_relaxed);
+        for (const auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            stats.cache_entries += shard->index.size();
+        }
+        return stats;
+    }
+
+private:
+    /**
+     * @brief 一个纪元的票据密钥
+     */
+    struct TicketKeys
+    {
+        int64_t epoch = 0;
+        std::array<unsigned char, kTicketKeyNameLength> name{};
+        std::array<unsigned char, 32> aes{};        ///< AES-256-CBC
+        std::array<unsigned char, 32> hmac{};       ///< HMAC-SHA256
+    };
+
+    struct CacheEntry
+    {
+        std::string id;
+        SSL_SESSION* session = nullptr;             ///< 缓存持有的一份引用
+    };
+
+    /**
+     * @brief 缓存分片：LRU 链表（表头最新）与按会话 ID 的索引
+     */
+    struct Shard
+    {
+        std::mutex mutex;
+        std::list<CacheEntry> lru;
+        std::unordered_map<std::string, std::list<CacheEntry>::iterator> index;
+    };
+
+    static int ctxIndex()
+    {
+        static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
+    /**
+     * @brief SSL 上的标记：该连接的握手已计入统计
+     */
+    static int countedIndex()
+    {
+        static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
+    static HttpTlsSessionManager* fromCtx(SSL_CTX* ctx)
+    {
+        return ctx != nullptr ? static_cast<HttpTlsSessionManager*>(SSL_CTX_get_ex_data(ctx, ctxIndex())) : nullptr;
+    }
+
+    static HttpTlsSessionManager* fromSsl(SSL* ssl) { return fromCtx(SSL_get_SSL_CTX(ssl)); }
+
+    bool initSecret(const std::string& secret, std::string& error)
+    {
+        if (!secret.empty()) {
+            if (secret.size() < kMinSecretLength) {
+                error = "ticket_secret must be at least 16 bytes";
+                return false;
+            }
+            m_secret.assign(secret.begin(), secret.end());
+            return true;
+        }
+        m_secret.assign(32, 0);
+        if (RAND_bytes(m_secret.data(), static_cast<int>(m_secret.size())) != 1) {
+            error = "RAND_bytes failed";
+            return false;
+        }
+        return true;
+    }
+
+    void derive(std::string_view label, int64_t epoch, unsigned char* out, size_t length) const
+    {
+        unsigned char input[32];
+        const size_t label_length = std::min(label.size(), sizeof(input) - 8);
+        std::memcpy(input, label.data(), label_length);
+        for (int i = 0; i < 8; ++i) {
+            input[label_length + i] = static_cast<unsigned char>(static_cast<uint64_t>(epoch) >> (56 - 8 * i));
+        }
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digest_length = 0;
+        HMAC(EVP_sha256(), m_secret.data(), static_cast<int>(m_secret.size()),
+             input, label_length + 8, digest, &digest_length);
+        std::memcpy(out, digest, std::min<size_t>(length, digest_length));
+    }
+
+    TicketKeys deriveKeys(int64_t epoch) const
+    {
+        TicketKeys keys;
+        keys.epoch = epoch;
+        derive("galay ticket name", epoch, keys.name.data(), keys.name.size());
+        derive("galay ticket aes", epoch, keys.aes.data(), keys.aes.size());
+        derive("galay ticket hmac", epoch, keys.hmac.data(), keys.hmac.size());
+        return keys;
+    }
+
+    /**
+     * @brief 按当前时间刷新密钥环（当前纪元在前，其后为仍可解密的历史纪元）
+     */
+    void refreshKeys(int64_t now_seconds)
+    {
+        const int64_t epoch = now_seconds / m_rotation_seconds;
+        if (!m_keys.empty() && m_keys.front().epoch == epoch) {
+            return;
+        }
+        if (!m_keys.empty()) {
+            m_rotations.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::vector<TicketKeys> keys;
+        keys.reserve(static_cast<size_t>(m_history_epochs) + 1);
+        for (int64_t e = epoch; e >= epoch - m_history_epochs; --e) {
+            auto it = std::find_if(m_keys.begin(), m_keys.end(), [e](const TicketKeys& k) { return k.epoch == e; });
+            keys.push_back(it != m_keys.end() ? *it : deriveKeys(e));
+        }
+        m_keys = std::move(keys);
+    }
+
+    TicketKeys currentKeys(int64_t now_seconds)
+    {
+        std::lock_guard<std::mutex> lock(m_key_mutex);
+        refreshKeys(now_seconds);
+        return m_keys.front();
+    }
+
+    bool findKeys(const unsigned char* name, int64_t now_seconds, TicketKeys& keys, bool& current)
+    {
+        std::lock_guard<std::mutex> lock(m_key_mutex);
+        refreshKeys(now_seconds);
+        for (size_t i = 0; i < m_keys.size(); ++i) {
+            if (std::memcmp(m_keys[i].name.data(), name, kTicketKeyNameLength) == 0) {
+                keys = m_keys[i];
+                current = i == 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static int64_t wallSeconds()
+    {
+        return static_cast<int64_t>(std::time(nullptr));
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static bool initMac(EVP_MAC_CTX* mac, const TicketKeys& keys)
+    {
+        OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+            OSSL_PARAM_construct_end(),
+        };
+        return EVP_MAC_init(mac, keys.hmac.data(), keys.hmac.size(), params) == 1;
+    }
+
+    static int onTicketKey(SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                           EVP_CIPHER_CTX* cipher, EVP_MAC_CTX* mac, int enc)
+#else
+    static bool initMac(HMAC_CTX* mac, const TicketKeys& keys)
+    {
+        return HMAC_Init_ex(mac, keys.hmac.data(), static_cast<int>(keys.hmac.size()), EVP_sha256(), nullptr) == 1;
+    }
+
+    static int onTicketKey(SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                           EVP_CIPHER_CTX* cipher, HMAC_CTX* mac, int enc)
+#endif
+    {
+        auto* self = fromSsl(ssl);
+        if (self == nullptr) {
+            return -1;
+        }
+        const int64_t now = wallSeconds();
+        if (enc != 0) {
+            const TicketKeys keys = self->currentKeys(now);
+            if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1) {
+                return -1;
+            }
+            std::memcpy(key_name, keys.name.data(), kTicketKeyNameLength);
+            if (EVP_EncryptInit_ex(cipher, EVP_aes_256_cbc(), nullptr, keys.aes.data(), iv) != 1 ||
+                !initMac(mac, keys)) {
+                return -1;
+            }
+            return 1;
+        }
+        TicketKeys keys;
+        bool current = false;
+        if (!self->findKeys(key_name, now, keys, current)) {
+            self->m_ticket_unknown.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        if (!initMac(mac, keys) ||
+            EVP_DecryptInit_ex(cipher, EVP_aes_256_cbc(), nullptr, keys.aes.data(), iv) != 1) {
+            return -1;
+        }
+        if (!current) {
+            self->m_ticket_renewed.fetch_add(1, std::memory_order_relaxed);
+            return 2;
+        }
+        return 1;
+    }
+
+    static void onInfo(const SSL* ssl, int where, int)
+    {
+        if ((where & SSL_CB_HANDSHAKE_DONE) == 0) {
+            return;
+        }
+        SSL* mutable_ssl = const_cast<SSL*>(ssl);
+        // TLS 1.3 发送 NewSessionTicket 后会再次报告 HANDSHAKE_DONE，每个连接只计一次
+        if (SSL_get_ex_data(mutable_ssl, countedIndex()) != nullptr) {
+            return;
+        }
+        SSL_set_ex_data(mutable_ssl, countedIndex(), mutable_ssl);
+        auto* self = fromSsl(mutable_ssl);
+        if (self == nullptr) {
+            return;
+        }
+        if (SSL_session_reused(mutable_ssl) == 1) {
+            self->m_resumed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            self->m_full.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    Shard& shardFor(const std::string& id)
+    {
+        return *m_shards[std::hash<std::string>{}(id) % m_shards.size()];
+    }
+
+    static std::string sessionKey(const unsigned char* id, unsigned int length)
+    {
+        return std::string(reinterpret_cast<const char*>(id), length);
+    }
+
+    static int onNewSession(SSL* ssl, SSL_SESSION* session)
+    {
+        auto* self = fromSsl(ssl);
+        if (self == nullptr || self->m_shards.empty()) {
+            return 0;
+        }
+        unsigned int length = 0;
+        const unsigned char* id = SSL_SESSION_get_id(session, &length);
+        std::string key = sessionKey(id, length);
+        Shard& shard = self->shardFor(key);
+        SSL_SESSION* evicted = nullptr;
+        SSL_SESSION* replaced = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (auto it = shard.index.find(key); it != shard.index.end()) {
+                replaced = it->second->session;
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+            }
+            shard.lru.push_front(CacheEntry{key, session});
+            shard.index.emplace(std::move(key), shard.lru.begin());
+            if (shard.lru.size() > self->m_shard_capacity) {
+                evicted = shard.lru.back().session;
+                shard.index.erase(shard.lru.back().id);
+                shard.lru.pop_back();
+            }
+        }
+        if (replaced != nullptr) {
+            SSL_SESSION_free(replaced);
+        }
+        if (evicted != nullptr) {
+            self->m_cache_evictions.fetch_add(1, std::memory_order_relaxed);
+            SSL_SESSION_free(evicted);
+        }
+        return 1;   // 保留 OpenSSL 传入的引用
+    }
+
+    static SSL_SESSION* onGetSession(SSL* ssl, const unsigned char* id, int length, int* copy)
+    {
+        *copy = 1;  // 缓存仍持有自己的引用，返回给 OpenSSL 的一份由其增加引用计数
+        auto* self = fromSsl(ssl);
+        if (self == nullptr || self->m_shards.empty() || length <= 0) {
+            return nullptr;
+        }
+        const std::string key = sessionKey(id, static_cast<unsigned int>(length));
+        Shard& shard = self->shardFor(key);
+        SSL_SESSION* expired = nullptr;
+        SSL_SESSION* found = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                SSL_SESSION* session = it->second->session;
+                if (SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) < wallSeconds()) {
+                    expired = session;
+                    shard.lru.erase(it->second);
+                    shard.index.erase(it);
+                } else {
+                    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                    found = session;
+                }
+            }
+        }
+        if (expired != nullptr) {
+            SSL_SESSION_free(expired);
+        }
+        if (found != nullptr) {
+            self->m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            self->m_cache_misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        return found;
+    }
+
+    static void onRemoveSession(SSL_CTX* ctx, SSL_SESSION* session)
+    {
+        auto* self = fromCtx(ctx);
+        if (self == nullptr || self->m_shards.empty()) {
+            return;
+        }
+        unsigned int length = 0;
+        const unsigned char* id = SSL_SESSION_get_id(session, &length);
+        const std::string key = sessionKey(id, length);
+        Shard& shard = self->shardFor(key);
+        SSL_SESSION* removed = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                removed = it->second->session;
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+            }
+        }
+        if (removed != nullptr) {
+            SSL_SESSION_free(removed);
+        }
+    }
+
+    void clearCache()
+    {
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto& entry : shard->lru) {
+                SSL_SESSION_free(entry.session);
+            }
+            shard->lru.clear();
+            shard->index.clear();
+        }
+        m_shards.clear();
+    }
+
+    HttpTlsSessionConfig m_config;
+    int64_t m_rotation_seconds = 3600;
+    int64_t m_history_epochs = 2;               ///< 当前纪元之外仍接受的历史纪元数
+    std::vector<unsigned char> m_secret;        ///< 票据主密钥
+    std::mutex m_key_mutex;
+    std::vector<TicketKeys> m_keys;             ///< 密钥环（受 m_key_mutex 保护）
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    size_t m_shard_capacity = 1;
+
+    std::atomic<uint64_t> m_resumed{0};
+    std::atomic<uint64_t> m_full{0};
+    std::atomic<uint64_t> m_ticket_unknown{0};
+    std::atomic<uint64_t> m_ticket_renewed{0};
+    std::atomic<uint64_t> m_rotations{0};
+    std::atomic<uint64_t> m_cache_hits{0};
+    std::atomic<uint64_t> m_cache_misses{0};
+    std::atomic<uint64_t> m_cache_evictions{0};
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_TLS_SESSION_H
@@ -0,0 +1,851 @@
+/**
+ * @file upstream.h
+ * @brief 反向代理上游组与负载均衡
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 一个上游组包含多个后端实例，按策略为每个请求选择一个实例：
+ * - RoundRobin：轮询
+ * - Weighted：平滑加权轮询（nginx 算法）
+ * - LeastOutstanding：最少在途请求
+ * - PeakEwma：两次随机选择（P2C）+ 峰值 EWMA 延迟
+ *
+ * 选择与记账只读写线程局部状态（每个 IO 调度器一份），
+ * 每隔合并周期才与进程级原子计数交换一次，热路径上没有跨核竞争。
+ *
+ * 可选的被动异常检测（outlier detection）根据真实请求结果摘除异常实例：
+ * 连续失败、窗口失败率、延迟显著高于其他实例三类信号触发摘除，
+ * 摘除时长按次数指数退避；到期后进入半开状态，只放行一个探测请求，
+ * 成功则恢复，失败则以更长时长再次摘除。摘除状态保存在进程级原子变量中，
+ * 所有调度器共享同一判定，选择时只做原子读，不涉及系统调用。
+ */
+
+#ifndef GALAY_HTTP_UPSTREAM_H
+#define GALAY_HTTP_UPSTREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "body_framer.h"
+#include "h2c_upstream.h"
+#include "hedge.h"
+#include "response_cache.h"
+#include "upstream_pool.h"
+
+namespace galay::http
+{
+
+/**
+ * @brief 上游实例
+ */
+struct UpstreamEndpoint
+{
+    std::string host;       ///< 主机：IPv4/IPv6 字面量，或 `unix:/path` 指向 Unix domain socket
+    uint16_t port = 0;      ///< 端口（Unix domain socket 忽略）
+    uint32_t weight = 1;    ///< 权重（仅 Weighted 策略使用，0 视为 1）
+};
+
+/**
+ * @brief 负载均衡策略
+ */
+enum class LoadBalancePolicy
+{
+    RoundRobin,         ///< 轮询
+    Weighted,           ///< 平滑加权轮询
+    LeastOutstanding,   ///< 最少在途请求
+    PeakEwma            ///< P2C + 峰值 EWMA 延迟
+};
+
+/**
+ * @brief 上游协议
+ */
+enum class UpstreamProtocol
+{
+    Http1,  ///< HTTP/1.1，每个在途请求独占一条池化连接
+    H2c     ///< 明文 HTTP/2，多个请求复用少量共享连接（仅 Http 模式）
+};
+
+/**
+ * @brief 被动异常检测配置
+ */
+struct OutlierDetectionConfig
+{
+    bool enabled = false;                               ///< 是否启用
+    uint32_t consecutive_failures = 5;                  ///< 连续失败次数阈值，0 关闭
+    double failure_rate = 0.5;                          ///< 统计窗口内失败率阈值，0 关闭
+    uint64_t failure_rate_min_requests = 20;            ///< 计算失败率所需的窗口内最少请求数
+    std::chrono::milliseconds window{10000};            ///< 失败率与延迟异常的统计窗口
+    double latency_factor = 3.0;                        ///< 延迟 EWMA 超过其他实例中位数的倍数视为异常，0 关闭
+    std::chrono::milliseconds latency_floor{50};        ///< 延迟异常的绝对下限，低于该值不判定
+    std::chrono::milliseconds base_ejection{30000};     ///< 首次摘除时长，之后每次翻倍
+    std::chrono::milliseconds max_ejection{300000};     ///< 摘除时长上限
+    uint32_t max_ejection_percent = 50;                 ///< 同时被摘除实例的最大比例（%）
+};
+
+/**
+ * @brief 上游组配置
+ */
+struct UpstreamGroupConfig
+{
+    LoadBalancePolicy policy = LoadBalancePolicy::RoundRobin;          ///< 负载均衡策略
+    std::chrono::milliseconds merge_interval{100};                    ///< 线程局部状态合并周期
+    std::chrono::milliseconds ewma_decay{10000};                      ///< EWMA 衰减时间常数
+    UpstreamPoolConfig pool;                                          ///< 各实例的连接池配置
+    ResponseCacheConfig cache;                                        ///< 响应缓存配置（默认关闭）
+    bool single_flight = false;                                       ///< 合并并发的相同 GET 请求，只回源一次
+    UpstreamProtocol protocol = UpstreamProtocol::Http1;              ///< 与上游通信的协议
+    H2cUpstreamConfig h2c;                                            ///< h2c 多路复用配置（protocol 为 H2c 时生效）
+    HedgeConfig hedge;                                                ///< 对冲与重试预算（默认关闭）
+    OutlierDetectionConfig outlier;                                   ///< 被动异常检测与摘除（默认关闭）
+    ProxyStreamingConfig streaming;                                   ///< Http 模式响应体流式转发（HTTP/1.1 上游）
+};
+
+/**
+ * @brief 上游实例统计（合并视图）
+ */
+struct UpstreamEndpointStats
+{
+    uint64_t requests = 0;      ///< 已完成请求数
+    uint64_t failures = 0;      ///< 失败请求数
+    int64_t outstanding = 0;    ///< 在途请求数（截至最近一次合并）
+    uint64_t ewma_ns = 0;       ///< 峰值 EWMA 延迟（纳秒）
+    bool ejected = false;       ///< 是否处于摘除或半开状态
+    uint64_t ejections = 0;     ///< 累计摘除次数
+};
+
+/**
+ * @brief 上游组
+ * @details 通过 `create()` 构造并以 shared_ptr 在路由处理器间共享。
+ *          选择结果在同一 IO 线程上以 `Lease` 记账，析构时自动结束。
+ *          各线程的局部状态以弱引用指向所属组，组销毁后在该线程下一次合并时释放。
+ */
+class UpstreamGroup : public std::enable_shared_from_this<UpstreamGroup>
+{
+public:
+    using ptr = std::shared_ptr<UpstreamGroup>;
+
+    /**
+     * @brief 创建上游组
+     * @param endpoints 上游实例列表（不可为空）
+     * @param config 组配置
+     * @return 上游组；endpoints 为空时返回 nullptr
+     */
+    static ptr create(std::vector<UpstreamEndpoint> endpoints,
+                      UpstreamGroupConfig config = UpstreamGroupConfig())
+    {
+        if (endpoints.empty()) {
+            return nullptr;
+        }
+        return ptr(new UpstreamGroup(std::move(endpoints), config));
+    }
+
+    /**
+     * @brief 创建只含一个实例的上游组
+     */
+    static ptr single(const std::string& host, uint16_t port)
+    {
+        return create({UpstreamEndpoint{host, port, 1}});
+    }
+
+    UpstreamGroup(const UpstreamGroup&) = delete;
+    UpstreamGroup& operator=(const UpstreamGroup&) = delete;
+    ~UpstreamGroup() { destroyedGroups().fetch_add(1, std::memory_order_release); }
+
+    size_t size() const { return m_endpoints.size(); }  ///< 实例数量
+    const UpstreamEndpoint& endpoint(size_t index) const { return m_endpoints[index]; } ///< 获取实例
+    const UpstreamGroupConfig& config() const { return m_config; } ///< 获取配置
+
+    /**
+     * @brief 一次选择的结果
+     * @details `probe` 为 true 表示本次选择领到了该半开实例的探测名额，须交给 Lease 判定
+     *          （或 releaseProbe 放弃）。名额随结果显式传递，选择与建 Lease 之间隔着协程调度也不会串号
+     */
+    struct Pick
+    {
+        size_t index = 0;   ///< 实例下标
+        bool probe = false; ///< 是否为半开探测
+    };
+
+    /**
+     * @brief 为一次请求选择实例
+     */
+    Pick select()
+    {
+        LocalState& local = localState();
+        const int64_t now = nowNs();
+        maybeMerge(local, now);
+
+        const size_t n = m_endpoints.size();
+        if (n == 1) {
+            return Pick{0, false};
+        }
+
+        // 半开实例优先放行一个探测请求
+        bool filter = false;
+        if (m_config.outlier.enabled) {
+            bool any_admitted = false;
+            for (size_t i = 0; i < n; ++i) {
+                const int64_t until = m_shared[i].ejected_until_ns.load(std::memory_order_relaxed);
+                if (until == 0) {
+                    any_admitted = true;
+                } else if (until <= now && claimProbe(i)) {
+                    return Pick{i, true};
+                }
+            }
+            // 全部被摘除时忽略摘除状态（panic），仍按策略分配
+            filter = any_admitted;
+        }
+        auto admitted = [this, filter](size_t i) {
+            return !filter || m_shared[i].ejected_until_ns.load(std::memory_order_relaxed) == 0;
+        };
+
+        switch (m_config.policy) {
+        case LoadBalancePolicy::RoundRobin:
+            for (size_t k = 0; k < n; ++k) {
+                const size_t i = static_cast<size_t>(local.rr++ % n);
+                if (admitted(i)) {
+                    return Pick{i, false};
+                }
+            }
+            return Pick{0, false};
+
+        case LoadBalancePolicy::Weighted: {
+            // 平滑加权轮询：每轮所有实例加自身权重，选最大者并减去总权重
+            int64_t total = 0;
+            size_t best = n;
+            for (size_t i = 0; i < n; ++i) {
+                if (!admitted(i)) {
+                    continue;
+                }
+                const int64_t w = weightOf(i);
+                local.endpoints[i].current_weight += w;
+                total += w;
+                if (best == n || local.endpoints[i].current_weight > local.endpoints[best].current_weight) {
+                    best = i;
+                }
+            }
+            local.endpoints[best].current_weight -= total;
+            return Pick{best, false};
+        }
+
+        case LoadBalancePolicy::LeastOutstanding: {
+            // 从轮询起点开始扫描，平局时在各实例间轮转
+            const size_t start = static_cast<size_t>(local.rr++ % n);
+            size_t best = n;
+            int64_t best_load = 0;
+            for (size_t k = 0; k < n; ++k) {
+                const size_t i = (start + k) % n;
+                if (!admitted(i)) {
+                    continue;
+                }
+                const int64_t load = outstandingView(local, i);
+                if (best == n || load < best_load) {
+                    best = i;
+                    best_load = load;
+                }
+            }
+            return Pick{best, false};
+        }
+
+        case LoadBalancePolicy::PeakEwma: {
+            // 随机起点后的第一个可用实例，保证两次选择互不相同
+            auto nextAdmitted = [&](size_t from, size_t skip) {
+                for (size_t k = 0; k < n; ++k) {
+                    const size_t i = (from + k) % n;
+                    if (i != skip && admitted(i)) {
+                        return i;
+                    }
+                }
+                return n;
+            };
+            const size_t a = nextAdmitted(static_cast<size_t>(nextRandom(local) % n), n);
+            const size_t b = nextAdmitted(static_cast<size_t>(nextRandom(local) % n), a);
+            if (b == n) {
+                return Pick{a, false};
+            }
+            return Pick{ewmaCost(local, a, now) <= ewmaCost(local, b, now) ? a : b, false};
+        }
+        }
+        return Pick{0, false};
+    }
+
+    /**
+     * @brief 为对冲或重试选择另一个实例
+     * @details 按策略选择；选中 exclude 时改为其后第一个未被摘除的实例。只有一个实例时返回它本身
+     */
+    Pick selectOther(size_t exclude)
+    {
+        const Pick pick = select();
+        const size_t n = m_endpoints.size();
+        if (n == 1 || pick.index != exclude) {
+            return pick;
+        }
+        if (pick.probe) {
+            releaseProbe(pick.index);
+        }
+        for (size_t k = 1; k < n; ++k) {
+            const size_t i = (exclude + k) % n;
+            if (!isEjected(i)) {
+                return Pick{i, false};
+            }
+        }
+        return Pick{(exclude + 1) % n, false};
+    }
+
+    /**
+     * @brief 当前线程的对冲状态（延迟窗口与重试预算）
+     */
+    HedgeState& hedgeState()
+    {
+        return localState().hedge;
+    }
+
+    /**
+     * @brief 记录请求开始（在途 +1）
+     */
+    void onRequestStart(size_t index)
+    {
+        LocalState& local = localState();
+        ++local.endpoints[index].outstanding;
+        ++local.endpoints[index].unpublished_outstanding;
+    }
+
+    /**
+     * @brief 记录请求结束
+     * @param index 实例下标
+     * @param latency 请求延迟；小于 0 表示不计入 EWMA
+     * @param success 是否成功
+     */
+    void onRequestEnd(size_t index, std::chrono::nanoseconds latency, bool success)
+    {
+        LocalState& local = localState();
+        LocalEndpoint& ep = local.endpoints[index];
+        --ep.outstanding;
+        --ep.unpublished_outstanding;
+        ++ep.unpublished_requests;
+        if (!success) {
+            ++ep.unpublished_failures;
+        }
+        if (latency.count() >= 0) {
+            observeLatency(ep, static_cast<double>(latency.count()), nowNs());
+        }
+    }
+
+    /**
+     * @brief 强制合并当前线程的局部状态
+     */
+    void flush()
+    {
+        LocalState& local = localState();
+        merge(local, nowNs());
+    }
+
+    /**
+     * @brief 当前线程持有局部状态的上游组数量（含尚未释放的已销毁组）
+     */
+    static size_t localStateCount()
+    {
+        return localStates().states.size();
+    }
+
+    /**
+     * @brief 获取合并视图下的实例统计
+     * @details 只包含各线程已合并的部分，最多滞后一个合并周期
+     */
+    std::vector<UpstreamEndpointStats> stats() const
+    {
+        std::vector<UpstreamEndpointStats> out(m_endpoints.size());
+        for (size_t i = 0; i < m_endpoints.size(); ++i) {
+            const SharedEndpoint& shared = m_shared[i];
+            out[i].requests = shared.requests.load(std::memory_order_relaxed);
+            out[i].failures = shared.failures.load(std::memory_order_relaxed);
+            out[i].outstanding = shared.outstanding.load(std::memory_order_relaxed);
+            out[i].ewma_ns = shared.ewma_ns.load(std::memory_order_relaxed);
+            out[i].ejected = shared.ejected_until_ns.load(std::memory_order_relaxed) != 0;
+            out[i].ejections = shared.ejections.load(std::memory_order_relaxed);
+        }
+        return out;
+    }
+
+    /**
+     * @brief 实例是否处于摘除或半开状态
+     */
+    bool isEjected(size_t index) const
+    {
+        return m_shared[index].ejected_until_ns.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * @brief 记录请求结果，驱动连续失败摘除与半开探测
+     * @param probe 是否为半开状态的探测请求
+     */
+    void recordOutcome(size_t index, bool success, bool probe)
+    {
+        if (!m_config.outlier.enabled) {
+            return;
+        }
+        SharedEndpoint& shared = m_shared[index];
+        const int64_t now = nowNs();
+        if (probe) {
+            shared.probing.store(false, std::memory_order_relaxed);
+            if (success) {
+                shared.consecutive_failures.store(0, std::memory_order_relaxed);
+                shared.ejected_until_ns.store(0, std::memory_order_release);
+                const uint32_t level = shared.ejection_level.load(std::memory_order_relaxed);
+                if (level > 0) {
+                    shared.ejection_level.store(level - 1, std::memory_order_relaxed);
+                }
+            } else {
+                eject(index, now, true);
+            }
+            return;
+        }
+        if (success) {
+            // 成功路径只读一次，计数非零时才写，避免无谓的缓存行争用
+            if (shared.consecutive_failures.load(std::memory_order_relaxed) != 0) {
+                shared.consecutive_failures.store(0, std::memory_order_relaxed);
+            }
+            return;
+        }
+        const uint32_t threshold = m_config.outlier.consecutive_failures;
+        if (threshold > 0 &&
+            shared.consecutive_failures.fetch_add(1, std::memory_order_relaxed) + 1 >= threshold) {
+            eject(index, now, false);
+        }
+    }
+
+    /**
+     * @brief 放弃探测名额（探测请求被取消，不作判定）
+     */
+    void releaseProbe(size_t index)
+    {
+        m_shared[index].probing.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 请求级记账句柄
+     * @details 构造时在途 +1；`finish()` 或析构时结束记账（析构视为失败）。
+     *          `stopClock()` 可提前截止延迟计时，例如流式响应只统计到请求发出。
+     */
+    class Lease
+    {
+    public:
+        Lease(UpstreamGroup& group, Pick pick)
+            : m_group(&group)
+            , m_index(pick.index)
+            , m_start(std::chrono::steady_clock::now())
+            , m_probe(pick.probe)
+        {
+            m_group->onRequestStart(m_index);
+        }
+
+        /**
+         * @brief 指定实例的普通请求（不持有探测名额）
+         */
+        Lease(UpstreamGroup& group, size_t index)
+            : Lease(group, Pick{index, false})
+        {
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() { finish(false); }
+
+        size_t index() const { return m_index; } ///< 实例下标
+
+        /**
+         * @brief 截止延迟计时
+         */
+        void stopClock()
+        {
+            if (!m_clock_stopped) {
+                m_latency = std::chrono::steady_clock::now() - m_start;
+                m_clock_stopped = true;
+            }
+        }
+
+        /**
+         * @brief 结束记账（幂等）
+         */
+        void finish(bool success)
+        {
+            if (m_group == nullptr) {
+                return;
+            }
+            stopClock();
+            // 失败请求不计入延迟，避免快速失败的实例被误判为低延迟
+            m_group->onRequestEnd(m_index, success ? m_latency : std::chrono::nanoseconds(-1), success);
+            m_group->recordOutcome(m_index, success, m_probe);
+            m_group = nullptr;
+        }
+
+        /**
+         * @brief 放弃请求（被对冲取消，或本地连接数达到上限）：不计失败，也不计入延迟
+         */
+        void abandon()
+        {
+            if (m_group == nullptr) {
+                return;
+            }
+            m_group->onRequestEnd(m_index, std::chrono::nanoseconds(-1), true);
+            if (m_probe) {
+                m_group->releaseProbe(m_index);
+            }
+            m_group = nullptr;
+        }
+
+    private:
+        UpstreamGroup* m_group;
+        size_t m_index;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::nanoseconds m_latency{0};
+        bool m_clock_stopped = false;
+        bool m_probe = false;
+    };
+
+private:
+    struct alignas(64) SharedEndpoint {
+        std::atomic<int64_t> outstanding{0};
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> ewma_ns{0};
+        // 异常检测：所有调度器共享的判定状态
+        std::atomic<int64_t> ejected_until_ns{0};       ///< 0 健康；大于当前时间为摘除中；否则为半开
+        std::atomic<uint32_t> ejection_level{0};        ///< 退避级数，每次摘除 +1，探测成功 -1
+        std::atomic<uint32_t> consecutive_failures{0};
+        std::atomic<bool> probing{false};               ///< 半开探测请求是否在途
+        std::atomic<uint64_t> ejections{0};
+        std::atomic<int64_t> window_start_ns{0};
+        std::atomic<uint64_t> window_requests{0};
+        std::atomic<uint64_t> window_failures{0};
+    };
+
+    struct LocalEndpoint {
+        int64_t outstanding = 0;              ///< 本线程在途数
+        int64_t unpublished_outstanding = 0;  ///< 尚未合并的在途增量
+        uint64_t unpublished_requests = 0;
+        uint64_t unpublished_failures = 0;
+        int64_t remote_outstanding = 0;       ///< 其他线程的在途数（合并时刷新）
+        double ewma_ns = 0.0;                 ///< 峰值 EWMA（纳秒）
+        int64_t ewma_stamp_ns = 0;            ///< 最近一次 EWMA 更新时间
+        bool ewma_dirty = false;              ///< 本周期内有新样本
+        int64_t current_weight = 0;           ///< 平滑加权轮询的当前权重
+    };
+
+    struct LocalState {
+        std::vector<LocalEndpoint> endpoints;
+        uint64_t rr = 0;
+        uint64_t rng = 0;
+        int64_t last_merge_ns = 0;
+        HedgeState hedge;
+        std::weak_ptr<UpstreamGroup> owner;   ///< 所属组，失效后在合并时释放
+    };
+
+    struct LocalStates {
+        std::unordered_map<uint64_t, LocalState> states;
+        uint64_t seen_destroyed = 0;          ///< 上次清理时的已销毁组计数
+    };
+
+    UpstreamGroup(std::vector<UpstreamEndpoint> endpoints, UpstreamGroupConfig config)
+        : m_endpoints(std::move(endpoints))
+        , m_config(config)
+        , m_shared(new SharedEndpoint[m_endpoints.size()])
+        , m_id(nextGroupId())
+    {
+    }
+
+    static uint64_t nextGroupId()
+    {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::atomic<uint64_t>& destroyedGroups()
+    {
+        static std::atomic<uint64_t> destroyed{0};
+        return destroyed;
+    }
+
+    static LocalStates& localStates()
+    {
+        thread_local LocalStates locals;
+        return locals;
+    }
+
+    /**
+     * @brief 释放本线程中已销毁组的局部状态（只在有组销毁后遍历）
+     */
+    static void pruneLocalStates()
+    {
+        LocalStates& locals = localStates();
+        const uint64_t destroyed = destroyedGroups().load(std::memory_order_acquire);
+        if (destroyed == locals.seen_destroyed) {
+            return;
+        }
+        locals.seen_destroyed = destroyed;
+        std::erase_if(locals.states, [](const auto& entry) { return entry.second.owner.expired(); });
+    }
+
+    static int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    LocalState& localState()
+    {
+        auto [it, inserted] = localStates().states.try_emplace(m_id);
+        if (inserted) {
+            LocalState& local = it->second;
+            local.owner = weak_from_this();
+            local.endpoints.resize(m_endpoints.size());
+            const uint64_t seed = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ (m_id * 0x9E3779B97F4A7C15ULL);
+            local.rng = seed | 1;
+            // 各线程从不同位置开始轮询，避免同时打到同一实例
+            local.rr = seed % m_endpoints.size();
+            local.last_merge_ns = nowNs();
+        }
+        return it->second;
+    }
+
+    int64_t weightOf(size_t index) const
+    {
+        return m_endpoints[index].weight == 0 ? 1 : static_cast<int64_t>(m_endpoints[index].weight);
+    }
+
+    static uint64_t nextRandom(LocalState& local)
+    {
+        // xorshift64
+        uint64_t x = local.rng;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        local.rng = x;
+        return x;
+    }
+
+    static int64_t outstandingView(const LocalState& local, size_t index)
+    {
+        const LocalEndpoint& ep = local.endpoints[index];
+        return ep.remote_outstanding + ep.outstanding;
+    }
+
+    double ewmaCost(const LocalState& local, size_t index, int64_t now) const
+    {
+        const LocalEndpoint& ep = local.endpoints[index];
+        const double outstanding = static_cast<double>(outstandingView(local, index));
+        if (ep.ewma_ns <= 0.0) {
+            // 尚无延迟样本：只按在途数比较，让新实例尽快获得样本
+            return outstanding;
+        }
+        // 空闲期间 EWMA 向 0 衰减，避免一次慢请求长期把实例拉黑
+        const double elapsed = static_cast<double>(now - ep.ewma_stamp_ns);
+        const double decay = std::exp(-elapsed / decayNs());
+        return ep.ewma_ns * decay * (outstanding + 1.0);
+    }
+
+    double decayNs() const
+    {
+        const double tau = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(m_config.ewma_decay).count());
+        return tau > 0.0 ? tau : 1.0;
+    }
+
+    void observeLatency(LocalEndpoint& ep, double rtt, int64_t now) const
+    {
+        if (ep.ewma_ns <= 0.0 || rtt > ep.ewma_ns) {
+            ep.ewma_ns = rtt;
+        } else {
+            const double elapsed = static_cast<double>(now - ep.ewma_stamp_ns);
+            const double w = std::exp(-elapsed / decayNs());
+            ep.ewma_ns = ep.ewma_ns * w + rtt * (1.0 - w);
+        }
+        ep.ewma_stamp_ns = now;
+        ep.ewma_dirty = true;
+    }
+
+    void maybeMerge(LocalState& local, int64_t now)
+    {
+        const int64_t interval = std::chrono::duration_cast<std::chrono::nanoseconds>(m_config.merge_interval).count();
+        if (now - local.last_merge_ns >= interval) {
+            merge(local, now);
+        }
+    }
+
+    void merge(LocalState& local, int64_t now)
+    {
+        pruneLocalStates();
+        local.last_merge_ns = now;
+        for (size_t i = 0; i < m_endpoints.size(); ++i) {
+            LocalEndpoint& ep = local.endpoints[i];
+            SharedEndpoint& shared = m_shared[i];
+
+            int64_t total;
+            if (ep.unpublished_outstanding != 0) {
+                total = shared.outstanding.fetch_add(ep.unpublished_outstanding, std::memory_order_relaxed) +
+                        ep.unpublished_outstanding;
+                ep.unpublished_outstanding = 0;
+            } else {
+                total = shared.outstanding.load(std::memory_order_relaxed);
+            }
+            ep.remote_outstanding = total > ep.outstanding ? total - ep.outstanding : 0;
+
+            if (ep.unpublished_requests != 0) {
+                shared.requests.fetch_add(ep.unpublished_requests, std::memory_order_relaxed);
+                if (m_config.outlier.enabled) {
+                    shared.window_requests.fetch_add(ep.unpublished_requests, std::memory_order_relaxed);
+                }
+                ep.unpublished_requests = 0;
+            }
+            if (ep.unpublished_failures != 0) {
+                shared.failures.fetch_add(ep.unpublished_failures, std::memory_order_relaxed);
+                if (m_config.outlier.enabled) {
+                    shared.window_failures.fetch_add(ep.unpublished_failures, std::memory_order_relaxed);
+                }
+                ep.unpublished_failures = 0;
+            }
+
+            // EWMA：有新样本时与全局值取平均后发布；否则采用全局值
+            const uint64_t shared_ewma = shared.ewma_ns.load(std::memory_order_relaxed);
+            if (ep.ewma_dirty) {
+                const double merged = shared_ewma == 0 ? ep.ewma_ns
+                                                       : (ep.ewma_ns + static_cast<double>(shared_ewma)) / 2.0;
+                shared.ewma_ns.store(static_cast<uint64_t>(merged), std::memory_order_relaxed);
+                ep.ewma_dirty = false;
+            } else if (shared_ewma != 0) {
+                ep.ewma_ns = static_cast<double>(shared_ewma);
+                if (ep.ewma_stamp_ns == 0) {
+                    ep.ewma_stamp_ns = now;
+                }
+            }
+        }
+        if (m_config.outlier.enabled) {
+            evaluateWindows(now);
+        }
+    }
+
+    /**
+     * @brief 窗口到期时评估失败率与延迟异常
+     * @details 窗口起点以 CAS 推进，每个窗口只有一个线程做评估
+     */
+    void evaluateWindows(int64_t now)
+    {
+        const OutlierDetectionConfig& config = m_config.outlier;
+        const int64_t window = std::chrono::duration_cast<std::chrono::nanoseconds>(config.window).count();
+        for (size_t i = 0; i < m_endpoints.size(); ++i) {
+            SharedEndpoint& shared = m_shared[i];
+            int64_t start = shared.window_start_ns.load(std::memory_order_relaxed);
+            if (start == 0) {
+                shared.window_start_ns.compare_exchange_strong(start, now, std::memory_order_relaxed);
+                continue;
+            }
+            if (now - start < window ||
+                !shared.window_start_ns.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+                continue;
+            }
+            const uint64_t requests = shared.window_requests.exchange(0, std::memory_order_relaxed);
+            const uint64_t failures = shared.window_failures.exchange(0, std::memory_order_relaxed);
+            if (config.failure_rate > 0.0 && requests > 0 && requests >= config.failure_rate_min_requests &&
+                static_cast<double>(failures) >= config.failure_rate * static_cast<double>(requests)) {
+                eject(i, now, false);
+            } else if (isLatencyOutlier(i)) {
+                eject(i, now, false);
+            }
+        }
+    }
+
+    /**
+     * @brief 延迟 EWMA 是否显著高于其他健康实例的中位数
+     */
+    bool isLatencyOutlier(size_t index) const
+    {
+        const OutlierDetectionConfig& config = m_config.outlier;
+        const uint64_t mine = m_shared[index].ewma_ns.load(std::memory_order_relaxed);
+        const auto floor = std::chrono::duration_cast<std::chrono::nanoseconds>(config.latency_floor).count();
+        if (config.latency_factor <= 0.0 || mine == 0 || static_cast<int64_t>(mine) < floor) {
+            return false;
+        }
+        std::vector<uint64_t> others;
+        others.reserve(m_endpoints.size());
+        for (size_t i = 0; i < m_endpoints.size(); ++i) {
+            const uint64_t ewma = m_shared[i].ewma_ns.load(std::memory_order_relaxed);
+            if (i != index && ewma != 0 && m_shared[i].ejected_until_ns.load(std::memory_order_relaxed) == 0) {
+                others.push_back(ewma);
+            }
+        }
+        if (others.empty()) {
+            return false;
+        }
+        std::nth_element(others.begin(), others.begin() + others.size() / 2, others.end());
+        const double median = static_cast<double>(others[others.size() / 2]);
+        return static_cast<double>(mine) > config.latency_factor * median;
+    }
+
+    /**
+     * @brief 摘除实例
+     * @param from_probe 半开探测失败：直接以更长时长重新摘除，不受比例上限约束
+     */
+    void eject(size_t index, int64_t now, bool from_probe)
+    {
+        const OutlierDetectionConfig& config = m_config.outlier;
+        SharedEndpoint& shared = m_shared[index];
+        if (!from_probe) {
+            size_t ejected = 0;
+            for (size_t i = 0; i < m_endpoints.size(); ++i) {
+                if (m_shared[i].ejected_until_ns.load(std::memory_order_relaxed) != 0) {
+                    ++ejected;
+                }
+            }
+            if ((ejected + 1) * 100 > m_endpoints.size() * config.max_ejection_percent) {
+                return;
+            }
+        }
+
+        const uint32_t level = std::min<uint32_t>(shared.ejection_level.load(std::memory_order_relaxed), 30);
+        const int64_t base = std::chrono::duration_cast<std::chrono::nanoseconds>(config.base_ejection).count();
+        const int64_t cap = std::chrono::duration_cast<std::chrono::nanoseconds>(config.max_ejection).count();
+        const int64_t duration = base > (cap >> level) ? cap : (base << level);
+        const int64_t until = now + std::max<int64_t>(duration, 1);
+
+        if (from_probe) {
+            shared.ejected_until_ns.store(until, std::memory_order_release);
+        } else {
+            int64_t expected = 0;
+            if (!shared.ejected_until_ns.compare_exchange_strong(expected, until, std::memory_order_acq_rel)) {
+                return;     // 其他线程已摘除
+            }
+        }
+        shared.ejection_level.fetch_add(1, std::memory_order_relaxed);
+        shared.ejections.fetch_add(1, std::memory_order_relaxed);
+        shared.consecutive_failures.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 领取半开实例的唯一探测名额
+     */
+    bool claimProbe(size_t index)
+    {
+        bool expected = false;
+        return m_shared[index].probing.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+    }
+
+    std::vector<UpstreamEndpoint> m_endpoints;
+    UpstreamGroupConfig m_config;
+    std::unique_ptr<SharedEndpoint[]> m_shared;
+    uint64_t m_id;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_UPSTREAM_H
@@ -0,0 +1,439 @@
+/**
+ * @file upstream_pool.h
+ * @brief 反向代理上游连接池
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 每个 IO 调度器线程持有一份连接池，按上游（host:port）分桶：
+ * - 每个上游的空闲连接数与连接总数（空闲 + 借出）均有上限
+ * - 空闲连接按最近使用时间排队，超过 idle_timeout 由定时器回收
+ * - 复用前以 MSG_PEEK 做一次非阻塞可读性探测，过滤已被对端关闭的连接
+ * - 支持预热：空闲连接低于 min_idle 时由调用方在后台提前建连
+ * - 丢弃、回收的连接交给回收回调关闭（关闭需要异步完成，由调用方投递到调度器）
+ * 连接池只在所属线程访问，无需加锁；各事件同时累加到进程级 ProxyStats。
+ */
+
+#ifndef GALAY_HTTP_UPSTREAM_POOL_H
+#define GALAY_HTTP_UPSTREAM_POOL_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <sys/socket.h>
+
+#include "proxy_stats.h"
+
+namespace galay::http
+{
+
+/**
+ * @brief 上游连接池配置（按上游生效）
+ */
+struct UpstreamPoolConfig
+{
+    size_t max_idle = 32;                                   ///< 每线程每上游最多保留的空闲连接数
+    size_t max_total = 0;                                   ///< 每线程每上游的连接总数上限，0 表示不限制
+    std::chrono::milliseconds idle_timeout{60000};          ///< 空闲连接最长保留时间
+    std::chrono::milliseconds eviction_interval{1000};      ///< 空闲回收定时器周期
+    size_t min_idle = 0;                                    ///< 预热目标：空闲连接低于该值时后台补齐
+};
+
+/**
+ * @brief 上游连接池统计（单线程单上游）
+ */
+struct UpstreamPoolStats
+{
+    uint64_t hits = 0;           ///< 复用空闲连接次数
+    uint64_t misses = 0;         ///< 无可用空闲连接、需要新建的次数
+    uint64_t evictions = 0;      ///< 因超时、探测失败或超出空闲上限而关闭的空闲连接数
+    uint64_t probe_failures = 0; ///< 复用前探测发现已失效的连接数（计入 evictions）
+    uint64_t stale_retries = 0;  ///< 复用连接收发失败后重连重试的次数
+    uint64_t warm_connects = 0;  ///< 预热成功建立的连接数
+    uint64_t exhausted = 0;      ///< 因达到连接总数上限而拒绝的次数
+    size_t open = 0;             ///< 当前连接总数（空闲 + 借出 + 预热中）
+    size_t idle = 0;             ///< 当前空闲连接数
+};
+
+/**
+ * @brief 检查空闲连接是否仍可复用
+ * @param fd 连接 fd
+ * @return 无数据可读且未被对端关闭时返回 true
+ * @details 空闲的 keep-alive 连接上不应有任何数据：读到 EOF 说明对端已关闭，
+ *          读到数据说明连接状态已不可预期，两者都不可复用
+ */
+inline bool probeIdleConnection(int fd)
+{
+    if (fd < 0) {
+        return false;
+    }
+    char byte;
+    const ssize_t n = ::recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return false;
+}
+
+/**
+ * @brief 线程局部的上游连接池
+ * @tparam Client 客户端类型，需要提供 `socket().handle().fd`；
+ *         未设置回收回调时，被丢弃的连接直接析构
+ */
+template <typename Client>
+class UpstreamConnectionPool
+{
+public:
+    using ClientPtr = std::unique_ptr<Client>;
+    using Clock = std::chrono::steady_clock;
+    using Retire = std::function<void(ClientPtr)>;  ///< 关闭被丢弃连接的回调
+
+    /**
+     * @brief 借出的连接句柄
+     * @details 析构时若仍持有连接，视为丢弃（连接总数 -1）；
+     *          需要复用时调用 `UpstreamConnectionPool::release()` 归还
+     */
+    class Handle
+    {
+    public:
+        Handle() = default;
+        Handle(Handle&& other) noexcept { *this = std::move(other); }
+        Handle& operator=(Handle&& other) noexcept
+        {
+            if (this != &other) {
+                discard();
+                m_pool = other.m_pool;
+                m_key = std::move(other.m_key);
+                m_client = std::move(other.m_client);
+                m_reused = other.m_reused;
+                m_exhausted = other.m_exhausted;
+                m_warming = other.m_warming;
+                other.m_pool = nullptr;
+            }
+            return *this;
+        }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        ~Handle() { discard(); }
+
+        explicit operator bool() const { return m_client != nullptr; }
+        Client* operator->() const { return m_client.get(); }
+        Client& operator*() const { return *m_client; }
+
+        bool reused() const { return m_reused; }       ///< 是否为复用的空闲连接
+        bool exhausted() const { return m_exhausted; } ///< 是否因总数上限被拒绝
+        const std::string& key() const { return m_key; }
+
+        /**
+         * @brief 用新建连接替换当前连接（总数不变），用于失效重连
+         */
+        void renew()
+        {
+            if (m_pool != nullptr && m_client) {
+                m_pool->retire(std::move(m_client));
+            }
+            m_client = std::make_unique<Client>();
+            m_reused = false;
+        }
+
+        /**
+         * @brief 丢弃连接（连接总数 -1）
+         */
+        void discard()
+        {
+            if (m_pool != nullptr) {
+                UpstreamConnectionPool* pool = m_pool;
+                m_pool = nullptr;
+                pool->onDiscard(m_key, m_warming);
+                if (m_client) {
+                    pool->retire(std::move(m_client));
+                }
+            }
+            m_client.reset();
+        }
+
+    private:
+        friend class UpstreamConnectionPool;
+
+        UpstreamConnectionPool* m_pool = nullptr;
+        std::string m_key;
+        ClientPtr m_client;
+        bool m_reused = false;
+        bool m_exhausted = false;
+        bool m_warming = false;
+    };
+
+    static UpstreamConnectionPool& local()
+    {
+        thread_local UpstreamConnectionPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief 设置连接回收回调（每线程一次），丢弃、超时与超出空闲上限的连接均经此关闭
+     */
+    void setRetireHook(Retire hook) { m_retire = std::move(hook); }
+    bool hasRetireHook() const { return static_cast<bool>(m_retire); }
+
+    /**
+     * @brief 借出连接
+     * @param key 上游标识（host:port）
+     * @param config 该上游的连接池配置（首次使用时生效）
+     * @return 复用的空闲连接，或一个待调用方 connect 的新连接；
+     *         达到总数上限时返回空句柄且 `exhausted()` 为 true
+     */
+    Handle acquire(const std::string& key, const UpstreamPoolConfig& config, Clock::time_point now = Clock::now())
+    {
+        Bucket& bucket = bucketFor(key, config);
+        while (!bucket.idle.empty()) {
+            IdleEntry entry = std::move(bucket.idle.back());
+            bucket.idle.pop_back();
+            const bool expired = now - entry.last_used > bucket.config.idle_timeout;
+            if (expired || !probeIdleConnection(entry.client->socket().handle().fd)) {
+                if (!expired) {
+                    ++bucket.stats.probe_failures;
+                }
+                ++bucket.stats.evictions;
+                --bucket.open;
+                ProxyStats::instance().addPoolEvictions(1);
+                retire(std::move(entry.client));
+                continue;
+            }
+            ++bucket.stats.hits;
+            ProxyStats::instance().addPoolHit();
+            return makeHandle(key, std::move(entry.client), true, false);
+        }
+
+        ++bucket.stats.misses;
+        ProxyStats::instance().addPoolMiss();
+        if (bucket.config.max_total > 0 && bucket.open >= bucket.config.max_total) {
+            ++bucket.stats.exhausted;
+            ProxyStats::instance().addPoolExhausted();
+            Handle handle;
+            handle.m_exhausted = true;
+            return handle;
+        }
+        ++bucket.open;
+        return makeHandle(key, std::make_unique<Client>(), false, false);
+    }
+
+    /**
+     * @brief 归还可复用的连接
+     */
+    void release(Handle&& handle, Clock::time_point now = Clock::now())
+    {
+        if (!handle.m_client || handle.m_pool != this) {
+            return;
+        }
+        Bucket& bucket = m_buckets[handle.m_key];
+        if (handle.m_warming) {
+            --bucket.warming;
+            ++bucket.stats.warm_connects;
+        }
+        handle.m_pool = nullptr;
+        if (bucket.idle.size() >= bucket.config.max_idle) {
+            ++bucket.stats.evictions;
+            --bucket.open;
+            ProxyStats::instance().addPoolEvictions(1);
+            retire(std::move(handle.m_client));
+            return;
+        }
+        bucket.idle.push_back(IdleEntry{std::move(handle.m_client), now});
+    }
+
+    /**
+     * @brief 记录一次复用连接失效后的重试
+     */
+    void noteStaleRetry(const std::string& key)
+    {
+        auto it = m_buckets.find(key);
+        if (it != m_buckets.end()) {
+            ++it->second.stats.stale_retries;
+        }
+        ProxyStats::instance().addPoolStaleRetry();
+    }
+
+    /**
+     * @brief 需要预热的连接数
+     * @return min_idle 与（空闲 + 预热中）的差值，受总数上限约束
+     */
+    size_t warmDeficit(const std::string& key) const
+    {
+        auto it = m_buckets.find(key);
+        if (it == m_buckets.end()) {
+            return 0;
+        }
+        const Bucket& bucket = it->second;
+        const size_t have = bucket.idle.size() + bucket.warming;
+        if (have >= bucket.config.min_idle) {
+            return 0;
+        }
+        size_t deficit = bucket.config.min_idle - have;
+        if (bucket.config.max_total > 0) {
+            const size_t room = bucket.open >= bucket.config.max_total ? 0 : bucket.config.max_total - bucket.open;
+            deficit = std::min(deficit, room);
+        }
+        return deficit;
+    }
+
+    /**
+     * @brief 为预热预留一个新连接（调用方 connect 成功后 release，失败则直接析构）
+     */
+    Handle reserveWarm(const std::string& key)
+    {
+        auto it = m_buckets.find(key);
+        if (it == m_buckets.end()) {
+            return Handle();
+        }
+        Bucket& bucket = it->second;
+        ++bucket.open;
+        ++bucket.warming;
+        return makeHandle(key, std::make_unique<Client>(), false, true);
+    }
+
+    /**
+     * @brief 回收超时的空闲连接
+     * @return 回收后剩余的空闲连接总数
+     */
+    size_t evictExpired(Clock::time_point now = Clock::now())
+    {
+        size_t remaining = 0;
+        uint64_t evicted = 0;
+        for (auto& [key, bucket] : m_buckets) {
+            while (!bucket.idle.empty() && now - bucket.idle.front().last_used > bucket.config.idle_timeout) {
+                ClientPtr client = std::move(bucket.idle.front().client);
+                bucket.idle.pop_front();
+                retire(std::move(client));
+                ++bucket.stats.evictions;
+                --bucket.open;
+                ++evicted;
+            }
+            remaining += bucket.idle.size();
+        }
+        if (evicted > 0) {
+            ProxyStats::instance().addPoolEvictions(evicted);
+        }
+        return remaining;
+    }
+
+    /**
+     * @brief 是否需要启动空闲回收定时器（有空闲连接且定时器未运行）
+     */
+    bool needsEvictor() const
+    {
+        if (m_evictor_running) {
+            return false;
+        }
+        for (const auto& [key, bucket] : m_buckets) {
+            if (!bucket.idle.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void setEvictorRunning(bool running) { m_evictor_running = running; }   ///< 标记定时器状态
+    std::chrono::milliseconds evictionInterval() const { return m_eviction_interval; } ///< 定时器周期
+
+    /**
+     * @brief 获取单个上游的统计
+     */
+    UpstreamPoolStats stats(const std::string& key) const
+    {
+        auto it = m_buckets.find(key);
+        if (it == m_buckets.end()) {
+            return UpstreamPoolStats{};
+        }
+        UpstreamPoolStats out = it->second.stats;
+        out.open = it->second.open;
+        out.idle = it->second.idle.size();
+        return out;
+    }
+
+    /**
+     * @brief 关闭所有空闲连接
+     */
+    void clear()
+    {
+        for (auto& [key, bucket] : m_buckets) {
+            bucket.open -= std::min(bucket.open, bucket.idle.size());
+            for (auto& entry : bucket.idle) {
+                retire(std::move(entry.client));
+            }
+            bucket.idle.clear();
+        }
+    }
+
+private:
+    struct IdleEntry {
+        ClientPtr client;
+        Clock::time_point last_used;
+    };
+
+    struct Bucket {
+        UpstreamPoolConfig config;
+        std::deque<IdleEntry> idle;     ///< 按最近使用时间排序，尾部最新
+        size_t open = 0;
+        size_t warming = 0;
+        UpstreamPoolStats stats;
+    };
+
+    Bucket& bucketFor(const std::string& key, const UpstreamPoolConfig& config)
+    {
+        auto [it, inserted] = m_buckets.try_emplace(key);
+        if (inserted) {
+            it->second.config = config;
+            if (config.eviction_interval.count() > 0) {
+                m_eviction_interval = std::min(m_eviction_interval, config.eviction_interval);
+            }
+        }
+        return it->second;
+    }
+
+    Handle makeHandle(const std::string& key, ClientPtr client, bool reused, bool warming)
+    {
+        Handle handle;
+        handle.m_pool = this;
+        handle.m_key = key;
+        handle.m_client = std::move(client);
+        handle.m_reused = reused;
+        handle.m_warming = warming;
+        return handle;
+    }
+
+    void retire(ClientPtr client)
+    {
+        if (client && m_retire) {
+            m_retire(std::move(client));
+        }
+    }
+
+    void onDiscard(const std::string& key, bool warming)
+    {
+        auto it = m_buckets.find(key);
+        if (it == m_buckets.end()) {
+            return;
+        }
+        if (it->second.open > 0) {
+            --it->second.open;
+        }
+        if (warming && it->second.warming > 0) {
+            --it->second.warming;
+        }
+    }
+
+    std::unordered_map<std::string, Bucket> m_buckets;
+    std::chrono::milliseconds m_eviction_interval{60000};
+    bool m_evictor_running = false;
+    Retire m_retire;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_UPSTREAM_POOL_H
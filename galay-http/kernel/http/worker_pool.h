@@ -0,0 +1,595 @@
+/**
+ * @file worker_pool.h
+ * @brief 预 fork 多进程模式：主进程监管工作进程，工作进程计数器放在共享内存中
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 主进程 bind 全部监听 socket 后，在调用 start() 的线程上 fork 出单线程的监管进程，
+ * 再由监管进程 fork 出 N 个工作进程；工作进程继承监听 fd，各自运行自己的 Runtime 并在同一组监听 socket 上 accept：
+ * - 所有 fork（含崩溃后的重启）都发生在单线程的监管进程中：多线程进程 fork 时其他线程持有的锁
+ *   （日志、单例、分配器）会以加锁状态复制到子进程，因此主进程在 start() 之后不再 fork；
+ *   监管进程只做 fork、waitpid、kill 与管道写入，不触碰任何锁
+ * - 工作进程被信号杀死或以非 0 状态退出时按崩溃处理，由监管进程重新 fork（启动 1 秒内崩溃的延后重启，避免忙循环）
+ * - 工作进程以 0 退出视为主动退出，不再重启
+ * - 主进程退出时监管进程被 SIGKILL，工作进程随之收到 SIGTERM（PR_SET_PDEATHSIG）
+ * - 退出事件经管道回传，由主进程的监视线程调用回调；停止指令经共享内存下发
+ * 计数器段以 MAP_SHARED 匿名映射创建于 fork 之前，每个工作进程的每个 IO 调度器独占一个缓存行对齐的槽位，
+ * 请求路径上只有本槽位的 relaxed 原子累加；任一进程都可直接读取全部槽位得到汇总，无需进程间通信。
+ * 本文件只包含系统调用封装，不依赖运行时；服务器侧的接入见 http_server.h。
+ */
+
+#ifndef GALAY_HTTP_WORKER_POOL_H
+#define GALAY_HTTP_WORKER_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+namespace galay::http
+{
+
+/**
+ * @brief 一个工作进程中一个 IO 调度器的计数器（位于共享内存）
+ */
+struct alignas(64) HttpWorkerCounters
+{
+    std::atomic<uint64_t> accepted{0};     ///< accept 的连接数
+    std::atomic<uint64_t> requests{0};     ///< 路由模式下读到的请求数
+    std::atomic<int64_t> active{0};        ///< 正在处理的连接数
+
+    void onAccept() { accepted.fetch_add(1, std::memory_order_relaxed); }
+    void onRequest() { requests.fetch_add(1, std::memory_order_relaxed); }
+    void onConnOpen() { active.fetch_add(1, std::memory_order_relaxed); }
+    void onConnClose() { active.fetch_sub(1, std::memory_order_relaxed); }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+              "shared-memory counters require lock-free 64-bit atomics");
+
+/**
+ * @brief 当前线程写入的计数器槽位
+ * @details 工作进程的 accept 循环启动时写入；非预 fork 模式或非 IO 调度器线程为 nullptr
+ */
+inline HttpWorkerCounters*& currentWorkerCounters()
+{
+    thread_local HttpWorkerCounters* counters = nullptr;
+    return counters;
+}
+
+/**
+ * @brief 单个工作进程的统计
+ */
+struct HttpWorkerStatsEntry
+{
+    size_t worker = 0;          ///< 工作进程下标
+    int pid = 0;                ///< 当前进程号（未运行为 0）
+    bool alive = false;         ///< 是否在运行
+    uint32_t restarts = 0;      ///< 崩溃后重启的次数
+    uint64_t accepted = 0;
+    uint64_t requests = 0;
+    int64_t active = 0;
+};
+
+/**
+ * @brief 预 fork 模式统计快照
+ */
+struct HttpWorkerStats
+{
+    std::vector<HttpWorkerStatsEntry> workers;
+    uint64_t accepted = 0;      ///< 全部工作进程合计（含已重启进程此前的累计）
+    uint64_t requests = 0;
+    int64_t active = 0;
+    uint32_t restarts = 0;
+
+    /**
+     * @brief 渲染为逐行 `key value` 文本，供统计端点直接作为响应体
+     */
+    std::string toText() const
+    {
+        std::string out;
+        auto line = [&out](const std::string& key, const std::string& value) {
+            out.append(key).append(" ").append(value).append("\n");
+        };
+        line("workers", std::to_string(workers.size()));
+        line("accepted", std::to_string(accepted));
+        line("requests", std::to_string(requests));
+        line("active", std::to_string(active));
+        line("restarts", std::to_string(restarts));
+        for (const auto& w : workers) {
+            const std::string prefix = "worker" + std::to_string(w.worker) + ".";
+            line(prefix + "pid", std::to_string(w.pid));
+            line(prefix + "alive", w.alive ? "1" : "0");
+            line(prefix + "restarts", std::to_string(w.restarts));
+            line(prefix + "accepted", std::to_string(w.accepted));
+            line(prefix + "requests", std::to_string(w.requests));
+            line(prefix + "active", std::to_string(w.active));
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief 主进程侧的工作进程池
+ * @details start() 之后的 fork、回收与重启都在监管进程中进行，主进程只保留一个读取退出事件的监视线程；
+ *          工作进程内 isWorker() 为 true，工作函数返回后进程以 0 退出，不会回到调用 start() 的代码
+ */
+class HttpWorkerPool
+{
+public:
+    using WorkerMain = std::function<void(size_t worker)>;
+    /// 工作进程退出时在主进程的监视线程上回调：下标、进程号、waitpid 状态、是否将重启
+    using ExitHook = std::function<void(size_t worker, int pid, int status, bool respawn)>;
+
+    static constexpr auto kPollInterval = std::chrono::milliseconds(20);
+    static constexpr auto kMinUptime = std::chrono::milliseconds(1000);     ///< 短于此的崩溃延后重启
+
+    HttpWorkerPool() = default;
+    ~HttpWorkerPool()
+    {
+        stop(std::chrono::milliseconds(0));
+        unmapSegment();
+    }
+
+    HttpWorkerPool(const HttpWorkerPool&) = delete;
+    HttpWorkerPool& operator=(const HttpWorkerPool&) = delete;
+
+    /**
+     * @brief 创建共享计数器段，fork 出监管进程并由其 fork 出全部工作进程
+     * @details 在调用线程上 fork，应在创建其他线程之前调用；工作进程与之后的重启都复制自此刻的进程状态
+     * @param workers 工作进程数
+     * @param slots_per_worker 每个工作进程的计数器槽位数（通常为 IO 调度器数）
+     * @param main 工作进程入口，在子进程中调用
+     * @param on_exit 工作进程退出回调（可为空）
+     * @return 任一工作进程 fork 失败时终止已启动的进程并返回 false
+     */
+    bool start(size_t workers, size_t slots_per_worker, WorkerMain main, ExitHook on_exit, std::string& error)
+    {
+        if (m_monitor.joinable() || workers == 0) {
+            error = workers == 0 ? "no workers" : "already started";
+            return false;
+        }
+        if (!mapSegment(workers, std::max<size_t>(slots_per_worker, 1), error)) {
+            return false;
+        }
+        m_main = std::move(main);
+        m_on_exit = std::move(on_exit);
+        m_slots.assign(workers, Slot{});
+        m_clean_exit = true;
+        m_master_pid = ::getpid();
+
+        int events[2];
+        if (::pipe(events) != 0) {
+            error = std::strerror(errno);
+            unmapSegment();
+            return false;
+        }
+        ::fcntl(events[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(events[1], F_SETFD, FD_CLOEXEC);
+        const pid_t supervisor = ::fork();
+        if (supervisor == 0) {
+            ::close(events[0]);
+            m_events_fd = events[1];
+            supervise();
+        }
+        ::close(events[1]);
+        if (supervisor < 0) {
+            error = std::strerror(errno);
+            ::close(events[0]);
+            unmapSegment();
+            return false;
+        }
+        m_supervisor_pid = supervisor;
+
+        // 监管进程先回送初始 fork 的结果
+        uint8_t started = 0;
+        if (!readFull(events[0], &started, sizeof(started)) || started == 0) {
+            ::close(events[0]);
+            ::waitpid(supervisor, nullptr, 0);
+            m_supervisor_pid = 0;
+            unmapSegment();
+            error = "fork failed";
+            return false;
+        }
+        m_monitor = std::thread([this, fd = events[0]] { monitor(fd); });
+        return true;
+    }
+
+    /**
+     * @brief 通知全部工作进程退出（SIGTERM），此后不再重启；非阻塞
+     */
+    void drain()
+    {
+        if (m_control != nullptr) {
+            m_control->stopping.store(true, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief 通知工作进程退出并等待回收
+     * @param timeout 超时后向仍在运行的工作进程发送 SIGKILL
+     * @return 全部工作进程在超时前退出返回 true
+     */
+    bool stop(std::chrono::milliseconds timeout)
+    {
+        if (!m_monitor.joinable() || isWorker()) {
+            return true;
+        }
+        m_control->kill_at.store((Clock::now() + timeout).time_since_epoch().count(), std::memory_order_release);
+        m_control->stopping.store(true, std::memory_order_release);
+        m_monitor.join();
+        return m_clean_exit;
+    }
+
+    /**
+     * @brief 主进程中工作进程池是否在运行
+     */
+    bool master() const { return m_monitor.joinable() && !isWorker(); }
+
+    bool stopping() const
+    {
+        return m_control != nullptr && m_control->stopping.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 当前进程是否为工作进程
+     */
+    bool isWorker() const { return m_worker_index.has_value(); }
+
+    /**
+     * @brief 工作进程下标（仅工作进程内有值）
+     */
+    std::optional<size_t> workerIndex() const { return m_worker_index; }
+
+    /**
+     * @brief 计数器槽位；下标越界或未启动时返回 nullptr
+     */
+    HttpWorkerCounters* counters(size_t worker, size_t slot) const
+    {
+        if (m_counters == nullptr || worker >= m_workers || slot >= m_slots_per_worker) {
+            return nullptr;
+        }
+        return m_counters + worker * m_slots_per_worker + slot;
+    }
+
+    /**
+     * @brief 读取共享计数器段，主进程与工作进程中均可调用
+     * @details stop() 之后仍保留最后一次运行的计数，直到下一次 start() 或析构
+     */
+    HttpWorkerStats snapshot() const
+    {
+        HttpWorkerStats stats;
+        if (m_segment == nullptr) {
+            return stats;
+        }
+        for (size_t w = 0; w < m_workers; ++w) {
+            HttpWorkerStatsEntry entry;
+            entry.worker = w;
+            entry.pid = m_infos[w].pid.load(std::memory_order_relaxed);
+            entry.alive = entry.pid != 0;
+            entry.restarts = m_infos[w].restarts.load(std::memory_order_relaxed);
+            for (size_t s = 0; s < m_slots_per_worker; ++s) {
+                const HttpWorkerCounters& c = m_counters[w * m_slots_per_worker + s];
+                entry.accepted += c.accepted.load(std::memory_order_relaxed);
+                entry.requests += c.requests.load(std::memory_order_relaxed);
+                entry.active += c.active.load(std::memory_order_relaxed);
+            }
+            stats.accepted += entry.accepted;
+            stats.requests += entry.requests;
+            stats.active += entry.active;
+            stats.restarts += entry.restarts;
+            stats.workers.push_back(entry);
+        }
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int64_t kNever = std::numeric_limits<int64_t>::max();
+
+    /**
+     * @brief 共享内存中的停止指令（由主进程写入，监管进程轮询）
+     * @details steady_clock 即 CLOCK_MONOTONIC，跨进程可比较
+     */
+    struct alignas(64) Control
+    {
+        std::atomic<bool> stopping{false};
+        std::atomic<int64_t> kill_at{kNever};   ///< 发送 SIGKILL 的时间点（steady_clock 计数）
+    };
+
+    /**
+     * @brief 共享内存中每个工作进程的元信息（由监管进程写入）
+     */
+    struct alignas(64) WorkerInfo
+    {
+        std::atomic<int32_t> pid{0};
+        std::atomic<uint32_t> restarts{0};
+    };
+
+    /**
+     * @brief 经管道回传给主进程的退出事件
+     */
+    struct ExitEvent
+    {
+        uint64_t worker = 0;
+        int32_t pid = 0;
+        int32_t status = 0;
+        uint8_t respawn = 0;
+    };
+
+    /**
+     * @brief 监管进程私有的工作进程状态
+     */
+    struct Slot
+    {
+        pid_t pid = 0;
+        Clock::time_point started_at{};
+        Clock::time_point respawn_at{};
+        bool respawn = false;
+    };
+
+    bool mapSegment(size_t workers, size_t slots_per_worker, std::string& error)
+    {
+        unmapSegment();
+        const size_t info_bytes = sizeof(Control) + sizeof(WorkerInfo) * workers;
+        const size_t bytes = info_bytes + sizeof(HttpWorkerCounters) * workers * slots_per_worker;
+        void* segment = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (segment == MAP_FAILED) {
+            error = std::strerror(errno);
+            return false;
+        }
+        m_segment = segment;
+        m_segment_bytes = bytes;
+        m_workers = workers;
+        m_slots_per_worker = slots_per_worker;
+        m_control = new (segment) Control();
+        m_infos = new (static_cast<char*>(segment) + sizeof(Control)) WorkerInfo[workers];
+        m_counters = new (static_cast<char*>(segment) + info_bytes) HttpWorkerCounters[workers * slots_per_worker];
+        return true;
+    }
+
+    void unmapSegment()
+    {
+        if (m_segment != nullptr) {
+            ::munmap(m_segment, m_segment_bytes);
+        }
+        m_segment = nullptr;
+        m_segment_bytes = 0;
+        m_control = nullptr;
+        m_infos = nullptr;
+        m_counters = nullptr;
+        m_workers = 0;
+        m_slots_per_worker = 0;
+    }
+
+    static bool readFull(int fd, void* data, size_t size)
+    {
+        auto* out = static_cast<char*>(data);
+        while (size > 0) {
+            const ssize_t n = ::read(fd, out, size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            out += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void writeEvent(const void* data, size_t size) const
+    {
+        // 不超过 PIPE_BUF 的写入是原子的；主进程已退出时写入以 EPIPE 失败（SIGPIPE 已屏蔽）
+        while (::write(m_events_fd, data, size) < 0 && errno == EINTR) {
+        }
+    }
+
+    /**
+     * @brief 主进程的监视线程：把监管进程回传的退出事件交给回调，管道关闭后回收监管进程
+     */
+    void monitor(int fd)
+    {
+        ExitEvent event;
+        while (readFull(fd, &event, sizeof(event))) {
+            if (m_on_exit) {
+                m_on_exit(static_cast<size_t>(event.worker), event.pid, event.status, event.respawn != 0);
+            }
+        }
+        ::close(fd);
+        int status = 0;
+        while (::waitpid(m_supervisor_pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        m_supervisor_pid = 0;
+        m_clean_exit = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    /**
+     * @brief fork 一个工作进程（只在监管进程中调用）；子进程中执行工作函数后以 0 退出
+     */
+    bool spawn(size_t worker)
+    {
+        for (size_t s = 0; s < m_slots_per_worker; ++s) {
+            counters(worker, s)->active.store(0, std::memory_order_relaxed);
+        }
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            return false;
+        }
+        if (pid == 0) {
+            m_worker_index = worker;
+            ::close(m_events_fd);
+            ::sigprocmask(SIG_SETMASK, &m_worker_mask, nullptr);
+#if defined(__linux__)
+            ::prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+            if (::getppid() != m_supervisor_self) {
+                ::_exit(1);
+            }
+            m_main(worker);
+            ::_exit(0);
+        }
+        Slot& slot = m_slots[worker];
+        slot.pid = pid;
+        slot.started_at = Clock::now();
+        slot.respawn = false;
+        m_infos[worker].pid.store(pid, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 回收已退出的工作进程
+     * @return 仍在运行的工作进程数
+     */
+    size_t reap()
+    {
+        size_t alive = 0;
+        for (size_t w = 0; w < m_slots.size(); ++w) {
+            Slot& slot = m_slots[w];
+            if (slot.pid <= 0) {
+                continue;
+            }
+            int status = 0;
+            const pid_t rc = ::waitpid(slot.pid, &status, WNOHANG);
+            if (rc == 0 || (rc < 0 && errno == EINTR)) {
+                ++alive;
+                continue;
+            }
+            const bool crashed = rc < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+            const bool respawn = crashed && !stopping();
+            const pid_t pid = slot.pid;
+            slot.pid = 0;
+            m_infos[w].pid.store(0, std::memory_order_relaxed);
+            if (respawn) {
+                const auto now = Clock::now();
+                slot.respawn = true;
+                slot.respawn_at = now - slot.started_at < kMinUptime ? slot.started_at + kMinUptime : now;
+            }
+            const ExitEvent event{w, pid, status, static_cast<uint8_t>(respawn ? 1 : 0)};
+            writeEvent(&event, sizeof(event));
+        }
+        return alive;
+    }
+
+    void signalAll(int signo)
+    {
+        for (const Slot& slot : m_slots) {
+            if (slot.pid > 0) {
+                ::kill(slot.pid, signo);
+            }
+        }
+    }
+
+    /**
+     * @brief 监管进程入口：fork 工作进程，轮询回收与重启，按共享内存中的指令停止；不返回
+     * @details 屏蔽 SIGINT / SIGTERM（终端信号不应杀死监管进程），工作进程 fork 后恢复原屏蔽字；
+     *          以 0 退出表示停止时无需 SIGKILL
+     */
+    [[noreturn]] void supervise()
+    {
+#if defined(__linux__)
+        ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+        if (::getppid() != m_master_pid) {
+            ::_exit(1);
+        }
+        m_supervisor_self = ::getpid();
+        sigset_t blocked;
+        sigemptyset(&blocked);
+        sigaddset(&blocked, SIGINT);
+        sigaddset(&blocked, SIGTERM);
+        sigaddset(&blocked, SIGPIPE);
+        ::sigprocmask(SIG_BLOCK, &blocked, &m_worker_mask);
+
+        uint8_t started = 1;
+        for (size_t w = 0; w < m_slots.size(); ++w) {
+            if (!spawn(w)) {
+                signalAll(SIGKILL);
+                for (Slot& slot : m_slots) {
+                    if (slot.pid > 0) {
+                        ::waitpid(slot.pid, nullptr, 0);
+                        slot.pid = 0;
+                    }
+                }
+                started = 0;
+                writeEvent(&started, sizeof(started));
+                ::_exit(1);
+            }
+        }
+        writeEvent(&started, sizeof(started));
+
+        bool terminated = false;
+        bool killed = false;
+        while (true) {
+            const size_t alive = reap();
+            if (stopping()) {
+                if (alive == 0) {
+                    break;
+                }
+                if (!terminated) {
+                    signalAll(SIGTERM);
+                    terminated = true;
+                }
+                const int64_t kill_at = m_control->kill_at.load(std::memory_order_acquire);
+                if (!killed && kill_at != kNever && Clock::now().time_since_epoch().count() >= kill_at) {
+                    signalAll(SIGKILL);
+                    killed = true;
+                }
+            } else {
+                const auto now = Clock::now();
+                for (size_t w = 0; w < m_slots.size(); ++w) {
+                    Slot& slot = m_slots[w];
+                    if (slot.respawn && now >= slot.respawn_at && spawn(w)) {
+                        m_infos[w].restarts.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+            std::this_thread::sleep_for(kPollInterval);
+        }
+        ::_exit(killed ? 1 : 0);
+    }
+
+    WorkerMain m_main;
+    ExitHook m_on_exit;
+    std::thread m_monitor;                      ///< 主进程中读取退出事件的监视线程
+    std::vector<Slot> m_slots;                  ///< 各工作进程状态（仅监管进程访问）
+    bool m_clean_exit = true;                   ///< 停止时是否无需 SIGKILL
+    pid_t m_master_pid = 0;
+    pid_t m_supervisor_pid = 0;                 ///< 主进程中记录的监管进程号
+    pid_t m_supervisor_self = 0;                ///< 监管进程中记录的自身进程号（工作进程据此确认父进程）
+    int m_events_fd = -1;                       ///< 监管进程中退出事件管道的写端
+    sigset_t m_worker_mask{};                   ///< 工作进程恢复的信号屏蔽字（start() 调用线程的屏蔽字）
+    std::optional<size_t> m_worker_index;       ///< 工作进程内为自身下标
+
+    void* m_segment = nullptr;                  ///< 共享计数器段
+    size_t m_segment_bytes = 0;
+    size_t m_workers = 0;
+    size_t m_slots_per_worker = 0;
+    Control* m_control = nullptr;
+    WorkerInfo* m_infos = nullptr;
+    HttpWorkerCounters* m_counters = nullptr;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_WORKER_POOL_H
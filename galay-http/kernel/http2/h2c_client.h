@@ -15,6 +15,7 @@
 #include "http2_stream.h"
 #include "stream_mgr.h"
 #include "galay-http/kernel/iov_utils.h"
+#include "galay-http/kernel/http/socket_addr.h"
 #include "galay-http/protoc/http/http_request.h"
 #include "galay-http/protoc/http/http_response.h"
 #include "galay-http/utils/req_bld.h"
@@ -29,6 +30,7 @@
 #include <algorithm>
 #include <string>
 #include <cstring>
+#include <expected>
 #include <optional>
 #include <span>
 
@@ -99,17 +101,38 @@ public:
     H2cClient& operator=(H2cClient&&) noexcept = default;
 
     auto connect(const std::string& host, uint16_t port) {
-        m_host = host;
+        const auto address = galay::http::HttpSocketAddress::parse(host, port);
+        const IPType ip_type = address.isIPv6() ? IPType::IPV6 : IPType::IPV4;
+        m_host = address.host;
         m_port = port;
-        m_authority = m_host + ":" + std::to_string(m_port);
-        m_socket = std::make_unique<TcpSocket>(IPType::IPV4);
+        m_authority = address.authority();
+        m_socket = std::make_unique<TcpSocket>(ip_type);
         m_ring_buffer = std::make_unique<RingBuffer>(m_ring_buffer_size);
         auto r = m_socket->option().handleNonBlock();
         if (!r) throw std::runtime_error("Failed to set non-blocking: " + r.error().message());
-        Host server_host(IPType::IPV4, host, port);
+        Host server_host(ip_type, m_host, port);
         return m_socket->connect(server_host);
     }
 
+    /**
+     * @brief 经 Unix domain socket 连接（非阻塞连接立即完成或失败，无需 co_await）
+     * @param path socket 文件路径（`@` 开头为抽象命名空间）
+     * @return 成功返回空值；失败返回错误，对端监听队列已满时 `retryable` 为 true。:authority 使用 localhost
+     */
+    std::expected<void, galay::http::HttpUnixConnectError> connectUnix(const std::string& path) {
+        galay::http::HttpUnixConnectError error;
+        const int fd = galay::http::detail::connectUnixStream(path, error.message, &error.retryable);
+        if (fd < 0) {
+            return std::unexpected(std::move(error));
+        }
+        m_host = "localhost";
+        m_port = 0;
+        m_authority = m_host;
+        m_socket = std::make_unique<TcpSocket>(GHandle{fd});
+        m_ring_buffer = std::make_unique<RingBuffer>(m_ring_buffer_size);
+        return {};
+    }
+
     H2cUpgradeAwaitable upgrade(const std::string& path = "/");
     Http2Stream::ptr get(const std::string& path);
     Http2Stream::ptr post(const std::string& path,
@@ -1072,7 +1072,7 @@ public:
      */
     Http2ConnImpl(galay::http::HttpConnImpl<SocketType>&& http_conn)
         : m_socket(std::move(http_conn.m_socket))
-        , m_ring_buffer(std::move(http_conn.m_ring_buffer))
+        , m_ring_buffer(std::move(http_conn.ringBuffer()))
         , m_last_peer_stream_id(0)
         , m_last_local_stream_id(0)
         , m_conn_send_window(kDefaultInitialWindowSize)
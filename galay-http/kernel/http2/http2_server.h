@@ -22,12 +22,18 @@
 #include "galay-http/protoc/http/http_request.h"
 #include "galay-http/common/http_log.h"
 #include "galay-http/kernel/http/http_conn.h"
+#include "galay-http/kernel/http/http_listener.h"
+#include "galay-http/kernel/http/compute_offload.h"
+#include "galay-http/kernel/http/admission.h"
+#include "galay-http/kernel/http/conn_balancer.h"
+#include "galay-http/kernel/http/server_drain.h"
 #include "galay-http/utils/rsp_bld.h"
 #include "galay-kernel/async/tcp_socket.h"
 #include "galay-kernel/kernel/runtime.h"
 #ifdef GALAY_HTTP_SSL_ENABLED
 #include "galay-ssl/ssl/ssl_context.h"
 #include "galay-ssl/async/ssl_socket.h"
+#include "galay-http/kernel/http/tls_session.h"
 #include <openssl/ssl.h>
 #endif
 #include <memory>
@@ -104,12 +110,18 @@ using Http2ConnectionHandler = Http2StreamHandler;
  */
 struct H2cServerConfig
 {
-    std::string host = "0.0.0.0";
+    std::string host = "0.0.0.0";              // IPv4/IPv6 字面量或 unix:/path
     uint16_t port = 8080;
     int backlog = 128;
+    bool ipv6_only = false;                     // IPv6 监听时是否设置 IPV6_V6ONLY（默认双栈）
     size_t io_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO;
     size_t compute_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO;
     RuntimeAffinityConfig affinity;
+    bool reuseport_cpu_steering = true;         // IO 调度器绑核时按接收 CPU 选择 listener
+    galay::http::HttpAdmissionConfig admission; // 连接上限、在途流上限与排队削峰（默认关闭）
+    size_t accept_batch = 1;                    // 每次 accept 唤醒最多取出的连接数（1 为不批量）
+    galay::http::HttpSocketTuning tuning;       // 监听 socket 与已 accept 连接的内核选项（默认不设置）
+    std::string handoff_path;                   // 监听 fd 交接用的 Unix socket 路径（为空不交接）
 
     // HTTP/2 设置
     uint32_t max_concurrent_streams = 100;
@@ -138,6 +150,12 @@ public:
     H2cServerBuilder& host(std::string v)              { m_config.host = std::move(v); return *this; }
     H2cServerBuilder& port(uint16_t v)                 { m_config.port = v; return *this; }
     H2cServerBuilder& backlog(int v)                   { m_config.backlog = v; return *this; }
+    H2cServerBuilder& ipv6Only(bool v)                 { m_config.ipv6_only = v; return *this; }
+    H2cServerBuilder& reuseportCpuSteering(bool v)     { m_config.reuseport_cpu_steering = v; return *this; }
+    H2cServerBuilder& admission(galay::http::HttpAdmissionConfig v) { m_config.admission = v; return *this; }
+    H2cServerBuilder& acceptBatch(size_t v)            { m_config.accept_batch = v; return *this; }
+    H2cServerBuilder& socketTuning(galay::http::HttpSocketTuning v) { m_config.tuning = v; return *this; }
+    H2cServerBuilder& handoffPath(std::string v)       { m_config.handoff_path = std::move(v); return *this; }
     H2cServerBuilder& ioSchedulerCount(size_t v)       { m_config.io_scheduler_count = v; return *this; }
     H2cServerBuilder& computeSchedulerCount(size_t v)  { m_config.compute_scheduler_count = v; return *this; }
     H2cServerBuilder& maxConcurrentStreams(uint32_t v)  { m_config.max_concurrent_streams = v; return *this; }
@@ -231,29 +249,6 @@ inline std::string drainRingBuffer(RingBuffer& rb) {
     return data;
 }
 
-inline void wakeTcpAcceptLoops(const std::string& host, uint16_t port, size_t attempts) {
-    if (attempts == 0 || port == 0) {
-        return;
-    }
-
-    const std::string wake_host =
-        (host.empty() || host == "0.0.0.0" || host == "::") ? "127.0.0.1" : host;
-    for (size_t i = 0; i < attempts; ++i) {
-        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
-        if (fd < 0) {
-            return;
-        }
-
-        sockaddr_in addr{};
-        addr.sin_family = AF_INET;
-        addr.sin_port = htons(port);
-        if (::inet_pton(AF_INET, wake_host.c_str(), &addr.sin_addr) == 1) {
-            (void)::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
-        }
-        ::close(fd);
-    }
-}
-
 inline void waitForLoopDrain(const std::atomic<size_t>& loop_count,
                              std::chrono::milliseconds timeout) {
     const auto deadline = std::chrono::steady_clock::now() + timeout;
@@ -321,11 +316,14 @@ public:
         m_running.store(false);
         HTTP_LOG_INFO("[h2c] [server] [stopping]", "port={}", m_config.port);
 
-        wakeTcpAcceptLoops(m_config.host,
-                           m_config.port,
-                           m_server_loop_count.load(std::memory_order_acquire));
+        if (!m_drain.handedOff()) {
+            m_listen.detachSteering();
+            m_listen.wakeAcceptLoops(m_server_loop_count.load(std::memory_order_acquire));
+        }
         waitForLoopDrain(m_server_loop_count, std::chrono::milliseconds(100));
         m_runtime.stop();
+        m_listen.close();
+        m_drain.onStopped();
         HTTP_LOG_INFO("[h2c] [server] [stopped]", "port={}", m_config.port);
     }
     
@@ -337,6 +335,56 @@ public:
         return m_runtime;
     }
 
+    galay::http::HttpAcceptStats acceptStats() const {
+        return m_listen.acceptStats();
+    }
+
+    galay::http::HttpAdmissionStats admissionStats() const {
+        return m_admission.snapshot();
+    }
+
+    /**
+     * @brief 开始排空：停止 accept，各连接发送 GOAWAY，在途流结束后关闭
+     * @details 非阻塞，可重复调用；监听 fd 已交给新进程时不唤醒 accept 循环
+     */
+    void beginDrain() {
+        if (!m_running.load() || !m_drain.begin(m_runtime)) {
+            return;
+        }
+        HTTP_LOG_INFO("[h2c] [drain]", "active={} handed_off={}",
+                      m_drain.activeConnections(), m_drain.handedOff());
+        if (!m_drain.handedOff()) {
+            m_listen.detachSteering();
+            m_listen.wakeAcceptLoops(m_server_loop_count.load(std::memory_order_acquire));
+        }
+    }
+
+    /**
+     * @brief 排空后停止服务器
+     * @return 超时前全部连接已结束返回 true
+     */
+    bool gracefulStop(std::chrono::milliseconds timeout) {
+        if (!m_running.load()) {
+            return true;
+        }
+        beginDrain();
+        const bool drained = m_drain.waitIdle(timeout);
+        stop();
+        return drained;
+    }
+
+    bool draining() const {
+        return m_drain.draining();
+    }
+
+    bool handedOff() const {
+        return m_drain.handedOff();
+    }
+
+    size_t activeConnections() const {
+        return m_drain.activeConnections();
+    }
+
 private:
     bool startInternal() {
         if (m_running.load()) {
@@ -349,6 +397,19 @@ private:
             return false;
         }
 
+        const size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
+        std::vector<int> steer_cpus;
+        if (m_config.reuseport_cpu_steering) {
+            steer_cpus = galay::http::pinnedIoSchedulerCpus(m_config.affinity, io_scheduler_count);
+        }
+        m_drain.reset(m_config.handoff_path);
+        m_drain.prepareListen(m_listen);
+        if (!m_listen.open(m_config.host, m_config.port, m_config.backlog, m_config.ipv6_only,
+                           io_scheduler_count, steer_cpus, m_config.tuning)) {
+            return false;
+        }
+        m_admission.reset(io_scheduler_count, m_config.admission);
+
         m_runtime.start();
 
         m_running.store(true);
@@ -358,11 +419,10 @@ private:
                       m_config.port);
 
         // Spawn one serverLoop per IO scheduler with SO_REUSEPORT
-        size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
         for (size_t i = 0; i < io_scheduler_count; i++) {
             auto* scheduler = m_runtime.getIOScheduler(i);
             if (scheduler) {
-                auto loop = serverLoop(scheduler);
+                auto loop = serverLoop(scheduler, i);
                 m_server_loop_count.fetch_add(1, std::memory_order_acq_rel);
                 if (!scheduleTask(scheduler, std::move(loop))) {
                     m_server_loop_count.fetch_sub(1, std::memory_order_acq_rel);
@@ -371,94 +431,85 @@ private:
                 }
             }
         }
+        m_drain.onStarted(m_runtime, m_listen, [this] { beginDrain(); });
 
         return true;
     }
 
-    Task<void> serverLoop(IOScheduler* scheduler) {
+    Task<void> serverLoop(IOScheduler* scheduler, size_t index) {
         struct LoopExitGuard {
             H2cServer* server;
             ~LoopExitGuard() {
                 server->m_server_loop_count.fetch_sub(1, std::memory_order_acq_rel);
             }
         } guard{this};
-
-        // Each serverLoop creates its own listener socket
-        TcpSocket listener(IPType::IPV4);
-
-        auto reuse_result = listener.option().handleReuseAddr();
-        if (!reuse_result) {
-            HTTP_LOG_ERROR("[socket] [reuseaddr-fail]",
-                           "error={}",
-                           reuse_result.error().message());
-            co_return;
-        }
-
-        auto reuse_port_result = listener.option().handleReusePort();
-        if (!reuse_port_result) {
-            HTTP_LOG_ERROR("[socket] [reuseport-fail]",
-                           "error={}",
-                           reuse_port_result.error().message());
-            co_return;
-        }
-
-        auto nonblock_result = listener.option().handleNonBlock();
-        if (!nonblock_result) {
-            HTTP_LOG_ERROR("[socket] [nonblock-fail]",
-                           "error={}",
-                           nonblock_result.error().message());
-            co_return;
-        }
-
-        Host bind_host(IPType::IPV4, m_config.host, m_config.port);
-        auto bind_result = listener.bind(bind_host);
-        if (!bind_result) {
-            HTTP_LOG_ERROR("[bind] [fail]",
-                           "host={} port={} error={}",
-                           m_config.host,
-                           m_config.port,
-                           bind_result.error().message());
-            co_return;
-        }
-
-        auto listen_result = listener.listen(m_config.backlog);
-        if (!listen_result) {
-            HTTP_LOG_ERROR("[listen] [fail]",
-                           "error={}",
-                           listen_result.error().message());
+        galay::http::currentComputeRuntime() = &m_runtime;
+        galay::http::currentSchedulerSlot() = index;
+        galay::http::currentAdmission() = m_admission.enabled() ? &m_admission : nullptr;
+        galay::http::HttpDrainList::local().reset();
+
+        // Each serverLoop creates its own listener socket (unix addresses share one queue)
+        auto listener_opt = m_listen.createListener(index);
+        if (!listener_opt) {
             co_return;
         }
+        TcpSocket& listener = *listener_opt;
+        galay::http::HttpAcceptBatch batch(listener.handle().fd, m_config.accept_batch);
+
+        while (m_running.load() && !m_drain.draining()) {
+            GHandle handle{};
+            const int batched_fd = batch.next();
+            const bool batched = batched_fd >= 0;
+            if (batched) {
+                handle = GHandle{batched_fd};
+            } else {
+                Host client_host;
+                auto accept_result = co_await listener.accept(&client_host);
 
-        while (m_running.load()) {
-            Host client_host;
-            auto accept_result = co_await listener.accept(&client_host);
+                if (!accept_result) {
+                    if (m_running.load()) {
+                        HTTP_LOG_ERROR("[accept] [fail]",
+                                       "error={}",
+                                       accept_result.error().message());
+                    }
+                    continue;
+                }
+                handle = accept_result.value();
+                batch.arm();
 
-            if (!accept_result) {
-                if (m_running.load()) {
-                    HTTP_LOG_ERROR("[accept] [fail]",
+                HTTP_LOG_INFO("[connect] [h2c]",
+                              "ip={} port={}",
+                              client_host.ip(),
+                              client_host.port());
+            }
+            m_listen.recordAccept(index, handle.fd, batched);
+            m_listen.tuneAccepted(handle.fd);
+
+            TcpSocket client_socket(handle);
+            // 批量取出的 fd 已由 accept4 设为非阻塞
+            if (!batched) {
+                auto nonblock_result = client_socket.option().handleNonBlock();
+                if (!nonblock_result) {
+                    HTTP_LOG_ERROR("[socket] [nonblock-fail] [client]",
                                    "error={}",
-                                   accept_result.error().message());
+                                   nonblock_result.error().message());
+                    continue;
                 }
-                continue;
             }
 
-            HTTP_LOG_INFO("[connect] [h2c]",
-                          "ip={} port={}",
-                          client_host.ip(),
-                          client_host.port());
-
-            TcpSocket client_socket(accept_result.value());
-            auto nonblock_result = client_socket.option().handleNonBlock();
-            if (!nonblock_result) {
-                HTTP_LOG_ERROR("[socket] [nonblock-fail] [client]",
-                               "error={}",
-                               nonblock_result.error().message());
+            if (!m_admission.tryOpenConnection(index)) {
+                HTTP_LOG_DEBUG("[admission] [reject]", "reason={} scheduler={}",
+                               galay::http::toString(galay::http::HttpAdmissionVerdict::ConnectionLimit), index);
+                co_await client_socket.close();
                 continue;
             }
 
             // Handle connection on the same scheduler
-            if (!scheduleTask(scheduler, handleConnection(std::move(client_socket)))) {
+            auto task = m_admission.enabled() ? serveAdmitted(index, std::move(client_socket))
+                                              : serveConnection(std::move(client_socket));
+            if (!scheduleTask(scheduler, std::move(task))) {
                 HTTP_LOG_ERROR("[h2c] [schedule-fail]", "handle-connection");
+                m_admission.onConnectionClose(index);
                 co_await client_socket.close();
             }
         }
@@ -472,6 +523,25 @@ private:
         co_return;
     }
     
+    /**
+     * @brief 处理占用了连接配额的连接，结束时归还
+     */
+    Task<void> serveAdmitted(size_t index, TcpSocket socket) {
+        co_await serveConnection(std::move(socket));
+        m_admission.onConnectionClose(index);
+        co_return;
+    }
+
+    /**
+     * @brief 处理连接并计入存活连接数（gracefulStop 据此等待）
+     */
+    Task<void> serveConnection(TcpSocket socket) {
+        m_drain.onConnOpen();
+        co_await handleConnection(std::move(socket));
+        m_drain.onConnClose();
+        co_return;
+    }
+
     /**
      * @brief 处理新连接
      */
@@ -692,6 +762,9 @@ private:
     Http1FallbackHandler m_http1_fallback;
     std::atomic<bool> m_running;
     std::atomic<size_t> m_server_loop_count{0};
+    galay::http::HttpListenEndpoint m_listen;
+    galay::http::HttpServerDrain m_drain;
+    galay::http::HttpAdmissionControl m_admission;
 };
 
 inline H2cServer H2cServerBuilder::build() const { return H2cServer(m_config); }
@@ -702,12 +775,18 @@ inline H2cServer H2cServerBuilder::build() const { return H2cServer(m_config); }
  */
 struct H2ServerConfig
 {
-    std::string host = "0.0.0.0";
+    std::string host = "0.0.0.0";              // IPv4/IPv6 字面量或 unix:/path
     uint16_t port = 9443;
     int backlog = 128;
+    bool ipv6_only = false;                     // IPv6 监听时是否设置 IPV6_V6ONLY（默认双栈）
     size_t io_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO;
     size_t compute_scheduler_count = GALAY_RUNTIME_SCHEDULER_COUNT_AUTO;
     RuntimeAffinityConfig affinity;
+    bool reuseport_cpu_steering = true;         // IO 调度器绑核时按接收 CPU 选择 listener
+    galay::http::HttpAdmissionConfig admission; // 连接上限、在途流上限与排队削峰（默认关闭）
+    size_t accept_batch = 1;                    // 每次 accept 唤醒最多取出的连接数（1 为不批量）
+    galay::http::HttpSocketTuning tuning;       // 监听 socket 与已 accept 连接的内核选项（默认不设置）
+    std::string handoff_path;                   // 监听 fd 交接用的 Unix socket 路径（为空不交接）
 
     // SSL 配置
     std::string cert_path;
@@ -715,6 +794,7 @@ struct H2ServerConfig
     std::string ca_path;
     bool verify_peer = false;
     int verify_depth = 4;
+    galay::http::HttpTlsSessionConfig tls_session; // 会话恢复：轮换密钥的票据（默认开启）与分片会话缓存（默认关闭）
 
     // HTTP/2 设置
     uint32_t max_concurrent_streams = 100;
@@ -743,6 +823,12 @@ public:
     H2ServerBuilder& host(std::string v)              { m_config.host = std::move(v); return *this; }
     H2ServerBuilder& port(uint16_t v)                 { m_config.port = v; return *this; }
     H2ServerBuilder& backlog(int v)                   { m_config.backlog = v; return *this; }
+    H2ServerBuilder& ipv6Only(bool v)                 { m_config.ipv6_only = v; return *this; }
+    H2ServerBuilder& reuseportCpuSteering(bool v)     { m_config.reuseport_cpu_steering = v; return *this; }
+    H2ServerBuilder& admission(galay::http::HttpAdmissionConfig v) { m_config.admission = v; return *this; }
+    H2ServerBuilder& acceptBatch(size_t v)            { m_config.accept_batch = v; return *this; }
+    H2ServerBuilder& socketTuning(galay::http::HttpSocketTuning v) { m_config.tuning = v; return *this; }
+    H2ServerBuilder& handoffPath(std::string v)        { m_config.handoff_path = std::move(v); return *this; }
     H2ServerBuilder& ioSchedulerCount(size_t v)       { m_config.io_scheduler_count = v; return *this; }
     H2ServerBuilder& computeSchedulerCount(size_t v)  { m_config.compute_scheduler_count = v; return *this; }
     H2ServerBuilder& sequentialAffinity(size_t io_count, size_t compute_count) {
@@ -766,6 +852,7 @@ public:
     H2ServerBuilder& caPath(std::string v)            { m_config.ca_path = std::move(v); return *this; }
     H2ServerBuilder& verifyPeer(bool v)               { m_config.verify_peer = v; return *this; }
     H2ServerBuilder& verifyDepth(int v)               { m_config.verify_depth = v; return *this; }
+    H2ServerBuilder& tlsSession(galay::http::HttpTlsSessionConfig v) { m_config.tls_session = std::move(v); return *this; }
     H2ServerBuilder& maxConcurrentStreams(uint32_t v) { m_config.max_concurrent_streams = v; return *this; }
     H2ServerBuilder& initialWindowSize(uint32_t v)    { m_config.initial_window_size = v; return *this; }
     H2ServerBuilder& maxFrameSize(uint32_t v)         { m_config.max_frame_size = v; return *this; }
@@ -848,11 +935,14 @@ public:
         }
 
         m_running.store(false);
-        wakeTcpAcceptLoops(m_config.host,
-                           m_config.port,
-                           m_server_loop_count.load(std::memory_order_acquire));
+        if (!m_drain.handedOff()) {
+            m_listen.detachSteering();
+            m_listen.wakeAcceptLoops(m_server_loop_count.load(std::memory_order_acquire));
+        }
         waitForLoopDrain(m_server_loop_count, std::chrono::milliseconds(100));
         m_runtime.stop();
+        m_listen.close();
+        m_drain.onStopped();
     }
 
     bool isRunning() const {
@@ -863,6 +953,60 @@ public:
         return m_runtime;
     }
 
+    galay::http::HttpAcceptStats acceptStats() const {
+        return m_listen.acceptStats();
+    }
+
+    galay::http::HttpAdmissionStats admissionStats() const {
+        return m_admission.snapshot();
+    }
+
+    /**
+     * @brief 开始排空：停止 accept，各连接发送 GOAWAY，在途流结束后关闭
+     * @details 非阻塞，可重复调用；监听 fd 已交给新进程时不唤醒 accept 循环
+     */
+    void beginDrain() {
+        if (!m_running.load() || !m_drain.begin(m_runtime)) {
+            return;
+        }
+        HTTP_LOG_INFO("[h2] [drain]", "active={} handed_off={}",
+                      m_drain.activeConnections(), m_drain.handedOff());
+        if (!m_drain.handedOff()) {
+            m_listen.detachSteering();
+            m_listen.wakeAcceptLoops(m_server_loop_count.load(std::memory_order_acquire));
+        }
+    }
+
+    /**
+     * @brief 排空后停止服务器
+     * @return 超时前全部连接已结束返回 true
+     */
+    bool gracefulStop(std::chrono::milliseconds timeout) {
+        if (!m_running.load()) {
+            return true;
+        }
+        beginDrain();
+        const bool drained = m_drain.waitIdle(timeout);
+        stop();
+        return drained;
+    }
+
+    bool draining() const {
+        return m_drain.draining();
+    }
+
+    bool handedOff() const {
+        return m_drain.handedOff();
+    }
+
+    size_t activeConnections() const {
+        return m_drain.activeConnections();
+    }
+
+    galay::http::HttpTlsSessionStats tlsSessionStats() const {
+        return m_tls_sessions.snapshot();
+    }
+
 private:
     static constexpr uint64_t kLowLatencyIoTimerTickNs = 1000000ULL;
 
@@ -918,16 +1062,27 @@ private:
         if (!initSslContext()) {
             return false;
         }
+        const size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
+        std::vector<int> steer_cpus;
+        if (m_config.reuseport_cpu_steering) {
+            steer_cpus = galay::http::pinnedIoSchedulerCpus(m_config.affinity, io_scheduler_count);
+        }
+        m_drain.reset(m_config.handoff_path);
+        m_drain.prepareListen(m_listen);
+        if (!m_listen.open(m_config.host, m_config.port, m_config.backlog, m_config.ipv6_only,
+                           io_scheduler_count, steer_cpus, m_config.tuning)) {
+            return false;
+        }
+        m_admission.reset(io_scheduler_count, m_config.admission);
 
         m_runtime.start();
         configureLowLatencyIoTimers();
         m_running.store(true);
 
-        size_t io_scheduler_count = m_runtime.getIOSchedulerCount();
         for (size_t i = 0; i < io_scheduler_count; i++) {
             auto* scheduler = m_runtime.getIOScheduler(i);
             if (scheduler) {
-                auto loop = serverLoop(scheduler);
+                auto loop = serverLoop(scheduler, i);
                 m_server_loop_count.fetch_add(1, std::memory_order_acq_rel);
                 if (!scheduleTask(scheduler, std::move(loop))) {
                     m_server_loop_count.fetch_sub(1, std::memory_order_acq_rel);
@@ -935,6 +1090,7 @@ private:
                 }
             }
         }
+        m_drain.onStarted(m_runtime, m_listen, [this] { beginDrain(); });
         return true;
     }
 
@@ -977,68 +1133,85 @@ private:
         }
         SSL_CTX_set_alpn_select_cb(m_ssl_ctx.native(), &H2Server::selectH2AlpnCallback, nullptr);
 
+        std::string session_error;
+        if (!m_tls_sessions.install(m_ssl_ctx.native(), m_config.tls_session,
+                                    m_runtime.getIOSchedulerCount(), session_error)) {
+            HTTP_LOG_ERROR("[h2] [ssl] [session] [fail]", "error={}", session_error);
+            return false;
+        }
+
         return true;
     }
 
-    Task<void> serverLoop(IOScheduler* scheduler) {
+    Task<void> serverLoop(IOScheduler* scheduler, size_t index) {
         struct LoopExitGuard {
             H2Server* server;
             ~LoopExitGuard() {
                 server->m_server_loop_count.fetch_sub(1, std::memory_order_acq_rel);
             }
         } guard{this};
+        galay::http::currentComputeRuntime() = &m_runtime;
+        galay::http::currentSchedulerSlot() = index;
+        galay::http::currentAdmission() = m_admission.enabled() ? &m_admission : nullptr;
+        galay::http::HttpDrainList::local().reset();
 
-        TcpSocket listener(IPType::IPV4);
-
-        auto reuse_result = listener.option().handleReuseAddr();
-        if (!reuse_result) {
-            co_return;
-        }
-
-        auto reuse_port_result = listener.option().handleReusePort();
-        if (!reuse_port_result) {
-            co_return;
-        }
-
-        auto nonblock_result = listener.option().handleNonBlock();
-        if (!nonblock_result) {
-            co_return;
-        }
-
-        Host bind_host(IPType::IPV4, m_config.host, m_config.port);
-        auto bind_result = listener.bind(bind_host);
-        if (!bind_result) {
-            co_return;
-        }
-
-        auto listen_result = listener.listen(m_config.backlog);
-        if (!listen_result) {
+        auto listener_opt = m_listen.createListener(index);
+        if (!listener_opt) {
             co_return;
         }
-
-        while (m_running.load()) {
-            Host client_host;
-            auto accept_result = co_await listener.accept(&client_host);
-            if (!accept_result) {
-                if (m_running.load()) {
+        TcpSocket& listener = *listener_opt;
+        galay::http::HttpAcceptBatch batch(listener.handle().fd, m_config.accept_batch);
+        const size_t io_count = m_runtime.getIOSchedulerCount();
+        size_t next_target = index;     // 本 accept 循环的轮转位置，从自身下标开始错开
+
+        while (m_running.load() && !m_drain.draining()) {
+            GHandle handle{};
+            const int batched_fd = batch.next();
+            const bool batched = batched_fd >= 0;
+            if (batched) {
+                handle = GHandle{batched_fd};
+            } else {
+                Host client_host;
+                auto accept_result = co_await listener.accept(&client_host);
+                if (!accept_result) {
+                    if (m_running.load()) {
+                    }
+                    continue;
                 }
-                continue;
+                handle = accept_result.value();
+                batch.arm();
             }
+            m_listen.recordAccept(index, handle.fd, batched);
+            m_listen.tuneAccepted(handle.fd);
 
-            galay::ssl::SslSocket client_socket(&m_ssl_ctx, accept_result.value());
-            auto nonblock_result = client_socket.option().handleNonBlock();
-            if (!nonblock_result) {
+            galay::ssl::SslSocket client_socket(&m_ssl_ctx, handle);
+            if (!batched && !client_socket.option().handleNonBlock()) {
                 continue;
             }
             auto nodelay_result = client_socket.option().handleTcpNoDelay();
             if (!nodelay_result) {
             }
-
-            auto* target_scheduler = m_runtime.getNextIOScheduler();
-            if (target_scheduler == nullptr) {
-                target_scheduler = scheduler;
+            // 先确定处理连接的调度器，连接配额记在该调度器上；按接收 CPU 分发时连接已落在本核调度器上，不再轮转
+            size_t target_index = index;
+            IOScheduler* target_scheduler = scheduler;
+            if (!m_listen.cpuSteering() && io_count > 1) {
+                next_target = (next_target + 1) % io_count;
+                if (auto* next = m_runtime.getIOScheduler(next_target)) {
+                    target_index = next_target;
+                    target_scheduler = next;
+                }
+            }
+            if (!m_admission.tryOpenConnection(target_index)) {
+                HTTP_LOG_DEBUG("[admission] [reject]", "reason={} scheduler={}",
+                               galay::http::toString(galay::http::HttpAdmissionVerdict::ConnectionLimit),
+                               target_index);
+                co_await client_socket.close();
+                continue;
             }
-            if (!scheduleTask(target_scheduler, handleConnection(std::move(client_socket)))) {
+            auto task = m_admission.enabled() ? serveAdmitted(target_index, std::move(client_socket))
+                                              : serveConnection(std::move(client_socket));
+            if (!scheduleTask(target_scheduler, std::move(task))) {
+                m_admission.onConnectionClose(target_index);
                 co_await client_socket.close();
             }
         }
@@ -1065,6 +1238,19 @@ private:
         co_return;
     }
 
+    Task<void> serveAdmitted(size_t index, galay::ssl::SslSocket socket) {
+        co_await serveConnection(std::move(socket));
+        m_admission.onConnectionClose(index);
+        co_return;
+    }
+
+    Task<void> serveConnection(galay::ssl::SslSocket socket) {
+        m_drain.onConnOpen();
+        co_await handleConnection(std::move(socket));
+        m_drain.onConnClose();
+        co_return;
+    }
+
     Task<void> handleConnection(galay::ssl::SslSocket socket) {
         auto handshake_result = co_await socket.handshake();
         if (!handshake_result) {
@@ -1126,6 +1312,10 @@ private:
     std::function<Task<void>(galay::http::HttpConnImpl<galay::ssl::SslSocket>)> m_http1_fallback;
     std::atomic<bool> m_running;
     std::atomic<size_t> m_server_loop_count{0};
+    galay::http::HttpListenEndpoint m_listen;
+    galay::http::HttpServerDrain m_drain;
+    galay::http::HttpAdmissionControl m_admission;
+    galay::http::HttpTlsSessionManager m_tls_sessions;  // 先于 m_ssl_ctx 构造、后于其析构
     galay::ssl::SslContext m_ssl_ctx;
 };
 
@@ -16,6 +16,7 @@
 #include "galay-http/protoc/http2/http2_frame.h"
 #include "galay-http/protoc/http2/http2_hpack.h"
 #include "galay-http/protoc/http2/http2_error.h"
+#include "galay-http/kernel/http/compute_offload.h"
 #include "galay-kernel/concurrency/async_waiter.h"
 #include "galay-kernel/concurrency/mpsc_channel.h"
 #include "galay-kernel/concurrency/unsafe_channel.h"
@@ -862,6 +863,16 @@ public:
         return m_response_waiter.wait();
     }
 
+    /**
+     * @brief 在计算调度器上执行 CPU 密集段，完成后回到本流所在的 IO 调度器
+     * @details 等价于 galay::http::offload；fn 在计算线程上运行，不得访问本流，
+     *          期间对端可能已发送 RST_STREAM，恢复后应先检查 state() 再回复
+     */
+    template<typename F>
+    galay::http::OffloadAwaitable<std::decay_t<F>> offload(F&& fn) {
+        return galay::http::OffloadAwaitable<std::decay_t<F>>(std::forward<F>(fn));
+    }
+
     // ==================== 发送接口 ====================
 
     /**
@@ -16,6 +16,10 @@
 #include "galay-http/protoc/http2/http2_base.h"
 #include "galay-http/protoc/http2/http2_frame.h"
 #include "galay-http/kernel/iov_utils.h"
+#include "galay-http/kernel/wheel_driver.h"
+#include "galay-http/kernel/graceful_drain.h"
+#include "galay-http/kernel/http/admission.h"
+#include "galay-http/kernel/http/conn_balancer.h"
 #include "galay-kernel/concurrency/async_waiter.h"
 #include "galay-kernel/concurrency/mpsc_channel.h"
 #include "galay-kernel/common/sleep.hpp"
@@ -528,8 +532,13 @@ private:
         m_active_stream_mailbox.reset();
         m_draining_handlers.store(false, std::memory_order_release);
         m_reject_new_streams = false;
+        m_drain_phase = DrainPhase::None;
         m_last_frame_recv_at = std::chrono::steady_clock::now();
         m_waiting_ping_ack = false;
+        // 服务端流按所在调度器的准入控制放行；客户端不受限
+        auto* admission = galay::http::currentAdmission();
+        m_admission = !m_conn.isClient() && admission != nullptr && admission->enabled() ? admission : nullptr;
+        m_admission_slot = galay::http::currentSchedulerSlot();
 
         if (m_next_local_stream_id == 0) {
             m_next_local_stream_id = m_conn.isClient() ? 3 : 2;
@@ -562,6 +571,7 @@ private:
         }
 
         m_running = false;
+        m_monitor_waiter.wake();
         m_send_channel.send(Http2OutgoingFrame{});
         co_await m_writer_done.wait();
         co_await m_monitor_done.wait();
@@ -576,6 +586,7 @@ private:
         }
 
         m_running = false;
+        m_monitor_waiter.wake();
         co_await m_monitor_done.wait();
         m_stop_waiter.notify();
         co_return;
@@ -590,6 +601,7 @@ private:
         }
 
         m_running = false;
+        m_monitor_waiter.wake();
         m_send_channel.send(Http2OutgoingFrame{});
         co_await m_writer_done.wait();
         co_await m_monitor_done.wait();
@@ -606,6 +618,7 @@ private:
         }
 
         m_running = false;
+        m_monitor_waiter.wake();
         co_await m_monitor_done.wait();
         m_stop_waiter.notify();
         co_return;
@@ -636,6 +649,36 @@ private:
     static constexpr auto kSslIoOwnerHotWaitInterval = std::chrono::milliseconds(1);
     static constexpr auto kSslIoOwnerActivePollInterval = std::chrono::milliseconds(5);
     static constexpr auto kSslIoOwnerIdlePollInterval = std::chrono::milliseconds(50);
+    static constexpr auto kMonitorRecheckInterval = std::chrono::milliseconds(1000);
+    static constexpr auto kDrainPollInterval = std::chrono::milliseconds(100);
+
+    /**
+     * @brief 服务器排空进度：Requested 由排空表回调设置，其余由 monitorLoop 推进
+     */
+    enum class DrainPhase : uint8_t {
+        None,
+        Requested,      ///< 待发送 GOAWAY(MAX)
+        Announced,      ///< 已发送 GOAWAY(MAX)，等待 graceful_shutdown_rtt
+        Sent,           ///< 已发送 GOAWAY(last_stream_id)，等待在途流结束
+    };
+
+    /**
+     * @brief 服务端连接挂到所在调度器排空表上的节点
+     */
+    struct MonitorDrainNode : galay::http::HttpDrainList::Node {
+        explicit MonitorDrainNode(Http2StreamManagerImpl* manager)
+            : Node(&MonitorDrainNode::onDrain), owner(manager) {}
+
+        static void onDrain(Node& node) {
+            auto* manager = static_cast<MonitorDrainNode&>(node).owner;
+            if (manager->m_drain_phase == DrainPhase::None) {
+                manager->m_drain_phase = DrainPhase::Requested;
+                manager->m_monitor_waiter.wake();
+            }
+        }
+
+        Http2StreamManagerImpl* owner;
+    };
 
     void collectOutgoingFrame(Http2OutgoingFrame&& item,
                               std::vector<Http2OutgoingFrame>& outgoing_batch,
@@ -862,7 +905,7 @@ private:
                         auto stream = m_pending_spawns.top();
                         m_pending_spawns.pop();
                         m_active_handlers.fetch_add(1, std::memory_order_acq_rel);
-                        co_await startDetachedTask(runHandler(handler, stream));
+                        co_await startDetachedTask(runHandler(handler, stream, spawnedAt()));
                     }
 
                     if (exit_loop) {
@@ -928,7 +971,7 @@ private:
                 auto stream = m_pending_spawns.top();
                 m_pending_spawns.pop();
                 m_active_handlers.fetch_add(1, std::memory_order_acq_rel);
-                co_await startDetachedTask(runHandler(handler, stream));
+                co_await startDetachedTask(runHandler(handler, stream, spawnedAt()));
             }
 
             if (exit_loop) {
@@ -1105,7 +1148,7 @@ private:
                     auto stream = m_pending_spawns.top();
                     m_pending_spawns.pop();
                     m_active_handlers.fetch_add(1, std::memory_order_acq_rel);
-                    co_await startDetachedTask(runHandler(handler, stream));
+                    co_await startDetachedTask(runHandler(handler, stream, spawnedAt()));
                 }
             }
 
@@ -1236,8 +1279,39 @@ private:
         co_return;
     }
 
-    Task<void> runHandler(Http2StreamHandler handler, Http2Stream::ptr stream) {
-        co_await handler(stream);
+    /**
+     * @brief 准入控制开启时记录流处理器的调度时间
+     */
+    std::chrono::steady_clock::time_point spawnedAt() const {
+        return m_admission != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    }
+
+    /**
+     * @brief 流处理器启动时的准入判定
+     * @return 被拒绝时已发送 RST_STREAM(REFUSED_STREAM)，返回 false
+     * @details 排队时延为从 spawn 到处理器开始执行的时间；放行后与 endRequest() 成对
+     */
+    bool admitStream(const Http2Stream::ptr& stream, std::chrono::steady_clock::time_point spawned_at) {
+        if (m_admission == nullptr || !stream) {
+            return true;
+        }
+        const auto verdict = m_admission->beginRequest(m_admission_slot, spawned_at);
+        if (verdict == galay::http::HttpAdmissionVerdict::Admit) {
+            return true;
+        }
+        m_admission->onRefusedStream();
+        stream->sendRstStream(Http2ErrorCode::RefusedStream);
+        return false;
+    }
+
+    Task<void> runHandler(Http2StreamHandler handler, Http2Stream::ptr stream,
+                          std::chrono::steady_clock::time_point spawned_at) {
+        if (admitStream(stream, spawned_at)) {
+            co_await handler(stream);
+            if (m_admission != nullptr) {
+                m_admission->endRequest();
+            }
+        }
         // Handler 可能在非 IO owner 线程恢复，流表回收统一回送给主循环串行处理。
         enqueueRetireStream(stream ? stream->streamId() : 0);
         int remaining = m_active_handlers.fetch_sub(1, std::memory_order_acq_rel) - 1;
@@ -1259,15 +1333,64 @@ private:
         co_return;
     }
 
+    /**
+     * @brief 下一次需要检查 SETTINGS ACK / PING 的时间
+     * @details 截止时间随收帧推后，到点后重新计算；间隔不超过 kMonitorRecheckInterval，
+     *          以覆盖监控启动后才发出的 SETTINGS 与 PING ACK 到达后的下一轮探活
+     */
+    std::chrono::steady_clock::time_point nextMonitorCheck(std::chrono::steady_clock::time_point now) const {
+        auto next = now + kMonitorRecheckInterval;
+        switch (m_drain_phase) {
+            case DrainPhase::None:
+                break;
+            case DrainPhase::Requested:
+                return now;
+            case DrainPhase::Announced:
+                next = std::min(next, m_drain_at);
+                break;
+            case DrainPhase::Sent:
+                next = std::min(next, std::min(m_drain_at, now + kDrainPollInterval));
+                break;
+        }
+        const auto& config = m_conn.runtimeConfig();
+        if (config.settings_ack_timeout.count() > 0 && m_conn.isSettingsAckPending() &&
+            m_last_frame_recv_at <= m_conn.settingsSentAt()) {
+            next = std::min(next, m_conn.settingsSentAt() + config.settings_ack_timeout);
+        }
+        if (config.ping_enabled && config.ping_interval.count() > 0) {
+            if (!m_waiting_ping_ack) {
+                next = std::min(next, m_last_frame_recv_at + config.ping_interval);
+            } else if (config.ping_timeout.count() > 0) {
+                next = std::min(next, m_last_ping_sent_at + config.ping_timeout);
+            }
+        }
+        return next;
+    }
+
+    /**
+     * @brief 连接级探活：SETTINGS ACK 超时与空闲 PING
+     * @details 挂在所在调度器的时间轮上，只在下一个截止时间醒来，不再为每个连接每 100ms 唤醒一次；
+     *          停止时由 m_monitor_waiter.wake() 立即唤醒
+     */
     Task<void> monitorLoop() {
+        MonitorDrainNode drain_node(this);
+        if (!m_conn.isClient()) {
+            galay::http::HttpDrainList::local().add(drain_node);
+        }
         while (m_running) {
-            co_await galay::kernel::sleep(std::chrono::milliseconds(100));
+            m_monitor_waiter.arm(nextMonitorCheck(std::chrono::steady_clock::now()));
+            co_await galay::http::ensureWheelDriver();
+            co_await m_monitor_waiter.wait();
             if (!m_running) {
                 break;
             }
 
             auto now = std::chrono::steady_clock::now();
 
+            if (m_drain_phase != DrainPhase::None && advanceDrain(now)) {
+                break;
+            }
+
             if (shouldEnforceSettingsAckTimeout(now)) {
                 enqueueGoaway(Http2ErrorCode::SettingsTimeout, "SETTINGS ACK timeout");
                 m_conn.initiateClose();
@@ -1301,9 +1424,44 @@ private:
                 break;
             }
         }
+        drain_node.unlink();
+        m_monitor_waiter.cancel();
         co_return;
     }
 
+    /**
+     * @brief 推进服务器排空：GOAWAY(MAX) → graceful_shutdown_rtt 后 GOAWAY(last_stream_id)
+     *        → 在途流结束或 graceful_shutdown_timeout 到期后关闭连接
+     * @details 与 shutdown() 的两阶段 GOAWAY 相同，但由 monitorLoop 按截止时间推进，不占用单独协程
+     * @return 连接已开始关闭时返回 true
+     */
+    bool advanceDrain(std::chrono::steady_clock::time_point now) {
+        const auto& config = m_conn.runtimeConfig();
+        if (m_conn.isClosing()) {
+            return true;
+        }
+        if (m_drain_phase == DrainPhase::Requested) {
+            m_conn.setDraining(true);
+            enqueueGoaway(Http2ErrorCode::NoError, "draining", nullptr, kMaxStreamId);
+            m_drain_phase = DrainPhase::Announced;
+            m_drain_at = now + config.graceful_shutdown_rtt;
+        }
+        if (m_drain_phase == DrainPhase::Announced) {
+            if (now < m_drain_at) {
+                return false;
+            }
+            m_reject_new_streams = true;
+            enqueueGoaway(Http2ErrorCode::NoError, "", nullptr, m_conn.lastPeerStreamId());
+            m_drain_phase = DrainPhase::Sent;
+            m_drain_at = now + config.graceful_shutdown_timeout;
+        }
+        if (m_active_handlers.load(std::memory_order_acquire) > 0 && now < m_drain_at) {
+            return false;
+        }
+        m_conn.initiateClose();
+        return true;
+    }
+
     /**
      * @brief Writer 协程：从 send channel 接收数据并写入 socket
      * @details 使用 writev 批量发送多个帧，减少系统调用和内存拷贝
@@ -2182,12 +2340,17 @@ private:
     galay::kernel::AsyncWaiter<void> m_writer_ready;
     galay::kernel::AsyncWaiter<void> m_writer_done;
     galay::kernel::AsyncWaiter<void> m_monitor_done;
+    galay::http::WheelWaiter m_monitor_waiter;
+    galay::http::HttpAdmissionControl* m_admission = nullptr;   ///< 所在服务器的准入控制（未启用为 nullptr）
+    size_t m_admission_slot = 0;                                ///< 所在 IO 调度器下标
     uint32_t m_next_local_stream_id = 0;
     std::atomic<int> m_active_handlers{0};
     std::atomic<bool> m_draining_handlers{false};
     galay::kernel::AsyncWaiter<void> m_handler_waiter;
     Http2Stream::ptr m_hot_stream;
     bool m_reject_new_streams = false;
+    DrainPhase m_drain_phase = DrainPhase::None;                ///< 服务器排空进度（仅服务端）
+    std::chrono::steady_clock::time_point m_drain_at{};        ///< 排空当前阶段的截止时间
     std::chrono::steady_clock::time_point m_last_frame_recv_at{};
     std::chrono::steady_clock::time_point m_last_ping_sent_at{};
     std::array<uint8_t, 8> m_last_ping_payload{};
@@ -0,0 +1,189 @@
+/**
+ * @file ring_buffer_pool.h
+ * @brief 调度器内复用的连接读缓冲池
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 空闲 keep-alive 连接把已读空的 RingBuffer 归还到所在调度器的空闲表，
+ *          数据到达时再取回；大量空闲连接只占用 socket 而不各自常驻一块读缓冲，
+ *          读缓冲总量随活跃连接数而不是总连接数增长。
+ *          池为 thread_local，调度器线程独占，无需加锁。
+ */
+
+#ifndef GALAY_HTTP_RING_BUFFER_POOL_H
+#define GALAY_HTTP_RING_BUFFER_POOL_H
+
+#include "galay-kernel/common/buffer.h"
+#include "galay-kernel/kernel/task.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace galay::http
+{
+
+using galay::kernel::RingBuffer;
+using galay::kernel::Task;
+
+/**
+ * @brief 池的累计计数（仅当前调度器）
+ */
+struct RingBufferPoolStats
+{
+    uint64_t acquired = 0;      ///< acquire 总次数
+    uint64_t reused = 0;        ///< 命中空闲表的次数
+    uint64_t released = 0;      ///< 放回空闲表的次数
+    uint64_t dropped = 0;       ///< 因容量不符或空闲表已满直接释放的次数
+    size_t cached = 0;          ///< 当前空闲表中的缓冲数
+};
+
+/**
+ * @brief 固定大小 RingBuffer 的空闲表
+ * @details 只回收容量等于 kBufferSize 的缓冲（HttpConnImpl 默认读缓冲），
+ *          其他容量（HTTP/2、WebSocket 扩容后的缓冲）直接释放
+ */
+class RingBufferPool
+{
+public:
+    static constexpr size_t kBufferSize = 8192;     ///< HttpConnImpl 默认读缓冲容量
+    static constexpr size_t kMaxCached = 256;       ///< 每调度器最多保留的空闲缓冲数（2MB）
+
+    /**
+     * @brief 当前调度器线程的缓冲池
+     */
+    static RingBufferPool& local()
+    {
+        thread_local RingBufferPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief 取出一块空缓冲，空闲表为空时新分配
+     */
+    RingBuffer acquire()
+    {
+        ++m_stats.acquired;
+        if (m_free.empty()) {
+            return RingBuffer(kBufferSize);
+        }
+        ++m_stats.reused;
+        RingBuffer buffer = std::move(m_free.back());
+        m_free.pop_back();
+        return buffer;
+    }
+
+    /**
+     * @brief 归还缓冲
+     * @param buffer 待归还的缓冲，调用方保证其中已无未消费数据
+     */
+    void release(RingBuffer&& buffer)
+    {
+        if (buffer.capacity() != kBufferSize || buffer.readable() != 0 || m_free.size() >= kMaxCached) {
+            ++m_stats.dropped;
+            return;
+        }
+        ++m_stats.released;
+        m_free.push_back(std::move(buffer));
+    }
+
+    RingBufferPoolStats stats() const
+    {
+        RingBufferPoolStats stats = m_stats;
+        stats.cached = m_free.size();
+        return stats;
+    }
+
+private:
+    std::vector<RingBuffer> m_free;
+    RingBufferPoolStats m_stats;
+};
+
+/**
+ * @brief 可归还缓冲池的连接读缓冲
+ * @details 默认从当前调度器的缓冲池取出；release() 后不占内存，下次 get() 时再取回。
+ *          取回的缓冲构造在同一块存储上，release() 前拿到的 RingBuffer 引用（如 Reader 持有的）
+ *          在再次 get() 之后仍指向当前缓冲；缓冲归还期间不得通过旧引用访问。
+ */
+class PooledRingBuffer
+{
+public:
+    PooledRingBuffer()
+        : m_buffer(RingBufferPool::local().acquire())
+    {
+    }
+
+    explicit PooledRingBuffer(RingBuffer&& buffer)
+        : m_buffer(std::move(buffer))
+    {
+    }
+
+    /**
+     * @brief 当前缓冲，已归还时先从缓冲池取回
+     */
+    RingBuffer& get()
+    {
+        if (!m_buffer) {
+            m_buffer.emplace(RingBufferPool::local().acquire());
+        }
+        return *m_buffer;
+    }
+
+    /**
+     * @brief 尚未消费的字节数（已归还时为 0）
+     */
+    size_t buffered() const { return m_buffer ? m_buffer->readable() : 0; }
+
+    /**
+     * @brief 缓冲是否已归还缓冲池
+     */
+    bool released() const { return !m_buffer.has_value(); }
+
+    /**
+     * @brief 把已读空的缓冲归还当前调度器的缓冲池
+     * @return 已归还（或此前已归还）时为 true；仍有未消费数据时为 false
+     */
+    bool release()
+    {
+        if (!m_buffer) {
+            return true;
+        }
+        if (m_buffer->readable() != 0) {
+            return false;
+        }
+        RingBufferPool::local().release(std::move(*m_buffer));
+        m_buffer.reset();
+        return true;
+    }
+
+private:
+    std::optional<RingBuffer> m_buffer;
+};
+
+/**
+ * @brief 不占读缓冲地等待连接可读
+ * @param socket 明文 TcpSocket（或同样提供 recv(char*, size_t) 的 socket）
+ * @param buffer 连接的读缓冲
+ * @return 收到数据时为 true；对端关闭或读失败时为 false
+ * @details 缓冲为空时归还缓冲池，以 1 字节探测读挂起等待；数据到达后取回缓冲并写入探测到的字节，
+ *          其余数据由之后的 readv 读入。缓冲中已有未消费数据时直接返回。
+ */
+template<typename SocketT>
+Task<bool> awaitReadableWithoutBuffer(SocketT& socket, PooledRingBuffer& buffer)
+{
+    if (!buffer.release()) {
+        co_return true;
+    }
+    char probe = 0;
+    auto recv_result = co_await socket.recv(&probe, 1);
+    if (!recv_result || recv_result.value() == 0) {
+        co_return false;
+    }
+    buffer.get().write(&probe, 1);
+    co_return true;
+}
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_RING_BUFFER_POOL_H
@@ -0,0 +1,263 @@
+/**
+ * @file timing_wheel.h
+ * @brief 每调度器一个的分层时间轮，承载连接的空闲、读头、读体与 HTTP/2 探活等截止时间
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 每个连接、每次读写各挂一个内核定时器时，20 万个以空闲为主的连接意味着 20 万个定时器节点，
+ * 且每次重新设定都要在定时器堆中调整。时间轮把截止时间按 tick 取整后挂到槽位链表：
+ * - 4 层 × 64 槽，第 l 层每槽跨 64^l 个 tick；tick 为 100ms 时覆盖约 19 天，更远的截止时间进入溢出链表
+ * - 定时器节点侵入式嵌在所有者对象中，arm / cancel 为 O(1) 链表操作，不分配内存
+ * - 低层槽位转完一圈时把上一层的当前槽位下放（cascade），每个定时器最多被搬移 3 次
+ * - 截止时间向上取整到 tick，到期回调最多晚一个 tick，不会提前
+ * 本文件不依赖运行时，驱动协程见 wheel_driver.h；实例按线程（即按 IO 调度器）各持一个，只在所属线程访问。
+ */
+
+#ifndef GALAY_HTTP_TIMING_WHEEL_H
+#define GALAY_HTTP_TIMING_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace galay::http
+{
+
+class TimingWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kSlotBits = 6;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+    static constexpr std::chrono::milliseconds kDefaultTick{100};
+
+    /**
+     * @brief 侵入式定时器节点
+     * @details 所有者持有节点（通常作为成员或协程帧上的局部对象），析构时自动从时间轮摘除。
+     *          回调在时间轮所属线程上执行，可以在回调中重新 arm 自身或其他节点。
+     */
+    class Timer
+    {
+    public:
+        using Callback = void (*)(Timer&);
+
+        explicit Timer(Callback callback = nullptr) noexcept : m_callback(callback) {}
+        ~Timer() { cancel(); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        void setCallback(Callback callback) noexcept { m_callback = callback; }
+
+        bool armed() const noexcept { return m_wheel != nullptr; }
+
+        /**
+         * @brief 从时间轮摘除；未挂载时无操作
+         */
+        void cancel() noexcept
+        {
+            if (m_wheel != nullptr) {
+                m_wheel->unlink(*this);
+            }
+        }
+
+    private:
+        friend class TimingWheel;
+
+        Timer* m_prev = nullptr;
+        Timer* m_next = nullptr;
+        TimingWheel* m_wheel = nullptr;
+        uint64_t m_expires = 0;     ///< 到期 tick
+        Callback m_callback;
+    };
+
+    explicit TimingWheel(std::chrono::milliseconds tick = kDefaultTick, Clock::time_point origin = Clock::now())
+        : m_origin(origin)
+        , m_tick(tick.count() > 0 ? tick : kDefaultTick)
+    {
+        for (auto& level : m_slots) {
+            for (auto& slot : level) {
+                slot.m_prev = slot.m_next = &slot;
+            }
+        }
+        m_overflow.m_prev = m_overflow.m_next = &m_overflow;
+    }
+
+    ~TimingWheel()
+    {
+        for (auto& level : m_slots) {
+            for (auto& slot : level) {
+                detachAll(slot);
+            }
+        }
+        detachAll(m_overflow);
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    /**
+     * @brief 当前线程的时间轮
+     */
+    static TimingWheel& local()
+    {
+        thread_local TimingWheel wheel;
+        return wheel;
+    }
+
+    std::chrono::milliseconds tick() const { return m_tick; }
+
+    /// 已挂载的定时器数量
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief 挂载（或重新挂载）定时器
+     * @param deadline 截止时间；已过期的截止时间在下一个 tick 触发
+     */
+    void arm(Timer& timer, Clock::time_point deadline)
+    {
+        timer.cancel();
+        timer.m_expires = toTick(deadline);
+        timer.m_wheel = this;
+        ++m_size;
+        place(timer);
+    }
+
+    /**
+     * @brief 推进到 now，依次执行到期回调
+     * @return 本次触发的定时器数量
+     */
+    size_t advance(Clock::time_point now)
+    {
+        const auto elapsed = now - m_origin;
+        if (elapsed.count() <= 0) {
+            return 0;
+        }
+        const uint64_t target = static_cast<uint64_t>(elapsed / m_tick);
+        if (m_size == 0) {
+            // 空轮直接跳到目标 tick，驱动协程停止一段时间后重新启动不必逐 tick 追赶
+            m_now = target > m_now ? target : m_now;
+            return 0;
+        }
+        size_t fired = 0;
+        while (m_now < target) {
+            ++m_now;
+            cascade();
+            Timer& slot = m_slots[0][m_now & (kSlots - 1)];
+            while (slot.m_next != &slot) {
+                Timer& timer = *slot.m_next;
+                unlink(timer);
+                ++fired;
+                if (timer.m_callback != nullptr) {
+                    timer.m_callback(timer);
+                }
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * @brief 最近一次推进到的时间点（按 tick 取整）
+     */
+    Clock::time_point now() const
+    {
+        return m_origin + m_tick * static_cast<int64_t>(m_now);
+    }
+
+private:
+    static void link(Timer& head, Timer& timer)
+    {
+        timer.m_prev = head.m_prev;
+        timer.m_next = &head;
+        head.m_prev->m_next = &timer;
+        head.m_prev = &timer;
+    }
+
+    static void detachAll(Timer& head)
+    {
+        while (head.m_next != &head) {
+            Timer& timer = *head.m_next;
+            head.m_next = timer.m_next;
+            timer.m_prev = timer.m_next = nullptr;
+            timer.m_wheel = nullptr;
+        }
+        head.m_prev = &head;
+    }
+
+    void unlink(Timer& timer)
+    {
+        timer.m_prev->m_next = timer.m_next;
+        timer.m_next->m_prev = timer.m_prev;
+        timer.m_prev = timer.m_next = nullptr;
+        timer.m_wheel = nullptr;
+        --m_size;
+    }
+
+    uint64_t toTick(Clock::time_point deadline) const
+    {
+        const auto offset = deadline - m_origin;
+        uint64_t ticks = 0;
+        if (offset.count() > 0) {
+            // 先整除再补余数，time_point::max() 这类远期截止时间不会溢出
+            ticks = static_cast<uint64_t>(offset / m_tick) + (offset % m_tick != Clock::duration::zero() ? 1 : 0);
+        }
+        return ticks > m_now ? ticks : m_now + 1;
+    }
+
+    /**
+     * @brief 按到期 tick 与当前 tick 最高的不同位组选层，保证每个槽位在到期前恰好被下放一次
+     */
+    void place(Timer& timer)
+    {
+        const uint64_t expires = timer.m_expires;
+        for (size_t level = 0; level < kLevels; ++level) {
+            const size_t shift = kSlotBits * (level + 1);
+            if ((expires >> shift) == (m_now >> shift)) {
+                link(m_slots[level][(expires >> (kSlotBits * level)) & (kSlots - 1)], timer);
+                return;
+            }
+        }
+        link(m_overflow, timer);
+    }
+
+    /**
+     * @brief 在低层槽位转完一圈时，自顶向下把各层当前槽位的定时器重新分层
+     */
+    void cascade()
+    {
+        if ((m_now & ((uint64_t{1} << (kSlotBits * kLevels)) - 1)) == 0) {
+            relink(m_overflow);
+        }
+        for (size_t level = kLevels - 1; level >= 1; --level) {
+            const size_t shift = kSlotBits * level;
+            if ((m_now & ((uint64_t{1} << shift) - 1)) == 0) {
+                relink(m_slots[level][(m_now >> shift) & (kSlots - 1)]);
+            }
+        }
+    }
+
+    void relink(Timer& head)
+    {
+        Timer* timer = head.m_next;
+        head.m_prev = head.m_next = &head;
+        while (timer != &head) {
+            Timer* next = timer->m_next;
+            place(*timer);
+            timer = next;
+        }
+    }
+
+    Clock::time_point m_origin;
+    std::chrono::milliseconds m_tick;
+    uint64_t m_now = 0;         ///< 已处理到的 tick
+    size_t m_size = 0;
+    std::array<std::array<Timer, kSlots>, kLevels> m_slots;
+    Timer m_overflow;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_TIMING_WHEEL_H
@@ -91,7 +91,7 @@ struct WsEchoMachine {
                   bool preserve_message = true)
         : m_conn(conn)
         , m_reader_setting(reader_setting)
-        , m_read_state(conn->m_ring_buffer,
+        , m_read_state(conn->ringBuffer(),
                        m_reader_setting,
                        message,
                        opcode,
@@ -146,7 +146,7 @@ struct WsEchoMachine {
 
             if ((m_direct_send.useContiguous() && m_direct_send.sent_bytes >= m_direct_send.total_bytes) ||
                 (m_direct_send.useCursor() && m_direct_send.cursor.empty())) {
-                m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                 m_direct_send.reset();
                 m_result = true;
             }
@@ -237,7 +237,7 @@ private:
         if (m_direct_send.active()) {
             if (m_direct_send.useContiguous()) {
                 if (m_direct_send.sent_bytes >= m_direct_send.total_bytes) {
-                    m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                    m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                     m_direct_send.reset();
                     m_result = true;
                     return MachineAction<result_type>::complete(true);
@@ -251,7 +251,7 @@ private:
             }
 
             if (m_direct_send.cursor.empty()) {
-                m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                 m_direct_send.reset();
                 m_result = true;
                 return MachineAction<result_type>::complete(true);
@@ -277,7 +277,7 @@ private:
     }
 
     bool tryPrepareZeroCopy() {
-        auto read_iovecs = borrowReadIovecs(m_conn->m_ring_buffer);
+        auto read_iovecs = borrowReadIovecs(m_conn->ringBuffer());
         WsConsumeFastPathView view;
         if (!bindWsConsumeFastPathView(read_iovecs.data(), read_iovecs.size(), m_conn->m_is_server, view)) {
             return false;
@@ -369,7 +369,7 @@ struct WsSslEchoMachine {
                      bool preserve_message = true)
         : m_conn(conn)
         , m_reader_setting(reader_setting)
-        , m_read_state(conn->m_ring_buffer,
+        , m_read_state(conn->ringBuffer(),
                        m_reader_setting,
                        message,
                        opcode,
@@ -432,7 +432,7 @@ struct WsSslEchoMachine {
 
             if ((m_direct_send.useContiguous() && m_direct_send.sent_bytes >= m_direct_send.total_bytes) ||
                 (m_direct_send.useCursor() && m_direct_send.cursor.empty())) {
-                m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                 m_direct_send.reset();
                 m_result = true;
             }
@@ -525,7 +525,7 @@ private:
         if (m_direct_send.active()) {
             if (m_direct_send.useContiguous()) {
                 if (m_direct_send.sent_bytes >= m_direct_send.total_bytes) {
-                    m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                    m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                     m_direct_send.reset();
                     m_result = true;
                     return galay::ssl::SslMachineAction<result_type>::complete(true);
@@ -537,7 +537,7 @@ private:
             }
 
             if (m_direct_send.cursor.empty()) {
-                m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                 m_direct_send.reset();
                 m_result = true;
                 return galay::ssl::SslMachineAction<result_type>::complete(true);
@@ -560,7 +560,7 @@ private:
     }
 
     bool tryPrepareZeroCopy() {
-        auto read_iovecs = borrowReadIovecs(m_conn->m_ring_buffer);
+        auto read_iovecs = borrowReadIovecs(m_conn->ringBuffer());
         WsConsumeFastPathView view;
         if (!bindWsConsumeFastPathView(read_iovecs.data(), read_iovecs.size(), m_conn->m_is_server, view)) {
             return false;
@@ -649,7 +649,7 @@ struct WsSslEchoLoopMachine {
         , m_reader_setting(reader_setting)
         , m_message()
         , m_opcode(WsOpcode::Close)
-        , m_read_state(conn->m_ring_buffer,
+        , m_read_state(conn->ringBuffer(),
                        m_reader_setting,
                        m_message,
                        m_opcode,
@@ -715,7 +715,7 @@ struct WsSslEchoLoopMachine {
 
                 if ((m_direct_send.useContiguous() && m_direct_send.sent_bytes >= m_direct_send.total_bytes) ||
                     (m_direct_send.useCursor() && m_direct_send.cursor.empty())) {
-                    m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                    m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                     m_direct_send.reset();
                     finishCurrentMessage();
                 }
@@ -825,7 +825,7 @@ private:
             case WriteMode::kDirect:
                 if (m_direct_send.useContiguous()) {
                     if (m_direct_send.sent_bytes >= m_direct_send.total_bytes) {
-                        m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                        m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                         m_direct_send.reset();
                         finishCurrentMessage();
                         return advanceRead();
@@ -837,7 +837,7 @@ private:
                 }
 
                 if (m_direct_send.cursor.empty()) {
-                    m_conn->m_ring_buffer.consume(m_direct_send.consume_bytes);
+                    m_conn->ringBuffer().consume(m_direct_send.consume_bytes);
                     m_direct_send.reset();
                     finishCurrentMessage();
                     return advanceRead();
@@ -875,7 +875,7 @@ private:
     }
 
     bool tryPrepareZeroCopy() {
-        auto read_iovecs = borrowReadIovecs(m_conn->m_ring_buffer);
+        auto read_iovecs = borrowReadIovecs(m_conn->ringBuffer());
         WsConsumeFastPathView view;
         if (!bindWsConsumeFastPathView(read_iovecs.data(), read_iovecs.size(), m_conn->m_is_server, view)) {
             return false;
@@ -987,7 +987,7 @@ public:
      */
     static WsConnImpl<SocketType> from(galay::http::HttpConnImpl<SocketType>&& http_conn, bool is_server = true)
     {
-        return WsConnImpl<SocketType>(std::move(http_conn.m_socket), std::move(http_conn.m_ring_buffer), is_server);
+        return WsConnImpl<SocketType>(std::move(http_conn.m_socket), std::move(http_conn.ringBuffer()), is_server);
     }
 
     /**
@@ -1005,7 +1005,7 @@ public:
      */
     WsConnImpl(SocketType&& socket, bool is_server = true)
         : m_socket(std::move(socket))
-        , m_ring_buffer(8192)  // 默认8KB buffer
+        , m_ring_buffer()  // 默认8KB buffer，优先复用缓冲池中的空闲缓冲
         , m_is_server(is_server)
     {
     }
@@ -1034,8 +1034,20 @@ public:
 
     /**
      * @brief 获取RingBuffer引用
+     * @note 缓冲已归还时先从当前调度器的缓冲池取回
      */
-    RingBuffer& ringBuffer() { return m_ring_buffer; }
+    RingBuffer& ringBuffer() { return m_ring_buffer.get(); }
+
+    /**
+     * @brief 不占读缓冲地等待下一帧（仅明文 TcpSocket）
+     * @return 收到数据时为 true；对端关闭或读失败时为 false
+     * @details 读缓冲为空时归还当前调度器的缓冲池，数据到达后再取回；
+     *          此前 getReader() 得到的 Reader 在返回 true 后可继续使用。
+     *          适合大量长期空闲的 WebSocket 连接，在两次 getMessage() 之间调用
+     */
+    Task<bool> awaitIdleData() requires std::is_same_v<SocketType, TcpSocket> {
+        return galay::http::awaitReadableWithoutBuffer(m_socket, m_ring_buffer);
+    }
 
     /**
      * @brief 获取WsReader
@@ -1045,7 +1057,7 @@ public:
     WsReaderImpl<SocketType> getReader(const WsReaderSetting& setting = WsReaderSetting()) {
         // use_mask: 客户端需要mask，服务器不需要
         bool use_mask = !m_is_server;
-        return WsReaderImpl<SocketType>(m_ring_buffer, setting, m_socket, m_is_server, use_mask);
+        return WsReaderImpl<SocketType>(m_ring_buffer.get(), setting, m_socket, m_is_server, use_mask);
     }
 
     /**
@@ -1161,7 +1173,7 @@ public:
 
 private:
     SocketType m_socket;
-    RingBuffer m_ring_buffer;
+    galay::http::PooledRingBuffer m_ring_buffer;
     bool m_is_server;
     EchoCounters m_echo_counters;
     std::string m_loop_message_scratch;
@@ -0,0 +1,114 @@
+/**
+ * @file wheel_driver.h
+ * @brief 时间轮的调度器侧驱动：按需启动的推进协程与可等待的轮上定时器
+ * @author galay-http
+ * @version 1.0.0
+ *
+ * @details 每个 IO 调度器线程最多一个驱动协程，按 tick 睡眠并推进本线程的 TimingWheel，
+ * 轮空后退出；挂载定时器的一方随后 `co_await ensureWheelDriver()` 在需要时重新拉起。
+ * 这样整个调度器只占一个内核定时器，服务端、客户端与 HTTP/2 连接共用同一个时间轮。
+ */
+
+#ifndef GALAY_HTTP_WHEEL_DRIVER_H
+#define GALAY_HTTP_WHEEL_DRIVER_H
+
+#include "timing_wheel.h"
+#include "galay-kernel/common/sleep.hpp"
+#include "galay-kernel/concurrency/unsafe_channel.h"
+#include "galay-kernel/kernel/task.h"
+#include <coroutine>
+#include <cstdint>
+
+namespace galay::http
+{
+
+namespace detail
+{
+
+inline bool& wheelDriverRunning()
+{
+    thread_local bool running = false;
+    return running;
+}
+
+/**
+ * @brief 推进本线程时间轮，轮空后退出
+ */
+inline galay::kernel::Task<void> runWheelDriver()
+{
+    auto& wheel = TimingWheel::local();
+    while (wheel.size() > 0) {
+        co_await galay::kernel::sleep(wheel.tick());
+        wheel.advance(TimingWheel::Clock::now());
+    }
+    wheelDriverRunning() = false;
+    co_return;
+}
+
+} // namespace detail
+
+/**
+ * @brief 确保当前调度器上运行着时间轮驱动协程
+ * @details 驱动已在运行时 await_ready 直接返回，不挂起；应在挂载定时器之后等待
+ */
+class EnsureWheelDriverAwaitable
+{
+public:
+    bool await_ready() const noexcept { return detail::wheelDriverRunning(); }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        auto* scheduler = handle.promise().taskRefView().belongScheduler();
+        if (scheduler != nullptr && scheduleTask(scheduler, detail::runWheelDriver())) {
+            detail::wheelDriverRunning() = true;
+        }
+        return false;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+inline EnsureWheelDriverAwaitable ensureWheelDriver()
+{
+    return {};
+}
+
+/**
+ * @brief 挂在本线程时间轮上的可等待定时器
+ * @details 到期或被 wake() 时唤醒 wait() 的等待方；多次唤醒至多使下一次 wait() 立即返回，
+ *          等待方应在醒来后重新检查自身状态
+ */
+class WheelWaiter : public TimingWheel::Timer
+{
+public:
+    WheelWaiter()
+        : TimingWheel::Timer(&WheelWaiter::onExpire)
+    {
+    }
+
+    void arm(TimingWheel::Clock::time_point deadline)
+    {
+        TimingWheel::local().arm(*this, deadline);
+    }
+
+    auto wait() { return m_wakeups.recv(); }
+
+    void wake()
+    {
+        cancel();
+        m_wakeups.send(uint8_t{1});
+    }
+
+private:
+    static void onExpire(TimingWheel::Timer& timer)
+    {
+        static_cast<WheelWaiter&>(timer).m_wakeups.send(uint8_t{1});
+    }
+
+    galay::kernel::UnsafeChannel<uint8_t> m_wakeups;
+};
+
+} // namespace galay::http
+
+#endif // GALAY_HTTP_WHEEL_DRIVER_H
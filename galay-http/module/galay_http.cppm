@@ -14,6 +14,7 @@ export {
 #include "galay-http/protoc/http/http_response.h"
 
 #include "galay-http/kernel/http/http_client.h"
+#include "galay-http/kernel/http/compute_offload.h"
 #include "galay-http/kernel/http/http_conn.h"
 #include "galay-http/kernel/http/http_reader.h"
 #include "galay-http/kernel/http/http_router.h"
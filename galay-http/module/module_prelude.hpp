@@ -149,6 +149,9 @@
 #if __has_include("galay-http/common/http_log.h")
 #include "galay-http/common/http_log.h"
 #endif
+#if __has_include("galay-http/kernel/http/compute_offload.h")
+#include "galay-http/kernel/http/compute_offload.h"
+#endif
 #if __has_include("galay-http/kernel/http/http_conn.h")
 #include "galay-http/kernel/http/http_conn.h"
 #endif
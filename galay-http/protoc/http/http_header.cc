@@ -1189,7 +1189,7 @@ namespace galay::http
         return {kIncomplete, static_cast<ssize_t>(total_consumed)};
     }
 
-    std::string HttpRequestHeader::toString() const
+    void HttpRequestHeader::appendRequestLine(std::string& out) const
     {
         // 构建 URI（带参数）
         std::string uri_str = m_uri;
@@ -1208,28 +1208,28 @@ namespace galay::http
             }
         }
         uri_str = convertToUri(std::move(uri_str));
-        
-        // 获取方法、版本和头部字符串
-        std::string method_str = httpMethodToString(this->m_method);
-        std::string version_str = httpVersionToString(this->m_version);
+
+        out += httpMethodToString(this->m_method);
+        out += ' ';
+        out += uri_str;
+        out += ' ';
+        out += httpVersionToString(this->m_version);
+        out += "\r\n";
+    }
+
+    std::string HttpRequestHeader::toString() const
+    {
         const size_t headers_size = m_headerPairs.estimatedSerializedSize();
 
-        // 预分配结果字符串
-        size_t estimated_size = method_str.size() + 1 + uri_str.size() + 1 +
-                                version_str.size() + 2 + headers_size + 2;
+        // 预分配结果字符串（请求行按 URI 长度加方法与版本的余量估算）
         std::string result;
-        result.reserve(estimated_size);
-        
+        result.reserve(m_uri.size() + 32 + headers_size + 2);
+
         // 直接拼接，避免 ostringstream 开销
-        result += method_str;
-        result += ' ';
-        result += uri_str;
-        result += ' ';
-        result += version_str;
-        result += "\r\n";
+        appendRequestLine(result);
         m_headerPairs.appendTo(result);
         result += "\r\n";
-        
+
         return result;
     }
 
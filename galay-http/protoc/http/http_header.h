@@ -282,6 +282,12 @@ namespace galay::http {
          */
         std::string toString() const;
 
+        /**
+         * @brief 追加请求行（含查询参数与结尾 CRLF），不含头部字段
+         * @param out 输出字符串
+         */
+        void appendRequestLine(std::string& out) const;
+
         /**
          * @brief 判断是否为 Keep-Alive 连接
          * @return Keep-Alive 返回 true
@@ -187,6 +187,16 @@ namespace galay::http
         return m_bodyParsed >= m_contentLength;
     }
 
+    bool HttpRequest::isHeaderComplete() const
+    {
+        return m_headerParsed;
+    }
+
+    size_t HttpRequest::bodyParsedSize() const
+    {
+        return m_bodyParsed;
+    }
+
     void HttpRequest::reset()
     {
         m_header.reset();
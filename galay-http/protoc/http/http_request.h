@@ -106,6 +106,18 @@ public:
      */
     bool isComplete() const;
 
+    /**
+     * @brief 检查请求头是否解析完成
+     * @return 请求头已解析返回 true
+     */
+    bool isHeaderComplete() const;
+
+    /**
+     * @brief 获取已解析的 body 字节数（Content-Length 请求）
+     * @return 已解析字节数
+     */
+    size_t bodyParsedSize() const;
+
     void reset(); ///< 重置解析状态
 
     // ==================== 路由参数支持 ====================
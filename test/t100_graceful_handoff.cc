@@ -0,0 +1,279 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/graceful_drain.h"
+#include "galay-http/kernel/http/listener_handoff.h"
+#include "galay-http/kernel/http/socket_addr.h"
+
+using namespace galay::http;
+
+namespace {
+
+struct CountingNode : HttpDrainList::Node {
+    CountingNode() : Node(&CountingNode::onDrain) {}
+    static void onDrain(Node& node) { ++static_cast<CountingNode&>(node).calls; }
+    int calls = 0;
+};
+
+uint16_t boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+/**
+ * @brief 监听 fd 以 SOCK_NONBLOCK 创建，accept 前先等待连接到达
+ */
+int acceptReady(int listener) {
+    pollfd pfd{listener, POLLIN, 0};
+    if (::poll(&pfd, 1, 5000) != 1) {
+        return -1;
+    }
+    return ::accept(listener, nullptr, nullptr);
+}
+
+int connectLoopback(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int testDrainList() {
+    HttpDrainList list;
+    CountingNode a;
+    CountingNode b;
+    CountingNode c;
+    list.add(a);
+    list.add(b);
+    list.add(c);
+    list.remove(b);
+    if (list.size() != 2 || b.linked()) {
+        std::cerr << "[T100] remove mismatch\n";
+        return 1;
+    }
+    {
+        CountingNode scoped;
+        list.add(scoped);
+        if (list.size() != 3) {
+            std::cerr << "[T100] add mismatch\n";
+            return 1;
+        }
+    }
+    // 节点析构时自动摘除
+    if (list.size() != 2) {
+        std::cerr << "[T100] destructor did not unlink\n";
+        return 1;
+    }
+    if (list.drain() != 2 || a.calls != 1 || b.calls != 0 || c.calls != 1 || list.size() != 0 ||
+        a.linked() || !list.draining()) {
+        std::cerr << "[T100] drain callbacks mismatch\n";
+        return 1;
+    }
+    // 排空期间挂载的节点立即回调
+    if (list.add(b) || b.calls != 1 || b.linked()) {
+        std::cerr << "[T100] add while draining mismatch\n";
+        return 1;
+    }
+    list.reset();
+    if (!list.add(b) || list.draining() || list.size() != 1) {
+        std::cerr << "[T100] reset mismatch\n";
+        return 1;
+    }
+    return 0;
+}
+
+int testFdPassing() {
+    int pair[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        std::cerr << "[T100] socketpair failed\n";
+        return 1;
+    }
+    std::string error;
+    const int listener = detail::openTcpListener(HttpSocketAddress::parse("127.0.0.1", 0), 16, false, error);
+    const int plain = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0 || plain < 0) {
+        std::cerr << "[T100] socket setup failed: " << error << "\n";
+        return 1;
+    }
+    if (!detail::sendListenerFds(pair[0], {listener, plain}, "127.0.0.1:1", error)) {
+        std::cerr << "[T100] send failed: " << error << "\n";
+        return 1;
+    }
+    std::vector<int> fds;
+    std::string tag;
+    if (!detail::recvListenerFds(pair[1], fds, tag, error) || fds.size() != 2 || tag != "127.0.0.1:1") {
+        std::cerr << "[T100] recv mismatch: " << error << "\n";
+        return 1;
+    }
+    if (!detail::isListeningSocket(fds[0]) || detail::isListeningSocket(fds[1]) ||
+        boundPort(fds[0]) != boundPort(listener)) {
+        std::cerr << "[T100] received fds mismatch\n";
+        return 1;
+    }
+    // 空 tag 不发送
+    if (detail::sendListenerFds(pair[0], {listener}, "", error)) {
+        std::cerr << "[T100] empty tag accepted\n";
+        return 1;
+    }
+    for (int fd : fds) {
+        ::close(fd);
+    }
+    ::close(listener);
+    ::close(plain);
+    ::close(pair[0]);
+    ::close(pair[1]);
+    return 0;
+}
+
+int testInheritance() {
+    const std::string path = "/tmp/galay_t100_handoff_" + std::to_string(::getpid()) + ".sock";
+    std::string error;
+    HttpListenerInheritance inheritance;
+
+    // 路径上没有旧进程：返回 false 且不报错
+    detail::removeUnixSocketFile(path);
+    if (inheritance.fetch(path, error) || !error.empty()) {
+        std::cerr << "[T100] fetch on missing path mismatch: " << error << "\n";
+        return 1;
+    }
+
+    const int listener = detail::openTcpListener(HttpSocketAddress::parse("127.0.0.1", 0), 16, false, error);
+    const int control = detail::openUnixListener(path, 4, error);
+    if (listener < 0 || control < 0) {
+        std::cerr << "[T100] old process setup failed: " << error << "\n";
+        return 1;
+    }
+    const uint16_t port = boundPort(listener);
+    const std::string authority = HttpSocketAddress::parse("127.0.0.1", port).authority();
+
+    // 旧进程侧：发送监听 fd 并等待就绪字节
+    char ready = 0;
+    std::thread old_process([&] {
+        const int peer = acceptReady(control);
+        std::string send_error;
+        if (peer >= 0 && detail::sendListenerFds(peer, {listener}, authority, send_error)) {
+            (void)::recv(peer, &ready, 1, 0);
+        }
+        if (peer >= 0) {
+            ::close(peer);
+        }
+    });
+
+    const bool fetched = inheritance.fetch(path, error);
+    if (!fetched || !inheritance.valid() || inheritance.authority() != authority) {
+        old_process.join();
+        std::cerr << "[T100] fetch failed: " << error << "\n";
+        return 1;
+    }
+    std::vector<int> inherited = inheritance.take();
+    if (!inheritance.confirm()) {
+        old_process.join();
+        std::cerr << "[T100] confirm failed\n";
+        return 1;
+    }
+    old_process.join();
+    if (ready != detail::kHandoffReady || inherited.size() != 1) {
+        std::cerr << "[T100] ready byte mismatch\n";
+        return 1;
+    }
+
+    // 旧进程关闭自己的副本后，新进程仍在同一监听队列上 accept
+    ::close(listener);
+    const int client = connectLoopback(port);
+    const int accepted = client >= 0 ? acceptReady(inherited[0]) : -1;
+    if (accepted < 0) {
+        std::cerr << "[T100] accept on inherited listener failed\n";
+        return 1;
+    }
+    ::close(accepted);
+    ::close(client);
+    ::close(inherited[0]);
+    ::close(control);
+    detail::removeUnixSocketFile(path);
+    return 0;
+}
+
+} // namespace
+
+/**
+ * @brief 交接 socket 权限为 0600，且只信任同 uid（或 root）的对端
+ */
+int testHandoffAccess() {
+    const std::string path = "/tmp/galay_t100_access_" + std::to_string(::getpid()) + ".sock";
+    std::string error;
+    const mode_t old_mask = ::umask(0);
+    const int control = detail::openUnixListener(path, 4, error, detail::kHandoffSocketMode);
+    ::umask(old_mask);
+    struct stat st{};
+    if (control < 0 || ::stat(path.c_str(), &st) != 0 || (st.st_mode & 0777) != detail::kHandoffSocketMode) {
+        std::cerr << "[T100] handoff socket mode mismatch: " << error << "\n";
+        return 1;
+    }
+
+    int pair[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0 || !detail::handoffPeerTrusted(pair[0], error)) {
+        std::cerr << "[T100] same-uid peer should be trusted: " << error << "\n";
+        return 1;
+    }
+    ::close(pair[0]);
+    ::close(pair[1]);
+
+    // 以 root 运行时降权连接（目录可写但 socket 文件 0600，连接被拒），再用抽象命名空间验证 uid 检查
+    if (::geteuid() == 0) {
+        const std::string abstract = "@galay_t100_access_" + std::to_string(::getpid());
+        const int open_control = detail::openUnixListener(abstract, 4, error);
+        const pid_t child = ::fork();
+        if (child == 0) {
+            if (::setuid(65534) != 0) {
+                ::_exit(2);
+            }
+            const bool file_refused = detail::connectUnixStream(path, error) < 0;
+            const int fd = detail::connectUnixStream(abstract, error);
+            if (fd >= 0) {
+                char byte = 0;
+                (void)::recv(fd, &byte, 1, 0);
+            }
+            ::_exit(file_refused && fd >= 0 ? 0 : 1);
+        }
+        const int peer = acceptReady(open_control);
+        const bool trusted = peer >= 0 && detail::handoffPeerTrusted(peer, error);
+        if (peer >= 0) {
+            ::close(peer);
+        }
+        int status = 0;
+        ::waitpid(child, &status, 0);
+        ::close(open_control);
+        if (trusted || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "[T100] foreign uid should be rejected: status=" << status << "\n";
+            return 1;
+        }
+    }
+    ::close(control);
+    detail::removeUnixSocketFile(path);
+    return 0;
+}
+
+int main() {
+    if (testDrainList() != 0 || testFdPassing() != 0 || testInheritance() != 0 ||
+        testHandoffAccess() != 0) {
+        return 1;
+    }
+    std::cout << "T100-GracefulHandoff PASS\n";
+    return 0;
+}
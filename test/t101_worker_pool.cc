@@ -0,0 +1,131 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <pthread.h>
+
+#include "galay-http/kernel/http/worker_pool.h"
+
+using namespace galay::http;
+
+namespace {
+
+HttpWorkerPool g_pool;
+std::mutex g_lock;      ///< start() 之后由主进程的另一个线程一直持有
+
+/**
+ * @brief 工作进程：记一次 accept，工作进程 0 第一次启动时崩溃，其余等待 SIGTERM 后正常退出
+ * @details 重启的工作进程也复制自 start() 时的进程状态，主进程中其他线程此后持有的锁在这里是空闲的
+ */
+void workerMain(size_t worker) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    if (!g_lock.try_lock()) {
+        std::_Exit(4);
+    }
+    auto* counters = g_pool.counters(worker, 1);
+    counters->onAccept();
+    counters->onRequest();
+    counters->onConnOpen();
+    if (!g_pool.isWorker() || g_pool.workerIndex() != worker) {
+        std::_Exit(3);
+    }
+
+    if (worker == 0 && g_pool.snapshot().workers[0].restarts == 0) {
+        std::abort();
+    }
+    int signo = 0;
+    sigwait(&signals, &signo);
+}
+
+bool waitFor(const std::function<bool()>& predicate, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::atomic<int> crashes{0};
+    std::string error;
+    const bool started = g_pool.start(2, 2, workerMain,
+        [&crashes](size_t worker, int, int status, bool respawn) {
+            if (worker == 0 && WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT && respawn) {
+                crashes.fetch_add(1);
+            }
+        }, error);
+    if (!started || !g_pool.master() || g_pool.isWorker()) {
+        std::cerr << "[T101] start failed: " << error << "\n";
+        return 1;
+    }
+    std::atomic<bool> release{false};
+    std::thread holder([&release] {
+        std::lock_guard<std::mutex> guard(g_lock);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    // 工作进程 0 崩溃一次后被重启（启动 1 秒内崩溃，重启延后到 1 秒）
+    const bool settled = waitFor([&] {
+        const auto stats = g_pool.snapshot();
+        return crashes.load() == 1 && stats.restarts == 1 && stats.accepted == 3 &&
+               stats.workers[0].alive && stats.workers[1].alive;
+    }, std::chrono::milliseconds(5000));
+    const auto stats = g_pool.snapshot();
+    if (!settled) {
+        std::cerr << "[T101] respawn mismatch: crashes=" << crashes.load() << " restarts=" << stats.restarts
+                  << " accepted=" << stats.accepted << "\n";
+        g_pool.stop(std::chrono::milliseconds(0));
+        release.store(true);
+        holder.join();
+        return 1;
+    }
+    // 重启时清零存活连接数，累计计数保留
+    if (stats.workers.size() != 2 || stats.workers[0].pid == stats.workers[1].pid ||
+        stats.workers[0].accepted != 2 || stats.workers[0].active != 1 || stats.active != 2 ||
+        stats.requests != 3 || g_pool.counters(2, 0) != nullptr || g_pool.counters(0, 2) != nullptr) {
+        std::cerr << "[T101] stats mismatch\n" << stats.toText();
+        g_pool.stop(std::chrono::milliseconds(0));
+        release.store(true);
+        holder.join();
+        return 1;
+    }
+    if (stats.toText().find("worker1.accepted 1\n") == std::string::npos) {
+        std::cerr << "[T101] text rendering mismatch\n" << stats.toText();
+        g_pool.stop(std::chrono::milliseconds(0));
+        release.store(true);
+        holder.join();
+        return 1;
+    }
+
+    release.store(true);
+    holder.join();
+
+    // SIGTERM 后正常退出，不再重启
+    if (!g_pool.stop(std::chrono::milliseconds(2000)) || g_pool.master()) {
+        std::cerr << "[T101] stop was not clean\n";
+        return 1;
+    }
+    const auto after = g_pool.snapshot();
+    if (after.workers.size() != 2 || after.workers[0].alive || after.workers[1].alive || after.restarts != 1) {
+        std::cerr << "[T101] stopped state mismatch\n" << after.toText();
+        return 1;
+    }
+    std::cout << "T101-WorkerPool PASS\n";
+    return 0;
+}
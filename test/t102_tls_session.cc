@@ -0,0 +1,276 @@
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#ifdef GALAY_HTTP_SSL_ENABLED
+#include <openssl/err.h>
+#include <openssl/x509.h>
+
+#include "galay-http/kernel/http/tls_session.h"
+
+using namespace galay::http;
+
+namespace {
+
+EVP_PKEY* g_key = nullptr;
+X509* g_cert = nullptr;
+
+bool makeSelfSigned() {
+    g_key = EVP_EC_gen("P-256");
+    g_cert = X509_new();
+    if (g_key == nullptr || g_cert == nullptr) {
+        return false;
+    }
+    ASN1_INTEGER_set(X509_get_serialNumber(g_cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(g_cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(g_cert), 3600);
+    X509_set_pubkey(g_cert, g_key);
+    X509_NAME* name = X509_get_subject_name(g_cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"),
+                               -1, -1, 0);
+    X509_set_issuer_name(g_cert, name);
+    return X509_sign(g_cert, g_key, EVP_sha256()) > 0;
+}
+
+SSL_CTX* makeServerCtx() {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(ctx, g_cert);
+    SSL_CTX_use_PrivateKey(ctx, g_key);
+    return ctx;
+}
+
+SSL_CTX* makeClientCtx(int max_version) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_max_proto_version(ctx, max_version);
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+    return ctx;
+}
+
+/**
+ * @brief 经内存 BIO 对完成一次握手并收下 TLS 1.3 的 NewSessionTicket
+ * @param session 非空时尝试恢复；返回后替换为本次连接的会话
+ * @return 握手失败返回 -1，否则返回是否恢复
+ */
+int handshake(SSL_CTX* server_ctx, SSL_CTX* client_ctx, SSL_SESSION*& session) {
+    SSL* server = SSL_new(server_ctx);
+    SSL* client = SSL_new(client_ctx);
+    BIO* server_bio = nullptr;
+    BIO* client_bio = nullptr;
+    BIO_new_bio_pair(&server_bio, 0, &client_bio, 0);
+    SSL_set_bio(server, server_bio, server_bio);
+    SSL_set_bio(client, client_bio, client_bio);
+    SSL_set_accept_state(server);
+    SSL_set_connect_state(client);
+    if (session != nullptr) {
+        SSL_set_session(client, session);
+    }
+
+    bool server_done = false;
+    bool client_done = false;
+    for (int round = 0; round < 32 && !(server_done && client_done); ++round) {
+        if (!client_done) {
+            const int rc = SSL_do_handshake(client);
+            client_done = rc == 1;
+            if (rc <= 0 && SSL_get_error(client, rc) != SSL_ERROR_WANT_READ) {
+                break;
+            }
+        }
+        if (!server_done) {
+            const int rc = SSL_do_handshake(server);
+            server_done = rc == 1;
+            if (rc <= 0 && SSL_get_error(server, rc) != SSL_ERROR_WANT_READ) {
+                break;
+            }
+        }
+    }
+    int result = -1;
+    if (server_done && client_done) {
+        char byte = 'x';
+        SSL_write(server, &byte, 1);
+        SSL_read(client, &byte, 1);
+        result = SSL_session_reused(client) == 1 ? 1 : 0;
+        if (session != nullptr) {
+            SSL_SESSION_free(session);
+        }
+        session = SSL_get1_session(client);
+        // 未发送 close_notify 就释放的连接，其会话按 RFC 5246 视为不可恢复
+        SSL_shutdown(client);
+        SSL_shutdown(server);
+    }
+    SSL_free(client);
+    SSL_free(server);
+    return result;
+}
+
+int testTickets() {
+    HttpTlsSessionManager manager;
+    SSL_CTX* server_ctx = makeServerCtx();
+    SSL_CTX* client_ctx = makeClientCtx(TLS1_3_VERSION);
+    HttpTlsSessionConfig config;
+    config.ticket_secret = "0123456789abcdef0123456789abcdef";
+    std::string error;
+    if (!manager.install(server_ctx, config, 4, error)) {
+        std::cerr << "[T102] install failed: " << error << "\n";
+        return 1;
+    }
+    SSL_SESSION* session = nullptr;
+    if (handshake(server_ctx, client_ctx, session) != 0 || handshake(server_ctx, client_ctx, session) != 1) {
+        std::cerr << "[T102] TLS 1.3 ticket resumption failed\n";
+        return 1;
+    }
+
+    // 相同 ticket_secret 的另一个实例（另一个工作进程或机器）可以恢复
+    HttpTlsSessionManager peer;
+    SSL_CTX* peer_ctx = makeServerCtx();
+    if (!peer.install(peer_ctx, config, 1, error) || handshake(peer_ctx, client_ctx, session) != 1) {
+        std::cerr << "[T102] shared secret resumption failed\n";
+        return 1;
+    }
+
+    // 不同主密钥：票据无法解密，回退到完整握手
+    HttpTlsSessionManager stranger;
+    SSL_CTX* stranger_ctx = makeServerCtx();
+    config.ticket_secret.clear();
+    if (!stranger.install(stranger_ctx, config, 1, error) || handshake(stranger_ctx, client_ctx, session) != 0 ||
+        stranger.snapshot().ticket_unknown_key != 1 || stranger.snapshot().full_handshakes != 1) {
+        std::cerr << "[T102] unknown ticket key mismatch\n";
+        return 1;
+    }
+
+    const auto stats = manager.snapshot();
+    if (stats.resumed != 1 || stats.full_handshakes != 1 || stats.cache_hits != 0 || stats.cache_entries != 0) {
+        std::cerr << "[T102] ticket stats mismatch\n";
+        return 1;
+    }
+    // 过短的主密钥被拒绝
+    config.ticket_secret = "short";
+    if (stranger.install(stranger_ctx, config, 1, error)) {
+        std::cerr << "[T102] short secret accepted\n";
+        return 1;
+    }
+    SSL_SESSION_free(session);
+    SSL_CTX_free(stranger_ctx);
+    SSL_CTX_free(peer_ctx);
+    SSL_CTX_free(client_ctx);
+    SSL_CTX_free(server_ctx);
+    return 0;
+}
+
+int testKeyRotation() {
+    HttpTlsSessionManager manager;
+    SSL_CTX* server_ctx = makeServerCtx();
+    SSL_CTX* client_ctx = makeClientCtx(TLS1_2_VERSION);
+    HttpTlsSessionConfig config;
+    config.ticket_key_rotation = std::chrono::seconds(1);
+    config.session_lifetime = std::chrono::seconds(60);
+    std::string error;
+    manager.install(server_ctx, config, 1, error);
+
+    SSL_SESSION* session = nullptr;
+    const std::time_t issued = std::time(nullptr);
+    if (handshake(server_ctx, client_ctx, session) != 0) {
+        std::cerr << "[T102] TLS 1.2 handshake failed\n";
+        return 1;
+    }
+    while (std::time(nullptr) == issued) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    // 上一纪元的票据仍可解密，并续发当前纪元的新票据
+    if (handshake(server_ctx, client_ctx, session) != 1) {
+        std::cerr << "[T102] resumption across rotation failed\n";
+        return 1;
+    }
+    const auto stats = manager.snapshot();
+    if (stats.key_rotations < 1 || stats.ticket_renewed != 1 || stats.resumed != 1) {
+        std::cerr << "[T102] rotation stats mismatch: rotations=" << stats.key_rotations
+                  << " renewed=" << stats.ticket_renewed << "\n";
+        return 1;
+    }
+    SSL_SESSION_free(session);
+    SSL_CTX_free(client_ctx);
+    SSL_CTX_free(server_ctx);
+    return 0;
+}
+
+int testSessionCache() {
+    HttpTlsSessionManager manager;
+    SSL_CTX* server_ctx = makeServerCtx();
+    HttpTlsSessionConfig config;
+    config.tickets = false;
+    config.session_cache = true;
+    config.session_cache_size = 4;
+    std::string error;
+    manager.install(server_ctx, config, 2, error);
+
+    for (int version : {TLS1_2_VERSION, TLS1_3_VERSION}) {
+        SSL_CTX* client_ctx = makeClientCtx(version);
+        SSL_SESSION* session = nullptr;
+        if (handshake(server_ctx, client_ctx, session) != 0 || handshake(server_ctx, client_ctx, session) != 1) {
+            std::cerr << "[T102] cache resumption failed: version=" << version << "\n";
+            return 1;
+        }
+        SSL_SESSION_free(session);
+        SSL_CTX_free(client_ctx);
+    }
+    auto stats = manager.snapshot();
+    if (stats.cache_hits != 2 || stats.resumed != 2 || stats.full_handshakes != 2 || stats.cache_entries == 0) {
+        std::cerr << "[T102] cache stats mismatch: hits=" << stats.cache_hits << " entries=" << stats.cache_entries
+                  << "\n";
+        return 1;
+    }
+
+    // 容量按分片均分（每片 2 个），超出后淘汰最旧的会话
+    SSL_CTX* client_ctx = makeClientCtx(TLS1_2_VERSION);
+    for (int i = 0; i < 8; ++i) {
+        SSL_SESSION* session = nullptr;
+        handshake(server_ctx, client_ctx, session);
+        SSL_SESSION_free(session);
+    }
+    stats = manager.snapshot();
+    if (stats.cache_entries > 4 || stats.cache_evictions == 0) {
+        std::cerr << "[T102] eviction mismatch: entries=" << stats.cache_entries << "\n";
+        return 1;
+    }
+
+    // 关闭票据与缓存后不再恢复
+    HttpTlsSessionManager disabled;
+    SSL_CTX* plain_ctx = makeServerCtx();
+    config.session_cache = false;
+    disabled.install(plain_ctx, config, 1, error);
+    SSL_SESSION* session = nullptr;
+    if (handshake(plain_ctx, client_ctx, session) != 0 || handshake(plain_ctx, client_ctx, session) != 0 ||
+        disabled.snapshot().full_handshakes != 2) {
+        std::cerr << "[T102] disabled resumption mismatch\n";
+        return 1;
+    }
+    SSL_SESSION_free(session);
+    SSL_CTX_free(plain_ctx);
+    SSL_CTX_free(client_ctx);
+    SSL_CTX_free(server_ctx);
+    return 0;
+}
+
+} // namespace
+#endif
+
+int main() {
+#ifndef GALAY_HTTP_SSL_ENABLED
+    std::cout << "T102-TlsSession SKIP (SSL disabled)\n";
+    return 0;
+#else
+    if (!makeSelfSigned()) {
+        std::cerr << "[T102] certificate generation failed\n";
+        return 1;
+    }
+    if (testTickets() != 0 || testKeyRotation() != 0 || testSessionCache() != 0) {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+    X509_free(g_cert);
+    EVP_PKEY_free(g_key);
+    std::cout << "T102-TlsSession PASS\n";
+    return 0;
+#endif
+}
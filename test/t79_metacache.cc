@@ -0,0 +1,102 @@
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "galay-http/kernel/http/static_meta.h"
+
+int main() {
+    using namespace galay::http;
+
+    // IMF-fixdate 格式化与三种历史格式解析
+    if (HttpDate::format(784111777) != "Sun, 06 Nov 1994 08:49:37 GMT") {
+        std::cerr << "[T79] IMF-fixdate format mismatch: " << HttpDate::format(784111777) << "\n";
+        return 1;
+    }
+    for (std::string_view value : {std::string_view("Sun, 06 Nov 1994 08:49:37 GMT"),
+                                    std::string_view("Sunday, 06-Nov-94 08:49:37 GMT"),
+                                    std::string_view("Sun Nov  6 08:49:37 1994")}) {
+        std::time_t parsed = 0;
+        if (!HttpDate::parse(value, parsed) || parsed != 784111777) {
+            std::cerr << "[T79] failed to parse http date: " << value << "\n";
+            return 1;
+        }
+    }
+    std::time_t ignored = 0;
+    if (HttpDate::parse("Sun, 31 Feb 1994 08:49:37 GMT", ignored) ||
+        HttpDate::parse("not a date", ignored)) {
+        std::cerr << "[T79] invalid http date should be rejected\n";
+        return 1;
+    }
+    for (std::time_t t : {std::time_t(0), std::time_t(951782400), std::time_t(4102444799)}) {
+        std::time_t parsed = 0;
+        if (!HttpDate::parse(HttpDate::format(t), parsed) || parsed != t) {
+            std::cerr << "[T79] http date round-trip mismatch at " << t << "\n";
+            return 1;
+        }
+    }
+
+    // 预构造 304 与条件判断
+    auto meta = StaticFileMeta::create("/srv/www/index.html", 1024, 784111777, 42,
+                                       ETagGenerator::generateStrong(42, 1024, 784111777),
+                                       "text/html");
+    const std::string& rsp = meta->not_modified_response;
+    if (rsp.rfind("HTTP/1.1 304", 0) != 0 ||
+        rsp.find(meta->etag) == std::string::npos ||
+        rsp.find("Sun, 06 Nov 1994 08:49:37 GMT") == std::string::npos ||
+        rsp.size() < 4 || rsp.compare(rsp.size() - 4, 4, "\r\n\r\n") != 0) {
+        std::cerr << "[T79] prebuilt 304 response is malformed:\n" << rsp << "\n";
+        return 1;
+    }
+    if (!meta->notModified(meta->etag, "") ||
+        !meta->notModified("\"other\", " + meta->etag, "") ||
+        !meta->notModified("*", "")) {
+        std::cerr << "[T79] matching If-None-Match should yield 304\n";
+        return 1;
+    }
+    if (meta->notModified("\"other\"", "Sun, 06 Nov 1994 08:49:37 GMT")) {
+        std::cerr << "[T79] If-None-Match must take precedence over If-Modified-Since\n";
+        return 1;
+    }
+    if (!meta->notModified("", "Sun, 06 Nov 1994 08:49:37 GMT") ||
+        meta->notModified("", "Sun, 06 Nov 1994 08:49:36 GMT")) {
+        std::cerr << "[T79] If-Modified-Since comparison mismatch\n";
+        return 1;
+    }
+
+    // 线程局部缓存：命中、TTL 过期、挂载点隔离与容量淘汰
+    auto& cache = StaticFileMetaCache::local();
+    cache.clear();
+    const uint64_t mount = StaticFileMetaCache::nextMountId();
+    const uint64_t other_mount = StaticFileMetaCache::nextMountId();
+    const auto ttl = std::chrono::milliseconds(1000);
+    const auto now = std::chrono::steady_clock::now();
+
+    cache.store(mount, "index.html", meta, 2);
+    if (cache.lookup(mount, "index.html", ttl, now) != meta) {
+        std::cerr << "[T79] cache lookup should hit fresh entry\n";
+        return 1;
+    }
+    if (cache.lookup(other_mount, "index.html", ttl, now) != nullptr) {
+        std::cerr << "[T79] cache entries must be isolated per mount\n";
+        return 1;
+    }
+    if (cache.lookup(mount, "index.html", ttl, now + std::chrono::seconds(2)) != nullptr) {
+        std::cerr << "[T79] expired entry should miss\n";
+        return 1;
+    }
+    cache.store(mount, "a.css", meta, 2);
+    cache.store(mount, "b.js", meta, 2);
+    if (cache.size() != 2 || cache.stats().evictions != 1) {
+        std::cerr << "[T79] cache should evict when exceeding max entries\n";
+        return 1;
+    }
+    if (cache.stats().hits != 1 || cache.stats().misses != 2) {
+        std::cerr << "[T79] cache stats mismatch\n";
+        return 1;
+    }
+
+    std::cout << "T79-HttpDateMetaCache PASS\n";
+    return 0;
+}
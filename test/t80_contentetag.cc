@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/content_etag.h"
+
+int main() {
+    using namespace galay::http;
+
+    // XXH64 官方测试向量
+    if (Xxh64::hash("", 0) != 0xEF46DB3751D8E999ULL ||
+        Xxh64::hash("abc", 3) != 0x44BC2CF5AD770999ULL) {
+        std::cerr << "[T80] xxh64 short input mismatch\n";
+        return 1;
+    }
+    const std::string long_input = "Nobody inspects the spammish repetition";
+    if (Xxh64::hash(long_input.data(), long_input.size()) != 0xFBCEA83C8A378BF1ULL) {
+        std::cerr << "[T80] xxh64 long input mismatch\n";
+        return 1;
+    }
+    // 流式输入与一次性输入一致
+    std::string big(100000, '\0');
+    for (size_t i = 0; i < big.size(); ++i) {
+        big[i] = static_cast<char>(i * 131 + 7);
+    }
+    Xxh64 streaming;
+    for (size_t off = 0; off < big.size(); off += 4093) {
+        streaming.update(big.data() + off, std::min<size_t>(4093, big.size() - off));
+    }
+    if (streaming.digest() != Xxh64::hash(big.data(), big.size())) {
+        std::cerr << "[T80] xxh64 streaming mismatch\n";
+        return 1;
+    }
+
+    char path[] = "/tmp/galay_t80_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, big.data(), big.size()) != static_cast<ssize_t>(big.size())) {
+        std::cerr << "[T80] failed to create temp file\n";
+        return 1;
+    }
+    close(fd);
+    struct stat st;
+    stat(path, &st);
+
+    auto& store = ContentETagStore::instance();
+    store.clear();
+
+    // 未安装执行器：不做哈希，也不标记计算中
+    auto none = store.request(path, st.st_ino, st.st_size, st.st_mtime);
+    if (none.etag || none.pending) {
+        std::cerr << "[T80] store without executor should not hash\n";
+        return 1;
+    }
+
+    // 执行器只排队，不立即执行：首次请求应返回 pending，且重复请求不重复提交
+    std::vector<std::function<void()>> queued;
+    int owner = 0;
+    store.setExecutor(&owner, [&queued](std::function<void()> job) {
+        queued.push_back(std::move(job));
+        return true;
+    });
+    auto first = store.request(path, st.st_ino, st.st_size, st.st_mtime);
+    auto second = store.request(path, st.st_ino, st.st_size, st.st_mtime);
+    if (first.etag || !first.pending || !second.pending || queued.size() != 1) {
+        std::cerr << "[T80] pending hash should be deduplicated\n";
+        return 1;
+    }
+    queued.front()();
+    auto ready = store.request(path, st.st_ino, st.st_size, st.st_mtime);
+    const std::string expected = ContentETagStore::formatETag(Xxh64::hash(big.data(), big.size()));
+    if (!ready.etag || *ready.etag != expected || ready.pending) {
+        std::cerr << "[T80] content etag mismatch after hashing\n";
+        return 1;
+    }
+    if (expected.size() != 24 || expected.front() != '"' || expected.back() != '"') {
+        std::cerr << "[T80] content etag should be a quoted strong etag: " << expected << "\n";
+        return 1;
+    }
+
+    // 新的文件版本（mtime 变化）换键重新计算
+    auto next_version = store.request(path, st.st_ino, st.st_size, st.st_mtime + 1);
+    if (!next_version.pending || queued.size() != 2) {
+        std::cerr << "[T80] new file version should trigger another hash\n";
+        return 1;
+    }
+
+    store.clearExecutor(&owner);
+    unlink(path);
+    if (ContentETagStore::hashFile(path).has_value()) {
+        std::cerr << "[T80] missing file should fail to hash\n";
+        return 1;
+    }
+
+    std::cout << "T80-ContentETag PASS\n";
+    return 0;
+}
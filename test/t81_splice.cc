@@ -0,0 +1,269 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "galay-http/kernel/http/splice_pipe.h"
+#include "galay-http/kernel/http/proxy_stats.h"
+
+namespace {
+
+// 建立一对回环 TCP 连接：返回 {client_fd, server_fd}
+bool makeTcpPair(int& client_fd, int& server_fd) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (listener < 0 ||
+        bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return false;
+    }
+    client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(client_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        return false;
+    }
+    server_fd = accept(listener, nullptr, nullptr);
+    close(listener);
+    if (server_fd < 0) {
+        return false;
+    }
+    fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL) | O_NONBLOCK);
+    fcntl(server_fd, F_SETFL, fcntl(server_fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    using namespace galay::http;
+
+    if (!SplicePipePool::isSupported()) {
+        std::cout << "T81-SpliceRelay SKIP (splice unsupported)\n";
+        return 0;
+    }
+
+    int upstream_peer = -1, upstream = -1, downstream = -1, downstream_peer = -1;
+    if (!makeTcpPair(upstream_peer, upstream) || !makeTcpPair(downstream, downstream_peer)) {
+        std::cerr << "[T81] failed to create loopback tcp pairs\n";
+        return 1;
+    }
+
+    auto& pool = SplicePipePool::local();
+    auto pipe = pool.acquire();
+    if (!pipe || !pipe->valid() || pipe->capacity == 0) {
+        std::cerr << "[T81] failed to acquire splice pipe\n";
+        return 1;
+    }
+
+    // 上游暂无数据：pump 立即返回 input_drained
+    auto idle = SplicePipePool::pump(upstream, downstream, *pipe);
+    if (idle.error != 0 || !idle.input_drained || idle.bytes_in != 0) {
+        std::cerr << "[T81] idle pump should report drained input\n";
+        return 1;
+    }
+
+    std::string payload(48 * 1024, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>('a' + i % 26);
+    }
+    if (write(upstream_peer, payload.data(), payload.size()) != static_cast<ssize_t>(payload.size())) {
+        std::cerr << "[T81] failed to write upstream payload\n";
+        return 1;
+    }
+    shutdown(upstream_peer, SHUT_WR);
+
+    size_t moved = 0;
+    bool eof = false;
+    for (int round = 0; round < 1000 && !eof; ++round) {
+        auto pumped = SplicePipePool::pump(upstream, downstream, *pipe);
+        if (pumped.error != 0) {
+            std::cerr << "[T81] splice pump failed: " << std::strerror(pumped.error) << "\n";
+            return 1;
+        }
+        moved += pumped.bytes_out;
+        eof = pumped.input_eof && pipe->pending == 0;
+        if (!eof) {
+            usleep(1000);
+        }
+    }
+    if (!eof || moved != payload.size()) {
+        std::cerr << "[T81] splice should relay full payload, moved=" << moved << "\n";
+        return 1;
+    }
+
+    std::string received;
+    char buffer[8192];
+    for (int round = 0; round < 1000 && received.size() < payload.size(); ++round) {
+        ssize_t n = read(downstream_peer, buffer, sizeof(buffer));
+        if (n > 0) {
+            received.append(buffer, static_cast<size_t>(n));
+        } else {
+            usleep(1000);
+        }
+    }
+    if (received != payload) {
+        std::cerr << "[T81] downstream content mismatch\n";
+        return 1;
+    }
+
+    // 已排空的管道回到池中复用
+    pool.release(*pipe);
+    if (pool.idleCount() != 1) {
+        std::cerr << "[T81] drained pipe should return to pool\n";
+        return 1;
+    }
+    auto reused = pool.acquire();
+    if (!reused || reused->read_fd != pipe->read_fd || pool.createdCount() != 1) {
+        std::cerr << "[T81] pipe pool should reuse idle pipe\n";
+        return 1;
+    }
+    pool.release(*reused);
+
+    // 慢下游：输出阻塞时只取管道头 1 字节等待可写（对应路由中的 awaitDownstreamWritable），其余继续 splice
+    {
+        int slow_up_peer = -1, slow_up = -1, slow_down = -1, slow_down_peer = -1;
+        if (!makeTcpPair(slow_up_peer, slow_up) || !makeTcpPair(slow_down, slow_down_peer)) {
+            std::cerr << "[T81] failed to create slow tcp pairs\n";
+            return 1;
+        }
+        const int small = 4096;
+        setsockopt(slow_down, SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+        // 两端对端由阻塞的读写线程驱动
+        fcntl(slow_up_peer, F_SETFL, fcntl(slow_up_peer, F_GETFL) & ~O_NONBLOCK);
+        fcntl(slow_down_peer, F_SETFL, fcntl(slow_down_peer, F_GETFL) & ~O_NONBLOCK);
+
+        std::string big(1 << 20, '\0');
+        for (size_t i = 0; i < big.size(); ++i) {
+            big[i] = static_cast<char>('a' + (i * 7) % 26);
+        }
+        std::thread writer([&] {
+            size_t off = 0;
+            while (off < big.size()) {
+                const ssize_t n = write(slow_up_peer, big.data() + off, big.size() - off);
+                if (n <= 0) {
+                    break;
+                }
+                off += static_cast<size_t>(n);
+            }
+            shutdown(slow_up_peer, SHUT_WR);
+        });
+        std::string got;
+        std::thread reader([&] {
+            char chunk[1024];
+            while (got.size() < big.size()) {
+                const ssize_t n = read(slow_down_peer, chunk, sizeof(chunk));
+                if (n <= 0) {
+                    break;
+                }
+                got.append(chunk, static_cast<size_t>(n));
+                usleep(50);
+            }
+        });
+
+        auto slow_pipe = pool.acquire();
+        size_t spliced = 0;
+        size_t copied = 0;
+        bool done = false;
+        while (slow_pipe && !done) {
+            auto pumped = SplicePipePool::pump(slow_up, slow_down, *slow_pipe);
+            spliced += pumped.bytes_out;
+            if (pumped.error != 0) {
+                break;
+            }
+            if (pumped.output_blocked) {
+                char head = 0;
+                if (read(slow_pipe->read_fd, &head, 1) != 1) {
+                    break;
+                }
+                slow_pipe->pending -= 1;
+                // 协程化 send 遇到 EAGAIN 时重新等待可写，这里以 poll 循环模拟
+                ssize_t sent = -1;
+                for (int wait = 0; wait < 5000 && sent != 1; ++wait) {
+                    pollfd pfd{slow_down, POLLOUT, 0};
+                    poll(&pfd, 1, 1);
+                    sent = write(slow_down, &head, 1);
+                }
+                if (sent != 1) {
+                    break;
+                }
+                ++copied;
+                continue;
+            }
+            if (pumped.input_eof && slow_pipe->pending == 0) {
+                done = true;
+            } else if (pumped.input_drained) {
+                pollfd pfd{slow_up, POLLIN, 0};
+                poll(&pfd, 1, 5000);
+            }
+        }
+        writer.join();
+        shutdown(slow_down, SHUT_WR);
+        reader.join();
+        if (!done || got != big || spliced + copied != big.size() || copied == 0 || copied * 64 > big.size()) {
+            std::cerr << "[T81] slow downstream relay mismatch: spliced=" << spliced << " copied=" << copied << "\n";
+            return 1;
+        }
+        pool.release(*slow_pipe);
+        close(slow_up_peer);
+        close(slow_up);
+        close(slow_down);
+        close(slow_down_peer);
+    }
+
+    ProxyStats::instance().reset();
+    ProxyStats::instance().addRaw(moved, 16);
+    ProxyStats::instance().addHttp(100);
+    auto stats = ProxyStats::instance().snapshot();
+    if (stats.raw_requests != 1 || stats.raw_splice_bytes != moved ||
+        stats.raw_buffered_bytes != 16 || stats.http_requests != 1 || stats.http_bytes != 100) {
+        std::cerr << "[T81] proxy stats mismatch\n";
+        return 1;
+    }
+
+    // 各线程写自己的计数槽，线程退出后计数仍计入汇总
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([]() {
+                for (int i = 0; i < 1000; ++i) {
+                    ProxyStats::instance().addHttp(2);
+                    ProxyStats::instance().addPoolHit();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::thread([]() { ProxyStats::instance().addPoolMiss(); }).join();
+        stats = ProxyStats::instance().snapshot();
+        if (stats.http_requests != 4001 || stats.http_bytes != 8100 || stats.pool_hits != 4000 ||
+            stats.pool_misses != 1) {
+            std::cerr << "[T81] per-thread stats should sum across threads\n";
+            return 1;
+        }
+        ProxyStats::instance().reset();
+        if (ProxyStats::instance().snapshot().http_requests != 0) {
+            std::cerr << "[T81] reset should clear every slot\n";
+            return 1;
+        }
+    }
+
+    close(upstream_peer);
+    close(upstream);
+    close(downstream);
+    close(downstream_peer);
+
+    std::cout << "T81-SpliceRelay PASS\n";
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "galay-http/kernel/http/upstream.h"
+
+using namespace galay::http;
+
+namespace {
+
+std::vector<UpstreamEndpoint> threeEndpoints() {
+    return {{"10.0.0.1", 8080, 1}, {"10.0.0.2", 8080, 1}, {"10.0.0.3", 8080, 1}};
+}
+
+} // namespace
+
+int main() {
+    if (UpstreamGroup::create({}) != nullptr) {
+        std::cerr << "[T82] empty upstream group should be rejected\n";
+        return 1;
+    }
+
+    // 轮询：均匀分布
+    {
+        auto group = UpstreamGroup::create(threeEndpoints());
+        std::vector<int> hits(3, 0);
+        for (int i = 0; i < 300; ++i) {
+            ++hits[group->select().index];
+        }
+        if (hits[0] != 100 || hits[1] != 100 || hits[2] != 100) {
+            std::cerr << "[T82] round-robin should distribute evenly\n";
+            return 1;
+        }
+    }
+
+    // 平滑加权轮询：按权重比例，且不连续堆积在高权重实例上
+    {
+        UpstreamGroupConfig config;
+        config.policy = LoadBalancePolicy::Weighted;
+        auto group = UpstreamGroup::create({{"a", 1, 3}, {"b", 1, 1}}, config);
+        std::vector<int> hits(2, 0);
+        size_t max_run = 0, run = 0, last = 99;
+        for (int i = 0; i < 400; ++i) {
+            size_t pick = group->select().index;
+            ++hits[pick];
+            run = pick == last ? run + 1 : 1;
+            last = pick;
+            max_run = std::max(max_run, run);
+        }
+        if (hits[0] != 300 || hits[1] != 100 || max_run > 3) {
+            std::cerr << "[T82] weighted policy should follow 3:1 smoothly\n";
+            return 1;
+        }
+    }
+
+    // 最少在途：避开已有在途请求的实例
+    {
+        UpstreamGroupConfig config;
+        config.policy = LoadBalancePolicy::LeastOutstanding;
+        auto group = UpstreamGroup::create(threeEndpoints(), config);
+        UpstreamGroup::Lease busy0(*group, 0);
+        UpstreamGroup::Lease busy1(*group, 0);
+        UpstreamGroup::Lease busy2(*group, 1);
+        for (int i = 0; i < 10; ++i) {
+            if (group->select().index != 2) {
+                std::cerr << "[T82] least-outstanding should pick the idle endpoint\n";
+                return 1;
+            }
+        }
+    }
+
+    // 峰值 EWMA：低延迟实例获得绝大多数流量
+    {
+        UpstreamGroupConfig config;
+        config.policy = LoadBalancePolicy::PeakEwma;
+        auto group = UpstreamGroup::create(threeEndpoints(), config);
+        for (size_t i = 0; i < 3; ++i) {
+            group->onRequestStart(i);
+            group->onRequestEnd(i, std::chrono::milliseconds(i == 1 ? 1 : 50), true);
+        }
+        std::vector<int> hits(3, 0);
+        for (int i = 0; i < 300; ++i) {
+            ++hits[group->select().index];
+        }
+        // P2C 中只有两个慢实例被同时抽中时才会选到慢实例，约占 1/3
+        if (hits[1] < 180) {
+            std::cerr << "[T82] peak-ewma should prefer the fast endpoint, hits=" << hits[1] << "\n";
+            return 1;
+        }
+    }
+
+    // 合并：其他线程的在途请求在合并后可见
+    {
+        UpstreamGroupConfig config;
+        config.policy = LoadBalancePolicy::LeastOutstanding;
+        config.merge_interval = std::chrono::milliseconds(0);
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 1, 1}}, config);
+        std::thread worker([&group]() {
+            group->onRequestStart(0);
+            group->onRequestStart(0);
+            group->flush();
+        });
+        worker.join();
+        for (int i = 0; i < 4; ++i) {
+            if (group->select().index != 1) {
+                std::cerr << "[T82] remote outstanding should be visible after merge\n";
+                return 1;
+            }
+        }
+        group->onRequestStart(1);
+        group->onRequestEnd(1, std::chrono::microseconds(200), false);
+        group->flush();
+        auto stats = group->stats();
+        if (stats[0].outstanding != 2 || stats[1].requests != 1 || stats[1].failures != 1) {
+            std::cerr << "[T82] merged stats mismatch\n";
+            return 1;
+        }
+    }
+
+    // 已销毁组的线程局部状态在下一次合并时释放
+    {
+        auto keeper = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}});
+        keeper->flush();
+        const size_t base = UpstreamGroup::localStateCount();
+        {
+            std::vector<UpstreamGroup::ptr> groups;
+            for (int i = 0; i < 8; ++i) {
+                groups.push_back(UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}}));
+                groups.back()->select();
+            }
+            if (UpstreamGroup::localStateCount() != base + 8) {
+                std::cerr << "[T82] each group should own a local state\n";
+                return 1;
+            }
+        }
+        keeper->flush();
+        if (UpstreamGroup::localStateCount() != base) {
+            std::cerr << "[T82] destroyed groups should be pruned on merge: "
+                      << UpstreamGroup::localStateCount() << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T82-UpstreamGroup PASS\n";
+    return 0;
+}
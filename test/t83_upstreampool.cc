@@ -0,0 +1,215 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/upstream_pool.h"
+
+using namespace galay::http;
+
+namespace {
+
+// 模拟 HttpClient：持有 socketpair 的一端，析构时关闭
+struct FakeClient {
+    struct Handle { int fd = -1; };
+    struct Socket {
+        Handle h;
+        const Handle& handle() const { return h; }
+    };
+
+    FakeClient() {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0) {
+            sock.h.fd = fds[0];
+            peer = fds[1];
+        }
+    }
+    ~FakeClient() {
+        if (sock.h.fd >= 0) close(sock.h.fd);
+        if (peer >= 0) close(peer);
+    }
+    Socket& socket() { return sock; }
+
+    Socket sock;
+    int peer = -1;
+};
+
+using Pool = UpstreamConnectionPool<FakeClient>;
+using Clock = Pool::Clock;
+
+} // namespace
+
+int main() {
+    const auto t0 = Clock::now();
+    UpstreamPoolConfig config;
+    config.max_idle = 2;
+    config.max_total = 3;
+    config.idle_timeout = std::chrono::milliseconds(1000);
+
+    // 未命中新建，归还后命中复用
+    {
+        Pool pool;
+        auto a = pool.acquire("u:1", config, t0);
+        if (!a || a.reused() || pool.stats("u:1").misses != 1 || pool.stats("u:1").open != 1) {
+            std::cerr << "[T83] first acquire should create a connection\n";
+            return 1;
+        }
+        const int fd = a->socket().handle().fd;
+        pool.release(std::move(a), t0);
+        auto b = pool.acquire("u:1", config, t0);
+        if (!b || !b.reused() || b->socket().handle().fd != fd || pool.stats("u:1").hits != 1) {
+            std::cerr << "[T83] released connection should be reused\n";
+            return 1;
+        }
+    }
+
+    // 总数上限与空闲上限
+    {
+        Pool pool;
+        auto a = pool.acquire("u:1", config, t0);
+        auto b = pool.acquire("u:1", config, t0);
+        auto c = pool.acquire("u:1", config, t0);
+        auto d = pool.acquire("u:1", config, t0);
+        if (d || !d.exhausted() || pool.stats("u:1").exhausted != 1) {
+            std::cerr << "[T83] max_total should reject the fourth connection\n";
+            return 1;
+        }
+        c.discard();
+        if (pool.stats("u:1").open != 2) {
+            std::cerr << "[T83] discard should free a slot\n";
+            return 1;
+        }
+        auto e = pool.acquire("u:1", config, t0);
+        pool.release(std::move(a), t0);
+        pool.release(std::move(b), t0);
+        pool.release(std::move(e), t0);
+        auto stats = pool.stats("u:1");
+        if (stats.idle != 2 || stats.evictions != 1 || stats.open != 2) {
+            std::cerr << "[T83] max_idle should cap idle connections\n";
+            return 1;
+        }
+    }
+
+    // 对端关闭或残留数据的空闲连接不被复用
+    {
+        Pool pool;
+        auto a = pool.acquire("u:1", config, t0);
+        auto b = pool.acquire("u:1", config, t0);
+        shutdown(a->peer, SHUT_WR);
+        if (write(b->peer, "x", 1) != 1) {
+            std::cerr << "[T83] failed to write stray byte\n";
+            return 1;
+        }
+        pool.release(std::move(a), t0);
+        pool.release(std::move(b), t0);
+        auto c = pool.acquire("u:1", config, t0);
+        auto stats = pool.stats("u:1");
+        if (c.reused() || stats.probe_failures != 2 || stats.evictions != 2 || stats.open != 1) {
+            std::cerr << "[T83] probe should discard dead idle connections\n";
+            return 1;
+        }
+        pool.noteStaleRetry("u:1");
+        if (pool.stats("u:1").stale_retries != 1) {
+            std::cerr << "[T83] stale retry should be counted\n";
+            return 1;
+        }
+    }
+
+    // 超时回收
+    {
+        Pool pool;
+        auto a = pool.acquire("u:1", config, t0);
+        auto b = pool.acquire("u:2", config, t0);
+        pool.release(std::move(a), t0);
+        pool.release(std::move(b), t0 + std::chrono::milliseconds(900));
+        if (!pool.needsEvictor()) {
+            std::cerr << "[T83] idle connections should request the evictor\n";
+            return 1;
+        }
+        if (pool.evictExpired(t0 + std::chrono::milliseconds(1500)) != 1 ||
+            pool.stats("u:1").idle != 0 || pool.stats("u:2").idle != 1) {
+            std::cerr << "[T83] only expired connections should be evicted\n";
+            return 1;
+        }
+        if (pool.evictExpired(t0 + std::chrono::milliseconds(2000)) != 0 || pool.needsEvictor()) {
+            std::cerr << "[T83] evictor should stop when pool drains\n";
+            return 1;
+        }
+    }
+
+    // 预热
+    {
+        Pool pool;
+        UpstreamPoolConfig warm = config;
+        warm.min_idle = 2;
+        auto a = pool.acquire("u:1", warm, t0);
+        if (pool.warmDeficit("u:1") != 2) {
+            std::cerr << "[T83] warm deficit should match min_idle\n";
+            return 1;
+        }
+        auto w1 = pool.reserveWarm("u:1");
+        auto w2 = pool.reserveWarm("u:1");
+        if (pool.warmDeficit("u:1") != 0) {
+            std::cerr << "[T83] in-flight warms should cover the deficit\n";
+            return 1;
+        }
+        pool.release(std::move(w1), t0);
+        w2.discard();
+        auto stats = pool.stats("u:1");
+        if (stats.warm_connects != 1 || stats.idle != 1 || stats.open != 2 || pool.warmDeficit("u:1") != 1) {
+            std::cerr << "[T83] warm accounting mismatch\n";
+            return 1;
+        }
+    }
+
+    // 丢弃、探测失败、超出空闲上限、超时与清空的连接都交给回收回调关闭
+    {
+        Pool pool;
+        std::vector<int> retired;
+        pool.setRetireHook([&retired](Pool::ClientPtr client) { retired.push_back(client->socket().handle().fd); });
+        auto a = pool.acquire("u:1", config, t0);
+        auto b = pool.acquire("u:1", config, t0);
+        auto c = pool.acquire("u:1", config, t0);
+        const int discarded = c->socket().handle().fd;
+        c.discard();
+        auto d = pool.acquire("u:1", config, t0);
+        const int renewed = d->socket().handle().fd;
+        d.renew();
+        if (retired != std::vector<int>{discarded, renewed} || pool.stats("u:1").open != 3) {
+            std::cerr << "[T83] discarded and renewed connections should be retired\n";
+            return 1;
+        }
+        d.discard();
+        if (retired.size() != 3 || pool.stats("u:1").open != 2) {
+            std::cerr << "[T83] discarded connections should be retired\n";
+            return 1;
+        }
+
+        shutdown(a->peer, SHUT_WR);
+        pool.release(std::move(a), t0);
+        auto e = pool.acquire("u:1", config, t0);
+        auto f = pool.acquire("u:1", config, t0);
+        pool.release(std::move(b), t0);
+        pool.release(std::move(e), t0);
+        pool.release(std::move(f), t0);
+        if (retired.size() != 5 || pool.stats("u:1").idle != 2) {
+            std::cerr << "[T83] probe failures and idle overflow should be retired: " << retired.size() << "\n";
+            return 1;
+        }
+        if (pool.evictExpired(t0 + std::chrono::milliseconds(1500)) != 0 || retired.size() != 7) {
+            std::cerr << "[T83] expired connections should be retired\n";
+            return 1;
+        }
+        auto g = pool.acquire("u:1", config, t0);
+        pool.release(std::move(g), t0);
+        pool.clear();
+        if (retired.size() != 8 || pool.stats("u:1").open != 0) {
+            std::cerr << "[T83] cleared connections should be retired\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T83-UpstreamPool PASS\n";
+    return 0;
+}
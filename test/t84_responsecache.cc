@@ -0,0 +1,177 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "galay-http/kernel/http/response_cache.h"
+
+using namespace galay::http;
+
+namespace {
+
+HttpResponseHeader makeResponse(const std::string& cache_control,
+                                HttpStatusCode code = HttpStatusCode::OK_200) {
+    HttpResponseHeader header;
+    header.version() = HttpVersion::HttpVersion_1_1;
+    header.code() = code;
+    header.headerPairs().addHeaderPair("Content-Type", "text/plain");
+    header.headerPairs().addHeaderPair("Connection", "keep-alive");
+    if (!cache_control.empty()) {
+        header.headerPairs().addHeaderPair("Cache-Control", cache_control);
+    }
+    return header;
+}
+
+} // namespace
+
+int main() {
+    using Clock = ResponseCache::Clock;
+    const auto t0 = Clock::now();
+    ResponseCacheConfig config;
+    config.enabled = true;
+    HeaderPair request;
+    const std::string key = ResponseCache::primaryKey("GET", "Example.com", "/a");
+
+    // Cache-Control 解析
+    {
+        auto cc = CacheControl::parse("Public, max-age=60, s-maxage=\"120\", stale-while-revalidate=30");
+        if (!cc.is_public || cc.max_age.value_or(0) != 60 || cc.s_maxage.value_or(0) != 120 ||
+            cc.stale_while_revalidate.value_or(0) != 30 || cc.no_store) {
+            std::cerr << "[T84] cache-control parse mismatch\n";
+            return 1;
+        }
+        if (CacheControl::parse("max-age=abc").max_age.value_or(-1) != 0) {
+            std::cerr << "[T84] invalid max-age should be treated as 0\n";
+            return 1;
+        }
+    }
+
+    // 不可缓存的响应
+    {
+        ResponseCache cache;
+        auto no_store = makeResponse("no-store, max-age=60");
+        auto priv = makeResponse("private, max-age=60");
+        auto no_fresh = makeResponse("");
+        auto partial = makeResponse("max-age=60", HttpStatusCode::PartialContent_206);
+        if (cache.store(key, request, no_store, "x", config, t0) ||
+            cache.store(key, request, priv, "x", config, t0) ||
+            cache.store(key, request, no_fresh, "x", config, t0) ||
+            cache.store(key, request, partial, "x", config, t0)) {
+            std::cerr << "[T84] uncacheable responses must not be stored\n";
+            return 1;
+        }
+        HeaderPair auth;
+        auth.addHeaderPair("Authorization", "Bearer x");
+        auto plain = makeResponse("max-age=60");
+        if (cache.store(key, auth, plain, "x", config, t0)) {
+            std::cerr << "[T84] authorized response requires public/s-maxage\n";
+            return 1;
+        }
+    }
+
+    // 新鲜命中、Age 改写、逐跳头部剥离、s-maxage 优先
+    {
+        ResponseCache cache;
+        auto header = makeResponse("public, max-age=5, s-maxage=60");
+        header.headerPairs().addHeaderPair("Age", "3");
+        if (!cache.store(key, request, header, "hello", config, t0)) {
+            std::cerr << "[T84] cacheable response should be stored\n";
+            return 1;
+        }
+        auto hit = cache.lookup(key, request, t0 + std::chrono::seconds(10));
+        if (hit.state != ResponseCache::State::Fresh || !hit.entry) {
+            std::cerr << "[T84] s-maxage should keep the entry fresh\n";
+            return 1;
+        }
+        const std::string& wire = hit.entry->wire;
+        if (wire.find("0000000013\r\n") == std::string::npos ||
+            wire.find("ength: 5\r\n") == std::string::npos ||
+            wire.find("eep-alive") != std::string::npos ||
+            wire.substr(wire.size() - 5) != "hello") {
+            std::cerr << "[T84] serialized response mismatch:\n" << wire << "\n";
+            return 1;
+        }
+        if (cache.lookup(key, request, t0 + std::chrono::seconds(58)).state != ResponseCache::State::Miss) {
+            std::cerr << "[T84] upstream Age should shorten freshness\n";
+            return 1;
+        }
+    }
+
+    // stale-while-revalidate：只有第一次过期命中负责刷新
+    {
+        ResponseCache cache;
+        auto header = makeResponse("max-age=10, stale-while-revalidate=20");
+        cache.store(key, request, header, "v1", config, t0);
+        auto first = cache.lookup(key, request, t0 + std::chrono::seconds(15));
+        auto second = cache.lookup(key, request, t0 + std::chrono::seconds(16));
+        if (first.state != ResponseCache::State::Stale || !first.refresh || second.refresh) {
+            std::cerr << "[T84] stale hit should trigger exactly one refresh\n";
+            return 1;
+        }
+        ResponseCache::finishRefresh(first.entry);
+        if (!cache.lookup(key, request, t0 + std::chrono::seconds(17)).refresh) {
+            std::cerr << "[T84] refresh should be re-armed after finishing\n";
+            return 1;
+        }
+        if (cache.lookup(key, request, t0 + std::chrono::seconds(31)).state != ResponseCache::State::Miss) {
+            std::cerr << "[T84] entry beyond the swr window should miss\n";
+            return 1;
+        }
+        auto strict = makeResponse("max-age=10, stale-while-revalidate=20, must-revalidate");
+        cache.store(key, request, strict, "v2", config, t0);
+        if (cache.lookup(key, request, t0 + std::chrono::seconds(15)).state != ResponseCache::State::Miss) {
+            std::cerr << "[T84] must-revalidate should disable stale serving\n";
+            return 1;
+        }
+    }
+
+    // Vary
+    {
+        ResponseCache cache;
+        HeaderPair gzip;
+        gzip.addHeaderPair("Accept-Encoding", "gzip");
+        HeaderPair br;
+        br.addHeaderPair("Accept-Encoding", "br");
+        auto header = makeResponse("max-age=60");
+        header.headerPairs().addHeaderPair("Vary", "Accept-Encoding");
+        cache.store(key, gzip, header, "gz", config, t0);
+        if (cache.lookup(key, br, t0).state != ResponseCache::State::Miss ||
+            cache.lookup(key, gzip, t0).state != ResponseCache::State::Fresh) {
+            std::cerr << "[T84] vary should select variants by request header\n";
+            return 1;
+        }
+        auto star = makeResponse("max-age=60");
+        star.headerPairs().addHeaderPair("Vary", "*");
+        if (cache.store(ResponseCache::primaryKey("GET", "example.com", "/b"), request, star, "x", config, t0)) {
+            std::cerr << "[T84] vary * must not be stored\n";
+            return 1;
+        }
+        HeaderPair no_cache;
+        no_cache.addHeaderPair("Cache-Control", "no-cache");
+        if (ResponseCache::canServeFromCache(no_cache) || !ResponseCache::canServeFromCache(gzip)) {
+            std::cerr << "[T84] request no-cache should bypass lookup\n";
+            return 1;
+        }
+    }
+
+    // LRU 容量
+    {
+        ResponseCache cache;
+        ResponseCacheConfig small = config;
+        small.max_entries = 2;
+        auto header = makeResponse("max-age=60");
+        for (const char* uri : {"/1", "/2"}) {
+            cache.store(ResponseCache::primaryKey("GET", "h", uri), request, header, "x", small, t0);
+        }
+        cache.lookup(ResponseCache::primaryKey("GET", "h", "/1"), request, t0);
+        cache.store(ResponseCache::primaryKey("GET", "h", "/3"), request, header, "x", small, t0);
+        if (cache.size() != 2 || cache.stats().evictions != 1 ||
+            cache.lookup(ResponseCache::primaryKey("GET", "h", "/2"), request, t0).state != ResponseCache::State::Miss ||
+            cache.lookup(ResponseCache::primaryKey("GET", "h", "/1"), request, t0).state != ResponseCache::State::Fresh) {
+            std::cerr << "[T84] least recently used entry should be evicted\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T84-ResponseCache PASS\n";
+    return 0;
+}
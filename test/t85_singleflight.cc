@@ -0,0 +1,122 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "galay-http/kernel/http/single_flight.h"
+#include "galay-http/kernel/http/response_cache.h"
+
+using namespace galay::http;
+
+int main() {
+    auto& registry = SingleFlight::instance();
+
+    // leader 与等待者：同一键只产生一个 leader，完成后全部唤醒并共享结果
+    {
+        auto lead = registry.join("GET h /a");
+        auto follow1 = registry.join("GET h /a");
+        auto follow2 = registry.join("GET h /a");
+        auto other = registry.join("GET h /b");
+        if (!lead.leader || follow1.leader || follow2.leader || !other.leader ||
+            follow1.flight != lead.flight || registry.inflight() != 2) {
+            std::cerr << "[T85] join should elect one leader per key\n";
+            return 1;
+        }
+
+        std::atomic<int> woken{0};
+        std::vector<std::thread> waiters;
+        std::atomic<int> subscribed{0};
+        for (auto* joined : {&follow1, &follow2}) {
+            waiters.emplace_back([joined, &woken, &subscribed]() {
+                std::atomic<bool> ready{false};
+                if (!joined->flight->subscribe([&woken, &ready]() {
+                        ready.store(true);
+                        woken.fetch_add(1);
+                    })) {
+                    woken.fetch_add(1);
+                    subscribed.fetch_add(1);
+                    return;
+                }
+                subscribed.fetch_add(1);
+                while (!ready.load()) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        while (subscribed.load() < 2) {
+            std::this_thread::yield();
+        }
+
+        registry.complete("GET h /a", lead.flight, std::make_shared<const std::string>("HTTP/1.1 200 OK\r\n\r\n"));
+        for (auto& t : waiters) {
+            t.join();
+        }
+        if (woken.load() != 2 || !follow1.flight->result() ||
+            *follow2.flight->result() != "HTTP/1.1 200 OK\r\n\r\n") {
+            std::cerr << "[T85] all waiters should be woken with the shared result\n";
+            return 1;
+        }
+        if (follow1.flight->subscribe([]() {})) {
+            std::cerr << "[T85] completed flight should reject new subscribers\n";
+            return 1;
+        }
+        if (!registry.join("GET h /a").leader) {
+            std::cerr << "[T85] completed key should start a new flight\n";
+            return 1;
+        }
+        registry.complete("GET h /b", other.flight, nullptr);
+    }
+
+    // LeaderGuard：leader 提前退出时以空结果完成，等待者回退为自行回源
+    {
+        SingleFlight::FlightPtr flight;
+        bool woke = false;
+        {
+            auto lead = registry.join("GET h /c");
+            SingleFlight::LeaderGuard guard(registry, "GET h /c", lead.flight);
+            auto follow = registry.join("GET h /c");
+            follow.flight->subscribe([&woke]() { woke = true; });
+            flight = follow.flight;
+        }
+        if (!woke || !flight->done() || flight->result() != nullptr) {
+            std::cerr << "[T85] guard should complete with an empty result\n";
+            return 1;
+        }
+    }
+
+    // 共享响应头：剥离逐跳字段，识别私有响应
+    {
+        HttpResponseHeader header;
+        header.version() = HttpVersion::HttpVersion_1_1;
+        header.code() = HttpStatusCode::OK_200;
+        header.headerPairs().addHeaderPair("Connection", "keep-alive, X-Hop");
+        header.headerPairs().addHeaderPair("X-Hop", "1");
+        header.headerPairs().addHeaderPair("Vary", "Accept-Encoding");
+        SharedResponseHeader shared(header);
+        const std::string wire = shared.serialize("body");
+        if (shared.isPrivate() || wire.find("x-hop") != std::string::npos ||
+            wire.find("X-Hop") != std::string::npos || wire.find("eep-alive") != std::string::npos ||
+            wire.substr(wire.size() - 4) != "body") {
+            std::cerr << "[T85] shared header should drop hop-by-hop fields:\n" << wire << "\n";
+            return 1;
+        }
+        header.headerPairs().addHeaderPair("Set-Cookie", "sid=1");
+        if (!SharedResponseHeader(header).isPrivate()) {
+            std::cerr << "[T85] Set-Cookie response must not be shared\n";
+            return 1;
+        }
+    }
+
+    auto stats = registry.stats();
+    if (stats.leaders < 4 || stats.followers != 3 || stats.shared != 2 || stats.fallbacks != 1) {
+        std::cerr << "[T85] stats mismatch leaders=" << stats.leaders << " followers=" << stats.followers
+                  << " shared=" << stats.shared << " fallbacks=" << stats.fallbacks << "\n";
+        return 1;
+    }
+
+    std::cout << "T85-SingleFlight PASS\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "galay-http/kernel/http/h2c_upstream.h"
+
+using namespace galay::http;
+
+namespace {
+
+// 模拟 H2cClient：peer_limit 为对端 SETTINGS_MAX_CONCURRENT_STREAMS，0 表示连接已失效
+struct FakeClient {
+    uint32_t peer_limit = 0;
+};
+
+using Mux = H2cUpstreamMux<FakeClient>;
+
+uint32_t probe(FakeClient& client) { return client.peer_limit; }
+
+} // namespace
+
+int main() {
+    H2cUpstreamConfig config;
+    config.max_connections = 2;
+    config.max_concurrent_streams = 3;
+
+    // 建连期间到达的请求共享同一条连接，完成后一起唤醒
+    {
+        Mux mux;
+        auto first = mux.acquire("u:1", config, probe);
+        auto second = mux.acquire("u:1", config, probe);
+        if (!first.connector() || second.connector() || !second.pending() || &*first != &*second) {
+            std::cerr << "[T86] burst during connect should wait on the same connection\n";
+            return 1;
+        }
+        int woken = 0;
+        second.subscribe([&woken]() { ++woken; });
+        first->peer_limit = 100;
+        first.established(100);
+        if (woken != 1 || !second.usable() || mux.stats("u:1").connects != 1 ||
+            mux.stats("u:1").waits != 1) {
+            std::cerr << "[T86] established connection should wake waiters\n";
+            return 1;
+        }
+    }
+
+    // 饱和后新建连接，并发上限取配置与对端的较小值，达到连接上限后拒绝
+    {
+        Mux mux;
+        std::vector<Mux::Stream> streams;
+        streams.push_back(mux.acquire("u:1", config, probe));
+        streams.back()->peer_limit = 2;
+        streams.back().established(2);
+        streams.push_back(mux.acquire("u:1", config, probe));
+        streams.push_back(mux.acquire("u:1", config, probe));
+        if (!streams.back().connector() || mux.stats("u:1").saturated != 1) {
+            std::cerr << "[T86] peer limit should saturate the first connection\n";
+            return 1;
+        }
+        streams.back()->peer_limit = 100;
+        streams.back().established(100);
+        streams.push_back(mux.acquire("u:1", config, probe));
+        streams.push_back(mux.acquire("u:1", config, probe));
+        auto rejected = mux.acquire("u:1", config, probe);
+        if (rejected || !rejected.exhausted() || mux.stats("u:1").connections != 2 ||
+            mux.stats("u:1").active != 5) {
+            std::cerr << "[T86] configured limit should cap streams per connection\n";
+            return 1;
+        }
+        streams[0].release();
+        auto reused = mux.acquire("u:1", config, probe);
+        if (!reused || reused.connector() || &*reused != &*streams[1]) {
+            std::cerr << "[T86] released stream slot should be reused\n";
+            return 1;
+        }
+    }
+
+    // 失效连接被摘除，最后一个 stream 结束时交给回收回调
+    {
+        Mux mux;
+        std::vector<FakeClient*> retired;
+        mux.setRetireHook([&retired](Mux::ClientPtr client) { retired.push_back(client.get()); });
+        auto a = mux.acquire("u:1", config, probe);
+        a->peer_limit = 10;
+        a.established(10);
+        auto b = mux.acquire("u:1", config, probe);
+        FakeClient* dead = &*a;
+        dead->peer_limit = 0;
+        auto c = mux.acquire("u:1", config, probe);
+        if (!c.connector() || mux.stats("u:1").retired != 1 || !retired.empty()) {
+            std::cerr << "[T86] dead connection should be retired but kept for in-flight streams\n";
+            return 1;
+        }
+        a.release();
+        b.release();
+        if (retired.size() != 1 || retired[0] != dead) {
+            std::cerr << "[T86] last stream should hand the connection to the retire hook\n";
+            return 1;
+        }
+    }
+
+    // 建连失败：等待者被唤醒且不可用；connector 未报告结果即按失败处理
+    {
+        Mux mux;
+        auto a = mux.acquire("u:1", config, probe);
+        auto b = mux.acquire("u:1", config, probe);
+        bool woke = false;
+        b.subscribe([&woke]() { woke = true; });
+        a.release();
+        if (!woke || b.usable() || b.pending() || mux.stats("u:1").connect_failures != 1 ||
+            mux.stats("u:1").connections != 0) {
+            std::cerr << "[T86] abandoned connect should fail waiters\n";
+            return 1;
+        }
+        auto c = mux.acquire("u:1", config, probe);
+        if (!c.connector()) {
+            std::cerr << "[T86] failed connection should not block new connects\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T86-H2cUpstream PASS\n";
+    return 0;
+}
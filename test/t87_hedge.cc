@@ -0,0 +1,124 @@
+#include <chrono>
+#include <iostream>
+
+#include "galay-http/kernel/http/upstream.h"
+
+using namespace galay::http;
+using namespace std::chrono_literals;
+
+int main() {
+    // 延迟窗口：nearest-rank 分位数，只保留最近的样本
+    {
+        LatencyWindow window;
+        for (int i = 1; i <= 100; ++i) {
+            window.observe(std::chrono::milliseconds(i));
+        }
+        if (window.quantile(0.95) != 95ms || window.quantile(0.5) != 50ms ||
+            window.quantile(1.0) != 100ms || window.quantile(0.0) != 1ms) {
+            std::cerr << "[T87] quantile mismatch p95=" << window.quantile(0.95).count() << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < LatencyWindow::kCapacity; ++i) {
+            window.observe(2ms);
+        }
+        if (window.size() != LatencyWindow::kCapacity || window.quantile(0.95) != 2ms) {
+            std::cerr << "[T87] old samples should age out of the window\n";
+            return 1;
+        }
+    }
+
+    // 重试预算：初始满额，按比例存入，按时间保底补充，有上限
+    {
+        HedgeConfig config;
+        config.budget_ratio = 0.5;
+        config.budget_min_per_second = 2.0;
+        config.budget_max_tokens = 3.0;
+        RetryBudget budget;
+        const auto t0 = RetryBudget::Clock::now();
+        int granted = 0;
+        while (budget.tryWithdraw(config, t0)) {
+            ++granted;
+        }
+        if (granted != 3) {
+            std::cerr << "[T87] budget should start full\n";
+            return 1;
+        }
+        budget.deposit(config, t0);
+        if (budget.tryWithdraw(config, t0)) {
+            std::cerr << "[T87] half a token must not grant a retry\n";
+            return 1;
+        }
+        budget.deposit(config, t0);
+        if (!budget.tryWithdraw(config, t0)) {
+            std::cerr << "[T87] two requests at ratio 0.5 should earn one retry\n";
+            return 1;
+        }
+        if (!budget.tryWithdraw(config, t0 + 500ms) || budget.tryWithdraw(config, t0 + 500ms)) {
+            std::cerr << "[T87] min_per_second should refill over time\n";
+            return 1;
+        }
+        budget.tryWithdraw(config, t0 + 60s);
+        if (budget.tokens() > config.budget_max_tokens) {
+            std::cerr << "[T87] tokens should be capped\n";
+            return 1;
+        }
+    }
+
+    // 对冲延迟：样本不足用默认值，之后取分位数并受上下限约束
+    {
+        HedgeConfig config;
+        config.min_samples = 10;
+        config.default_delay = 40ms;
+        config.min_delay = 5ms;
+        config.max_delay = 200ms;
+        HedgeState state;
+        if (state.delay(config) != 40ms) {
+            std::cerr << "[T87] default delay expected without samples\n";
+            return 1;
+        }
+        for (int i = 0; i < 20; ++i) {
+            state.latency.observe(1ms);
+        }
+        if (state.delay(config) != 5ms) {
+            std::cerr << "[T87] delay should be clamped to min_delay\n";
+            return 1;
+        }
+        for (int i = 0; i < 200; ++i) {
+            state.latency.observe(std::chrono::seconds(1));
+        }
+        if (state.delay(config) != 200ms) {
+            std::cerr << "[T87] delay should be clamped to max_delay\n";
+            return 1;
+        }
+    }
+
+    // selectOther 避开主请求实例；abandon 不计失败
+    {
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}, {"c", 3, 1}});
+        for (size_t exclude = 0; exclude < group->size(); ++exclude) {
+            for (int i = 0; i < 10; ++i) {
+                if (group->selectOther(exclude).index == exclude) {
+                    std::cerr << "[T87] selectOther should avoid the excluded endpoint\n";
+                    return 1;
+                }
+            }
+        }
+        if (UpstreamGroup::single("a", 1)->selectOther(0).index != 0) {
+            std::cerr << "[T87] single endpoint group should hedge to itself\n";
+            return 1;
+        }
+        {
+            UpstreamGroup::Lease lease(*group, 1);
+            lease.abandon();
+        }
+        group->flush();
+        auto stats = group->stats();
+        if (stats[1].requests != 1 || stats[1].failures != 0 || stats[1].outstanding != 0) {
+            std::cerr << "[T87] abandoned lease should not count as a failure\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T87-Hedge PASS\n";
+    return 0;
+}
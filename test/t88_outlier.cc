@@ -0,0 +1,237 @@
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <thread>
+
+#include "galay-http/kernel/http/upstream.h"
+
+using namespace galay::http;
+using namespace std::chrono_literals;
+
+namespace {
+
+UpstreamGroupConfig outlierConfig() {
+    UpstreamGroupConfig config;
+    config.policy = LoadBalancePolicy::RoundRobin;
+    config.outlier.enabled = true;
+    config.outlier.consecutive_failures = 3;
+    config.outlier.failure_rate = 0.0;
+    config.outlier.latency_factor = 0.0;
+    config.outlier.base_ejection = 30ms;
+    config.outlier.max_ejection = 1000ms;
+    config.outlier.max_ejection_percent = 50;
+    return config;
+}
+
+void fail(UpstreamGroup& group, size_t index, int times) {
+    for (int i = 0; i < times; ++i) {
+        UpstreamGroup::Lease lease(group, index);
+        lease.finish(false);
+    }
+}
+
+std::set<size_t> selectMany(UpstreamGroup& group, int rounds) {
+    std::set<size_t> seen;
+    for (int i = 0; i < rounds; ++i) {
+        const UpstreamGroup::Pick pick = group.select();
+        UpstreamGroup::Lease lease(group, pick);
+        lease.finish(true);
+        seen.insert(pick.index);
+    }
+    return seen;
+}
+
+// 连接池只需要 socket().handle().fd；本用例不归还连接，不会探测
+struct NullClient {
+    struct Handle { int fd = -1; };
+    struct Socket {
+        Handle h;
+        const Handle& handle() const { return h; }
+    };
+    Socket& socket() { return sock; }
+    Socket sock;
+};
+
+} // namespace
+
+int main() {
+    // 连续失败摘除，选择时跳过；比例上限阻止摘除过半实例
+    {
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}, {"c", 3, 1}, {"d", 4, 1}}, outlierConfig());
+        fail(*group, 1, 2);
+        { UpstreamGroup::Lease lease(*group, 1); lease.finish(true); }
+        fail(*group, 1, 2);
+        if (group->isEjected(1)) {
+            std::cerr << "[T88] success should reset consecutive failures\n";
+            return 1;
+        }
+        fail(*group, 1, 1);
+        if (!group->isEjected(1) || selectMany(*group, 12).count(1) != 0) {
+            std::cerr << "[T88] ejected endpoint should be skipped\n";
+            return 1;
+        }
+        fail(*group, 2, 3);
+        fail(*group, 3, 3);
+        if (!group->isEjected(2) || group->isEjected(3)) {
+            std::cerr << "[T88] max_ejection_percent should cap ejections\n";
+            return 1;
+        }
+        auto stats = group->stats();
+        if (!stats[1].ejected || stats[1].ejections != 1 || stats[3].ejected) {
+            std::cerr << "[T88] ejection stats mismatch\n";
+            return 1;
+        }
+    }
+
+    // 半开探测：到期后只放行一个探测；失败则退避加倍，成功则恢复
+    {
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}}, outlierConfig());
+        fail(*group, 0, 3);
+        std::this_thread::sleep_for(40ms);
+        UpstreamGroup::Pick probe_pick = group->select();
+        if (probe_pick.index != 0 || !probe_pick.probe) {
+            std::cerr << "[T88] half-open endpoint should receive a probe\n";
+            return 1;
+        }
+        {
+            UpstreamGroup::Lease probe(*group, probe_pick);
+            if (selectMany(*group, 6).count(0) != 0) {
+                std::cerr << "[T88] only one probe may be in flight\n";
+                return 1;
+            }
+            probe.finish(false);
+        }
+        // 第二次摘除时长为 60ms
+        std::this_thread::sleep_for(40ms);
+        if (selectMany(*group, 4).count(0) != 0) {
+            std::cerr << "[T88] failed probe should double the ejection\n";
+            return 1;
+        }
+        std::this_thread::sleep_for(40ms);
+        probe_pick = group->select();
+        {
+            UpstreamGroup::Lease probe(*group, probe_pick);
+            probe.finish(true);
+        }
+        if (probe_pick.index != 0 || group->isEjected(0) || selectMany(*group, 4).count(0) == 0) {
+            std::cerr << "[T88] successful probe should restore the endpoint\n";
+            return 1;
+        }
+    }
+
+    // 被取消的探测不作判定，探测名额被释放
+    {
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}}, outlierConfig());
+        fail(*group, 0, 3);
+        std::this_thread::sleep_for(40ms);
+        {
+            UpstreamGroup::Lease probe(*group, group->select());
+            probe.abandon();
+        }
+        if (group->select().index != 0) {
+            std::cerr << "[T88] abandoned probe should free the probe slot\n";
+            return 1;
+        }
+    }
+
+    // 探测名额随选择结果传递：两次选择之间交错建 Lease（对冲路径上 Lease 在后台协程中建立），各自判定各自的探测
+    {
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}, {"c", 3, 1}, {"d", 4, 1}}, outlierConfig());
+        fail(*group, 0, 3);
+        fail(*group, 1, 3);
+        std::this_thread::sleep_for(40ms);
+        const UpstreamGroup::Pick first = group->select();
+        const UpstreamGroup::Pick second = group->select();
+        {
+            // 指定实例的普通请求不会领走探测名额
+            UpstreamGroup::Lease unrelated(*group, first.index);
+            unrelated.finish(true);
+        }
+        {
+            UpstreamGroup::Lease lease(*group, second);
+            lease.finish(true);
+        }
+        {
+            UpstreamGroup::Lease lease(*group, first);
+            lease.finish(true);
+        }
+        if (!first.probe || !second.probe || first.index == second.index ||
+            group->isEjected(0) || group->isEjected(1)) {
+            std::cerr << "[T88] interleaved probes should both be judged\n";
+            return 1;
+        }
+    }
+
+    // 窗口失败率
+    {
+        auto config = outlierConfig();
+        config.merge_interval = 1ms;
+        config.outlier.consecutive_failures = 0;
+        config.outlier.failure_rate = 0.5;
+        config.outlier.failure_rate_min_requests = 10;
+        config.outlier.window = 10ms;
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}}, config);
+        group->flush();
+        for (int i = 0; i < 20; ++i) {
+            UpstreamGroup::Lease lease(*group, 1);
+            lease.finish(i % 3 == 0);
+        }
+        group->flush();
+        std::this_thread::sleep_for(15ms);
+        group->flush();
+        if (!group->isEjected(1) || group->isEjected(0)) {
+            std::cerr << "[T88] failure rate above threshold should eject\n";
+            return 1;
+        }
+    }
+
+    // 全部摘除时忽略摘除状态（panic）
+    {
+        auto config = outlierConfig();
+        config.outlier.max_ejection_percent = 100;
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}}, config);
+        fail(*group, 0, 3);
+        fail(*group, 1, 3);
+        if (selectMany(*group, 4).size() != 2) {
+            std::cerr << "[T88] panic mode should spread traffic over all endpoints\n";
+            return 1;
+        }
+    }
+
+    // 本地连接池耗尽按代理路径放弃记账：不计失败，不摘除实例，也不占用探测名额
+    {
+        auto group = UpstreamGroup::create({{"a", 1, 1}, {"b", 2, 1}}, outlierConfig());
+        UpstreamConnectionPool<NullClient> pool;
+        UpstreamPoolConfig pool_config;
+        pool_config.max_total = 1;
+        auto held = pool.acquire("a:1", pool_config);
+        for (int i = 0; i < 10; ++i) {
+            UpstreamGroup::Lease lease(*group, 0);
+            auto client = pool.acquire("a:1", pool_config);
+            if (client || !client.exhausted()) {
+                std::cerr << "[T88] pool should be exhausted\n";
+                return 1;
+            }
+            lease.abandon();
+        }
+        group->flush();
+        if (group->isEjected(0) || group->stats()[0].failures != 0) {
+            std::cerr << "[T88] pool exhaustion should never eject an endpoint\n";
+            return 1;
+        }
+        fail(*group, 1, 3);
+        std::this_thread::sleep_for(40ms);
+        for (int i = 0; i < 2; ++i) {
+            const UpstreamGroup::Pick pick = group->select();
+            UpstreamGroup::Lease lease(*group, pick);
+            if (pick.index != 1 || !pick.probe) {
+                std::cerr << "[T88] exhausted probe should hand the slot back\n";
+                return 1;
+            }
+            lease.abandon();
+        }
+    }
+
+    std::cout << "T88-Outlier PASS\n";
+    return 0;
+}
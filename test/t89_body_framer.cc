@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "galay-http/kernel/http/body_framer.h"
+
+using namespace galay::http;
+
+namespace {
+
+HttpResponseHeader parseHeader(const std::string& raw) {
+    HttpResponseHeader header;
+    header.fromString(raw);
+    return header;
+}
+
+// 按固定步长切分输入，模拟分多次到达的网络数据
+size_t feedInSteps(HttpBodyFramer& framer, std::string_view data, size_t step) {
+    size_t accepted = 0;
+    for (size_t i = 0; i < data.size() && !framer.done() && !framer.failed(); i += step) {
+        const auto part = data.substr(i, step);
+        const size_t n = framer.feed(part);
+        accepted += n;
+        if (n < part.size()) {
+            break;
+        }
+    }
+    return accepted;
+}
+
+} // namespace
+
+int main() {
+    // 分帧方式按响应头与请求方法判定
+    {
+        auto chunked = parseHeader("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+        auto length = parseHeader("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n");
+        auto close = parseHeader("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n");
+        auto no_content = parseHeader("HTTP/1.1 204 No Content\r\n\r\n");
+        auto bad_length = parseHeader("HTTP/1.1 200 OK\r\nContent-Length: 1x\r\n\r\n");
+        if (HttpBodyFramer::forResponse(chunked, false).framing() != HttpBodyFraming::Chunked ||
+            HttpBodyFramer::forResponse(length, false).framing() != HttpBodyFraming::Length ||
+            HttpBodyFramer::forResponse(close, false).framing() != HttpBodyFraming::UntilClose ||
+            !HttpBodyFramer::forResponse(no_content, false).done() ||
+            !HttpBodyFramer::forResponse(length, true).done() ||
+            !HttpBodyFramer::forResponse(bad_length, false).failed()) {
+            std::cerr << "[T89] framing selection mismatch\n";
+            return 1;
+        }
+    }
+
+    // Content-Length：读取上限不超过剩余字节，多余字节不计入
+    {
+        auto framer = HttpBodyFramer::length(10);
+        if (framer.nextReadSize(4096) != 10 || framer.feed("12345") != 5 || framer.done() ||
+            framer.nextReadSize(4096) != 5 || framer.feed("67890EXTRA") != 5 || !framer.done()) {
+            std::cerr << "[T89] content-length accounting mismatch\n";
+            return 1;
+        }
+        auto truncated = HttpBodyFramer::length(10);
+        truncated.feed("123");
+        if (truncated.onClose() || !truncated.failed()) {
+            std::cerr << "[T89] early close should be reported as truncation\n";
+            return 1;
+        }
+    }
+
+    // chunked：任意切分下都能找到终止位置，trailer 与扩展被跳过
+    {
+        const std::string body =
+            "5;ext=1\r\nhello\r\n"
+            "1A\r\nabcdefghijklmnopqrstuvwxyz\r\n"
+            "0\r\nX-Trailer: v\r\n\r\n";
+        for (size_t step = 1; step <= body.size(); ++step) {
+            auto framer = HttpBodyFramer::chunked();
+            const size_t accepted = feedInSteps(framer, body + "HTTP/1.1 200 OK", step);
+            if (!framer.done() || accepted != body.size()) {
+                std::cerr << "[T89] chunked end mismatch step=" << step << " accepted=" << accepted << "\n";
+                return 1;
+            }
+        }
+        auto bad = HttpBodyFramer::chunked();
+        if (bad.feed("5\r\nhelloXX") != 8 || !bad.failed()) {
+            std::cerr << "[T89] missing CRLF after chunk data should fail\n";
+            return 1;
+        }
+        auto no_digits = HttpBodyFramer::chunked();
+        no_digits.feed("\r\n");
+        if (!no_digits.failed()) {
+            std::cerr << "[T89] empty chunk size should fail\n";
+            return 1;
+        }
+    }
+
+    // 以连接关闭界定：全部接收，关闭即结束
+    {
+        auto framer = HttpBodyFramer::untilClose();
+        if (framer.feed("abc") != 3 || framer.done() || !framer.onClose() || !framer.done()) {
+            std::cerr << "[T89] until-close framing mismatch\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T89-BodyFramer PASS\n";
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "galay-http/kernel/http/proxy_headers.h"
+
+using namespace galay::http;
+
+namespace {
+
+HttpRequestHeader parseRequest(const std::string& raw) {
+    HttpRequestHeader header;
+    header.fromString(raw);
+    return header;
+}
+
+bool contains(const std::string& haystack, std::string_view needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+int main() {
+    // 逐跳头部与 Connection 列出的字段被丢弃，Host 与转发头重新生成
+    {
+        auto header = parseRequest(
+            "POST /api/items?id=7 HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "Connection: keep-alive, X-Secret\r\n"
+            "Keep-Alive: timeout=5\r\n"
+            "TE: trailers\r\n"
+            "Upgrade: websocket\r\n"
+            "Proxy-Connection: keep-alive\r\n"
+            "X-Secret: hidden\r\n"
+            "X-Forwarded-For: 10.0.0.1\r\n"
+            "X-Forwarded-Proto: https\r\n"
+            "Content-Length: 999\r\n"
+            "Accept: text/event-stream\r\n"
+            "User-Agent: t90\r\n"
+            "\r\n");
+        const std::string before = header.toString();
+
+        ProxyRequestHeaders headers;
+        headers.scan(header.headerPairs());
+        if (headers.host() != "example.com" || headers.accept() != "text/event-stream") {
+            std::cerr << "[T90] recorded fields mismatch\n";
+            return 1;
+        }
+
+        ProxyForwarding forwarding;
+        forwarding.client_ip = "192.168.1.9";
+        forwarding.upstream_host = "127.0.0.1:8080";
+        forwarding.connection = "keep-alive";
+        std::string out;
+        headers.appendUpstreamRequest(out, header, forwarding, 5);
+
+        if (out.rfind("POST /api/items?id=7 HTTP/1.1\r\nHost: 127.0.0.1:8080\r\n", 0) != 0 ||
+            !contains(out, "X-Forwarded-For: 10.0.0.1, 192.168.1.9\r\n") ||
+            !contains(out, "X-Real-IP: 192.168.1.9\r\n") ||
+            !contains(out, "X-Forwarded-Proto: http\r\n") ||
+            !contains(out, "X-Forwarded-Host: example.com\r\n") ||
+            !contains(out, "Connection: keep-alive\r\nContent-Length: 5\r\n\r\n") ||
+            !contains(out, "user-agent: t90\r\n") ||
+            !contains(out, "accept: text/event-stream\r\n")) {
+            std::cerr << "[T90] upstream request mismatch:\n" << out;
+            return 1;
+        }
+        for (std::string_view dropped : {"keep-alive: timeout", "te: ", "upgrade: ", "proxy-connection",
+                                         "x-secret", "999", "https"}) {
+            if (contains(out, dropped)) {
+                std::cerr << "[T90] hop-by-hop field leaked: " << dropped << "\n" << out;
+                return 1;
+            }
+        }
+        if (header.toString() != before) {
+            std::cerr << "[T90] client headers should not be modified\n";
+            return 1;
+        }
+    }
+
+    // 手工构造的请求头同样适用；分类不区分大小写
+    {
+        HttpRequestHeader header;
+        header.method() = HttpMethod::GET;
+        header.uri() = "/";
+        header.version() = HttpVersion::HttpVersion_1_1;
+        header.headerPairs().addHeaderPair("HOST", "a.test");
+        header.headerPairs().addHeaderPair("Transfer-Encoding", "chunked");
+        header.headerPairs().addHeaderPair("X-Trace", "1");
+
+        ProxyRequestHeaders headers;
+        headers.scan(header.headerPairs());
+        ProxyForwarding forwarding;
+        forwarding.upstream_host = "b.test";
+        std::string out;
+        headers.appendUpstreamRequest(out, header, forwarding, 0);
+        if (headers.host() != "a.test" || contains(out, "chunked") || !contains(out, "x-trace: 1\r\n") ||
+            contains(out, "X-Real-IP") || contains(out, "Connection:") ||
+            !contains(out, "Content-Length: 0\r\n\r\n")) {
+            std::cerr << "[T90] client-side header mismatch:\n" << out;
+            return 1;
+        }
+    }
+
+    // 超过内联容量的字段进入溢出数组，顺序不变
+    {
+        std::string raw = "GET / HTTP/1.1\r\nHost: h\r\n";
+        for (int i = 0; i < 40; ++i) {
+            raw += "X-F" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+        }
+        raw += "\r\n";
+        auto header = parseRequest(raw);
+        ProxyRequestHeaders headers;
+        headers.scan(header.headerPairs());
+        size_t forwarded = 0;
+        headers.forEachUpstreamHeader(ProxyForwarding{}, [&forwarded](std::string_view key, std::string_view) {
+            if (key.size() <= 5 && key.rfind("x-f", 0) == 0) {
+                ++forwarded;
+            }
+        });
+        if (forwarded != 40) {
+            std::cerr << "[T90] overflow fields lost: " << forwarded << "\n";
+            return 1;
+        }
+    }
+
+    // Connection 列出超过内联容量的字段名时，其余字段名同样按逐跳头部丢弃
+    {
+        std::string raw = "GET / HTTP/1.1\r\nHost: h\r\nConnection: close";
+        for (int i = 0; i < 12; ++i) {
+            raw += ", X-Hop" + std::to_string(i);
+        }
+        raw += "\r\n";
+        for (int i = 0; i < 12; ++i) {
+            raw += "X-Hop" + std::to_string(i) + ": v\r\n";
+        }
+        raw += "X-Keep: 1\r\n\r\n";
+        auto header = parseRequest(raw);
+        ProxyRequestHeaders headers;
+        headers.scan(header.headerPairs());
+        size_t leaked = 0;
+        bool kept = false;
+        headers.forEachUpstreamHeader(ProxyForwarding{}, [&leaked, &kept](std::string_view key, std::string_view) {
+            if (key.rfind("x-hop", 0) == 0) {
+                ++leaked;
+            }
+            kept = kept || key == "x-keep";
+        });
+        if (leaked != 0 || !kept) {
+            std::cerr << "[T90] connection tokens beyond inline capacity leaked: " << leaked << "\n";
+            return 1;
+        }
+    }
+
+    // 序列化缓冲在线程内复用
+    {
+        const char* first = nullptr;
+        {
+            ProxyHeadBuffer buffer;
+            buffer.get().assign(512, 'x');
+            first = buffer.get().data();
+        }
+        ProxyHeadBuffer again;
+        if (!again.get().empty() || again.get().capacity() < 512 || again.get().data() != first) {
+            std::cerr << "[T90] head buffer should be recycled\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T90-ProxyHeaders PASS\n";
+    return 0;
+}
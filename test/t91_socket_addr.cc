@@ -0,0 +1,154 @@
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/socket_addr.h"
+
+using namespace galay::http;
+
+namespace {
+
+bool roundTrip(const std::string& path) {
+    std::string error;
+    const int listen_fd = detail::openUnixListener(path, 16, error);
+    if (listen_fd < 0) {
+        std::cerr << "[T91] listen failed path=" << path << " error=" << error << "\n";
+        return false;
+    }
+    const int client_fd = detail::connectUnixStream(path, error);
+    if (client_fd < 0) {
+        std::cerr << "[T91] connect failed path=" << path << " error=" << error << "\n";
+        ::close(listen_fd);
+        return false;
+    }
+    const int server_fd = ::accept(listen_fd, nullptr, nullptr);
+    bool ok = server_fd >= 0 &&
+              ::send(client_fd, "ping", 4, MSG_NOSIGNAL) == 4;
+    char buf[4] = {};
+    ok = ok && ::recv(server_fd, buf, sizeof(buf), MSG_WAITALL) == 4 && std::string(buf, 4) == "ping";
+    if (server_fd >= 0) ::close(server_fd);
+    ::close(client_fd);
+    ::close(listen_fd);
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    // 地址族按 host 文本判定
+    {
+        const auto v4 = HttpSocketAddress::parse("127.0.0.1", 8080);
+        const auto v6 = HttpSocketAddress::parse("::1", 8080);
+        const auto bracketed = HttpSocketAddress::parse("[::]", 443);
+        const auto uds = HttpSocketAddress::parse("unix:/run/app.sock", 80);
+        if (v4.family != HttpAddressFamily::IPv4 || v4.authority() != "127.0.0.1:8080" ||
+            !v6.isIPv6() || v6.authority() != "[::1]:8080" || v6.hostHeader() != "[::1]:8080" ||
+            !bracketed.isIPv6() || bracketed.host != "::" ||
+            !uds.isUnix() || uds.host != "/run/app.sock" || uds.port != 0 ||
+            uds.authority() != "unix:/run/app.sock" || uds.hostHeader() != "localhost") {
+            std::cerr << "[T91] address parse mismatch\n";
+            return 1;
+        }
+    }
+
+    // 路径长度校验
+    {
+        sockaddr_un addr{};
+        socklen_t len = 0;
+        if (detail::fillUnixSockAddr("", addr, len) ||
+            detail::fillUnixSockAddr(std::string(sizeof(addr.sun_path), 'a'), addr, len)) {
+            std::cerr << "[T91] invalid unix path should be rejected\n";
+            return 1;
+        }
+    }
+
+    // 文件路径：遗留的 socket 文件在 bind 前被删除
+    {
+        const std::string path = "/tmp/galay-t91-" + std::to_string(::getpid()) + ".sock";
+        if (!roundTrip(path) || !roundTrip(path)) {
+            return 1;
+        }
+        detail::removeUnixSocketFile(path);
+        struct stat st{};
+        if (::lstat(path.c_str(), &st) == 0) {
+            std::cerr << "[T91] socket file should be removed\n";
+            return 1;
+        }
+    }
+
+    // 抽象命名空间
+    {
+        if (!roundTrip("@galay-t91-" + std::to_string(::getpid()))) {
+            return 1;
+        }
+    }
+
+    // 连接不存在的 socket 返回错误而不是阻塞
+    {
+        std::string error;
+        if (detail::connectUnixStream("/tmp/galay-t91-missing.sock", error) >= 0 || error.empty()) {
+            std::cerr << "[T91] connect to missing socket should fail\n";
+            return 1;
+        }
+    }
+
+    // 监听队列已满时立即返回可重试的错误，而不是阻塞到对端 accept
+    {
+        const std::string path = "@galay-t91-full-" + std::to_string(::getpid());
+        std::string error;
+        const int listen_fd = detail::openUnixListener(path, 0, error);
+        bool retryable = false;
+        int held = -1;
+        int rejected = -1;
+        for (int i = 0; i < 8 && listen_fd >= 0; ++i) {
+            const int fd = detail::connectUnixStream(path, error, &retryable);
+            if (fd < 0) {
+                break;
+            }
+            if (held < 0) {
+                held = fd;
+            } else {
+                ::close(fd);
+            }
+        }
+        if (listen_fd < 0 || !retryable || error.empty()) {
+            std::cerr << "[T91] full backlog should fail with a retryable error: " << error << "\n";
+            return 1;
+        }
+        if ((::fcntl(held, F_GETFL) & O_NONBLOCK) == 0) {
+            std::cerr << "[T91] connected fd should be non-blocking\n";
+            return 1;
+        }
+        rejected = detail::connectUnixStream("/tmp/galay-t91-missing.sock", error, &retryable);
+        if (rejected >= 0 || retryable) {
+            std::cerr << "[T91] missing socket should not be retryable\n";
+            return 1;
+        }
+        ::close(held);
+        ::close(listen_fd);
+    }
+
+    // 双栈开关
+    {
+        const int fd = ::socket(AF_INET6, SOCK_STREAM, 0);
+        if (fd >= 0) {
+            int value = -1;
+            socklen_t len = sizeof(value);
+            const bool ok = detail::setIpv6Only(fd, false) &&
+                            ::getsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &value, &len) == 0 && value == 0 &&
+                            detail::setIpv6Only(fd, true) &&
+                            ::getsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &value, &len) == 0 && value == 1;
+            ::close(fd);
+            if (!ok) {
+                std::cerr << "[T91] IPV6_V6ONLY toggle mismatch\n";
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "T91-SocketAddr PASS\n";
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/reuseport_steering.h"
+#include "galay-http/kernel/http/socket_addr.h"
+
+using namespace galay::http;
+
+namespace {
+
+uint16_t boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+int connectLoopback(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// 轮询所有 listener，返回接到连接的下标与已 accept 的 fd
+int acceptAny(const std::vector<int>& listeners, int& accepted) {
+    for (int attempt = 0; attempt < 200; ++attempt) {
+        for (size_t i = 0; i < listeners.size(); ++i) {
+            accepted = ::accept(listeners[i], nullptr, nullptr);
+            if (accepted >= 0) {
+                return static_cast<int>(i);
+            }
+        }
+        ::usleep(1000);
+    }
+    return -1;
+}
+
+} // namespace
+
+int main() {
+    // 程序形状：ld cpu；每个 CPU 一对 jeq/ret；越界下标兜底
+    {
+        const std::vector<int> cpus{3, 1, 7};
+        const auto program = detail::buildCpuSteeringProgram(cpus);
+        if (program.size() != 8 ||
+            program[0].code != (BPF_LD | BPF_W | BPF_ABS) || program[0].k != static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU) ||
+            program[3].k != 1 || program[4].k != 1 || program[6].k != 2 ||
+            program[7].code != (BPF_RET | BPF_K) || program[7].k != 3 ||
+            !detail::buildCpuSteeringProgram({}).empty()) {
+            std::cerr << "[T92] program shape mismatch\n";
+            return 1;
+        }
+    }
+
+    // 实际挂载：当前线程绑到每个可用 CPU 上发起连接，连接应落在该 CPU 对应的 listener
+    {
+        cpu_set_t original;
+        CPU_ZERO(&original);
+        ::pthread_getaffinity_np(::pthread_self(), sizeof(original), &original);
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE && cpus.size() < 4; ++cpu) {
+            if (CPU_ISSET(cpu, &original)) {
+                cpus.push_back(cpu);
+            }
+        }
+
+        std::string error;
+        auto address = HttpSocketAddress::parse("127.0.0.1", 0);
+        std::vector<int> listeners;
+        const int first = detail::openTcpListener(address, 16, false, error);
+        if (first < 0) {
+            std::cerr << "[T92] listen failed: " << error << "\n";
+            return 1;
+        }
+        listeners.push_back(first);
+        address.port = boundPort(first);
+        while (listeners.size() < cpus.size()) {
+            const int fd = detail::openTcpListener(address, 16, false, error);
+            if (fd < 0) {
+                std::cerr << "[T92] reuseport listen failed: " << error << "\n";
+                return 1;
+            }
+            listeners.push_back(fd);
+        }
+
+        if (!detail::attachCpuSteering(listeners.front(), cpus, error)) {
+            std::cerr << "[T92] attach failed: " << error << "\n";
+            return 1;
+        }
+
+        HttpAcceptCounters counters;
+        counters.reset(cpus);
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            cpu_set_t one;
+            CPU_ZERO(&one);
+            CPU_SET(cpus[i], &one);
+            ::pthread_setaffinity_np(::pthread_self(), sizeof(one), &one);
+            const int client = connectLoopback(address.port);
+            int accepted = -1;
+            const int index = client >= 0 ? acceptAny(listeners, accepted) : -1;
+            if (index != static_cast<int>(i)) {
+                std::cerr << "[T92] cpu " << cpus[i] << " landed on listener " << index << "\n";
+                return 1;
+            }
+            counters.record(static_cast<size_t>(index), accepted, true);
+            ::close(accepted);
+            ::close(client);
+        }
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(original), &original);
+
+        const auto stats = counters.snapshot(true);
+        if (!stats.cpu_steering || stats.schedulers.size() != cpus.size() ||
+            stats.totalAccepted() != cpus.size()) {
+            std::cerr << "[T92] accept stats mismatch\n";
+            return 1;
+        }
+        for (const auto& slot : stats.schedulers) {
+            if (slot.accepted != 1 || slot.cpu_local != 1 || slot.cpu != cpus[slot.scheduler]) {
+                std::cerr << "[T92] slot " << slot.scheduler << " accepted=" << slot.accepted
+                          << " cpu_local=" << slot.cpu_local << "\n";
+                return 1;
+            }
+        }
+
+        detail::detachReuseportProgram(listeners.front());
+        for (int fd : listeners) {
+            ::close(fd);
+        }
+    }
+
+    // 未启用引导时只计数，不读取 SO_INCOMING_CPU
+    {
+        HttpAcceptCounters counters;
+        counters.reset(std::vector<int>(2, -1));
+        counters.record(1, -1, false);
+        counters.record(5, -1, false);
+        const auto stats = counters.snapshot(false);
+        if (stats.cpu_steering || stats.schedulers[0].accepted != 0 || stats.schedulers[1].accepted != 1 ||
+            stats.schedulers[1].cpu_local != 0) {
+            std::cerr << "[T92] plain counters mismatch\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T92-ReuseportSteering PASS\n";
+    return 0;
+}
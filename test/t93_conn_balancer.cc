@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
+#include "galay-http/kernel/http/conn_balancer.h"
+
+using namespace galay::http;
+using namespace std::chrono_literals;
+
+namespace {
+
+HttpConnBalanceConfig enabledConfig() {
+    HttpConnBalanceConfig config;
+    config.enabled = true;
+    return config;
+}
+
+void open(HttpConnBalancer& balancer, size_t index, int n) {
+    for (int i = 0; i < n; ++i) {
+        balancer.onOpen(index);
+    }
+}
+
+} // namespace
+
+int main() {
+    const auto now = HttpConnBalancer::Clock::now();
+
+    // 默认关闭；单个调度器时即使启用也不转交
+    {
+        HttpConnBalancer balancer;
+        balancer.reset(4, HttpConnBalanceConfig{});
+        open(balancer, 0, 10);
+        if (balancer.enabled() || balancer.pick(0, now) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] disabled balancer should stay local\n";
+            return 1;
+        }
+        HttpConnBalancer single;
+        single.reset(1, enabledConfig());
+        if (single.enabled() || single.pick(0, now) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] single scheduler should stay local\n";
+            return 1;
+        }
+    }
+
+    // 轻微不均衡留在本地，明显倾斜时交给最空闲的调度器
+    {
+        HttpConnBalancer balancer;
+        balancer.reset(3, enabledConfig());
+        open(balancer, 0, 4);
+        open(balancer, 1, 3);
+        open(balancer, 2, 3);
+        if (balancer.pick(0, now) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] small imbalance should stay local\n";
+            return 1;
+        }
+        open(balancer, 0, 8);
+        balancer.onClose(2);
+        if (balancer.pick(0, now) != 2 || balancer.pick(2, now) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] skewed scheduler should hand off to least loaded\n";
+            return 1;
+        }
+    }
+
+    // 迁移判断先扣除连接自身：4 对 2 不迁移，6 对 2 迁移
+    {
+        HttpConnBalancer balancer;
+        balancer.reset(2, enabledConfig());
+        open(balancer, 0, 4);
+        open(balancer, 1, 2);
+        if (balancer.migrationTarget(0, now) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] near-balanced connection should not migrate\n";
+            return 1;
+        }
+        open(balancer, 0, 2);
+        if (balancer.migrationTarget(0, now) != 1 || balancer.migrationTarget(1, now) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] idle connection should migrate to lighter scheduler\n";
+            return 1;
+        }
+    }
+
+    // 连接数相同，忙碌的调度器把新连接让给空闲的调度器；忙碌值按半衰期衰减
+    {
+        HttpConnBalanceConfig config = enabledConfig();
+        config.busy_half_life = 100ms;
+        HttpConnBalancer balancer;
+        balancer.reset(2, config);
+        open(balancer, 0, 6);
+        open(balancer, 1, 6);
+        balancer.addBusy(0, 140ms, now);
+        if (balancer.pick(0, now) != 1) {
+            std::cerr << "[T93] busy scheduler should hand off\n";
+            return 1;
+        }
+        const auto later = now + 1s;
+        const auto stats = balancer.snapshot(later);
+        if (stats.schedulers[0].busy > 0.01 || balancer.pick(0, later) != HttpConnBalancer::kStay) {
+            std::cerr << "[T93] busy time should decay\n";
+            return 1;
+        }
+    }
+
+    // 线程 CPU 时间采样：首次只记录基线，之后计入忙碌值
+    {
+        HttpConnBalancer balancer;
+        balancer.reset(2, enabledConfig());
+        balancer.sampleBusy(0);
+        volatile uint64_t sink = 0;
+        const auto spin_until = HttpConnBalancer::Clock::now() + 20ms;
+        while (HttpConnBalancer::Clock::now() < spin_until) {
+            sink = sink + 1;
+        }
+        balancer.sampleBusy(0);
+        if (balancer.snapshot().schedulers[0].busy <= 0.0) {
+            std::cerr << "[T93] thread cpu time should be sampled\n";
+            return 1;
+        }
+    }
+
+    // 统计
+    {
+        HttpConnBalancer balancer;
+        balancer.reset(2, enabledConfig());
+        open(balancer, 1, 2);
+        balancer.onHandedIn(1);
+        balancer.onMigratedIn(1);
+        balancer.onClose(1);
+        const auto stats = balancer.snapshot(now);
+        if (!stats.enabled || stats.schedulers.size() != 2 || stats.schedulers[1].live != 1 ||
+            stats.schedulers[1].handed_in != 1 || stats.schedulers[1].migrated_in != 1 ||
+            stats.schedulers[0].live != 0) {
+            std::cerr << "[T93] stats mismatch\n";
+            return 1;
+        }
+    }
+
+#if defined(__linux__)
+    // 迁移前注销 epoll 注册：dup 存活时关闭原 fd 不会移除注册，显式删除后旧实例不再收到事件
+    {
+        const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            std::cerr << "[T93] epoll setup failed\n";
+            return 1;
+        }
+        const auto fds = detail::listEpollFds();
+        if (std::find(fds.begin(), fds.end(), epoll_fd) == fds.end()) {
+            std::cerr << "[T93] epoll instance not listed\n";
+            return 1;
+        }
+        auto staleEvents = [&](bool drop) {
+            int local[2];
+            ::socketpair(AF_UNIX, SOCK_STREAM, 0, local);
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = local[0];
+            ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, local[0], &event);
+            const int migrated = ::dup(local[0]);
+            if (drop) {
+                detail::dropEpollRegistrations(local[0], fds);
+            }
+            ::close(local[0]);
+            (void)::write(local[1], "x", 1);
+            epoll_event out{};
+            const int ready = ::epoll_wait(epoll_fd, &out, 1, 0);
+            ::close(migrated);
+            ::close(local[1]);
+            return ready;
+        };
+        if (staleEvents(false) != 1 || staleEvents(true) != 0) {
+            std::cerr << "[T93] epoll registration should be dropped before migration\n";
+            return 1;
+        }
+        ::close(epoll_fd);
+    }
+#endif
+
+    std::cout << "T93-ConnBalancer PASS\n";
+    return 0;
+}
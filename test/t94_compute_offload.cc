@@ -0,0 +1,130 @@
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/compute_offload.h"
+#include "galay-http/kernel/http/http_server.h"
+#include "galay-http/utils/rsp_bld.h"
+
+using namespace galay::http;
+using namespace galay::kernel;
+
+namespace {
+
+constexpr uint16_t kPort = 19494;
+
+Task<void> reply(HttpConn& conn, std::string body) {
+    auto response = Http1_1ResponseBuilder::ok().text(std::move(body)).build();
+    auto writer = conn.getWriter();
+    while (true) {
+        auto result = co_await writer.sendResponse(response);
+        if (!result || result.value()) {
+            break;
+        }
+    }
+    co_return;
+}
+
+/// 计算段应在其他线程执行，恢复后回到原 IO 线程
+Task<void> offloadHandler(HttpConn& conn, HttpRequest req) {
+    (void)req;
+    const auto io_thread = std::this_thread::get_id();
+    std::thread::id compute_thread;
+    const int sum = co_await offload([&compute_thread] {
+        compute_thread = std::this_thread::get_id();
+        int total = 0;
+        for (int i = 1; i <= 100; ++i) {
+            total += i;
+        }
+        return total;
+    });
+    const bool ok = sum == 5050 && compute_thread != io_thread && std::this_thread::get_id() == io_thread;
+    co_await reply(conn, ok ? "offloaded" : "wrong thread");
+    co_return;
+}
+
+/// 计算段的异常在等待处重新抛出
+Task<void> throwingHandler(HttpConn& conn, HttpRequest req) {
+    (void)req;
+    bool caught = false;
+    try {
+        co_await offload([] { throw std::runtime_error("boom"); });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    co_await reply(conn, caught ? "caught" : "not caught");
+    co_return;
+}
+
+std::string roundTrip(const std::string& path) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return {};
+    }
+    const std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buf[4096];
+    ssize_t n = 0;
+    while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) {
+        response.append(buf, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+int main() {
+    HttpRouter router;
+    router.addHandler<HttpMethod::GET>("/offload", offloadHandler);
+    router.addHandler<HttpMethod::GET>("/throw", throwingHandler);
+    router.addComputeHandler<HttpMethod::GET>("/compute", [](HttpRequest& req) {
+        return Http1_1ResponseBuilder::ok().text("computed " + req.header().uri()).build();
+    });
+    router.addComputeHandler<HttpMethod::GET>("/compute-throw", [](HttpRequest&) -> HttpResponse {
+        throw std::runtime_error("boom");
+    });
+
+    HttpServer server(HttpServerBuilder()
+        .host("127.0.0.1")
+        .port(kPort)
+        .ioSchedulerCount(2)
+        .computeSchedulerCount(2)
+        .build());
+    server.start(std::move(router));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    int failures = 0;
+    auto expect = [&failures](const std::string& path, const std::string& needle) {
+        const std::string response = roundTrip(path);
+        if (response.find(needle) == std::string::npos) {
+            std::cerr << "[T94] " << path << " expected \"" << needle << "\", got: " << response << "\n";
+            ++failures;
+        }
+    };
+    expect("/offload", "offloaded");
+    expect("/throw", "caught");
+    expect("/compute", "computed /compute");
+    expect("/compute-throw", " 500 ");
+
+    server.stop();
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "T94-ComputeOffload PASS\n";
+    return 0;
+}
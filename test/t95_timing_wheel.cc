@@ -0,0 +1,200 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "galay-http/kernel/timing_wheel.h"
+#include "galay-http/kernel/http/http_deadline.h"
+
+using namespace galay::http;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct CountingTimer : TimingWheel::Timer
+{
+    CountingTimer() : TimingWheel::Timer(&CountingTimer::onFire) {}
+
+    static void onFire(TimingWheel::Timer& timer)
+    {
+        auto& self = static_cast<CountingTimer&>(timer);
+        ++self.fired;
+        self.fired_at = self.wheel->now();
+        if (self.rearm_every.count() > 0 && self.fired < 3) {
+            self.wheel->arm(self, self.fired_at + self.rearm_every);
+        }
+    }
+
+    TimingWheel* wheel = nullptr;
+    int fired = 0;
+    TimingWheel::Clock::time_point fired_at{};
+    std::chrono::milliseconds rearm_every{0};
+};
+
+} // namespace
+
+int main() {
+    const auto origin = TimingWheel::Clock::now();
+
+    // 基本到期：不提前、最多晚一个 tick；cancel 后不触发
+    {
+        TimingWheel wheel(10ms, origin);
+        CountingTimer a, b;
+        a.wheel = b.wheel = &wheel;
+        wheel.arm(a, origin + 35ms);
+        wheel.arm(b, origin + 50ms);
+        b.cancel();
+        if (wheel.size() != 1 || b.armed()) {
+            std::cerr << "[T95] cancel should unlink\n";
+            return 1;
+        }
+        wheel.advance(origin + 30ms);
+        if (a.fired != 0) {
+            std::cerr << "[T95] timer fired early\n";
+            return 1;
+        }
+        wheel.advance(origin + 40ms);
+        if (a.fired != 1 || b.fired != 0 || wheel.size() != 0 || a.armed()) {
+            std::cerr << "[T95] timer should fire once at 40ms\n";
+            return 1;
+        }
+    }
+
+    // 跨层级：随机截止时间（覆盖 4 层与溢出链表）全部按序在正确的 tick 触发
+    {
+        TimingWheel wheel(1ms, origin);
+        std::mt19937_64 rng(42);
+        std::vector<CountingTimer> timers(2000);
+        std::vector<uint64_t> expected(timers.size());
+        for (size_t i = 0; i < timers.size(); ++i) {
+            timers[i].wheel = &wheel;
+            const uint64_t exp = 1 + rng() % (i % 4 == 0 ? (uint64_t{1} << 26) : 300000);
+            expected[i] = exp;
+            wheel.arm(timers[i], origin + std::chrono::milliseconds(exp));
+        }
+        // 分批推进，模拟驱动协程每次醒来推进多个 tick
+        for (uint64_t t = 0; t <= (uint64_t{1} << 26) + 1; t += 997) {
+            wheel.advance(origin + std::chrono::milliseconds(t));
+        }
+        wheel.advance(origin + std::chrono::milliseconds((uint64_t{1} << 26) + 2));
+        for (size_t i = 0; i < timers.size(); ++i) {
+            const auto at = std::chrono::duration_cast<std::chrono::milliseconds>(timers[i].fired_at - origin).count();
+            if (timers[i].fired != 1 || static_cast<uint64_t>(at) != expected[i]) {
+                std::cerr << "[T95] timer " << i << " expected tick " << expected[i] << " fired " << timers[i].fired
+                          << " at " << at << "\n";
+                return 1;
+            }
+        }
+        if (wheel.size() != 0) {
+            std::cerr << "[T95] wheel should be empty\n";
+            return 1;
+        }
+    }
+
+    // 回调中重新挂载自身；过期截止时间在下一个 tick 触发
+    {
+        TimingWheel wheel(10ms, origin);
+        CountingTimer periodic;
+        periodic.wheel = &wheel;
+        periodic.rearm_every = 100ms;
+        wheel.arm(periodic, origin - 1s);
+        wheel.advance(origin + 10ms);
+        wheel.advance(origin + 1s);
+        if (periodic.fired != 3 || periodic.fired_at != origin + 210ms) {
+            std::cerr << "[T95] periodic rearm mismatch fired=" << periodic.fired << "\n";
+            return 1;
+        }
+    }
+
+    // 定时器先于时间轮析构 / 时间轮先于定时器析构
+    {
+        auto wheel = std::make_unique<TimingWheel>(10ms, origin);
+        CountingTimer outlives;
+        {
+            CountingTimer scoped;
+            wheel->arm(scoped, origin + 1s);
+            wheel->arm(outlives, origin + 1s);
+        }
+        if (wheel->size() != 1) {
+            std::cerr << "[T95] destroyed timer should unlink\n";
+            return 1;
+        }
+        wheel.reset();
+        if (outlives.armed()) {
+            std::cerr << "[T95] wheel destruction should detach timers\n";
+            return 1;
+        }
+    }
+
+    // 请求截止时间：首个请求按读请求头计时
+    HttpDeadlineConfig config;
+    config.header_timeout = 10s;
+    config.body_timeout = 20s;
+    config.keepalive_timeout = 60s;
+    {
+        HttpRequestDeadline deadline;
+        deadline.begin(config, origin, true, 0);
+        if (deadline.nextCheck() != origin + 10s ||
+            deadline.check(HttpReadProgress{5, false, 0}, origin + 10s) != HttpDeadlineExpiry::Header) {
+            std::cerr << "[T95] first request header timeout mismatch\n";
+            return 1;
+        }
+    }
+
+    // keep-alive 空闲：每 header_timeout 检查一次，看到数据后转入读请求头；一直无数据则空闲超时
+    {
+        HttpRequestDeadline deadline;
+        deadline.begin(config, origin, false, 0);
+        if (deadline.nextCheck() != origin + 10s ||
+            deadline.check(HttpReadProgress{}, origin + 10s) != HttpDeadlineExpiry::None ||
+            deadline.nextCheck() != origin + 20s ||
+            deadline.check(HttpReadProgress{3, false, 0}, origin + 20s) != HttpDeadlineExpiry::None ||
+            deadline.nextCheck() != origin + 30s ||
+            deadline.check(HttpReadProgress{9, false, 0}, origin + 30s) != HttpDeadlineExpiry::Header) {
+            std::cerr << "[T95] slowloris header should expire\n";
+            return 1;
+        }
+        HttpRequestDeadline idle;
+        idle.begin(config, origin, false, 0);
+        for (auto t = origin + 10s; t < origin + 60s; t += 10s) {
+            if (idle.check(HttpReadProgress{}, t) != HttpDeadlineExpiry::None) {
+                std::cerr << "[T95] idle connection expired early\n";
+                return 1;
+            }
+        }
+        if (idle.nextCheck() != origin + 60s ||
+            idle.check(HttpReadProgress{}, origin + 60s) != HttpDeadlineExpiry::KeepAlive) {
+            std::cerr << "[T95] keepalive timeout mismatch\n";
+            return 1;
+        }
+    }
+
+    // 读请求体：有进展即续期，两次检查间无新数据则超时；整个请求总时限优先
+    {
+        HttpRequestDeadline deadline;
+        deadline.begin(config, origin, true, 0);
+        if (deadline.check(HttpReadProgress{0, true, 100}, origin + 5s) != HttpDeadlineExpiry::None ||
+            deadline.nextCheck() != origin + 25s ||
+            deadline.check(HttpReadProgress{0, true, 200}, origin + 25s) != HttpDeadlineExpiry::None ||
+            deadline.nextCheck() != origin + 45s ||
+            deadline.check(HttpReadProgress{0, true, 200}, origin + 45s) != HttpDeadlineExpiry::Body) {
+            std::cerr << "[T95] body inactivity timeout mismatch\n";
+            return 1;
+        }
+        HttpDeadlineConfig bounded = config;
+        bounded.request_timeout = 30s;
+        HttpRequestDeadline total;
+        total.begin(bounded, origin, true, 0);
+        total.check(HttpReadProgress{0, true, 100}, origin + 5s);
+        total.check(HttpReadProgress{0, true, 200}, origin + 25s);
+        if (total.nextCheck() != origin + 30s ||
+            total.check(HttpReadProgress{0, true, 300}, origin + 30s) != HttpDeadlineExpiry::Request) {
+            std::cerr << "[T95] request timeout mismatch\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T95-TimingWheel PASS\n";
+    return 0;
+}
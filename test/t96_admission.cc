@@ -0,0 +1,172 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/admission.h"
+
+using namespace galay::http;
+using namespace std::chrono_literals;
+
+int main() {
+    const auto origin = std::chrono::steady_clock::now();
+
+    // CoDel：突发（窗口内有低时延样本）不丢弃，整窗口积压后丢弃超过 2 × target 的样本
+    {
+        HttpCoDel codel;
+        codel.configure(5ms, 100ms);
+        // 第一个窗口：时延高但有一个低样本，属于突发
+        if (codel.shouldShed(50ms, origin) || codel.shouldShed(1ms, origin + 10ms) ||
+            codel.shouldShed(50ms, origin + 50ms)) {
+            std::cerr << "[T96] burst should not be shed\n";
+            return 1;
+        }
+        // 第二个窗口：开始时判定上一窗口不积压；本窗口全部高于 target
+        if (codel.shouldShed(20ms, origin + 100ms) || codel.overloaded() ||
+            codel.shouldShed(30ms, origin + 150ms)) {
+            std::cerr << "[T96] second window should still admit\n";
+            return 1;
+        }
+        // 第三个窗口：上一窗口最小时延 20ms > 5ms，进入积压
+        if (!codel.shouldShed(30ms, origin + 200ms) || !codel.overloaded()) {
+            std::cerr << "[T96] standing queue should shed\n";
+            return 1;
+        }
+        if (codel.shouldShed(8ms, origin + 210ms)) {
+            std::cerr << "[T96] sample under 2x target should pass\n";
+            return 1;
+        }
+        // 第四个窗口：上一窗口最小 8ms 仍积压；之后空闲超过一个窗口，恢复放行
+        if (!codel.shouldShed(40ms, origin + 300ms)) {
+            std::cerr << "[T96] still overloaded\n";
+            return 1;
+        }
+        if (codel.shouldShed(40ms, origin + 1s) || codel.overloaded()) {
+            std::cerr << "[T96] idle gap should reset overload\n";
+            return 1;
+        }
+    }
+
+    HttpAdmissionConfig config;
+    config.enabled = true;
+    config.max_connections_per_scheduler = 2;
+    config.max_inflight_requests = 3;
+    config.queue_delay_target = 5ms;
+    config.retry_after_seconds = 7;
+
+    // 连接上限按调度器独立计数
+    {
+        HttpAdmissionControl admission;
+        admission.reset(2, config);
+        if (!admission.tryOpenConnection(0) || !admission.tryOpenConnection(0) ||
+            admission.tryOpenConnection(0) || !admission.tryOpenConnection(1)) {
+            std::cerr << "[T96] per-scheduler connection limit mismatch\n";
+            return 1;
+        }
+        admission.onConnectionClose(0);
+        if (!admission.tryOpenConnection(0)) {
+            std::cerr << "[T96] closed connection should free quota\n";
+            return 1;
+        }
+        admission.adoptConnection(1);
+        admission.adoptConnection(1);
+        const auto stats = admission.snapshot();
+        if (stats.schedulers.size() != 2 || stats.schedulers[0].live != 2 || stats.schedulers[1].live != 3 ||
+            stats.schedulers[0].rejected_connections != 1) {
+            std::cerr << "[T96] connection stats mismatch\n";
+            return 1;
+        }
+    }
+
+    // 在途上限与排队时延
+    {
+        HttpAdmissionControl admission;
+        admission.reset(1, config);
+        for (int i = 0; i < 3; ++i) {
+            if (admission.beginRequest(0) != HttpAdmissionVerdict::Admit) {
+                std::cerr << "[T96] request under limit rejected\n";
+                return 1;
+            }
+        }
+        if (admission.beginRequest(0) != HttpAdmissionVerdict::InflightLimit) {
+            std::cerr << "[T96] inflight limit not enforced\n";
+            return 1;
+        }
+        admission.endRequest();
+        if (admission.beginRequest(0) != HttpAdmissionVerdict::Admit) {
+            std::cerr << "[T96] finished request should free quota\n";
+            return 1;
+        }
+        admission.endRequest();
+        admission.endRequest();
+        admission.endRequest();
+
+        // 一整个窗口积压后，排队 20ms 的工作被丢弃且不占在途配额
+        admission.beginRequest(0, origin, origin + 20ms);
+        admission.endRequest();
+        admission.beginRequest(0, origin + 100ms, origin + 110ms);
+        admission.endRequest();
+        if (admission.beginRequest(0, origin + 180ms, origin + 200ms) != HttpAdmissionVerdict::QueueDelay) {
+            std::cerr << "[T96] queue delay should shed\n";
+            return 1;
+        }
+        const auto stats = admission.snapshot();
+        if (stats.inflight != 0 || stats.shed_inflight != 1 || stats.schedulers[0].shed_queue_delay != 1 ||
+            !stats.schedulers[0].overloaded) {
+            std::cerr << "[T96] request stats mismatch inflight=" << stats.inflight << "\n";
+            return 1;
+        }
+    }
+
+    // 未启用时全部放行且不计数
+    {
+        HttpAdmissionConfig disabled = config;
+        disabled.enabled = false;
+        HttpAdmissionControl admission;
+        admission.reset(1, disabled);
+        for (int i = 0; i < 10; ++i) {
+            if (!admission.tryOpenConnection(0) || admission.beginRequest(0) != HttpAdmissionVerdict::Admit) {
+                std::cerr << "[T96] disabled admission should admit\n";
+                return 1;
+            }
+        }
+        if (admission.snapshot().inflight != 0) {
+            std::cerr << "[T96] disabled admission should not count\n";
+            return 1;
+        }
+    }
+
+    // 预构造的 503 响应经 socket 原样写出
+    {
+        HttpAdmissionControl admission;
+        admission.reset(1, config);
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            std::cerr << "[T96] socketpair failed\n";
+            return 1;
+        }
+        const std::string request = "GET / HTTP/1.1\r\nHost: x\r\n\r\n";
+        (void)::send(fds[1], request.data(), request.size(), 0);
+        HttpAdmissionControl::writeRejection(fds[0], admission.rejectResponse());
+        ::close(fds[0]);
+        std::string response;
+        char buf[512];
+        ssize_t n = 0;
+        while ((n = ::recv(fds[1], buf, sizeof(buf), 0)) > 0) {
+            response.append(buf, static_cast<size_t>(n));
+        }
+        ::close(fds[1]);
+        if (response.rfind("HTTP/1.1 503 Service Unavailable\r\n", 0) != 0 ||
+            response.find("Retry-After: 7\r\n") == std::string::npos ||
+            response.find("Connection: close\r\n") == std::string::npos ||
+            response.find("Content-Length: 19\r\n") == std::string::npos ||
+            !response.ends_with("\r\n\r\nService Unavailable")) {
+            std::cerr << "[T96] unexpected rejection: " << response << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T96-Admission PASS\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <thread>
+
+#include "galay-http/kernel/ring_buffer_pool.h"
+
+using namespace galay::http;
+
+int main() {
+    auto& pool = RingBufferPool::local();
+
+    // 空闲表为空时新分配；归还后再取回时命中空闲表
+    {
+        RingBuffer buffer = pool.acquire();
+        if (buffer.capacity() != RingBufferPool::kBufferSize || buffer.readable() != 0) {
+            std::cerr << "[T97] fresh buffer mismatch\n";
+            return 1;
+        }
+        buffer.write("GET", 3);
+        buffer.consume(3);
+        pool.release(std::move(buffer));
+        RingBuffer again = pool.acquire();
+        const auto stats = pool.stats();
+        if (again.capacity() != RingBufferPool::kBufferSize || again.readable() != 0 || stats.acquired != 2 || stats.reused != 1 ||
+            stats.released != 1 || stats.cached != 0) {
+            std::cerr << "[T97] released buffer should be reused\n";
+            return 1;
+        }
+        pool.release(std::move(again));
+    }
+
+    // 仍有未消费数据或容量不符的缓冲不回收
+    {
+        RingBuffer pending = pool.acquire();
+        pending.write("x", 1);
+        pool.release(std::move(pending));
+        pool.release(RingBuffer(65536));
+        const auto stats = pool.stats();
+        if (stats.dropped != 2 || stats.cached != 0) {
+            std::cerr << "[T97] non-empty or oversized buffer should be dropped\n";
+            return 1;
+        }
+    }
+
+    // 连接读缓冲：有未消费数据时不归还；归还后 get() 在同一存储上取回，Reader 持有的引用仍有效
+    {
+        PooledRingBuffer conn_buffer;
+        RingBuffer& reader_view = conn_buffer.get();
+        reader_view.write("ab", 2);
+        if (conn_buffer.release() || conn_buffer.released() || conn_buffer.buffered() != 2) {
+            std::cerr << "[T97] pipelined data should keep buffer\n";
+            return 1;
+        }
+        reader_view.consume(2);
+        if (!conn_buffer.release() || !conn_buffer.released() || conn_buffer.buffered() != 0 ||
+            pool.stats().cached != 1) {
+            std::cerr << "[T97] empty buffer should be released\n";
+            return 1;
+        }
+        RingBuffer& again = conn_buffer.get();
+        if (&again != &reader_view || conn_buffer.released() || pool.stats().cached != 0) {
+            std::cerr << "[T97] reacquired buffer should reuse storage\n";
+            return 1;
+        }
+    }
+
+    // 空闲表有上限
+    {
+        for (size_t i = 0; i < RingBufferPool::kMaxCached + 4; ++i) {
+            pool.release(RingBuffer(RingBufferPool::kBufferSize));
+        }
+        if (pool.stats().cached != RingBufferPool::kMaxCached) {
+            std::cerr << "[T97] pool should cap cached buffers\n";
+            return 1;
+        }
+    }
+
+    // 每个线程独立的空闲表
+    {
+        size_t other_cached = 1;
+        std::thread worker([&] { other_cached = RingBufferPool::local().stats().cached; });
+        worker.join();
+        if (other_cached != 0) {
+            std::cerr << "[T97] pool should be per thread\n";
+            return 1;
+        }
+    }
+
+    std::cout << "T97-RingBufferPool PASS\n";
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/socket_addr.h"
+
+using namespace galay::http;
+
+namespace {
+
+uint16_t boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+int connectLoopback(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main() {
+    std::string error;
+    const int listener = detail::openTcpListener(HttpSocketAddress::parse("127.0.0.1", 0), 64, false, error);
+    if (listener < 0) {
+        std::cerr << "[T98] listen failed: " << error << "\n";
+        return 1;
+    }
+    const uint16_t port = boundPort(listener);
+
+    std::vector<int> clients;
+    for (int i = 0; i < 5; ++i) {
+        clients.push_back(connectLoopback(port));
+        if (clients.back() < 0) {
+            std::cerr << "[T98] connect failed\n";
+            return 1;
+        }
+    }
+
+    std::vector<int> accepted;
+    // 未 arm 时不取连接；limit 为 1 时不批量
+    {
+        HttpAcceptBatch disabled(listener, 1);
+        disabled.arm();
+        HttpAcceptBatch batch(listener, 4);
+        if (disabled.next() >= 0 || batch.next() >= 0) {
+            std::cerr << "[T98] batch should only drain after arm\n";
+            return 1;
+        }
+    }
+
+    // 每轮最多取 limit - 1 个；队列为空时返回 -1 回到等待式 accept
+    {
+        HttpAcceptBatch batch(listener, 4);
+        batch.arm();
+        for (int fd = batch.next(); fd >= 0; fd = batch.next()) {
+            accepted.push_back(fd);
+        }
+        if (accepted.size() != 3) {
+            std::cerr << "[T98] first round should take 3, took " << accepted.size() << "\n";
+            return 1;
+        }
+        batch.arm();
+        for (int fd = batch.next(); fd >= 0; fd = batch.next()) {
+            accepted.push_back(fd);
+        }
+        if (accepted.size() != 5 || batch.next() >= 0) {
+            std::cerr << "[T98] second round should drain to EAGAIN, total " << accepted.size() << "\n";
+            return 1;
+        }
+    }
+
+    // 取出的 fd 已是非阻塞且 close-on-exec
+    for (int fd : accepted) {
+        if ((::fcntl(fd, F_GETFL) & O_NONBLOCK) == 0 || (::fcntl(fd, F_GETFD) & FD_CLOEXEC) == 0) {
+            std::cerr << "[T98] accepted fd should be nonblocking and cloexec\n";
+            return 1;
+        }
+        ::close(fd);
+    }
+    for (int fd : clients) {
+        ::close(fd);
+    }
+    ::close(listener);
+
+    std::cout << "T98-AcceptBatch PASS\n";
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <string>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "galay-http/kernel/http/socket_addr.h"
+#include "galay-http/kernel/http/socket_tuning.h"
+
+using namespace galay::http;
+
+namespace {
+
+int readOption(int fd, int level, int name) {
+    int value = -1;
+    socklen_t len = sizeof(value);
+    if (::getsockopt(fd, level, name, &value, &len) != 0) {
+        return -1;
+    }
+    return value;
+}
+
+uint16_t boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+} // namespace
+
+int main() {
+    HttpSocketTuning tuning;
+    tuning.defer_accept_seconds = 5;
+    tuning.fastopen_queue = 16;
+    tuning.busy_poll_usecs = 50;
+    tuning.recv_buffer = 256 * 1024;
+    tuning.send_buffer = 128 * 1024;
+    tuning.notsent_lowat = 16 * 1024;
+    tuning.quickack = true;
+
+    // 默认配置不设置任何选项
+    if (HttpSocketTuning().hasAcceptedOptions() || !tuning.hasAcceptedOptions()) {
+        std::cerr << "[T99] accepted option detection mismatch\n";
+        return 1;
+    }
+
+    std::string error;
+    const int listener = detail::openTcpListener(HttpSocketAddress::parse("127.0.0.1", 0), 64, false, error);
+    if (listener < 0) {
+        std::cerr << "[T99] listen failed: " << error << "\n";
+        return 1;
+    }
+    const std::string failed = detail::applyListenerTuning(listener, tuning, true);
+    // SO_BUSY_POLL 超过 net.core.busy_read 需要 CAP_NET_ADMIN，非特权环境允许失败
+    const bool busy_poll_set = failed.find("SO_BUSY_POLL") == std::string::npos;
+    if (!failed.empty() && failed != "SO_BUSY_POLL") {
+        std::cerr << "[T99] listener tuning failed: " << failed << "\n";
+        return 1;
+    }
+
+    // 读回：DEFER_ACCEPT 按重传次数取整（不小于设置值），缓冲按两倍记账
+    if (readOption(listener, IPPROTO_TCP, TCP_DEFER_ACCEPT) < tuning.defer_accept_seconds ||
+        readOption(listener, IPPROTO_TCP, TCP_FASTOPEN) != tuning.fastopen_queue ||
+        readOption(listener, SOL_SOCKET, SO_RCVBUF) < tuning.recv_buffer ||
+        readOption(listener, SOL_SOCKET, SO_SNDBUF) < tuning.send_buffer ||
+        (busy_poll_set && readOption(listener, SOL_SOCKET, SO_BUSY_POLL) != tuning.busy_poll_usecs)) {
+        std::cerr << "[T99] listener readback mismatch defer=" << readOption(listener, IPPROTO_TCP, TCP_DEFER_ACCEPT)
+                  << " tfo=" << readOption(listener, IPPROTO_TCP, TCP_FASTOPEN)
+                  << " rcvbuf=" << readOption(listener, SOL_SOCKET, SO_RCVBUF) << "\n";
+        return 1;
+    }
+
+    // TCP_DEFER_ACCEPT 下连接在收到数据后才可 accept；accept 出的连接继承缓冲大小
+    const int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(boundPort(listener));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (client < 0 || ::connect(client, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "[T99] connect failed\n";
+        return 1;
+    }
+    ::usleep(50 * 1000);
+    if (::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK) >= 0) {
+        std::cerr << "[T99] defer accept should hold connection without data\n";
+        return 1;
+    }
+    (void)::send(client, "GET", 3, 0);
+    int accepted = -1;
+    for (int attempt = 0; attempt < 100 && accepted < 0; ++attempt) {
+        accepted = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+        if (accepted < 0) {
+            ::usleep(10 * 1000);
+        }
+    }
+    if (accepted < 0) {
+        std::cerr << "[T99] accept after data failed\n";
+        return 1;
+    }
+    const std::string accepted_failed = detail::applyAcceptedTuning(accepted, tuning);
+    if (!accepted_failed.empty() ||
+        readOption(accepted, IPPROTO_TCP, TCP_NOTSENT_LOWAT) != tuning.notsent_lowat ||
+        readOption(accepted, SOL_SOCKET, SO_RCVBUF) < tuning.recv_buffer ||
+        (busy_poll_set && readOption(accepted, SOL_SOCKET, SO_BUSY_POLL) != tuning.busy_poll_usecs)) {
+        std::cerr << "[T99] accepted readback mismatch failed=" << accepted_failed << "\n";
+        return 1;
+    }
+
+    // Unix domain socket 只设置缓冲大小，TCP 选项被跳过
+    {
+        const int unix_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (!detail::applyListenerTuning(unix_fd, tuning, false).empty() ||
+            readOption(unix_fd, SOL_SOCKET, SO_SNDBUF) < tuning.send_buffer) {
+            std::cerr << "[T99] unix tuning mismatch\n";
+            return 1;
+        }
+        ::close(unix_fd);
+    }
+
+    ::close(accepted);
+    ::close(client);
+    ::close(listener);
+
+    std::cout << "T99-SocketTuning PASS\n";
+    return 0;
+}